@@ -78,6 +78,25 @@ void handle_udp_prog_framer(
 /***********************************************************************
  * Handler for peek and poke host packets
  **********************************************************************/
+static uint32_t fw_comms_peek32(const uint32_t addr)
+{
+    if (addr & 0x00100000) {
+        uint32_t data = 0;
+        chinch_peek32(addr & 0x000FFFFF, &data);
+        return data;
+    }
+    return wb_peek32(addr);
+}
+
+static void fw_comms_poke32(const uint32_t addr, const uint32_t data)
+{
+    if (addr & 0x00100000) {
+        chinch_poke32(addr & 0x000FFFFF, data);
+    } else {
+        wb_poke32(addr, data);
+    }
+}
+
 void handle_udp_fw_comms(
     const uint8_t ethno,
     const struct ip_addr *src, const struct ip_addr *dst,
@@ -89,36 +108,15 @@ void handle_udp_fw_comms(
      /* We got here from ICMP_DUR undeliverable packet */
     /* Future space for hooks to tear down streaming radios etc */
     } else {
-        const x300_fw_comms_t *request = (const x300_fw_comms_t *)buff;
-        x300_fw_comms_t reply; memcpy(&reply, buff, sizeof(reply));
-
-        //check for error and set error flag
-        if (num_bytes < sizeof(x300_fw_comms_t)) {
-           reply.flags |= X300_FW_COMMS_FLAGS_ERROR;
-        }
-        //otherwise, run the actions set by the flags
-        else {
-            if (request->flags & X300_FW_COMMS_FLAGS_PEEK32)
-            {
-                if (request->addr & 0x00100000) {
-                    chinch_peek32(request->addr & 0x000FFFFF, &reply.data);
-                } else {
-                    reply.data = wb_peek32(request->addr);
-                }
-            }
-            if (request->flags & X300_FW_COMMS_FLAGS_POKE32)
-            {
-                if (request->addr & 0x00100000) {
-                    chinch_poke32(request->addr & 0x000FFFFF, request->data);
-                } else {
-                    wb_poke32(request->addr, request->data);
-                }
-            }
-        }
+        //static: a full batch is too large for the stack
+        static x300_fw_comms_batch_t reply;
+        const uint32_t flags = ((const x300_fw_comms_t *)buff)->flags;
+        const size_t reply_len = x300_fw_comms_handle_request(
+            buff, num_bytes, &reply, &fw_comms_peek32, &fw_comms_poke32);
 
         //send a reply if ack requested
-        if (request->flags & X300_FW_COMMS_FLAGS_ACK) {
-            u3_net_stack_send_udp_pkt(ethno, src, dst_port, src_port, &reply, sizeof(reply));
+        if (flags & X300_FW_COMMS_FLAGS_ACK) {
+            u3_net_stack_send_udp_pkt(ethno, src, dst_port, src_port, &reply, reply_len);
         }
     }
 }
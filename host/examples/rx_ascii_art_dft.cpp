@@ -7,6 +7,7 @@
 
 #include "ascii_art_dft.hpp" //implementation
 #include <uhd/usrp/multi_usrp.hpp>
+#include <uhd/utils/fft.hpp>
 #include <uhd/utils/safe_main.hpp>
 #include <uhd/utils/thread.hpp>
 #include <curses.h>
@@ -25,7 +26,7 @@ int UHD_SAFE_MAIN(int argc, char* argv[])
 {
     // variables to be set by po
     std::string args, ant, subdev, ref;
-    size_t num_bins;
+    size_t num_bins, num_avg;
     double rate, freq, gain, bw, frame_rate, step;
     float ref_lvl, dyn_rng;
     bool show_controls;
@@ -45,6 +46,7 @@ int UHD_SAFE_MAIN(int argc, char* argv[])
         ("bw", po::value<double>(&bw), "analog frontend filter bandwidth in Hz")
         // display parameters
         ("num-bins", po::value<size_t>(&num_bins)->default_value(512), "the number of bins in the DFT")
+        ("avg", po::value<size_t>(&num_avg)->default_value(1), "the number of DFTs to average per display frame")
         ("frame-rate", po::value<double>(&frame_rate)->default_value(5), "frame rate of the display (fps)")
         ("ref-lvl", po::value<float>(&ref_lvl)->default_value(0), "reference level for the display (dB)")
         ("dyn-rng", po::value<float>(&dyn_rng)->default_value(60), "dynamic range for the display (dB)")
@@ -171,6 +173,7 @@ int UHD_SAFE_MAIN(int argc, char* argv[])
     // allocate recv buffer and metatdata
     uhd::rx_metadata_t md;
     std::vector<std::complex<float>> buff(num_bins);
+    uhd::power_spectrum::sptr spectrum = uhd::power_spectrum::make(num_bins);
     //------------------------------------------------------------------
     //-- Initialize
     //------------------------------------------------------------------
@@ -187,6 +190,12 @@ int UHD_SAFE_MAIN(int argc, char* argv[])
         if (num_rx_samps != buff.size())
             continue;
 
+        // average the first num_avg buffers after every display refresh
+        const size_t num_averaged = spectrum->get_num_averaged();
+        if (num_averaged == 0 or num_averaged < num_avg) {
+            spectrum->process(&buff.front(), num_rx_samps);
+        }
+
         // check and update the display refresh condition
         if (high_resolution_clock::now() < next_refresh) {
             continue;
@@ -194,9 +203,8 @@ int UHD_SAFE_MAIN(int argc, char* argv[])
         next_refresh = high_resolution_clock::now()
                        + std::chrono::microseconds(int64_t(1e6 / frame_rate));
 
-        // calculate the dft and create the ascii art frame
-        ascii_art_dft::log_pwr_dft_type lpdft(
-            ascii_art_dft::log_pwr_dft(&buff.front(), num_rx_samps));
+        // get the averaged dft and create the ascii art frame
+        ascii_art_dft::log_pwr_dft_type lpdft(spectrum->get_log_power());
         std::string frame = ascii_art_dft::dft_to_plot(lpdft,
             COLS,
             (show_controls ? LINES - 6 : LINES),
@@ -9,6 +9,7 @@
 #include <uhd/exception.hpp>
 #include <uhd/usrp/multi_usrp.hpp>
 #include <uhd/utils/safe_main.hpp>
+#include <uhd/utils/signal_generator.hpp>
 #include <uhd/utils/static.hpp>
 #include <uhd/utils/thread.hpp>
 #include <stdint.h>
@@ -41,8 +42,8 @@ int UHD_SAFE_MAIN(int argc, char* argv[])
     // variables to be set by po
     std::string args, wave_type, ant, subdev, ref, pps, otw, channel_list;
     uint64_t total_num_samps;
-    size_t spb;
-    double rate, freq, gain, wave_freq, bw, lo_offset;
+    size_t spb, num_tones, prbs_order;
+    double rate, freq, gain, wave_freq, bw, lo_offset, sweep_time;
     float ampl;
 
     // setup the program options
@@ -62,8 +63,11 @@ int UHD_SAFE_MAIN(int argc, char* argv[])
         ("ant", po::value<std::string>(&ant), "antenna selection")
         ("subdev", po::value<std::string>(&subdev), "subdevice specification")
         ("bw", po::value<double>(&bw), "analog frontend filter bandwidth in Hz")
-        ("wave-type", po::value<std::string>(&wave_type)->default_value("CONST"), "waveform type (CONST, SQUARE, RAMP, SINE)")
-        ("wave-freq", po::value<double>(&wave_freq)->default_value(0), "waveform frequency in Hz")
+        ("wave-type", po::value<std::string>(&wave_type)->default_value("CONST"), "waveform type (CONST, SQUARE, RAMP, SINE, MULTITONE, CHIRP, PRBS, NOISE)")
+        ("wave-freq", po::value<double>(&wave_freq)->default_value(0), "waveform frequency in Hz (MULTITONE: tone spacing, CHIRP: sweeps from -wave-freq to +wave-freq)")
+        ("num-tones", po::value<size_t>(&num_tones)->default_value(4), "number of tones for MULTITONE")
+        ("sweep-time", po::value<double>(&sweep_time)->default_value(1e-3), "duration of one sweep in seconds for CHIRP")
+        ("prbs-order", po::value<size_t>(&prbs_order)->default_value(23), "order of the sequence for PRBS (7, 9, 11, 15, 20, 23, 31)")
         ("ref", po::value<std::string>(&ref)->default_value("internal"), "clock reference (internal, external, mimo, gpsdo)")
         ("pps", po::value<std::string>(&pps), "PPS source (internal, external, mimo, gpsdo)")
         ("otw", po::value<std::string>(&otw)->default_value("sc16"), "specify the over-the-wire sample mode")
@@ -169,29 +173,54 @@ int UHD_SAFE_MAIN(int argc, char* argv[])
 
     std::this_thread::sleep_for(std::chrono::seconds(1)); // allow for some setup time
 
-    // for the const wave, set the wave freq for small samples per period
+    // waveforms which need no wave freq
+    const double tx_rate = usrp->get_tx_rate();
     if (wave_freq == 0) {
         if (wave_type == "CONST") {
-            wave_freq = usrp->get_tx_rate() / 2;
-        } else {
-            throw std::runtime_error(
-                "wave freq cannot be 0 with wave type other than CONST");
+            wave_freq = tx_rate / 2;
+        } else if (wave_type != "PRBS" and wave_type != "NOISE") {
+            throw std::runtime_error("wave freq cannot be 0 with wave type other than "
+                                     "CONST, PRBS or NOISE");
         }
     }
 
     // error when the waveform is not possible to generate
-    if (std::abs(wave_freq) > usrp->get_tx_rate() / 2) {
+    if (std::abs(wave_freq) > tx_rate / 2) {
         throw std::runtime_error("wave freq out of Nyquist zone");
     }
-    if (usrp->get_tx_rate() / std::abs(wave_freq) > wave_table_len / 2) {
+
+    // the square and ramp waves come from a table, the others are synthesized
+    // straight into the send buffer
+    uhd::signal_generator::sptr generator;
+    if (wave_type == "CONST") {
+        generator = uhd::signal_generator::make_const(std::complex<float>(ampl, ampl));
+    } else if (wave_type == "SINE") {
+        generator = uhd::signal_generator::make_tone(tx_rate, wave_freq, ampl);
+    } else if (wave_type == "MULTITONE") {
+        // tones spaced by the wave freq, centered around DC
+        std::vector<double> tone_freqs;
+        for (size_t k = 0; k < num_tones; k++) {
+            tone_freqs.push_back((k - (num_tones - 1) / 2.0) * wave_freq);
+        }
+        if (num_tones == 0 or std::abs(tone_freqs.front()) > tx_rate / 2) {
+            throw std::runtime_error("tones out of Nyquist zone");
+        }
+        generator = uhd::signal_generator::make_multi_tone(tx_rate, tone_freqs, ampl);
+    } else if (wave_type == "CHIRP") {
+        generator = uhd::signal_generator::make_chirp(
+            tx_rate, -std::abs(wave_freq), std::abs(wave_freq), sweep_time, ampl);
+    } else if (wave_type == "PRBS") {
+        generator = uhd::signal_generator::make_prbs(prbs_order, ampl);
+    } else if (wave_type == "NOISE") {
+        generator = uhd::signal_generator::make_noise(ampl);
+    } else if (tx_rate / std::abs(wave_freq) > wave_table_len / 2) {
         throw std::runtime_error("wave freq too small for table");
     }
 
     // pre-compute the waveform values
-    const wave_table_class wave_table(wave_type, ampl);
-    const size_t step =
-        boost::math::iround(wave_freq / usrp->get_tx_rate() * wave_table_len);
-    size_t index = 0;
+    const wave_table_class wave_table(generator ? "CONST" : wave_type, ampl);
+    const size_t step = boost::math::iround(wave_freq / tx_rate * wave_table_len);
+    size_t index      = 0;
 
     // create a transmit streamer
     // linearly map channels (index0 = channel0, index1 = channel1, ...)
@@ -206,10 +235,17 @@ int UHD_SAFE_MAIN(int argc, char* argv[])
     std::vector<std::complex<float>> buff(spb);
     std::vector<std::complex<float>*> buffs(channel_nums.size(), &buff.front());
 
-    // pre-fill the buffer with the waveform
-    for (size_t n = 0; n < buff.size(); n++) {
-        buff[n] = wave_table(index += step);
-    }
+    // fill the buffer with the next samples of the waveform
+    auto fill_buff = [&]() {
+        if (generator) {
+            generator->generate(buff.data(), buff.size());
+        } else {
+            for (size_t n = 0; n < buff.size(); n++) {
+                buff[n] = wave_table(index += step);
+            }
+        }
+    };
+    fill_buff();
 
     std::cout << boost::format("Setting device timestamp to 0...") << std::endl;
     if (channel_nums.size() > 1) {
@@ -296,9 +332,7 @@ int UHD_SAFE_MAIN(int argc, char* argv[])
         num_acc_samps += tx_stream->send(buffs, buff.size(), md);
 
         // fill the buffer with the waveform
-        for (size_t n = 0; n < buff.size(); n++) {
-            buff[n] = wave_table(index += step);
-        }
+        fill_buff();
 
         md.start_of_burst = false;
         md.has_time_spec  = false;
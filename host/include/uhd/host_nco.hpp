@@ -0,0 +1,88 @@
+//
+// Copyright 2019 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#ifndef INCLUDED_UHD_HOST_NCO_HPP
+#define INCLUDED_UHD_HOST_NCO_HPP
+
+#include <uhd/config.hpp>
+#include <uhd/stream_stage.hpp>
+#include <uhd/types/time_spec.hpp>
+#include <boost/shared_ptr.hpp>
+
+namespace uhd {
+
+/*! A numerically controlled oscillator which runs on the host
+ *
+ * The NCO is a uhd::stream_stage which multiplies every sample with
+ * exp(2j * pi * freq * n / samp_rate). It shifts a signal within the captured
+ * band without retuning the device: to move a signal at an offset of +f in an
+ * RX stream to DC, set the frequency to -f. The phase is continuous across
+ * frequency changes and transport frames.
+ *
+ * The frequency can be changed from any thread while streaming. Changes do
+ * not take a lock in the streaming thread; they are picked up at the next
+ * transport frame, or at the sample with the given timestamp for timed
+ * changes. Only the most recent change is kept: a change replaces any change
+ * which has not taken effect yet.
+ *
+ * When the NCO is the first stage of an RX streamer that converts "sc16"
+ * over the wire to "fc32", the streamer runs the conversion and the mixing in
+ * one pass. Otherwise it runs on the converted samples like any other stage.
+ * The CPU formats "fc32" and "sc16" are supported.
+ *
+ * \code{.cpp}
+ * uhd::host_nco::sptr nco = uhd::host_nco::make(usrp->get_rx_rate(), -25e3);
+ * uhd::stream_args_t stream_args("fc32", "sc16");
+ * stream_args.stages.push_back(nco);
+ * auto rx_stream = usrp->get_rx_stream(stream_args);
+ * // ...later, from any thread:
+ * nco->set_freq(-30e3, usrp->get_time_now() + uhd::time_spec_t(0.1));
+ * \endcode
+ */
+class UHD_API host_nco : public stream_stage
+{
+public:
+    typedef boost::shared_ptr<host_nco> sptr;
+
+    /*!
+     * Make a new host NCO.
+     * \param samp_rate the sample rate of the stream, in Hz
+     * \param freq the initial frequency, in Hz
+     * \throws uhd::value_error if the sample rate is not positive
+     */
+    static sptr make(const double samp_rate, const double freq = 0.0);
+
+    /*!
+     * Change the frequency at the start of the next transport frame.
+     * This is safe to call from any thread.
+     * \param freq the new frequency, in Hz
+     */
+    virtual void set_freq(const double freq) = 0;
+
+    /*!
+     * Change the frequency at the sample with the given time.
+     * This requires timestamped samples; on streams without timestamps, the
+     * change happens at the next transport frame. Times in the past take
+     * effect immediately.
+     * This is safe to call from any thread.
+     * \param freq the new frequency, in Hz
+     * \param time the time of the first sample with the new frequency
+     */
+    virtual void set_freq(const double freq, const time_spec_t& time) = 0;
+
+    //! Get the most recently requested frequency, in Hz
+    virtual double get_freq(void) const = 0;
+
+    /*!
+     * Get the frequency step of the NCO.
+     * Frequencies are rounded to a multiple of this step.
+     */
+    virtual double get_freq_resolution(void) const = 0;
+};
+
+} /* namespace uhd */
+
+#endif /* INCLUDED_UHD_HOST_NCO_HPP */
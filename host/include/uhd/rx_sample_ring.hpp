@@ -0,0 +1,170 @@
+//
+// Copyright 2019 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#ifndef INCLUDED_UHD_RX_SAMPLE_RING_HPP
+#define INCLUDED_UHD_RX_SAMPLE_RING_HPP
+
+#include <uhd/config.hpp>
+#include <uhd/stream.hpp>
+#include <uhd/types/metadata.hpp>
+#include <uhd/types/time_spec.hpp>
+#include <uhd/utils/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace uhd {
+
+/*! A memory-bounded ring of received samples
+ *
+ * The ring receives from an RX streamer and converts the samples directly into
+ * a circular buffer (one per channel), without an intermediate copy. This is
+ * useful for applications which need to look back in time, such as a
+ * trigger-and-capture application with a pre-trigger buffer.
+ *
+ * Every sample has an index, which is the number of samples received before
+ * it. The buffers are mapped twice, back to back, so any window of up to
+ * get_capacity() samples is contiguous in memory and can be read in place.
+ *
+ * One thread calls recv() to fill the ring, while any number of threads may
+ * read windows from it:
+ *
+ * \code{.cpp}
+ * auto ring = uhd::rx_sample_ring::make(rx_stream, "fc32", 10e6, rate);
+ * // Receive thread:
+ * uhd::rx_metadata_t md;
+ * while (running) {
+ *     ring->recv(md);
+ * }
+ * // Consumer thread:
+ * uhd::rx_sample_ring::window_t window;
+ * if (ring->get_window(trigger_time - pretrigger, nsamps, window)
+ *         == uhd::rx_sample_ring::READ_OK) {
+ *     process(window.buffs, window.nsamps);
+ *     if (ring->is_overwritten(window)) {
+ *         // The receive thread overwrote the window while it was processed
+ *     }
+ * }
+ * \endcode
+ *
+ * \b Note: This feature requires support for memory mapped files, and is not
+ * available on all platforms.
+ */
+class UHD_API rx_sample_ring : uhd::noncopyable
+{
+public:
+    typedef boost::shared_ptr<rx_sample_ring> sptr;
+
+    //! Result of a window request
+    enum read_status_t {
+        //! The window was read successfully
+        READ_OK,
+        //! (Parts of) the requested samples have already been overwritten
+        READ_OVERWRITTEN,
+        //! (Parts of) the requested samples have not been received yet
+        READ_NOT_AVAILABLE
+    };
+
+    //! A range of samples in the ring
+    struct window_t
+    {
+        //! One pointer per channel to the first sample of the window
+        std::vector<const void*> buffs;
+        //! Index of the first sample of the window
+        uint64_t start_index;
+        //! Number of samples per channel
+        size_t nsamps;
+        //! Time of the first sample, if timestamps were received
+        time_spec_t time_spec;
+        //! True if time_spec is valid
+        bool has_time_spec;
+    };
+
+    /*! Make a new sample ring
+     *
+     * \param rx_stream The streamer to receive from
+     * \param cpu_format The CPU format of \p rx_stream (e.g., "fc32")
+     * \param capacity Minimum number of samples per channel the ring can hold.
+     *                 It is rounded up to a multiple of the page size. It must
+     *                 be at least the max number of samples per packet of
+     *                 \p rx_stream.
+     * \param samp_rate The sample rate of \p rx_stream, used for converting
+     *                  between sample indices and timestamps.
+     * \throws uhd::not_implemented_error if the platform does not support
+     *         sample rings.
+     */
+    static sptr make(rx_streamer::sptr rx_stream,
+        const std::string& cpu_format,
+        const size_t capacity,
+        const double samp_rate);
+
+    virtual ~rx_sample_ring(void) = 0;
+
+    //! Number of samples per channel the ring can hold
+    virtual size_t get_capacity(void) const = 0;
+
+    //! Number of channels of the underlying streamer
+    virtual size_t get_num_channels(void) const = 0;
+
+    /*! Receive one packet from the streamer into the ring
+     *
+     * This converts directly into the ring, overwriting the oldest samples.
+     * Only one thread may call this method at a time.
+     *
+     * \param metadata The metadata of the packet, as returned by
+     *                 uhd::rx_streamer::recv()
+     * \param timeout The timeout in seconds for the underlying recv() call
+     * \returns the number of samples received per channel
+     */
+    virtual size_t recv(rx_metadata_t& metadata, const double timeout = 0.1) = 0;
+
+    //! Index of the next sample that will be written (the write index)
+    virtual uint64_t get_write_index(void) const = 0;
+
+    //! Index of the oldest sample that may still be read
+    virtual uint64_t get_oldest_index(void) const = 0;
+
+    /*! Return the time of the sample with a given index
+     *
+     * \throws uhd::value_error if the sample is not in the ring, or if no
+     *         timestamp is known for it.
+     */
+    virtual time_spec_t get_time_spec(const uint64_t index) const = 0;
+
+    /*! Get a window of samples by index
+     *
+     * On success, \p window points into the ring. The data remains valid
+     * until the receive thread overwrites it, see is_overwritten().
+     *
+     * \param start_index Index of the first sample
+     * \param nsamps Number of samples per channel, at most get_capacity()
+     * \param window The window to fill in
+     */
+    virtual read_status_t get_window(
+        const uint64_t start_index, const size_t nsamps, window_t& window) const = 0;
+
+    /*! Get a window of samples by time
+     *
+     * Same as above, but the first sample is the one closest to \p start_time.
+     * Returns READ_OVERWRITTEN if \p start_time is older than any timestamp
+     * in the ring.
+     */
+    virtual read_status_t get_window(const time_spec_t& start_time,
+        const size_t nsamps,
+        window_t& window) const = 0;
+
+    /*! Check if a window was (partially) overwritten
+     *
+     * Call this after processing a window to find out if the consumer has
+     * fallen behind, in which case the processed data is not reliable.
+     */
+    virtual bool is_overwritten(const window_t& window) const = 0;
+};
+
+} /* namespace uhd */
+
+#endif /* INCLUDED_UHD_RX_SAMPLE_RING_HPP */
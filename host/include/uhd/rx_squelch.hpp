@@ -0,0 +1,133 @@
+//
+// Copyright 2019 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#ifndef INCLUDED_UHD_RX_SQUELCH_HPP
+#define INCLUDED_UHD_RX_SQUELCH_HPP
+
+#include <uhd/config.hpp>
+#include <uhd/types/time_spec.hpp>
+#include <uhd/utils/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <stdint.h>
+#include <vector>
+
+namespace uhd {
+
+/*! An energy gate for RX streamers
+ *
+ * A squelch measures the mean power of every received packet before it is
+ * converted, and drops packets which only contain noise. This saves the
+ * conversion, and everything downstream of recv(), for sparse signals.
+ * Squelches are added to a streamer through uhd::stream_args_t::squelch. They
+ * require "sc16" over the wire.
+ *
+ * The gate opens when a packet reaches the threshold, and closes again when
+ * the power falls below the threshold minus the hysteresis. To capture the
+ * edges of a signal, the packets right before the gate opens (pre-trigger)
+ * and after it closes (post-trigger) are passed too. Every opening of the
+ * gate is delivered as a burst: the first packet has the start-of-burst flag
+ * set, and the last one the end-of-burst flag. The timestamps of the packets
+ * are unchanged, so the length of the gaps can be derived from them.
+ *
+ * For streamers with several channels, the gate opens and closes for all
+ * channels at once, based on the channel with the highest power.
+ *
+ * Power levels are given in dBFS, relative to a full-scale complex tone:
+ * samples with a magnitude of 32767 read 0 dBFS.
+ *
+ * \code{.cpp}
+ * uhd::stream_args_t stream_args("fc32", "sc16");
+ * stream_args.squelch = uhd::rx_squelch::make(-60.0);
+ * auto rx_stream = usrp->get_rx_stream(stream_args);
+ * \endcode
+ */
+class UHD_API rx_squelch : uhd::noncopyable
+{
+public:
+    typedef boost::shared_ptr<rx_squelch> sptr;
+
+    //! What happens to packets which don't pass the gate
+    enum mode_t {
+        //! Release the packets, and only count them
+        MODE_DROP,
+        //! Release the packets, but keep a summary of each (see get_summaries())
+        MODE_SUMMARIZE
+    };
+
+    //! Description of a packet which did not pass the gate
+    struct summary_t
+    {
+        //! True if the packet had a timestamp
+        bool has_time_spec;
+        //! The time of the first sample of the packet
+        time_spec_t time_spec;
+        //! The number of samples per channel in the packet
+        size_t nsamps;
+        //! The mean power of the packet, in dBFS (highest of all channels)
+        float power_dbfs;
+    };
+
+    //! Counters of the gate
+    struct stats_t
+    {
+        //! Number of packets passed to the user (per channel)
+        uint64_t num_packets_passed;
+        //! Number of packets dropped or summarized (per channel)
+        uint64_t num_packets_gated;
+        //! Number of times the gate opened
+        uint64_t num_bursts;
+        //! Number of summaries lost because get_summaries() was not called in time
+        uint64_t num_summaries_lost;
+    };
+
+    virtual ~rx_squelch(void) = 0;
+
+    /*!
+     * Make a new squelch.
+     * \param threshold_dbfs the power at which the gate opens, in dBFS
+     * \param hysteresis_db the gate closes at threshold_dbfs - hysteresis_db
+     * \param pre_packets the number of packets passed before the gate opens
+     *                    (at most 64). These packets occupy receive frames of
+     *                    the transport, so num_recv_frames must be larger.
+     * \param post_packets the number of packets passed after the gate closes,
+     *                     the last of which has the end-of-burst flag. Must be
+     *                     at least 1.
+     * \param mode what to do with the packets which don't pass the gate
+     * \param max_summaries the number of summaries kept until get_summaries()
+     *                      is called; older summaries are discarded
+     * \throws uhd::value_error if one of the arguments is out of range
+     */
+    static sptr make(const double threshold_dbfs,
+        const double hysteresis_db = 3.0,
+        const size_t pre_packets   = 1,
+        const size_t post_packets  = 1,
+        const mode_t mode          = MODE_DROP,
+        const size_t max_summaries = 4096);
+
+    /*!
+     * Change the threshold. This is safe to call from any thread while
+     * streaming, and applies from the next packet on.
+     * \param threshold_dbfs the power at which the gate opens, in dBFS
+     */
+    virtual void set_threshold(const double threshold_dbfs) = 0;
+
+    //! Get the power at which the gate opens, in dBFS
+    virtual double get_threshold(void) const = 0;
+
+    /*!
+     * Take the summaries of the packets which did not pass the gate, oldest
+     * first. Only available in MODE_SUMMARIZE. This is safe to call from any
+     * thread while streaming.
+     */
+    virtual std::vector<summary_t> get_summaries(void) = 0;
+
+    //! Get the counters of the gate
+    virtual stats_t get_stats(void) const = 0;
+};
+
+} /* namespace uhd */
+
+#endif /* INCLUDED_UHD_RX_SQUELCH_HPP */
@@ -0,0 +1,242 @@
+//
+// Copyright 2019 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#ifndef INCLUDED_UHD_SHM_STREAM_HPP
+#define INCLUDED_UHD_SHM_STREAM_HPP
+
+#include <uhd/config.hpp>
+#include <uhd/stream.hpp>
+#include <uhd/types/metadata.hpp>
+#include <uhd/utils/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <string>
+
+/*! \file shm_stream.hpp
+ * Streaming of samples between processes through named shared memory.
+ *
+ * The process which owns the device publishes the samples of a streamer in a
+ * shared memory segment, and any number of other processes attach to the
+ * segment by its name to read them, without another copy through a socket:
+ *
+ * \code{.cpp}
+ * // Device process:
+ * auto source = uhd::shm_rx_source::make(rx_stream, "sc16", "uhd_rx0", 1 << 20, rate);
+ * uhd::rx_metadata_t md;
+ * while (running) {
+ *     source->recv(md);
+ * }
+ *
+ * // Analysis process:
+ * auto client = uhd::shm_rx_client::make("uhd_rx0");
+ * std::vector<std::complex<short>> buff(10000);
+ * uhd::rx_metadata_t md;
+ * while (running) {
+ *     const size_t nsamps = client->recv(buff.data(), buff.size(), md);
+ *     // md reports timestamps, bursts and overflows like an rx_streamer
+ * }
+ * \endcode
+ *
+ * For transmitting, the roles are reversed: a uhd::shm_tx_client in another
+ * process writes samples into the segment, and a uhd::shm_tx_sink in the
+ * device process sends them.
+ *
+ * The segments hold a ring of samples per channel, and a ring of records
+ * with the metadata of each packet. The writer and the readers synchronize
+ * through lock-free indices in the segment, and wait for each other by
+ * polling. The samples are stored in the CPU format of the owning streamer.
+ */
+
+namespace uhd {
+
+/*!
+ * Publishes the samples of an RX streamer in shared memory.
+ *
+ * The samples are converted directly into the shared memory. The source never
+ * waits for clients: a client which falls behind by more than the capacity of
+ * the ring gets an overflow (see uhd::shm_rx_client::recv()).
+ */
+class UHD_API shm_rx_source : uhd::noncopyable
+{
+public:
+    typedef boost::shared_ptr<shm_rx_source> sptr;
+
+    /*!
+     * Make a new source, and create its shared memory segment.
+     *
+     * An existing segment of the same name is replaced. The segment is
+     * removed when the source is destroyed; attached clients keep their
+     * mapping, but get no more samples.
+     *
+     * \param rx_stream The streamer to receive from
+     * \param cpu_format The CPU format of \p rx_stream (e.g., "fc32")
+     * \param name The name of the segment, without any slashes
+     * \param capacity Number of samples per channel the ring holds. It must be
+     *                 at least the max number of samples per packet of
+     *                 \p rx_stream.
+     * \param samp_rate The sample rate of \p rx_stream, used for computing the
+     *                  timestamps of partial packets
+     * \throws uhd::value_error for invalid arguments, or uhd::os_error if the
+     *         segment can't be created
+     */
+    static sptr make(rx_streamer::sptr rx_stream,
+        const std::string& cpu_format,
+        const std::string& name,
+        const size_t capacity,
+        const double samp_rate);
+
+    virtual ~shm_rx_source(void) = 0;
+
+    /*!
+     * Receive one packet from the streamer into the shared memory.
+     *
+     * Errors reported by the streamer (e.g., overflows) are published to
+     * the clients, too. Only one thread may call this method at a time.
+     *
+     * \param metadata The metadata of the packet, as returned by
+     *                 uhd::rx_streamer::recv()
+     * \param timeout The timeout in seconds for the underlying recv() call
+     * \returns the number of samples received per channel
+     */
+    virtual size_t recv(rx_metadata_t& metadata, const double timeout = 0.1) = 0;
+};
+
+/*!
+ * Reads the samples published by a uhd::shm_rx_source in another process.
+ *
+ * The client maps the segment read-only. It starts with the first packet
+ * which the source receives after the client was made.
+ */
+class UHD_API shm_rx_client : uhd::noncopyable
+{
+public:
+    typedef boost::shared_ptr<shm_rx_client> sptr;
+
+    /*!
+     * Attach to the segment of a source.
+     * \param name The name which was passed to uhd::shm_rx_source::make()
+     * \throws uhd::lookup_error if there is no such source
+     */
+    static sptr make(const std::string& name);
+
+    virtual ~shm_rx_client(void) = 0;
+
+    //! Number of channels of the source
+    virtual size_t get_num_channels(void) const = 0;
+
+    //! CPU format of the samples (e.g., "fc32")
+    virtual std::string get_cpu_format(void) const = 0;
+
+    /*!
+     * Copy the next samples out of the shared memory.
+     *
+     * This works like uhd::rx_streamer::recv() with one_packet set: it
+     * returns the samples of at most one packet, and the rest of the packet
+     * on the next call (with more_fragments set). If the client has fallen
+     * behind and samples were overwritten, it returns no samples and an
+     * ERROR_CODE_OVERFLOW, and continues with the next packet which the
+     * source receives.
+     *
+     * \param buffs One buffer per channel, in the CPU format of the source
+     * \param nsamps_per_buff The size of each buffer, in samples
+     * \param metadata The metadata of the samples
+     * \param timeout The time in seconds to wait for samples
+     * \returns the number of samples copied per channel
+     */
+    virtual size_t recv(const rx_streamer::buffs_type& buffs,
+        const size_t nsamps_per_buff,
+        rx_metadata_t& metadata,
+        const double timeout = 0.1) = 0;
+};
+
+/*!
+ * Sends the samples written into shared memory by a uhd::shm_tx_client.
+ *
+ * The samples are sent straight out of the shared memory.
+ */
+class UHD_API shm_tx_sink : uhd::noncopyable
+{
+public:
+    typedef boost::shared_ptr<shm_tx_sink> sptr;
+
+    /*!
+     * Make a new sink, and create its shared memory segment.
+     *
+     * An existing segment of the same name is replaced. The segment is
+     * removed when the sink is destroyed.
+     *
+     * \param tx_stream The streamer to send to
+     * \param cpu_format The CPU format of \p tx_stream (e.g., "fc32")
+     * \param name The name of the segment, without any slashes
+     * \param capacity Number of samples per channel the ring holds
+     * \throws uhd::value_error for invalid arguments, or uhd::os_error if the
+     *         segment can't be created
+     */
+    static sptr make(tx_streamer::sptr tx_stream,
+        const std::string& cpu_format,
+        const std::string& name,
+        const size_t capacity);
+
+    virtual ~shm_tx_sink(void) = 0;
+
+    /*!
+     * Send the samples of the next packet written by the client.
+     *
+     * If the streamer times out, the rest of the packet is sent on the next
+     * call. Only one thread may call this method at a time.
+     *
+     * \param timeout The time in seconds to wait for samples, and the timeout
+     *                of the underlying send() call
+     * \returns the number of samples sent per channel
+     */
+    virtual size_t send(const double timeout = 0.1) = 0;
+};
+
+/*!
+ * Writes samples into the segment of a uhd::shm_tx_sink in another process.
+ *
+ * Only one client may write into a segment at a time.
+ */
+class UHD_API shm_tx_client : uhd::noncopyable
+{
+public:
+    typedef boost::shared_ptr<shm_tx_client> sptr;
+
+    /*!
+     * Attach to the segment of a sink.
+     * \param name The name which was passed to uhd::shm_tx_sink::make()
+     * \throws uhd::lookup_error if there is no such sink
+     */
+    static sptr make(const std::string& name);
+
+    virtual ~shm_tx_client(void) = 0;
+
+    //! Number of channels of the sink
+    virtual size_t get_num_channels(void) const = 0;
+
+    //! CPU format of the samples (e.g., "fc32")
+    virtual std::string get_cpu_format(void) const = 0;
+
+    /*!
+     * Copy samples into the shared memory.
+     *
+     * This works like uhd::tx_streamer::send(), and waits until the ring has
+     * room for the samples. Large buffers are split into several packets.
+     *
+     * \param buffs One buffer per channel, in the CPU format of the sink
+     * \param nsamps_per_buff The number of samples in each buffer
+     * \param metadata The metadata of the samples
+     * \param timeout The time in seconds to wait for room in the ring
+     * \returns the number of samples copied per channel
+     */
+    virtual size_t send(const tx_streamer::buffs_type& buffs,
+        const size_t nsamps_per_buff,
+        const tx_metadata_t& metadata,
+        const double timeout = 0.1) = 0;
+};
+
+} /* namespace uhd */
+
+#endif /* INCLUDED_UHD_SHM_STREAM_HPP */
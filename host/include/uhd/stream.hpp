@@ -9,6 +9,8 @@
 #define INCLUDED_UHD_STREAM_HPP
 
 #include <uhd/config.hpp>
+#include <uhd/rx_squelch.hpp>
+#include <uhd/stream_stage.hpp>
 #include <uhd/types/device_addr.hpp>
 #include <uhd/types/metadata.hpp>
 #include <uhd/types/ref_vector.hpp>
@@ -129,6 +131,26 @@ struct UHD_API stream_args_t
      * Users should specify this option to request smaller than default
      * packets, probably with the intention of reducing packet latency.
      *
+     * - host_rate: (RX only, uhd::usrp::multi_usrp) resample the received samples
+     * on the host to this rate, for rates the device can't produce itself. The
+     * device rate must be set before creating the streamer. Only the "fc32" and
+     * "sc16" CPU formats are supported. See \ref stream_host_rate.
+     *
+     * - host_rate_taps: the number of filter taps per output sample of the
+     * host-side resampler (default: 32). Fewer taps are faster, but attenuate
+     * aliases less.
+     *
+     * - channelizer: (RX only, uhd::usrp::multi_usrp) split a single wideband
+     * RX channel into this many narrowband channels on the host. The streamer
+     * then has one output channel per narrowband channel. Can't be combined
+     * with host_rate. See \ref stream_channelizer.
+     *
+     * - channelizer_taps: the number of filter taps per channel of the
+     * channelizer (default: 12).
+     *
+     * - channelizer_threads: the number of threads the channelizer runs on,
+     * including the thread calling recv() (default: 1).
+     *
      * - noclear: Used by tx_dsp_core_200 and rx_dsp_core_200
      *
      * The following are not implemented, but are listed for conceptual purposes:
@@ -160,6 +182,21 @@ struct UHD_API stream_args_t
      * than setting the subdev globally to "B:0".
      */
     std::vector<size_t> channels;
+
+    /*!
+     * A list of host-side processing stages to run inside the streamer.
+     * The stages process the samples in the CPU format, one transport frame
+     * at a time, in the order given here. See uhd::stream_stage.
+     * Leave this blank to stream the samples unmodified.
+     */
+    std::vector<stream_stage::sptr> stages;
+
+    /*!
+     * (RX only) An energy gate, which drops packets that only contain noise
+     * before they are converted. See uhd::rx_squelch.
+     * Leave this empty to receive every packet.
+     */
+    rx_squelch::sptr squelch;
 };
 
 /*!
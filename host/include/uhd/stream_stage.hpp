@@ -0,0 +1,113 @@
+//
+// Copyright 2019 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#ifndef INCLUDED_UHD_STREAM_STAGE_HPP
+#define INCLUDED_UHD_STREAM_STAGE_HPP
+
+#include <uhd/config.hpp>
+#include <uhd/types/time_spec.hpp>
+#include <uhd/utils/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <stdint.h>
+#include <atomic>
+#include <string>
+
+namespace uhd {
+
+/*! A host-side processing stage which runs inside a streamer
+ *
+ * Stages are added to a streamer through uhd::stream_args_t::stages. For RX
+ * streamers, every stage processes the samples of a transport frame right
+ * after they were converted into the user's buffer, while they are still hot
+ * in the cache. For TX streamers, the stages process a copy of the user's
+ * samples right before they are converted into a transport frame. Stages run
+ * in the order in which they appear in uhd::stream_args_t::stages.
+ *
+ * Stages operate in place, and may not change the number of samples. A stage
+ * instance keeps its state (e.g., filter history) per channel, and may only
+ * be used by one streamer.
+ *
+ * Stages are profiled: get_stats() returns the number of samples processed
+ * and the time spent in process().
+ */
+class UHD_API stream_stage : uhd::noncopyable
+{
+public:
+    typedef boost::shared_ptr<stream_stage> sptr;
+
+    //! Profiling information of a stage
+    struct stats_t
+    {
+        //! Number of calls to process()
+        uint64_t num_calls;
+        //! Number of samples processed, summed over all channels
+        uint64_t num_samps;
+        //! Total time spent in process(), in nanoseconds
+        uint64_t total_ns;
+    };
+
+    virtual ~stream_stage(void);
+
+    //! Return a name for this stage, e.g. for profiling output
+    virtual std::string get_name(void) const = 0;
+
+    /*! Prepare the stage for streaming
+     *
+     * This is called once, when the streamer is created.
+     *
+     * \param cpu_format The format of the samples passed to process(), e.g.
+     *                   "fc32"
+     * \param num_chans The number of channels of the streamer
+     * \throws uhd::value_error if the stage does not support \p cpu_format
+     */
+    virtual void init(const std::string& cpu_format, const size_t num_chans) = 0;
+
+    /*! Process a block of samples in place
+     *
+     * This is called from the thread calling recv() or send(), once per
+     * transport frame and channel. Implementations should not block or
+     * allocate memory.
+     *
+     * \param chan The channel index, in the range [0, num_chans)
+     * \param buff Pointer to the samples, in the format given to init()
+     * \param nsamps The number of samples in \p buff
+     */
+    virtual void process(const size_t chan, void* buff, const size_t nsamps) = 0;
+
+    /*! Set the time of the next sample passed to process()
+     *
+     * Streamers call this before process() whenever the samples of a
+     * transport frame carry a timestamp. Stages which don't depend on the
+     * sample time can ignore it, which is what the default implementation
+     * does.
+     *
+     * \param chan The channel index, in the range [0, num_chans)
+     * \param time The time of the first sample of the next call to process()
+     */
+    virtual void set_time(const size_t chan, const time_spec_t& time);
+
+    //! Run process() and update the profiling information
+    void run(const size_t chan, void* buff, const size_t nsamps);
+
+    //! Return the profiling information
+    stats_t get_stats(void) const;
+
+    //! Reset the profiling information
+    void reset_stats(void);
+
+protected:
+    //! Add one call to the profiling information, for stages run without run()
+    void update_stats(const size_t nsamps, const uint64_t elapsed_ns);
+
+private:
+    std::atomic<uint64_t> _num_calls{0};
+    std::atomic<uint64_t> _num_samps{0};
+    std::atomic<uint64_t> _total_ns{0};
+};
+
+} /* namespace uhd */
+
+#endif /* INCLUDED_UHD_STREAM_STAGE_HPP */
@@ -26,7 +26,7 @@ namespace uhd { namespace transport {
  * appropriate virtual streams with the given classifier
  * function. A worker therad is spawned to handle the demuxing.
  */
-class muxed_zero_copy_if : private uhd::noncopyable
+class UHD_API muxed_zero_copy_if : private uhd::noncopyable
 {
 public:
     typedef boost::shared_ptr<muxed_zero_copy_if> sptr;
@@ -0,0 +1,179 @@
+//
+// Copyright 2019 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#ifndef INCLUDED_UHD_USRP_SESSION_HPP
+#define INCLUDED_UHD_USRP_SESSION_HPP
+
+#include <uhd/config.hpp>
+#include <uhd/stream.hpp>
+#include <uhd/types/device_addr.hpp>
+#include <uhd/types/stream_cmd.hpp>
+#include <uhd/usrp/multi_usrp.hpp>
+#include <uhd/utils/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <functional>
+#include <string>
+
+/*! \file session.hpp
+ * Sharing an initialized device between processes.
+ *
+ * Making a device claims it and runs its full initialization, which takes
+ * seconds. A session server keeps a device open in one long-running process
+ * (see the uhd_session_daemon utility), and other processes attach to it
+ * through a Unix domain socket within milliseconds:
+ *
+ * \code{.cpp}
+ * auto session = uhd::usrp::session_client::make("/tmp/uhd_session.sock");
+ * session->call("set_rx_freq", uhd::device_addr_t("freq=2.4e9,chan=0"));
+ * uhd::stream_args_t stream_args("fc32", "sc16");
+ * const std::string stream = session->open_rx_stream(stream_args);
+ * auto rx = uhd::shm_rx_client::make(stream);
+ * session->issue_stream_cmd(
+ *     stream, uhd::stream_cmd_t(uhd::stream_cmd_t::STREAM_MODE_START_CONTINUOUS));
+ * // rx->recv(...)
+ * \endcode
+ *
+ * Control calls are forwarded to the uhd::usrp::multi_usrp of the server, one
+ * at a time. Samples don't go through the socket: the server streams into
+ * shared memory rings (see uhd::shm_rx_source and uhd::shm_tx_sink), and the
+ * client reads or writes them directly.
+ *
+ * The server understands the following methods. Channels are selected with
+ * the "chan" argument, motherboards with "mboard" (both default to 0). In the
+ * names, "rx" may be replaced by "tx".
+ * - get_pp_string, get_num_mboards, get_mboard_name
+ * - get_rx_num_channels
+ * - set_rx_rate (rate), get_rx_rate
+ * - set_rx_freq (freq), get_rx_freq: set_rx_freq returns the actual frequency
+ * - set_rx_gain (gain, name), get_rx_gain (name)
+ * - set_rx_antenna (antenna), get_rx_antenna
+ * - set_rx_bandwidth (bandwidth), get_rx_bandwidth
+ * - get_rx_sensor (name), get_mboard_sensor (name)
+ * - set_clock_source (source), set_time_source (source)
+ * - get_time_now, set_time_now (time), set_time_next_pps (time)
+ * - open_rx_stream, issue_stream_cmd, close_stream: see uhd::usrp::session_client
+ */
+
+namespace uhd { namespace usrp {
+
+/*!
+ * Serves a device to other processes on a Unix domain socket.
+ *
+ * Requests are handled on a thread of the server, one at a time. Streams
+ * opened by a client are closed when it disconnects.
+ */
+class UHD_API session_server : uhd::noncopyable
+{
+public:
+    typedef boost::shared_ptr<session_server> sptr;
+
+    /*!
+     * Handles a request, and returns the result.
+     *
+     * Exceptions are passed on to the client.
+     */
+    typedef std::function<std::string(const std::string& method, const device_addr_t& args)>
+        handler_t;
+
+    /*!
+     * Serve a device on a socket.
+     *
+     * A socket left behind at \p socket_path by a server which didn't shut
+     * down cleanly is replaced. The socket is removed when the server is
+     * destroyed.
+     *
+     * \param usrp The device to serve
+     * \param socket_path The path of the socket
+     * \throws uhd::os_error if the socket can't be created, if \p socket_path
+     *         is already in use by another server or is not a socket, or
+     *         uhd::not_implemented_error on platforms without Unix sockets
+     */
+    static sptr make(multi_usrp::sptr usrp, const std::string& socket_path);
+
+    /*!
+     * Serve custom methods on a socket.
+     *
+     * \param handler Handles all requests
+     * \param socket_path The path of the socket
+     */
+    static sptr make(handler_t handler, const std::string& socket_path);
+
+    virtual ~session_server(void) = 0;
+
+    //! The number of clients which are currently attached
+    virtual size_t get_num_clients(void) const = 0;
+};
+
+/*!
+ * Attaches to a uhd::usrp::session_server in another process.
+ *
+ * All methods are thread-safe. Calls from several threads are sent one
+ * after the other.
+ */
+class UHD_API session_client : uhd::noncopyable
+{
+public:
+    typedef boost::shared_ptr<session_client> sptr;
+
+    //! The default number of samples per channel in the ring of a stream
+    static const size_t DEFAULT_RING_CAPACITY = 1 << 20;
+
+    /*!
+     * Attach to a server.
+     * \param socket_path The path of the socket of the server
+     * \throws uhd::io_error if there is no server at \p socket_path
+     */
+    static sptr make(const std::string& socket_path);
+
+    virtual ~session_client(void) = 0;
+
+    /*!
+     * Forward a call to the server, and wait for its result.
+     *
+     * Keys and values must not contain line breaks.
+     *
+     * \param method The name of the method (see session.hpp)
+     * \param args The arguments of the method
+     * \returns the result of the method; numbers are returned as text
+     * \throws uhd::runtime_error with the message of the server if the call
+     *         failed, or uhd::io_error if the connection was lost
+     */
+    virtual std::string call(
+        const std::string& method, const device_addr_t& args = device_addr_t()) = 0;
+
+    /*!
+     * Make an RX streamer on the server, which publishes its samples in
+     * shared memory.
+     *
+     * \param args The arguments of the streamer
+     * \param capacity The number of samples per channel in the ring
+     * \returns the name of the stream; pass it to uhd::shm_rx_client::make()
+     */
+    virtual std::string open_rx_stream(
+        const stream_args_t& args, const size_t capacity = DEFAULT_RING_CAPACITY) = 0;
+
+    /*!
+     * Make a TX streamer on the server, which sends the samples written into
+     * shared memory.
+     *
+     * \param args The arguments of the streamer
+     * \param capacity The number of samples per channel in the ring
+     * \returns the name of the stream; pass it to uhd::shm_tx_client::make()
+     */
+    virtual std::string open_tx_stream(
+        const stream_args_t& args, const size_t capacity = DEFAULT_RING_CAPACITY) = 0;
+
+    //! Issue a stream command to the RX streamer of a stream
+    virtual void issue_stream_cmd(
+        const std::string& stream, const stream_cmd_t& stream_cmd) = 0;
+
+    //! Destroy the streamer of a stream on the server
+    virtual void close_stream(const std::string& stream) = 0;
+};
+
+}} // namespace uhd::usrp
+
+#endif /* INCLUDED_UHD_USRP_SESSION_HPP */
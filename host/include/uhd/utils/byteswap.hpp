@@ -10,12 +10,17 @@
 
 #include <uhd/config.hpp>
 #include <uhd/types/endianness.hpp>
+#include <stddef.h>
 #include <stdint.h>
 
 /*! \file byteswap.hpp
  *
  * Provide fast byteswaping routines for 16, 32, and 64 bit integers,
  * by using the system's native routines/intrinsics when available.
+ *
+ * For bulk data, such as firmware images and flash contents, there are
+ * versions which swap whole buffers with SIMD instructions, a bit reversal,
+ * and a CRC.
  */
 namespace uhd {
 
@@ -46,6 +51,48 @@ template <typename T> T wtohx(T);
 // of typical network endianness).
 template <typename T> T htowx(T);
 
+/*! Byteswap a buffer of 16, 32, or 64 bit integers
+ *
+ * \param in The integers to swap
+ * \param out Where to store the swapped integers; may be equal to \p in (but
+ *            the buffers may not overlap otherwise)
+ * \param num_items The number of integers
+ */
+UHD_API void byteswap(const uint16_t* in, uint16_t* out, size_t num_items);
+
+//! Byteswap a buffer of 32 bit integers (see above)
+UHD_API void byteswap(const uint32_t* in, uint32_t* out, size_t num_items);
+
+//! Byteswap a buffer of 64 bit integers (see above)
+UHD_API void byteswap(const uint64_t* in, uint64_t* out, size_t num_items);
+
+//! network to host: a buffer of shorts, longs, or long-longs
+template <typename T> void ntohx_buff(const T* in, T* out, size_t num_items);
+
+//! host to network: a buffer of shorts, longs, or long-longs
+template <typename T> void htonx_buff(const T* in, T* out, size_t num_items);
+
+/*! Reverse the order of the bits in every byte of a buffer
+ *
+ * FPGA bitstreams are stored with the opposite bit order of what some
+ * configuration interfaces expect.
+ *
+ * \param in The bytes to reverse
+ * \param out Where to store the result; may be equal to \p in
+ * \param num_bytes The number of bytes
+ */
+UHD_API void bitswap(const uint8_t* in, uint8_t* out, size_t num_bytes);
+
+/*! Compute the CRC-16 of a buffer
+ *
+ * This is the reflected CRC-16 with polynomial 0x8005 (0xA001 reflected), no
+ * final XOR, and an initial value of 0xFFFF (also known as CRC-16/MODBUS).
+ * The OctoClock bootloader uses it to verify firmware images. To compute the
+ * CRC of data in several pieces, pass the result of the previous piece as
+ * \p crc.
+ */
+UHD_API uint16_t crc16(const void* data, size_t len, uint16_t crc = 0xFFFF);
+
 } // namespace uhd
 
 #include <uhd/utils/byteswap.ipp>
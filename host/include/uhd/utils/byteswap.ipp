@@ -8,6 +8,8 @@
 #ifndef INCLUDED_UHD_UTILS_BYTESWAP_IPP
 #define INCLUDED_UHD_UTILS_BYTESWAP_IPP
 
+#include <cstring>
+
 /***********************************************************************
  * Platform-specific implementation details for byteswap below:
  **********************************************************************/
@@ -145,6 +147,22 @@ template <typename T> UHD_INLINE T htowx(T num)
 #endif
 }
 
+template <typename T> UHD_INLINE void ntohx_buff(const T* in, T* out, size_t num_items)
+{
+#ifdef UHD_BIG_ENDIAN
+    if (in != out) {
+        std::memcpy(out, in, num_items * sizeof(T));
+    }
+#else
+    uhd::byteswap(in, out, num_items);
+#endif
+}
+
+template <typename T> UHD_INLINE void htonx_buff(const T* in, T* out, size_t num_items)
+{
+    uhd::ntohx_buff(in, out, num_items);
+}
+
 } /* namespace uhd */
 
 #endif /* INCLUDED_UHD_UTILS_BYTESWAP_IPP */
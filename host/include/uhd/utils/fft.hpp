@@ -0,0 +1,131 @@
+//
+// Copyright 2019 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#ifndef INCLUDED_UHD_UTILS_FFT_HPP
+#define INCLUDED_UHD_UTILS_FFT_HPP
+
+#include <uhd/config.hpp>
+#include <uhd/utils/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <complex>
+#include <cstddef>
+#include <vector>
+
+namespace uhd {
+
+/*!
+ * Complex FFT of a fixed size.
+ *
+ * Computes out[k] = sum_n in[n] * exp(-2j*pi*k*n/size), without any
+ * normalization. Sizes which are a power of two use a radix-4 FFT (with one
+ * radix-2 stage for odd powers of two) and SIMD butterflies where available.
+ * All other sizes fall back to a precomputed DFT matrix, which takes
+ * size * size operations and memory; these are meant for small sizes only.
+ *
+ * Plans (bit-reversal and twiddle tables) are cached: every call to make()
+ * with the same size returns the same plan while it is in use. execute() does
+ * not modify the plan, so a plan may be used by several threads at once.
+ */
+class UHD_API fft : uhd::noncopyable
+{
+public:
+    typedef boost::shared_ptr<fft> sptr;
+
+    //! Window functions for make_window()
+    enum window_type {
+        WINDOW_RECTANGULAR,
+        WINDOW_HANN,
+        WINDOW_HAMMING,
+        WINDOW_BLACKMAN_HARRIS,
+        WINDOW_FLAT_TOP
+    };
+
+    virtual ~fft(void) = 0;
+
+    /*!
+     * Get an FFT plan of the given size.
+     * \param size the number of points
+     * \return a plan, shared with all other users of this size
+     * \throws uhd::value_error if size is zero
+     */
+    static sptr make(const size_t size);
+
+    /*!
+     * Compute the coefficients of a window function.
+     * \param window the window type
+     * \param size the number of coefficients
+     * \return the window, with a peak of 1.0
+     */
+    static std::vector<float> make_window(const window_type window, const size_t size);
+
+    //! Get the number of points of this plan
+    virtual size_t size(void) const = 0;
+
+    /*!
+     * Compute the FFT of \p in into \p out.
+     * Both hold size() samples. \p in and \p out may be the same buffer, but
+     * must not overlap otherwise.
+     */
+    virtual void execute(const std::complex<float>* in, std::complex<float>* out) const = 0;
+};
+
+/*!
+ * Averaged log-power spectrum.
+ *
+ * Splits the samples passed to process() into frames of the FFT size,
+ * windows them, and accumulates the power of every bin. get_log_power()
+ * returns the average over all frames since the last reset, in dB relative to
+ * full scale: a complex tone of amplitude 1.0 in the center of a bin reads
+ * about 3 dB, the same scale as the ascii_art_dft example has always used.
+ */
+class UHD_API power_spectrum : uhd::noncopyable
+{
+public:
+    typedef boost::shared_ptr<power_spectrum> sptr;
+
+    virtual ~power_spectrum(void) = 0;
+
+    /*!
+     * Make a new power spectrum.
+     * \param fft_size the number of bins
+     * \param window the window to apply to every frame
+     * \return a new power spectrum, with nothing accumulated
+     * \throws uhd::value_error if fft_size is zero
+     */
+    static sptr make(
+        const size_t fft_size, const fft::window_type window = fft::WINDOW_BLACKMAN_HARRIS);
+
+    //! Get the number of bins
+    virtual size_t get_fft_size(void) const = 0;
+
+    /*!
+     * Add the power of every complete frame in \p samps to the average.
+     * Samples which don't make up a complete frame are ignored.
+     * \param samps the samples, in the range [-1.0, 1.0]
+     * \param nsamps the number of samples
+     * \return the number of frames processed
+     */
+    virtual size_t process(const std::complex<float>* samps, const size_t nsamps) = 0;
+
+    //! Get the number of frames accumulated since the last reset
+    virtual size_t get_num_averaged(void) const = 0;
+
+    /*!
+     * Get the average power of every bin, in dBFS.
+     * Bin 0 is DC; the upper half of the bins are the negative frequencies.
+     * \param reset true to start a new average afterwards
+     * \return the log power of all bins, or an empty vector if no frame was
+     *         accumulated
+     */
+    virtual std::vector<float> get_log_power(const bool reset = true) = 0;
+
+    //! Discard all accumulated frames
+    virtual void reset(void) = 0;
+};
+
+} // namespace uhd
+
+#endif /* INCLUDED_UHD_UTILS_FFT_HPP */
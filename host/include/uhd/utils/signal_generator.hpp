@@ -0,0 +1,127 @@
+//
+// Copyright 2019 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#ifndef INCLUDED_UHD_UTILS_SIGNAL_GENERATOR_HPP
+#define INCLUDED_UHD_UTILS_SIGNAL_GENERATOR_HPP
+
+#include <uhd/config.hpp>
+#include <uhd/utils/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <stdint.h>
+#include <complex>
+#include <cstddef>
+#include <vector>
+
+namespace uhd {
+
+/*!
+ * Generator for test signals, e.g. for transmitting.
+ *
+ * A generator writes its signal straight into the buffers passed to
+ * generate(), in either of the "fc32" or "sc16" CPU formats, so the buffers
+ * can be sent without any further copies. Oscillators keep their phase in
+ * 64-bit accumulators, and are continuous across calls to generate(). Where
+ * available, SIMD instructions are used to compute the samples.
+ *
+ * The amplitude \p ampl is relative to full scale: 1.0 for "fc32", and 32767
+ * for "sc16". Values outside of the range of "sc16" are clipped.
+ *
+ * \code{.cpp}
+ * auto generator = uhd::signal_generator::make_tone(rate, 1e6, 0.5f);
+ * std::vector<std::complex<float>> buff(tx_stream->get_max_num_samps());
+ * while (running) {
+ *     generator->generate(buff.data(), buff.size());
+ *     tx_stream->send(buff.data(), buff.size(), md);
+ * }
+ * \endcode
+ *
+ * A generator keeps state, so it is not safe to use from several threads at
+ * once.
+ */
+class UHD_API signal_generator : uhd::noncopyable
+{
+public:
+    typedef boost::shared_ptr<signal_generator> sptr;
+
+    virtual ~signal_generator(void) = 0;
+
+    /*!
+     * Make a generator for a constant.
+     * \param value the value of every sample, relative to full scale
+     */
+    static sptr make_const(const std::complex<float>& value);
+
+    /*!
+     * Make a generator for a complex tone, i.e., sample n is
+     * ampl * exp(2j * pi * freq * n / samp_rate).
+     * \param samp_rate the sample rate, in Hz
+     * \param freq the frequency of the tone, in Hz (may be negative)
+     * \param ampl the amplitude
+     * \throws uhd::value_error if the sample rate is not positive
+     */
+    static sptr make_tone(const double samp_rate, const double freq, const float ampl);
+
+    /*!
+     * Make a generator for a sum of complex tones of equal amplitude.
+     * Tone k of N starts at a phase of pi * k * k / N, which keeps the peak
+     * amplitude of the sum low (Newman phases).
+     * \param samp_rate the sample rate, in Hz
+     * \param freqs the frequencies of the tones, in Hz
+     * \param ampl the amplitude of the sum; every tone has ampl / N
+     * \throws uhd::value_error if there are no tones
+     */
+    static sptr make_multi_tone(
+        const double samp_rate, const std::vector<double>& freqs, const float ampl);
+
+    /*!
+     * Make a generator for a linear chirp. The frequency sweeps from
+     * start_freq to stop_freq, then starts over, without phase jumps.
+     * \param samp_rate the sample rate, in Hz
+     * \param start_freq the frequency at the start of a sweep, in Hz
+     * \param stop_freq the frequency at the end of a sweep, in Hz
+     * \param sweep_time the duration of one sweep, in seconds
+     * \param ampl the amplitude
+     * \throws uhd::value_error if a sweep is shorter than two samples
+     */
+    static sptr make_chirp(const double samp_rate,
+        const double start_freq,
+        const double stop_freq,
+        const double sweep_time,
+        const float ampl);
+
+    /*!
+     * Make a generator for a pseudo-random bit sequence (PRBS), mapped to
+     * QPSK symbols: every sample takes two bits, for I and Q, and a one bit
+     * maps to +ampl / sqrt(2). The sequences are those of ITU-T O.150, e.g.
+     * x^15 + x^14 + 1 for order 15, and the register starts as all ones.
+     * \param order the order of the sequence: 7, 9, 11, 15, 20, 23 or 31
+     * \param ampl the amplitude
+     * \throws uhd::value_error if the order is not supported
+     */
+    static sptr make_prbs(const size_t order, const float ampl);
+
+    /*!
+     * Make a generator for white, approximately Gaussian noise. Each of I and
+     * Q is the sum of four uniform random variables.
+     * \param ampl the RMS amplitude; I and Q stay within +/- 2.45 * ampl
+     * \param seed the seed of the random number generator
+     */
+    static sptr make_noise(const float ampl, const uint32_t seed = 0);
+
+    /*!
+     * Generate the next samples of the signal.
+     * \param buff the buffer to write the samples into
+     * \param nsamps the number of samples
+     */
+    virtual void generate(std::complex<float>* buff, const size_t nsamps) = 0;
+
+    //! Generate the next samples of the signal as sc16
+    virtual void generate(std::complex<int16_t>* buff, const size_t nsamps) = 0;
+};
+
+} // namespace uhd
+
+#endif /* INCLUDED_UHD_UTILS_SIGNAL_GENERATOR_HPP */
@@ -11,6 +11,7 @@
 #include <uhd/config.hpp>
 #include <boost/thread/thread.hpp>
 #include <string>
+#include <vector>
 
 namespace uhd {
 
@@ -41,6 +42,16 @@ UHD_API void set_thread_priority(
 UHD_API bool set_thread_priority_safe(
     float priority = default_thread_priority, bool realtime = true);
 
+/*!
+ * Restrict the current thread to the given set of CPUs.
+ *
+ * An empty list leaves the affinity unchanged.
+ *
+ * \param cpu_affinity_list list of CPU indices the thread may run on
+ * \throw exception on failure, or if not supported on this platform
+ */
+UHD_API void set_thread_affinity(const std::vector<size_t>& cpu_affinity_list);
+
 /*!
  * Set the thread name on the given boost thread.
  * \param thread pointer to a boost thread
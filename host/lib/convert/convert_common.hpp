@@ -10,12 +10,17 @@
 
 #include <uhd/convert.hpp>
 #include <uhd/utils/static.hpp>
+#include <uhdlib/convert/fast_converter.hpp>
 #include <stdint.h>
 #include <complex>
 
 #define _DECLARE_CONVERTER(name, in_form, num_in, out_form, num_out, prio) \
-    struct name : public uhd::convert::converter{ \
+    struct name : public uhd::convert::fast_converter{ \
+        name(void) : fast_converter(&name::conv_fn){} \
         static sptr make(void){return sptr(new name());} \
+        static void conv_fn(converter* self, const input_type& in, const output_type& out, const size_t num){ \
+            if (num != 0) static_cast<name*>(self)->name::operator()(in, out, num); \
+        } \
         double scale_factor; \
         void set_scalar(const double s){scale_factor = s;} \
         void operator()(const input_type&, const output_type&, const size_t); \
@@ -12,7 +12,10 @@
 #include <uhd/exception.hpp>
 #include <stdint.h>
 #include <boost/format.hpp>
+#include <boost/lexical_cast.hpp>
 #include <complex>
+#include <mutex>
+#include <unordered_map>
 
 using namespace uhd;
 
@@ -59,6 +62,25 @@ std::string convert::id_type::to_string(void) const{
 typedef uhd::dict<convert::id_type, uhd::dict<convert::priority_type, convert::function_type> > fcn_table_type;
 UHD_SINGLETON_FCN(fcn_table_type, get_table);
 
+/***********************************************************************
+ * Cache of resolved converters, keyed by ID string and priority. A cache
+ * hit avoids the linear search through the registry.
+ **********************************************************************/
+typedef std::unordered_map<std::string, convert::function_type> fcn_cache_type;
+UHD_SINGLETON_FCN(fcn_cache_type, get_cache);
+
+static std::mutex &get_cache_mutex(void){
+    static std::mutex cache_mutex;
+    return cache_mutex;
+}
+
+static std::string get_cache_key(
+    const convert::id_type &id,
+    const convert::priority_type prio
+){
+    return id.to_string() + "@" + boost::lexical_cast<std::string>(prio);
+}
+
 /***********************************************************************
  * The registry functions
  **********************************************************************/
@@ -68,6 +90,10 @@ void uhd::convert::register_converter(
     const priority_type prio
 ){
     get_table()[id][prio] = fcn;
+    {
+        std::lock_guard<std::mutex> lock(get_cache_mutex());
+        get_cache().clear();
+    }
 
     //----------------------------------------------------------------//
     //UHD_LOG_TRACE("CONVERT", boost::format("register_converter: %s prio: %s") % id.to_string() % prio)
@@ -77,10 +103,11 @@ void uhd::convert::register_converter(
 /***********************************************************************
  * The converter functions
  **********************************************************************/
-convert::function_type convert::get_converter(
-    const id_type &id,
-    const priority_type prio
+static convert::function_type resolve_converter(
+    const convert::id_type &id,
+    const convert::priority_type prio
 ){
+    using namespace uhd::convert;
     if (not get_table().has_key(id)) throw uhd::key_error(
         "Cannot find a conversion routine for " + id.to_pp_string());
 
@@ -111,6 +138,20 @@ convert::function_type convert::get_converter(
     return get_table()[id][best_prio];
 }
 
+convert::function_type convert::get_converter(
+    const id_type &id,
+    const priority_type prio
+){
+    const std::string key = get_cache_key(id, prio);
+    std::lock_guard<std::mutex> lock(get_cache_mutex());
+    fcn_cache_type &cache = get_cache();
+    fcn_cache_type::const_iterator it = cache.find(key);
+    if (it == cache.end()) {
+        it = cache.emplace(key, resolve_converter(id, prio)).first;
+    }
+    return it->second;
+}
+
 /***********************************************************************
  * Mappings for item format to byte size for all items we can
  **********************************************************************/
@@ -13,6 +13,8 @@
 #include <uhd/utils/static.hpp>
 #include <uhd/utils/algorithm.hpp>
 #include <uhdlib/utils/prefs.hpp>
+#include <uhdlib/utils/thread_policy.hpp>
+#include <uhdlib/utils/trace.hpp>
 
 #include <boost/format.hpp>
 #include <boost/weak_ptr.hpp>
@@ -20,7 +22,11 @@
 #include <boost/tuple/tuple.hpp>
 #include <boost/thread/mutex.hpp>
 
-#include <future>
+#include <condition_variable>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <thread>
 
 using namespace uhd;
 
@@ -88,35 +94,154 @@ device::~device(void){
     /* NOP */
 }
 
+/***********************************************************************
+ * Parallel discovery
+ **********************************************************************/
+/*!
+ * Checks if a hint can only match one device (or one set of devices).
+ * This is the case if every device in the hint is identified by its serial,
+ * address or resource, unless the hint asks for all devices with "find_all".
+ * Broadcast addresses can match more than one device.
+ */
+static bool is_unique_hint(const device_addr_t &hint){
+    if (hint.has_key("find_all")) return false;
+    const device_addrs_t hints = separate_device_addr(hint);
+    for (const device_addr_t &hint_i : hints) {
+        const std::string addr = hint_i.get("addr", "");
+        if (addr.size() >= 4 and addr.compare(addr.size() - 4, 4, ".255") == 0) {
+            return false;
+        }
+        if (not (hint_i.has_key("serial") or not addr.empty()
+                 or hint_i.has_key("resource") or hint_i.has_key("mgmt_addr"))) {
+            return false;
+        }
+    }
+    return not hints.empty();
+}
+
+/*!
+ * Finders which were still running when run_finders() returned.
+ *
+ * They're joined explicitly: before the next discovery starts, so it doesn't
+ * compete with the leftovers of the last one, and at exit, before the
+ * transports they use are torn down. Each of them ends within its discovery
+ * timeout.
+ */
+static std::mutex pending_finders_mutex;
+static std::vector<std::thread> pending_finders;
+
+static void join_pending_finders(void){
+    std::lock_guard<std::mutex> lock(pending_finders_mutex);
+    for (auto &finder : pending_finders) {
+        finder.join();
+    }
+    pending_finders.clear();
+}
+
+/*!
+ * Runs the finders of the given registrations in parallel.
+ *
+ * If \p early_return is true, this returns as soon as a finder found a device
+ * and all finders registered before it found none. The result is therefore
+ * the same as that of running the finders one after another, and stopping at
+ * the first one which finds a device. The results of the finders which are
+ * still running are then left empty, and they finish in the background.
+ *
+ * \return the discovered devices, in the order of the registrations
+ */
+static std::vector<device_addrs_t> run_finders(
+    const std::vector<dev_fcn_reg_t> &fcns,
+    const device_addr_t &hint,
+    const bool early_return
+){
+    struct find_state_t {
+        std::mutex mutex;
+        std::condition_variable cond;
+        std::vector<bool> done;
+        std::vector<device_addrs_t> results;
+    };
+    auto state = std::make_shared<find_state_t>();
+    state->done.resize(fcns.size(), false);
+    state->results.resize(fcns.size());
+
+    join_pending_finders();
+    std::vector<std::thread> finders;
+    for (size_t i = 0; i < fcns.size(); i++) {
+        const device::find_t find = fcns[i].get<0>();
+        finders.emplace_back([find, hint, state, i](){
+            device_addrs_t discovered_addrs;
+            try {
+                discovered_addrs = find(hint);
+            }
+            catch (const std::exception &e) {
+                UHD_LOGGER_ERROR("UHD") << "Device discovery error: " << e.what();
+            }
+            std::lock_guard<std::mutex> lock(state->mutex);
+            state->done[i]    = true;
+            state->results[i] = discovered_addrs;
+            state->cond.notify_all();
+        });
+    }
+
+    std::vector<device_addrs_t> results(fcns.size());
+    std::vector<bool> done;
+    {
+        std::unique_lock<std::mutex> lock(state->mutex);
+        state->cond.wait(lock, [&](){
+            for (size_t i = 0; i < fcns.size(); i++) {
+                if (not state->done[i]) {
+                    return false;
+                }
+                if (early_return and not state->results[i].empty()) {
+                    return true;
+                }
+            }
+            return true;
+        });
+        // Only pass on the results which decided when to return, so the
+        // result doesn't depend on which of the other finders were faster
+        for (size_t i = 0; i < fcns.size() and state->done[i]; i++) {
+            results[i] = state->results[i];
+        }
+        done = state->done;
+    }
+
+    std::lock_guard<std::mutex> lock(pending_finders_mutex);
+    for (size_t i = 0; i < finders.size(); i++) {
+        if (done[i]) {
+            finders[i].join();
+        } else {
+            pending_finders.push_back(std::move(finders[i]));
+        }
+    }
+    if (not pending_finders.empty()) {
+        static std::once_flag at_exit_flag;
+        std::call_once(at_exit_flag, [](){ std::atexit(&join_pending_finders); });
+    }
+    return results;
+}
+
 /***********************************************************************
  * Discover
  **********************************************************************/
 device_addrs_t device::find(const device_addr_t &hint, device_filter_t filter){
     boost::mutex::scoped_lock lock(_device_mutex);
+    UHD_TRACE_SCOPE("device::find");
 
-    device_addrs_t device_addrs;
-    std::vector<std::future<device_addrs_t>> find_tasks;
+    std::vector<dev_fcn_reg_t> fcns;
     for (const auto& fcn : get_dev_fcn_regs()) {
         if (filter == ANY or fcn.get<2>() == filter) {
-            find_tasks.emplace_back(std::async(std::launch::async,
-                [fcn, hint](){
-                    return fcn.get<0>()(hint);
-                }
-            ));
+            fcns.push_back(fcn);
         }
     }
-    for(auto &find_task : find_tasks) {
-        try {
-            device_addrs_t discovered_addrs = find_task.get();
-            device_addrs.insert(
-                device_addrs.begin(),
-                discovered_addrs.begin(),
-                discovered_addrs.end()
-            );
-        }
-        catch (const std::exception &e) {
-            UHD_LOGGER_ERROR("UHD") << "Device discovery error: " << e.what();
-        }
+
+    device_addrs_t device_addrs;
+    for (const auto &discovered_addrs : run_finders(fcns, hint, is_unique_hint(hint))) {
+        device_addrs.insert(
+            device_addrs.begin(),
+            discovered_addrs.begin(),
+            discovered_addrs.end()
+        );
     }
 
     return device_addrs;
@@ -131,17 +256,22 @@ device::sptr device::make(const device_addr_t &hint, device_filter_t filter, siz
     typedef boost::tuple<device_addr_t, make_t> dev_addr_make_t;
     std::vector<dev_addr_make_t> dev_addr_makers;
 
-    for(const dev_fcn_reg_t &fcn:  get_dev_fcn_regs()){
-        try{
+    {
+        UHD_TRACE_SCOPE("device::make: find");
+        std::vector<dev_fcn_reg_t> fcns;
+        for(const dev_fcn_reg_t &fcn:  get_dev_fcn_regs()){
             if(filter == ANY or fcn.get<2>() == filter){
-                for(device_addr_t dev_addr:  fcn.get<0>()(hint)){
-                    //append the discovered address and its factory function
-                    dev_addr_makers.push_back(dev_addr_make_t(dev_addr, fcn.get<1>()));
-                }
+                fcns.push_back(fcn);
             }
         }
-        catch(const std::exception &e){
-            UHD_LOGGER_ERROR("UHD") << "Device discovery error: " << e.what() ;
+        //only the first device is needed to make one with a unique hint
+        const std::vector<device_addrs_t> results =
+            run_finders(fcns, hint, which == 0 and is_unique_hint(hint));
+        for(size_t i = 0; i < fcns.size(); i++){
+            for(const device_addr_t &dev_addr:  results[i]){
+                //append the discovered address and its factory function
+                dev_addr_makers.push_back(dev_addr_make_t(dev_addr, fcns[i].get<1>()));
+            }
         }
     }
 
@@ -182,8 +312,16 @@ device::sptr device::make(const device_addr_t &hint, device_filter_t filter, siz
         // Add keys from the config files (note: the user-defined keys will
         // always be applied, see also get_usrp_args()
         // Then, create and register a new device.
-        device::sptr dev = maker(prefs::get_usrp_args(dev_addr));
+        const device_addr_t usrp_args = prefs::get_usrp_args(dev_addr);
+        // Thread placement must be known before the device spawns threads
+        thread_policy::update_from_args(usrp_args);
+        device::sptr dev;
+        {
+            UHD_TRACE_SCOPE("device::make: " + dev_addr.get("type", "device"));
+            dev = maker(usrp_args);
+        }
         hash_to_device[dev_hash] = dev;
+        uhd::trace::write_file();
         return dev;
     }
 }
@@ -0,0 +1,499 @@
+//
+// Copyright 2019 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include <uhd/exception.hpp>
+#include <uhd/utils/fft.hpp>
+#include <uhd/utils/safe_call.hpp>
+#include <uhd/utils/thread.hpp>
+#include <uhdlib/dsp/channelizer_streamer.hpp>
+#include <uhdlib/dsp/firdes.hpp>
+#include <uhdlib/utils/thread_policy.hpp>
+#include <boost/format.hpp>
+#include <boost/thread/thread.hpp>
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#if defined(__SSE2__)
+#    include <emmintrin.h>
+#endif
+
+using namespace uhd;
+using namespace uhd::dsp;
+
+namespace {
+
+typedef std::complex<float> fc32_t;
+
+//! Complex multiplication, without the NaN/Inf handling of operator*
+inline fc32_t mul(const fc32_t& a, const fc32_t& b)
+{
+    return fc32_t(a.real() * b.real() - a.imag() * b.imag(),
+        a.real() * b.imag() + a.imag() * b.real());
+}
+
+inline int16_t to_sc16_component(const float x)
+{
+    return int16_t(std::max(-32768.0f, std::min(32767.0f, std::round(x))));
+}
+
+/*! Compute the polyphase branches of one block
+ *
+ * For every interleaved component i of the N branches, this accumulates the
+ * products of the K taps with the sc16 samples N apart, newest first:
+ * branches[i] = sum_k taps[k * 2N + i] * block[(K - 1 - k) * 2N + i]
+ */
+void filter_block(const int16_t* block,
+    const float* taps,
+    const size_t num_chans,
+    const size_t taps_per_chan,
+    float* branches)
+{
+    const size_t stride = 2 * num_chans;
+    size_t i            = 0;
+#if defined(__SSE2__)
+    // Eight components at a time, with the sums kept in registers
+    for (; i + 8 <= stride; i += 8) {
+        __m128 acc0 = _mm_setzero_ps();
+        __m128 acc1 = _mm_setzero_ps();
+        for (size_t k = 0; k < taps_per_chan; k++) {
+            const int16_t* x = block + (taps_per_chan - 1 - k) * stride + i;
+            const float* t   = taps + k * stride + i;
+            const __m128i xi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(x));
+            // Sign-extend to 32 bits by shifting the duplicated halves back down
+            const __m128 x0 =
+                _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(xi, xi), 16));
+            const __m128 x1 =
+                _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(xi, xi), 16));
+            acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(t), x0));
+            acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(t + 4), x1));
+        }
+        _mm_storeu_ps(branches + i, acc0);
+        _mm_storeu_ps(branches + i + 4, acc1);
+    }
+#endif
+    for (; i < stride; i++) {
+        float acc = 0.0f;
+        for (size_t k = 0; k < taps_per_chan; k++) {
+            acc += taps[k * stride + i]
+                   * float(block[(taps_per_chan - 1 - k) * stride + i]);
+        }
+        branches[i] = acc;
+    }
+}
+
+/*! Critically sampled polyphase filterbank channelizer
+ *
+ * For N channels and a prototype filter h of length K * N, output m of
+ * channel c is the input, shifted down by c / N of the sample rate, filtered
+ * with h, and sampled at input sample m * N. This is computed as N polyphase
+ * branches of K taps each, followed by an N-point FFT.
+ */
+class channelizer_rx_streamer : public rx_streamer
+{
+public:
+    channelizer_rx_streamer(rx_streamer::sptr rx_stream,
+        const std::string& cpu_format,
+        const double device_rate,
+        const size_t num_chans,
+        const size_t taps_per_chan,
+        const size_t num_threads)
+        : _rx_stream(rx_stream)
+        , _sc16(cpu_format == "sc16")
+        , _device_rate(device_rate)
+        , _num_chans(num_chans)
+        , _taps_per_chan(taps_per_chan)
+        , _filter_len(num_chans * taps_per_chan)
+        , _max_num_samps_in(rx_stream->get_max_num_samps())
+        , _fft(fft::make(num_chans))
+    {
+        if (rx_stream->get_num_channels() != 1) {
+            throw uhd::value_error(
+                "channelizer: The wideband streamer must have exactly one channel");
+        }
+        if (cpu_format != "fc32" and cpu_format != "sc16") {
+            throw uhd::value_error(str(
+                boost::format("channelizer: Unsupported CPU format %s") % cpu_format));
+        }
+        if (num_chans < 2 or taps_per_chan == 0 or num_threads == 0
+            or not(device_rate > 0.0)) {
+            throw uhd::value_error("channelizer: Invalid filterbank parameters");
+        }
+
+        // The prototype has an odd number of taps (plus a zero), so its delay
+        // is an integer number of samples
+        std::vector<double> proto = kaiser_lowpass(_filter_len - 1, 0.5 / num_chans);
+        proto.push_back(0.0);
+        const size_t delay = _filter_len / 2 - 1;
+
+        // Branch k holds taps k * N ... (k + 1) * N - 1, reversed, so it can
+        // be applied to a contiguous run of input samples. Duplicate every tap
+        // for I and Q.
+        _taps.resize(2 * _filter_len);
+        for (size_t k = 0; k < taps_per_chan; k++) {
+            for (size_t q = 0; q < num_chans; q++) {
+                const float tap = float(proto[k * num_chans + num_chans - 1 - q]);
+                _taps[2 * (k * num_chans + q) + 0] = tap;
+                _taps[2 * (k * num_chans + q) + 1] = tap;
+            }
+        }
+
+        // Per-channel phase correction for the branch ordering and the filter
+        // delay, including the scaling of the sc16 input samples
+        const double scale = _sc16 ? 1.0 : 1.0 / 32767.0;
+        const uint64_t phase_step = (uint64_t(num_chans - 1) * (delay + 1)) % num_chans;
+        for (size_t c = 0; c < num_chans; c++) {
+            const double phase = 2.0 * M_PI * double((c * phase_step) % num_chans) / num_chans;
+            _rotation.push_back(std::polar(float(scale), float(phase)));
+        }
+
+        _in_packet.resize(2 * _max_num_samps_in);
+        _in_buff.resize(2 * 4 * (_filter_len + _max_num_samps_in));
+        reset_input();
+
+        _scratch.resize(num_threads);
+        for (auto& scratch : _scratch) {
+            scratch.resize(2 * num_chans);
+        }
+        for (size_t i = 1; i < num_threads; i++) {
+            _workers.emplace_back(new boost::thread([this, i]() { run_worker(i); }));
+            set_thread_name(_workers.back().get(), thread_policy::CHANNELIZER);
+        }
+    }
+
+    ~channelizer_rx_streamer(void)
+    {
+        {
+            std::lock_guard<std::mutex> l(_job_mutex);
+            _stop = true;
+        }
+        _job_cond.notify_all();
+        for (auto& worker : _workers) {
+            UHD_SAFE_CALL(worker->join();)
+        }
+    }
+
+    size_t get_num_channels(void) const
+    {
+        return _num_chans;
+    }
+
+    size_t get_max_num_samps(void) const
+    {
+        return std::max<size_t>(1, _max_num_samps_in / _num_chans);
+    }
+
+    size_t recv(const buffs_type& buffs,
+        const size_t nsamps_per_buff,
+        rx_metadata_t& metadata,
+        const double timeout,
+        const bool one_packet)
+    {
+        metadata.reset();
+        size_t nblocks = 0;
+        while (true) {
+            nblocks = get_num_blocks_available();
+            if (_flushing) {
+                nblocks = std::min<uint64_t>(nblocks, _flush_end - _out_count);
+                break;
+            }
+            if (nblocks >= nsamps_per_buff or (nblocks and one_packet)) {
+                break;
+            }
+
+            if (not _pending) {
+                _pending_nsamps = _rx_stream->recv(
+                    _in_packet.data(), _max_num_samps_in, _pending_md, timeout, true);
+                _pending = true;
+            }
+            if (_pending_md.error_code != rx_metadata_t::ERROR_CODE_NONE) {
+                // Return the samples we have first, then report the error
+                if (not nblocks) {
+                    metadata = _pending_md;
+                    _pending = false;
+                    if (metadata.error_code != rx_metadata_t::ERROR_CODE_TIMEOUT) {
+                        end_segment();
+                    }
+                    return 0;
+                }
+                if (_pending_md.error_code == rx_metadata_t::ERROR_CODE_TIMEOUT) {
+                    _pending = false;
+                }
+                break;
+            }
+            if (_segment_valid and is_discontinuous(_pending_md)) {
+                // Don't mix samples from different segments in one call
+                if (nblocks) {
+                    break;
+                }
+                end_segment();
+            }
+            if (not _segment_valid) {
+                start_segment(_pending_md);
+            }
+            push_input(_in_packet.data(), _pending_nsamps);
+            _in_count += _pending_nsamps;
+            if (_pending_md.end_of_burst) {
+                // Add enough zeros to produce the outputs up to the last input
+                int16_t* zeros = grow_input(_filter_len / 2);
+                std::fill(zeros, zeros + 2 * (_filter_len / 2), int16_t(0));
+                _flushing  = true;
+                _flush_end = (_in_count + _num_chans - 1) / _num_chans;
+            }
+            _pending = false;
+        }
+
+        nblocks = std::min(nblocks, nsamps_per_buff);
+        if (nblocks) {
+            metadata.has_time_spec = _segment_has_time_spec;
+            metadata.time_spec =
+                _segment_time_spec
+                + time_spec_t::from_ticks(_out_count * _num_chans, _device_rate);
+            metadata.start_of_burst = _start_of_burst;
+            _start_of_burst         = false;
+            run_job(buffs, nblocks);
+            _in_first += nblocks * _num_chans;
+            _out_count += nblocks;
+        }
+        if (_flushing and _out_count == _flush_end) {
+            metadata.end_of_burst = true;
+            end_segment();
+        }
+        return nblocks;
+    }
+
+    void issue_stream_cmd(const stream_cmd_t& stream_cmd)
+    {
+        stream_cmd_t device_stream_cmd = stream_cmd;
+        device_stream_cmd.num_samps    = stream_cmd.num_samps * _num_chans;
+        _rx_stream->issue_stream_cmd(device_stream_cmd);
+    }
+
+private:
+    /***********************************************************************
+     * Input handling
+     **********************************************************************/
+    size_t get_num_blocks_available(void) const
+    {
+        const size_t num_samps = _in_end - _in_first;
+        if (num_samps < _filter_len) {
+            return 0;
+        }
+        return (num_samps - _filter_len) / _num_chans + 1;
+    }
+
+    /*! Make room for nsamps more input samples, and return where they go
+     *
+     * When the end of the buffer is reached, the samples which are still
+     * needed (less than a filter length plus the blocks not yet returned)
+     * move to the front, so every sample is only moved now and then.
+     */
+    int16_t* grow_input(const size_t nsamps)
+    {
+        if (2 * (_in_end + nsamps) > _in_buff.size()) {
+            std::copy(_in_buff.begin() + 2 * _in_first,
+                _in_buff.begin() + 2 * _in_end,
+                _in_buff.begin());
+            _in_end -= _in_first;
+            _in_first = 0;
+            if (4 * 2 * (_in_end + nsamps) > _in_buff.size()) {
+                _in_buff.resize(4 * 2 * (_in_end + nsamps));
+            }
+        }
+        int16_t* samps = &_in_buff[2 * _in_end];
+        _in_end += nsamps;
+        return samps;
+    }
+
+    void push_input(const int16_t* samps, const size_t nsamps)
+    {
+        std::copy(samps, samps + 2 * nsamps, grow_input(nsamps));
+    }
+
+    //! Start with the filter half full, so output m lines up with input m * N
+    void reset_input(void)
+    {
+        _in_first      = 0;
+        _in_end        = 0;
+        int16_t* zeros = grow_input(_filter_len / 2);
+        std::fill(zeros, zeros + 2 * (_filter_len / 2), int16_t(0));
+    }
+
+    //! True if a packet does not continue the current segment
+    bool is_discontinuous(const rx_metadata_t& md) const
+    {
+        if (md.start_of_burst or md.has_time_spec != _segment_has_time_spec) {
+            return true;
+        }
+        if (not md.has_time_spec) {
+            return false;
+        }
+        const time_spec_t expected_time =
+            _segment_time_spec + time_spec_t::from_ticks(_in_count, _device_rate);
+        return std::abs((md.time_spec - expected_time).get_real_secs())
+               >= 0.5 / _device_rate;
+    }
+
+    void start_segment(const rx_metadata_t& md)
+    {
+        _segment_valid         = true;
+        _segment_has_time_spec = md.has_time_spec;
+        _segment_time_spec     = md.time_spec;
+        _start_of_burst        = md.start_of_burst;
+        _in_count              = 0;
+        _out_count             = 0;
+    }
+
+    void end_segment(void)
+    {
+        _segment_valid = false;
+        _flushing      = false;
+        reset_input();
+    }
+
+    /***********************************************************************
+     * Filterbank
+     **********************************************************************/
+    //! Compute blocks [first, last) into the output buffers
+    void process_blocks(
+        const buffs_type& buffs, const size_t first, const size_t last, fc32_t* scratch)
+    {
+        float* branches  = reinterpret_cast<float*>(scratch);
+        fc32_t* spectrum = scratch + _num_chans;
+        for (size_t m = first; m < last; m++) {
+            filter_block(&_in_buff[2 * (_in_first + m * _num_chans)],
+                _taps.data(),
+                _num_chans,
+                _taps_per_chan,
+                branches);
+            _fft->execute(scratch, spectrum);
+
+            if (_sc16) {
+                for (size_t c = 0; c < _num_chans; c++) {
+                    const fc32_t y  = mul(spectrum[c], _rotation[c]);
+                    int16_t* out    = static_cast<int16_t*>(buffs[c]) + 2 * m;
+                    out[0]          = to_sc16_component(y.real());
+                    out[1]          = to_sc16_component(y.imag());
+                }
+            } else {
+                for (size_t c = 0; c < _num_chans; c++) {
+                    static_cast<fc32_t*>(buffs[c])[m] = mul(spectrum[c], _rotation[c]);
+                }
+            }
+        }
+    }
+
+    //! Split the blocks between the threads, and wait for all of them
+    void run_job(const buffs_type& buffs, const size_t nblocks)
+    {
+        const size_t num_threads = _scratch.size();
+        if (num_threads == 1) {
+            process_blocks(buffs, 0, nblocks, _scratch[0].data());
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> l(_job_mutex);
+            _job_buffs   = &buffs;
+            _job_nblocks = nblocks;
+            _job_pending = num_threads - 1;
+            _job_id++;
+        }
+        _job_cond.notify_all();
+        process_blocks(buffs, 0, nblocks / num_threads, _scratch[0].data());
+        std::unique_lock<std::mutex> l(_job_mutex);
+        _done_cond.wait(l, [this]() { return _job_pending == 0; });
+    }
+
+    void run_worker(const size_t index)
+    {
+        thread_policy::apply(thread_policy::CHANNELIZER);
+        const size_t num_threads = _scratch.size();
+        uint64_t last_job_id     = 0;
+        while (true) {
+            size_t nblocks;
+            const buffs_type* buffs;
+            {
+                std::unique_lock<std::mutex> l(_job_mutex);
+                _job_cond.wait(l, [&]() { return _stop or _job_id != last_job_id; });
+                if (_stop) {
+                    return;
+                }
+                last_job_id = _job_id;
+                nblocks     = _job_nblocks;
+                buffs       = _job_buffs;
+            }
+            process_blocks(*buffs,
+                nblocks * index / num_threads,
+                nblocks * (index + 1) / num_threads,
+                _scratch[index].data());
+            std::lock_guard<std::mutex> l(_job_mutex);
+            if (--_job_pending == 0) {
+                _done_cond.notify_one();
+            }
+        }
+    }
+
+    rx_streamer::sptr _rx_stream;
+    const bool _sc16;
+    const double _device_rate;
+    const size_t _num_chans;
+    const size_t _taps_per_chan;
+    const size_t _filter_len;
+    const size_t _max_num_samps_in;
+    const fft::sptr _fft;
+    std::vector<float> _taps;
+    std::vector<fc32_t> _rotation;
+
+    //! Input samples (interleaved sc16). The next block starts at sample
+    //  _in_first, and samples up to _in_end are valid.
+    std::vector<int16_t> _in_buff;
+    size_t _in_first = 0;
+    size_t _in_end   = 0;
+    std::vector<int16_t> _in_packet;
+
+    //! A packet received from the device, but not processed yet
+    bool _pending          = false;
+    size_t _pending_nsamps = 0;
+    rx_metadata_t _pending_md;
+
+    //! A segment is a contiguous run of samples, starting at a known time
+    bool _segment_valid         = false;
+    bool _segment_has_time_spec = false;
+    time_spec_t _segment_time_spec;
+    bool _start_of_burst = false;
+    uint64_t _in_count   = 0;
+    uint64_t _out_count  = 0;
+    bool _flushing       = false;
+    uint64_t _flush_end  = 0;
+
+    //! Worker threads, and the branch/FFT scratch space of every thread
+    std::vector<std::unique_ptr<boost::thread>> _workers;
+    std::vector<std::vector<fc32_t>> _scratch;
+    std::mutex _job_mutex;
+    std::condition_variable _job_cond;
+    std::condition_variable _done_cond;
+    bool _stop                    = false;
+    uint64_t _job_id              = 0;
+    size_t _job_nblocks           = 0;
+    size_t _job_pending           = 0;
+    const buffs_type* _job_buffs = nullptr;
+};
+
+} // namespace
+
+rx_streamer::sptr uhd::dsp::make_channelizer_rx_streamer(rx_streamer::sptr rx_stream,
+    const std::string& cpu_format,
+    const double device_rate,
+    const size_t num_chans,
+    const size_t taps_per_chan,
+    const size_t num_threads)
+{
+    return rx_streamer::sptr(new channelizer_rx_streamer(
+        rx_stream, cpu_format, device_rate, num_chans, taps_per_chan, num_threads));
+}
@@ -0,0 +1,47 @@
+//
+// Copyright 2019 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include <uhdlib/dsp/firdes.hpp>
+#include <cmath>
+
+namespace {
+
+//! Zeroth-order modified Bessel function of the first kind
+double bessel_i0(const double x)
+{
+    double sum  = 1.0;
+    double term = 1.0;
+    for (int k = 1; k < 50; k++) {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+        if (term < sum * 1e-12) {
+            break;
+        }
+    }
+    return sum;
+}
+
+} // namespace
+
+std::vector<double> uhd::dsp::kaiser_lowpass(
+    const size_t num_taps, const double cutoff, const double beta)
+{
+    std::vector<double> taps(num_taps);
+    const double center = double(num_taps - 1) / 2.0;
+    double sum          = 0.0;
+    for (size_t i = 0; i < num_taps; i++) {
+        const double t = double(i) - center;
+        const double x = 2.0 * M_PI * cutoff * t;
+        const double r = (center > 0.0) ? t / (center + 1.0) : 0.0;
+        taps[i] = ((t == 0.0) ? 1.0 : std::sin(x) / x)
+                  * bessel_i0(beta * std::sqrt(1.0 - r * r)) / bessel_i0(beta);
+        sum += taps[i];
+    }
+    for (auto& tap : taps) {
+        tap /= sum;
+    }
+    return taps;
+}
@@ -0,0 +1,390 @@
+//
+// Copyright 2019 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include <uhd/exception.hpp>
+#include <uhd/host_nco.hpp>
+#include <uhd/utils/byteswap.hpp>
+#include <uhdlib/dsp/fused_stage.hpp>
+#include <uhdlib/dsp/phasor.hpp>
+#include <boost/format.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <mutex>
+#include <vector>
+
+#if defined(__SSE2__)
+#    include <emmintrin.h>
+#endif
+
+using namespace uhd;
+using namespace uhd::dsp;
+
+namespace {
+
+typedef std::complex<float> fc32_t;
+
+//! The phasor is recomputed from the phase accumulator at least this often
+constexpr size_t MAX_SEGMENT_LEN = 1024;
+
+inline int16_t to_sc16_component(const float x)
+{
+    return int16_t(std::max(-32768.0f, std::min(32767.0f, std::round(x))));
+}
+
+/***********************************************************************
+ * Mixing kernels
+ *
+ * All kernels multiply sample i by phasor * step^i. The phasor is advanced
+ * by a recurrence, which is exact enough for MAX_SEGMENT_LEN samples.
+ **********************************************************************/
+inline fc32_t item32_to_sc16(const uint32_t item, const bool big_endian)
+{
+    const uint32_t host_item = big_endian ? uhd::ntohx(item) : uhd::wtohx(item);
+    return fc32_t(float(int16_t(host_item >> 16)), float(int16_t(host_item >> 0)));
+}
+
+#if defined(__SSE2__)
+void mix_fc32(fc32_t* buff, const size_t nsamps, fc32_t phasor, const fc32_t step)
+{
+    phasor4_t phasor4(phasor, step);
+    size_t i = 0;
+    for (; i + 4 <= nsamps; i += 4) {
+        const float* in_f = reinterpret_cast<const float*>(buff + i);
+        const __m128 a    = _mm_loadu_ps(in_f);
+        const __m128 b    = _mm_loadu_ps(in_f + 4);
+        __m128 re, im;
+        phasor4.mix(_mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)),
+            _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)),
+            re,
+            im);
+        store_fc32x4(buff + i, re, im);
+        phasor4.advance();
+    }
+    phasor = phasor4.get_first();
+    for (; i < nsamps; i++) {
+        buff[i] = complex_mul(buff[i], phasor);
+        phasor  = complex_mul(phasor, step);
+    }
+}
+
+void convert_mix_sc16_item32(const uint32_t* in,
+    const bool big_endian,
+    fc32_t* out,
+    const size_t nsamps,
+    fc32_t phasor,
+    const fc32_t step)
+{
+    phasor4_t phasor4(phasor, step);
+    size_t i = 0;
+    for (; i + 4 <= nsamps; i += 4) {
+        __m128i items = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        if (big_endian) {
+            items = _mm_or_si128(_mm_slli_epi16(items, 8), _mm_srli_epi16(items, 8));
+            items = _mm_shufflelo_epi16(items, _MM_SHUFFLE(2, 3, 0, 1));
+            items = _mm_shufflehi_epi16(items, _MM_SHUFFLE(2, 3, 0, 1));
+        }
+        // I is in the upper half of every item, Q in the lower half
+        const __m128 in_re = _mm_cvtepi32_ps(_mm_srai_epi32(items, 16));
+        const __m128 in_im =
+            _mm_cvtepi32_ps(_mm_srai_epi32(_mm_slli_epi32(items, 16), 16));
+        __m128 re, im;
+        phasor4.mix(in_re, in_im, re, im);
+        store_fc32x4(out + i, re, im);
+        phasor4.advance();
+    }
+    phasor = phasor4.get_first();
+    for (; i < nsamps; i++) {
+        out[i] = complex_mul(item32_to_sc16(in[i], big_endian), phasor);
+        phasor = complex_mul(phasor, step);
+    }
+}
+#else
+void mix_fc32(fc32_t* buff, const size_t nsamps, fc32_t phasor, const fc32_t step)
+{
+    for (size_t i = 0; i < nsamps; i++) {
+        buff[i] = complex_mul(buff[i], phasor);
+        phasor  = complex_mul(phasor, step);
+    }
+}
+
+void convert_mix_sc16_item32(const uint32_t* in,
+    const bool big_endian,
+    fc32_t* out,
+    const size_t nsamps,
+    fc32_t phasor,
+    const fc32_t step)
+{
+    for (size_t i = 0; i < nsamps; i++) {
+        out[i] = complex_mul(item32_to_sc16(in[i], big_endian), phasor);
+        phasor = complex_mul(phasor, step);
+    }
+}
+#endif
+
+void mix_sc16(int16_t* buff, const size_t nsamps, fc32_t phasor, const fc32_t step)
+{
+    for (size_t i = 0; i < nsamps; i++) {
+        const fc32_t y =
+            complex_mul(fc32_t(float(buff[2 * i]), float(buff[2 * i + 1])), phasor);
+        buff[2 * i]     = to_sc16_component(y.real());
+        buff[2 * i + 1] = to_sc16_component(y.imag());
+        phasor          = complex_mul(phasor, step);
+    }
+}
+
+/***********************************************************************
+ * Host NCO
+ **********************************************************************/
+class host_nco_impl : public host_nco, public uhd::dsp::fused_sc16_stage
+{
+public:
+    host_nco_impl(const double samp_rate, const double freq) : _samp_rate(samp_rate)
+    {
+        if (not(samp_rate > 0.0)) {
+            throw uhd::value_error("host_nco: The sample rate must be positive");
+        }
+        _initial_phase_inc = freq_to_phase_inc(freq, _samp_rate);
+        _freq.store(freq, std::memory_order_relaxed);
+    }
+
+    std::string get_name(void) const
+    {
+        return "host_nco";
+    }
+
+    void init(const std::string& cpu_format, const size_t num_chans)
+    {
+        if (cpu_format != "fc32" and cpu_format != "sc16") {
+            throw uhd::value_error(str(
+                boost::format("host_nco: Unsupported CPU format %s") % cpu_format));
+        }
+        _sc16 = cpu_format == "sc16";
+        // Start at the initial frequency; changes requested since will still
+        // be picked up
+        chan_state_t state;
+        state.phase_inc = _initial_phase_inc;
+        state.step      = phase_to_phasor(_initial_phase_inc, 1.0f);
+        _chans.assign(num_chans, state);
+    }
+
+    void process(const size_t chan, void* buff, const size_t nsamps)
+    {
+        if (_sc16) {
+            int16_t* samps = static_cast<int16_t*>(buff);
+            run_segments(_chans.at(chan),
+                nsamps,
+                1.0f,
+                [samps](const size_t offset,
+                    const size_t count,
+                    const fc32_t phasor,
+                    const fc32_t step) {
+                    mix_sc16(samps + 2 * offset, count, phasor, step);
+                });
+        } else {
+            fc32_t* samps = static_cast<fc32_t*>(buff);
+            run_segments(_chans.at(chan),
+                nsamps,
+                1.0f,
+                [samps](const size_t offset,
+                    const size_t count,
+                    const fc32_t phasor,
+                    const fc32_t step) {
+                    mix_fc32(samps + offset, count, phasor, step);
+                });
+        }
+    }
+
+    void set_time(const size_t chan, const time_spec_t& time)
+    {
+        chan_state_t& state    = _chans.at(chan);
+        state.has_time         = true;
+        state.base_time        = time;
+        state.samps_since_base = 0;
+    }
+
+    void convert_and_process(const size_t chan,
+        const void* in,
+        const bool big_endian,
+        const float scale,
+        fc32_t* out,
+        const size_t nsamps)
+    {
+        const auto start_time = std::chrono::steady_clock::now();
+        const uint32_t* items = static_cast<const uint32_t*>(in);
+        run_segments(_chans.at(chan),
+            nsamps,
+            scale,
+            [items, big_endian, out](const size_t offset,
+                const size_t count,
+                const fc32_t phasor,
+                const fc32_t step) {
+                convert_mix_sc16_item32(
+                    items + offset, big_endian, out + offset, count, phasor, step);
+            });
+        const auto elapsed = std::chrono::steady_clock::now() - start_time;
+        update_stats(nsamps,
+            std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    }
+
+    void set_freq(const double freq)
+    {
+        post_command(freq, false, time_spec_t(0.0));
+    }
+
+    void set_freq(const double freq, const time_spec_t& time)
+    {
+        post_command(freq, true, time);
+    }
+
+    double get_freq(void) const
+    {
+        return _freq.load(std::memory_order_relaxed);
+    }
+
+    double get_freq_resolution(void) const
+    {
+        return _samp_rate * PHASE_INC_UNIT / PHASE_ONE_CYCLE;
+    }
+
+private:
+    //! A frequency change, as requested through set_freq()
+    struct command_t
+    {
+        uint64_t phase_inc = 0;
+        bool timed        = false;
+        time_spec_t time;
+    };
+
+    //! The state of one channel, only accessed by the streaming thread
+    struct chan_state_t
+    {
+        uint64_t phase     = 0;
+        uint64_t phase_inc = 0;
+        fc32_t step        = fc32_t(1.0f, 0.0f);
+        uint64_t seen_seq  = 0;
+        bool cmd_pending   = false;
+        command_t cmd;
+        bool has_time             = false;
+        time_spec_t base_time;
+        uint64_t samps_since_base = 0;
+    };
+
+    /*******************************************************************
+     * Commands
+     *
+     * Commands are published with a sequence lock: writers (serialized by
+     * a mutex) make the sequence number odd while they update the command,
+     * and the streaming thread retries if it sees an odd or changed
+     * sequence number. The streaming thread never blocks on the writers.
+     ******************************************************************/
+    void post_command(const double freq, const bool timed, const time_spec_t& time)
+    {
+        const uint64_t phase_inc = freq_to_phase_inc(freq, _samp_rate);
+
+        std::lock_guard<std::mutex> lock(_cmd_mutex);
+        const uint64_t seq = _cmd_seq.load(std::memory_order_relaxed);
+        _cmd_seq.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        _cmd_phase_inc.store(phase_inc, std::memory_order_relaxed);
+        _cmd_timed.store(timed, std::memory_order_relaxed);
+        _cmd_full_secs.store(time.get_full_secs(), std::memory_order_relaxed);
+        _cmd_frac_secs.store(time.get_frac_secs(), std::memory_order_relaxed);
+        _cmd_seq.store(seq + 2, std::memory_order_release);
+        _freq.store(freq, std::memory_order_relaxed);
+    }
+
+    //! Pick up a new command, if there is one
+    void poll_command(chan_state_t& state)
+    {
+        uint64_t seq = _cmd_seq.load(std::memory_order_acquire);
+        if (seq == state.seen_seq) {
+            return;
+        }
+        command_t cmd;
+        while (true) {
+            if (seq % 2 == 0) {
+                cmd.phase_inc = _cmd_phase_inc.load(std::memory_order_relaxed);
+                cmd.timed     = _cmd_timed.load(std::memory_order_relaxed);
+                cmd.time =
+                    time_spec_t(_cmd_full_secs.load(std::memory_order_relaxed),
+                        _cmd_frac_secs.load(std::memory_order_relaxed));
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (_cmd_seq.load(std::memory_order_relaxed) == seq) {
+                    break;
+                }
+            }
+            seq = _cmd_seq.load(std::memory_order_acquire);
+        }
+        state.seen_seq    = seq;
+        state.cmd         = cmd;
+        state.cmd_pending = true;
+    }
+
+    //! Number of samples until the pending command is due, <= 0 if it is due
+    int64_t get_samps_until_command(const chan_state_t& state) const
+    {
+        if (not state.cmd.timed or not state.has_time) {
+            return 0;
+        }
+        return (state.cmd.time - state.base_time).to_ticks(_samp_rate)
+               - int64_t(state.samps_since_base);
+    }
+
+    /*! Run a mixing kernel over nsamps samples
+     *
+     * Splits the samples where a command takes effect, and into segments of
+     * at most MAX_SEGMENT_LEN samples. The kernel is called with the offset
+     * and length of every segment, and the phasor of its first sample.
+     */
+    template <typename kernel_type>
+    void run_segments(chan_state_t& state,
+        const size_t nsamps,
+        const float scale,
+        const kernel_type& kernel)
+    {
+        poll_command(state);
+        size_t offset = 0;
+        while (offset < nsamps) {
+            size_t count = std::min(nsamps - offset, MAX_SEGMENT_LEN);
+            if (state.cmd_pending) {
+                const int64_t samps_until = get_samps_until_command(state);
+                if (samps_until <= 0) {
+                    state.phase_inc   = state.cmd.phase_inc;
+                    state.step        = phase_to_phasor(state.phase_inc, 1.0f);
+                    state.cmd_pending = false;
+                } else {
+                    count = size_t(std::min<int64_t>(count, samps_until));
+                }
+            }
+            kernel(offset, count, phase_to_phasor(state.phase, scale), state.step);
+            state.phase += state.phase_inc * count;
+            state.samps_since_base += count;
+            offset += count;
+        }
+    }
+
+    const double _samp_rate;
+    uint64_t _initial_phase_inc;
+    bool _sc16 = false;
+    std::vector<chan_state_t> _chans;
+
+    std::mutex _cmd_mutex;
+    std::atomic<uint64_t> _cmd_seq{0};
+    std::atomic<uint64_t> _cmd_phase_inc{0};
+    std::atomic<bool> _cmd_timed{false};
+    std::atomic<int64_t> _cmd_full_secs{0};
+    std::atomic<double> _cmd_frac_secs{0.0};
+    std::atomic<double> _freq{0.0};
+};
+
+} // namespace
+
+host_nco::sptr host_nco::make(const double samp_rate, const double freq)
+{
+    return sptr(new host_nco_impl(samp_rate, freq));
+}
@@ -0,0 +1,237 @@
+//
+// Copyright 2019 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include <uhd/convert.hpp>
+#include <uhd/exception.hpp>
+#include <uhdlib/dsp/host_rate_streamer.hpp>
+#include <uhdlib/dsp/polyphase_resampler.hpp>
+#include <cmath>
+#include <vector>
+
+using namespace uhd;
+using namespace uhd::dsp;
+
+namespace {
+
+class host_rate_rx_streamer : public rx_streamer
+{
+public:
+    host_rate_rx_streamer(rx_streamer::sptr rx_stream,
+        const std::string& cpu_format,
+        const double device_rate,
+        const double host_rate,
+        const size_t taps_per_phase)
+        : _rx_stream(rx_stream)
+        , _bytes_per_item(convert::get_bytes_per_item(cpu_format))
+        , _device_rate(device_rate)
+        , _max_num_samps_in(rx_stream->get_max_num_samps())
+    {
+        if (not(device_rate > 0.0) or not(host_rate > 0.0)) {
+            throw uhd::value_error("host_rate_rx_streamer: Invalid sample rate");
+        }
+        polyphase_resampler::rationalize(
+            host_rate / device_rate, HOST_RATE_MAX_INTERP, _interp, _decim);
+        const auto taps =
+            polyphase_resampler::design_taps(_interp, _decim, taps_per_phase);
+        _num_flush_samps = taps->taps_per_phase;
+        for (size_t chan = 0; chan < rx_stream->get_num_channels(); chan++) {
+            _resamplers.emplace_back(taps, cpu_format);
+            _in_buffs.emplace_back(_max_num_samps_in * _bytes_per_item);
+            _in_buff_ptrs.push_back(_in_buffs.back().data());
+        }
+    }
+
+    size_t get_num_channels(void) const
+    {
+        return _rx_stream->get_num_channels();
+    }
+
+    size_t get_max_num_samps(void) const
+    {
+        return (_max_num_samps_in * _interp + _decim - 1) / _decim;
+    }
+
+    size_t recv(const buffs_type& buffs,
+        const size_t nsamps_per_buff,
+        rx_metadata_t& metadata,
+        const double timeout,
+        const bool one_packet)
+    {
+        metadata.reset();
+        size_t nsamps = 0;
+        while (nsamps < nsamps_per_buff) {
+            if (_flushing and _out_count == _flush_end) {
+                metadata.end_of_burst = true;
+                end_segment();
+                break;
+            }
+            size_t num_available = _resamplers.front().get_num_available();
+            if (_flushing) {
+                num_available = std::min<uint64_t>(num_available, _flush_end - _out_count);
+            }
+
+            if (num_available == 0) {
+                if (nsamps and one_packet) {
+                    break;
+                }
+                if (not _pending) {
+                    _pending_nsamps = _rx_stream->recv(
+                        _in_buff_ptrs, _max_num_samps_in, _pending_md, timeout, true);
+                    _pending = true;
+                }
+                if (_pending_md.error_code != rx_metadata_t::ERROR_CODE_NONE) {
+                    // Return the samples we have first, then report the error
+                    if (not nsamps) {
+                        metadata = _pending_md;
+                        _pending = false;
+                        if (metadata.error_code != rx_metadata_t::ERROR_CODE_TIMEOUT) {
+                            end_segment();
+                        }
+                    } else if (_pending_md.error_code
+                               == rx_metadata_t::ERROR_CODE_TIMEOUT) {
+                        _pending = false;
+                    }
+                    break;
+                }
+                if (_segment_valid and is_discontinuous(_pending_md)) {
+                    // Don't mix samples from different segments in one call
+                    if (nsamps) {
+                        break;
+                    }
+                    end_segment();
+                }
+                if (not _segment_valid) {
+                    start_segment(_pending_md);
+                }
+                for (size_t chan = 0; chan < _resamplers.size(); chan++) {
+                    _resamplers[chan].push(_in_buff_ptrs[chan], _pending_nsamps);
+                }
+                _in_count += _pending_nsamps;
+                if (_pending_md.end_of_burst) {
+                    // Produce the outputs up to the last input, then stop
+                    for (auto& resampler : _resamplers) {
+                        resampler.push_zeros(_num_flush_samps);
+                    }
+                    _flushing  = true;
+                    _flush_end = (_in_count * _interp + _decim - 1) / _decim;
+                }
+                _pending = false;
+                continue;
+            }
+
+            if (not nsamps) {
+                metadata.has_time_spec = _segment_has_time_spec;
+                metadata.time_spec =
+                    _segment_time_spec
+                    + time_spec_t::from_ticks(_out_count * _decim, _device_rate * _interp);
+                metadata.start_of_burst = _start_of_burst;
+                _start_of_burst         = false;
+            }
+            const size_t n = std::min(num_available, nsamps_per_buff - nsamps);
+            for (size_t chan = 0; chan < _resamplers.size(); chan++) {
+                _resamplers[chan].pull(
+                    static_cast<char*>(buffs[chan]) + nsamps * _bytes_per_item, n);
+            }
+            nsamps += n;
+            _out_count += n;
+            if (_flushing and _out_count == _flush_end) {
+                metadata.end_of_burst = true;
+                end_segment();
+                break;
+            }
+        }
+        return nsamps;
+    }
+
+    void issue_stream_cmd(const stream_cmd_t& stream_cmd)
+    {
+        stream_cmd_t device_stream_cmd = stream_cmd;
+        device_stream_cmd.num_samps =
+            (stream_cmd.num_samps * _decim + _interp - 1) / _interp;
+        _rx_stream->issue_stream_cmd(device_stream_cmd);
+    }
+
+private:
+    //! True if a packet does not continue the current segment
+    bool is_discontinuous(const rx_metadata_t& md) const
+    {
+        if (md.start_of_burst or md.has_time_spec != _segment_has_time_spec) {
+            return true;
+        }
+        if (not md.has_time_spec) {
+            return false;
+        }
+        const time_spec_t expected_time =
+            _segment_time_spec + time_spec_t::from_ticks(_in_count, _device_rate);
+        return std::abs((md.time_spec - expected_time).get_real_secs())
+               >= 0.5 / _device_rate;
+    }
+
+    void start_segment(const rx_metadata_t& md)
+    {
+        _segment_valid         = true;
+        _segment_has_time_spec = md.has_time_spec;
+        _segment_time_spec     = md.time_spec;
+        _start_of_burst        = md.start_of_burst;
+        _in_count              = 0;
+        _out_count             = 0;
+    }
+
+    void end_segment(void)
+    {
+        _segment_valid = false;
+        _flushing      = false;
+        for (auto& resampler : _resamplers) {
+            resampler.reset();
+        }
+    }
+
+    rx_streamer::sptr _rx_stream;
+    const size_t _bytes_per_item;
+    const double _device_rate;
+    const size_t _max_num_samps_in;
+    size_t _interp;
+    size_t _decim;
+    size_t _num_flush_samps;
+    std::vector<polyphase_resampler> _resamplers;
+    std::vector<std::vector<char>> _in_buffs;
+    std::vector<void*> _in_buff_ptrs;
+
+    //! A packet received from the device, but not processed yet
+    bool _pending = false;
+    size_t _pending_nsamps = 0;
+    rx_metadata_t _pending_md;
+
+    //! A segment is a contiguous run of samples, starting at a known time
+    bool _segment_valid         = false;
+    bool _segment_has_time_spec = false;
+    time_spec_t _segment_time_spec;
+    bool _start_of_burst = false;
+    uint64_t _in_count   = 0;
+    uint64_t _out_count  = 0;
+    bool _flushing       = false;
+    uint64_t _flush_end  = 0;
+};
+
+} // namespace
+
+rx_streamer::sptr uhd::dsp::make_host_rate_rx_streamer(rx_streamer::sptr rx_stream,
+    const std::string& cpu_format,
+    const double device_rate,
+    const double host_rate,
+    const size_t taps_per_phase)
+{
+    return rx_streamer::sptr(new host_rate_rx_streamer(
+        rx_stream, cpu_format, device_rate, host_rate, taps_per_phase));
+}
+
+double uhd::dsp::get_host_rate_actual(const double device_rate, const double host_rate)
+{
+    size_t interp, decim;
+    polyphase_resampler::rationalize(
+        host_rate / device_rate, HOST_RATE_MAX_INTERP, interp, decim);
+    return device_rate * interp / decim;
+}
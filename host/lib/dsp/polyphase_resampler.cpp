@@ -0,0 +1,401 @@
+//
+// Copyright 2019 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include <uhd/exception.hpp>
+#include <uhdlib/dsp/firdes.hpp>
+#include <uhdlib/dsp/polyphase_resampler.hpp>
+#include <boost/format.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__)
+#    include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#    include <arm_neon.h>
+#endif
+
+// The AVX2 kernel is compiled for the target on its own, and selected at
+// runtime, so the library still runs on CPUs without AVX2
+#if defined(__GNUC__) and (defined(__x86_64__) or defined(__i386__))
+#    include <immintrin.h>
+#    define UHD_RESAMPLER_HAVE_AVX2
+#endif
+
+using namespace uhd::dsp;
+
+namespace {
+
+//! The largest supported ratio between input and output rate
+constexpr size_t MAX_RATIO = 64;
+
+//! Cutoff frequency relative to the lower of the two Nyquist frequencies
+constexpr double CUTOFF = 0.86;
+
+/*! Compute a block of output samples
+ *
+ * For every output, this computes the dot product of num_taps interleaved
+ * complex samples with the taps of the current phase. The taps are
+ * duplicated, so they line up with the I and Q components. The number of taps
+ * is a multiple of 8.
+ */
+typedef void (*resample_block_fn)(const std::complex<float>* buff,
+    const float* taps,
+    const size_t num_taps,
+    const size_t interp,
+    const size_t decim,
+    size_t& pos,
+    std::complex<float>* out,
+    const size_t nsamps);
+
+void resample_block_generic(const std::complex<float>* buff,
+    const float* taps,
+    const size_t num_taps,
+    const size_t interp,
+    const size_t decim,
+    size_t& pos,
+    std::complex<float>* out,
+    const size_t nsamps)
+{
+    // Step through the input without dividing for every output
+    const size_t decim_int  = decim / interp;
+    const size_t decim_frac = decim % interp;
+    size_t index            = pos / interp;
+    size_t phase            = pos % interp;
+    for (size_t n = 0; n < nsamps; n++) {
+        const float* x = reinterpret_cast<const float*>(buff + index);
+        const float* t = taps + 2 * num_taps * phase;
+#if defined(__SSE2__)
+        __m128 acc0 = _mm_setzero_ps();
+        __m128 acc1 = _mm_setzero_ps();
+        for (size_t i = 0; i < 2 * num_taps; i += 8) {
+            acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(x + i), _mm_loadu_ps(t + i)));
+            acc1 = _mm_add_ps(
+                acc1, _mm_mul_ps(_mm_loadu_ps(x + i + 4), _mm_loadu_ps(t + i + 4)));
+        }
+        float acc[4];
+        _mm_storeu_ps(acc, _mm_add_ps(acc0, acc1));
+#elif defined(__ARM_NEON)
+        float32x4_t acc0 = vdupq_n_f32(0.0f);
+        float32x4_t acc1 = vdupq_n_f32(0.0f);
+        for (size_t i = 0; i < 2 * num_taps; i += 8) {
+            acc0 = vmlaq_f32(acc0, vld1q_f32(x + i), vld1q_f32(t + i));
+            acc1 = vmlaq_f32(acc1, vld1q_f32(x + i + 4), vld1q_f32(t + i + 4));
+        }
+        float acc[4];
+        vst1q_f32(acc, vaddq_f32(acc0, acc1));
+#else
+        float acc[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+        for (size_t i = 0; i < 2 * num_taps; i += 4) {
+            acc[0] += x[i + 0] * t[i + 0];
+            acc[1] += x[i + 1] * t[i + 1];
+            acc[2] += x[i + 2] * t[i + 2];
+            acc[3] += x[i + 3] * t[i + 3];
+        }
+#endif
+        out[n] = std::complex<float>(acc[0] + acc[2], acc[1] + acc[3]);
+        index += decim_int;
+        phase += decim_frac;
+        if (phase >= interp) {
+            phase -= interp;
+            index++;
+        }
+    }
+    pos = index * interp + phase;
+}
+
+#ifdef UHD_RESAMPLER_HAVE_AVX2
+__attribute__((target("avx2,fma"))) void resample_block_avx2(
+    const std::complex<float>* buff,
+    const float* taps,
+    const size_t num_taps,
+    const size_t interp,
+    const size_t decim,
+    size_t& pos,
+    std::complex<float>* out,
+    const size_t nsamps)
+{
+    // Step through the input without dividing for every output
+    const size_t decim_int  = decim / interp;
+    const size_t decim_frac = decim % interp;
+    size_t index            = pos / interp;
+    size_t phase            = pos % interp;
+    for (size_t n = 0; n < nsamps; n++) {
+        const float* x = reinterpret_cast<const float*>(buff + index);
+        const float* t = taps + 2 * num_taps * phase;
+        __m256 acc0    = _mm256_setzero_ps();
+        __m256 acc1    = _mm256_setzero_ps();
+        for (size_t i = 0; i < 2 * num_taps; i += 16) {
+            acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(x + i), _mm256_loadu_ps(t + i), acc0);
+            acc1 = _mm256_fmadd_ps(
+                _mm256_loadu_ps(x + i + 8), _mm256_loadu_ps(t + i + 8), acc1);
+        }
+        const __m256 acc8 = _mm256_add_ps(acc0, acc1);
+        const __m128 acc4 = _mm_add_ps(
+            _mm256_castps256_ps128(acc8), _mm256_extractf128_ps(acc8, 1));
+        float acc[4];
+        _mm_storeu_ps(acc, acc4);
+        out[n] = std::complex<float>(acc[0] + acc[2], acc[1] + acc[3]);
+        index += decim_int;
+        phase += decim_frac;
+        if (phase >= interp) {
+            phase -= interp;
+            index++;
+        }
+    }
+    pos = index * interp + phase;
+}
+#endif
+
+//! Pick the fastest kernel the CPU supports
+resample_block_fn get_resample_block_fn(void)
+{
+#ifdef UHD_RESAMPLER_HAVE_AVX2
+    // This runs during static initialization, possibly before the CPU
+    // detection of the runtime
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") and __builtin_cpu_supports("fma")) {
+        return &resample_block_avx2;
+    }
+#endif
+    return &resample_block_generic;
+}
+
+const resample_block_fn resample_block = get_resample_block_fn();
+
+inline int16_t to_sc16_component(const float x)
+{
+    return int16_t(std::max(-32768.0f, std::min(32767.0f, std::round(x))));
+}
+
+//! Convert interleaved sc16 samples to fc32, without scaling
+void sc16_to_fc32(const int16_t* in, std::complex<float>* out, const size_t nsamps)
+{
+    float* out_f = reinterpret_cast<float*>(out);
+    size_t i     = 0;
+#if defined(__SSE2__)
+    for (; i + 8 <= 2 * nsamps; i += 8) {
+        const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        // Sign-extend to 32 bits by shifting the duplicated halves back down
+        const __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16);
+        const __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16);
+        _mm_storeu_ps(out_f + i, _mm_cvtepi32_ps(lo));
+        _mm_storeu_ps(out_f + i + 4, _mm_cvtepi32_ps(hi));
+    }
+#endif
+    for (; i < 2 * nsamps; i++) {
+        out_f[i] = float(in[i]);
+    }
+}
+
+//! Convert fc32 samples to interleaved sc16, without scaling
+void fc32_to_sc16(const std::complex<float>* in, int16_t* out, const size_t nsamps)
+{
+    const float* in_f = reinterpret_cast<const float*>(in);
+    size_t i          = 0;
+#if defined(__SSE2__)
+    const __m128 max = _mm_set1_ps(32767.0f);
+    const __m128 min = _mm_set1_ps(-32768.0f);
+    for (; i + 8 <= 2 * nsamps; i += 8) {
+        const __m128 lo = _mm_max_ps(min, _mm_min_ps(max, _mm_loadu_ps(in_f + i)));
+        const __m128 hi = _mm_max_ps(min, _mm_min_ps(max, _mm_loadu_ps(in_f + i + 4)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i),
+            _mm_packs_epi32(_mm_cvtps_epi32(lo), _mm_cvtps_epi32(hi)));
+    }
+#endif
+    for (; i < 2 * nsamps; i++) {
+        out[i] = to_sc16_component(in_f[i]);
+    }
+}
+
+} // namespace
+
+polyphase_resampler::taps_sptr polyphase_resampler::design_taps(
+    const size_t interp, const size_t decim, const size_t taps_per_phase)
+{
+    if (interp == 0 or decim == 0 or taps_per_phase == 0) {
+        throw uhd::value_error("polyphase_resampler: Invalid filter parameters");
+    }
+    if (interp > MAX_RATIO * decim or decim > MAX_RATIO * interp) {
+        throw uhd::value_error(
+            str(boost::format("polyphase_resampler: Rate change of %d/%d exceeds the "
+                              "maximum ratio of %d")
+                % interp % decim % MAX_RATIO));
+    }
+
+    // When decimating, the filter gets narrower relative to the input rate, so
+    // it needs more taps for the same transition band. The kernels need a
+    // multiple of 8 taps.
+    const size_t scaled_taps_per_phase =
+        std::max(taps_per_phase, (taps_per_phase * decim + interp - 1) / interp);
+    const size_t num_taps_per_phase = ((scaled_taps_per_phase + 7) / 8) * 8;
+
+    // Design the prototype at the interpolated rate. It has an odd number of
+    // taps (the last tap of the table is zero), so its delay is an integer
+    // number of samples.
+    const size_t num_taps = num_taps_per_phase * interp;
+    std::vector<double> proto =
+        kaiser_lowpass(num_taps - 1, CUTOFF * 0.5 / double(std::max(interp, decim)));
+    proto.push_back(0.0);
+
+    // Split into phases, reverse, and duplicate for I and Q. Scale so that
+    // every phase has unity gain at DC.
+    auto taps            = std::make_shared<taps_type>();
+    taps->interp         = interp;
+    taps->decim          = decim;
+    taps->taps_per_phase = num_taps_per_phase;
+    taps->taps.resize(2 * num_taps);
+    const double gain = double(interp);
+    for (size_t phase = 0; phase < interp; phase++) {
+        for (size_t i = 0; i < num_taps_per_phase; i++) {
+            const float tap =
+                float(gain * proto[(num_taps_per_phase - 1 - i) * interp + phase]);
+            taps->taps[2 * (phase * num_taps_per_phase + i) + 0] = tap;
+            taps->taps[2 * (phase * num_taps_per_phase + i) + 1] = tap;
+        }
+    }
+    return taps;
+}
+
+void polyphase_resampler::rationalize(
+    const double ratio, const size_t max_interp, size_t& interp, size_t& decim)
+{
+    if (not(ratio > 0.0) or not std::isfinite(ratio) or max_interp == 0) {
+        throw uhd::value_error("polyphase_resampler: Invalid rate ratio");
+    }
+    // Walk the convergents of the continued fraction of the ratio, and stop at
+    // the last one which satisfies the constraint on the interpolation
+    uint64_t num_prev = 1, den_prev = 0;
+    uint64_t num = uint64_t(std::floor(ratio)), den = 1;
+    double x = ratio;
+    for (int i = 0; i < 64; i++) {
+        const double frac = x - std::floor(x);
+        if (frac < 1e-9) {
+            break;
+        }
+        x                    = 1.0 / frac;
+        const uint64_t a     = uint64_t(std::floor(x));
+        const uint64_t num_n = a * num + num_prev;
+        const uint64_t den_n = a * den + den_prev;
+        if (num_n > max_interp) {
+            break;
+        }
+        num_prev = num;
+        den_prev = den;
+        num      = num_n;
+        den      = den_n;
+    }
+    if (num == 0) {
+        throw uhd::value_error(
+            "polyphase_resampler: Rate ratio too small for the interpolation limit");
+    }
+    interp = size_t(num);
+    decim  = size_t(den);
+}
+
+polyphase_resampler::polyphase_resampler(
+    taps_sptr taps, const std::string& cpu_format)
+    : _taps(taps), _sc16(cpu_format == "sc16")
+{
+    if (cpu_format != "fc32" and cpu_format != "sc16") {
+        throw uhd::value_error(str(
+            boost::format("polyphase_resampler: Unsupported CPU format %s") % cpu_format));
+    }
+    reset();
+}
+
+void polyphase_resampler::reset(void)
+{
+    // Start with an empty filter history, and skip the filter delay, so
+    // output n lines up with input n * decim / interp
+    _buff.assign(_taps->taps_per_phase - 1, std::complex<float>(0.0f, 0.0f));
+    _start = 0;
+    _pos   = (_taps->taps_per_phase * _taps->interp - 2) / 2;
+}
+
+void polyphase_resampler::push(const void* in, const size_t nsamps)
+{
+    compact();
+    const size_t offset = _buff.size();
+    _buff.resize(offset + nsamps);
+    if (_sc16) {
+        sc16_to_fc32(static_cast<const int16_t*>(in), &_buff[offset], nsamps);
+    } else {
+        std::memcpy(&_buff[offset], in, nsamps * sizeof(std::complex<float>));
+    }
+}
+
+void polyphase_resampler::push_zeros(const size_t nsamps)
+{
+    compact();
+    _buff.resize(_buff.size() + nsamps, std::complex<float>(0.0f, 0.0f));
+}
+
+size_t polyphase_resampler::get_num_available(void) const
+{
+    const size_t num_taps_per_phase = _taps->taps_per_phase;
+    const size_t avail              = _buff.size() - _start;
+    if (avail < num_taps_per_phase) {
+        return 0;
+    }
+    // Outputs are available as long as their window fits into the buffer
+    const size_t end_pos = (avail - num_taps_per_phase + 1) * _taps->interp;
+    if (_pos >= end_pos) {
+        return 0;
+    }
+    return (end_pos - _pos - 1) / _taps->decim + 1;
+}
+
+size_t polyphase_resampler::pull(void* out, const size_t max_nsamps)
+{
+    const size_t nsamps = std::min(max_nsamps, get_num_available());
+    const std::complex<float>* buff = _buff.data() + _start;
+
+    if (_sc16) {
+        // Compute in chunks, then convert
+        constexpr size_t CHUNK_SIZE = 256;
+        std::complex<float> chunk[CHUNK_SIZE];
+        int16_t* samps = static_cast<int16_t*>(out);
+        for (size_t offset = 0; offset < nsamps; offset += CHUNK_SIZE) {
+            const size_t n = std::min(CHUNK_SIZE, nsamps - offset);
+            resample_block(buff,
+                _taps->taps.data(),
+                _taps->taps_per_phase,
+                _taps->interp,
+                _taps->decim,
+                _pos,
+                chunk,
+                n);
+            fc32_to_sc16(chunk, samps + 2 * offset, n);
+        }
+    } else {
+        resample_block(buff,
+            _taps->taps.data(),
+            _taps->taps_per_phase,
+            _taps->interp,
+            _taps->decim,
+            _pos,
+            static_cast<std::complex<float>*>(out),
+            nsamps);
+    }
+
+    // Drop the input which is no longer needed
+    const size_t drop = std::min(_pos / _taps->interp, _buff.size() - _start);
+    _start += drop;
+    _pos -= drop * _taps->interp;
+    return nsamps;
+}
+
+void polyphase_resampler::compact(void)
+{
+    // Only move the samples which are still needed once there are fewer of
+    // them than samples before them, so every sample is moved at most once
+    // on average
+    if (_start and _start >= _buff.size() - _start) {
+        _buff.erase(_buff.begin(), _buff.begin() + _start);
+        _start = 0;
+    }
+}
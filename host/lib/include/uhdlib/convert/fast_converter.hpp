@@ -0,0 +1,69 @@
+//
+// Copyright 2019 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#ifndef INCLUDED_UHDLIB_CONVERT_FAST_CONVERTER_HPP
+#define INCLUDED_UHDLIB_CONVERT_FAST_CONVERTER_HPP
+
+#include <uhd/config.hpp>
+#include <uhd/convert.hpp>
+
+namespace uhd { namespace convert {
+
+/*! Pointer to a conversion routine that bypasses the virtual call
+ *
+ * The first argument is the converter object which holds the conversion state
+ * (e.g., the scale factor).
+ */
+typedef void (*conv_fn_type)(converter* self,
+    const converter::input_type& in,
+    const converter::output_type& out,
+    const size_t num);
+
+/*! Base class for converters that provide a direct conversion function
+ *
+ * Converters declared with DECLARE_CONVERTER derive from this class. Their
+ * conversion function is a non-virtual thunk into which the converter body is
+ * inlined, so the streamers can call it without going through the vtable.
+ */
+class UHD_API fast_converter : public converter
+{
+public:
+    conv_fn_type get_conv_fn(void) const
+    {
+        return _conv_fn;
+    }
+
+protected:
+    fast_converter(const conv_fn_type conv_fn) : _conv_fn(conv_fn) {}
+
+private:
+    const conv_fn_type _conv_fn;
+};
+
+//! Conversion function for converters without a direct conversion function
+inline void conv_generic(converter* self,
+    const converter::input_type& in,
+    const converter::output_type& out,
+    const size_t num)
+{
+    self->conv(in, out, num);
+}
+
+/*! Return the fastest conversion function for a converter
+ *
+ * This is the direct conversion function if the converter provides one, or
+ * a wrapper around converter::conv() otherwise. Call this once when binding a
+ * converter, not for every conversion.
+ */
+inline conv_fn_type get_conv_fn(const converter::sptr& conv)
+{
+    const fast_converter* fast_conv = dynamic_cast<const fast_converter*>(conv.get());
+    return fast_conv ? fast_conv->get_conv_fn() : &conv_generic;
+}
+
+}} // namespace uhd::convert
+
+#endif /* INCLUDED_UHDLIB_CONVERT_FAST_CONVERTER_HPP */
@@ -0,0 +1,50 @@
+//
+// Copyright 2019 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#ifndef INCLUDED_UHDLIB_DSP_CHANNELIZER_STREAMER_HPP
+#define INCLUDED_UHDLIB_DSP_CHANNELIZER_STREAMER_HPP
+
+#include <uhd/stream.hpp>
+#include <string>
+
+namespace uhd { namespace dsp {
+
+/*! Split a wideband RX streamer into narrowband channels
+ *
+ * The samples from \p rx_stream are split into \p num_chans channels of equal
+ * bandwidth by a critically sampled polyphase filterbank. Every output
+ * channel runs at device_rate / num_chans. Channel i is centered at
+ * i * device_rate / num_chans; channels above num_chans / 2 wrap around to
+ * negative frequencies.
+ *
+ * The filter delay is compensated, so output sample m of every channel
+ * corresponds to input sample m * num_chans, and carries its timestamp. Bursts
+ * are flushed, and the last output of a burst is flagged with end_of_burst.
+ * Number of samples in stream commands refer to samples per channel.
+ *
+ * The filterbank reads the wideband samples as "sc16", and filters them
+ * directly from a buffer of sc16 samples; the wideband stream is never
+ * converted to "fc32".
+ *
+ * \param rx_stream The wideband streamer, with one channel and CPU format sc16
+ * \param cpu_format The output format, "fc32" or "sc16"
+ * \param device_rate The sample rate of \p rx_stream
+ * \param num_chans The number of output channels
+ * \param taps_per_chan The filter length, in taps per channel
+ * \param num_threads The number of threads to run the filterbank on,
+ *                    including the thread calling recv()
+ * \throws uhd::value_error on invalid arguments
+ */
+rx_streamer::sptr make_channelizer_rx_streamer(rx_streamer::sptr rx_stream,
+    const std::string& cpu_format,
+    const double device_rate,
+    const size_t num_chans,
+    const size_t taps_per_chan = 12,
+    const size_t num_threads   = 1);
+
+}} // namespace uhd::dsp
+
+#endif /* INCLUDED_UHDLIB_DSP_CHANNELIZER_STREAMER_HPP */
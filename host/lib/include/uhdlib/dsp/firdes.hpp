@@ -0,0 +1,29 @@
+//
+// Copyright 2019 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#ifndef INCLUDED_UHDLIB_DSP_FIRDES_HPP
+#define INCLUDED_UHDLIB_DSP_FIRDES_HPP
+
+#include <cstddef>
+#include <vector>
+
+namespace uhd { namespace dsp {
+
+/*! Design a linear-phase lowpass filter with a Kaiser window
+ *
+ * The taps are symmetric around (num_taps - 1) / 2, and sum up to one.
+ *
+ * \param num_taps The number of taps
+ * \param cutoff The cutoff frequency, relative to the sample rate
+ * \param beta The Kaiser window parameter. The default gives about 70 dB of
+ *             stopband attenuation.
+ */
+std::vector<double> kaiser_lowpass(
+    const size_t num_taps, const double cutoff, const double beta = 7.0);
+
+}} // namespace uhd::dsp
+
+#endif /* INCLUDED_UHDLIB_DSP_FIRDES_HPP */
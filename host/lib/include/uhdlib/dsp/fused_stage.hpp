@@ -0,0 +1,46 @@
+//
+// Copyright 2019 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#ifndef INCLUDED_UHDLIB_DSP_FUSED_STAGE_HPP
+#define INCLUDED_UHDLIB_DSP_FUSED_STAGE_HPP
+
+#include <complex>
+#include <cstddef>
+
+namespace uhd { namespace dsp {
+
+/*! Interface for stream stages which can run as part of the RX conversion
+ *
+ * An RX streamer whose first stage implements this interface, and which
+ * converts "sc16_item32_le" or "sc16_item32_be" into "fc32", calls
+ * convert_and_process() instead of the converter followed by the stage. This
+ * saves a pass over the samples.
+ */
+class fused_sc16_stage
+{
+public:
+    virtual ~fused_sc16_stage(void) {}
+
+    /*! Convert sc16 items into fc32, and process them like the stage would
+     *
+     * \param chan The channel index
+     * \param in The sc16 items, as they were received
+     * \param big_endian True for "sc16_item32_be", false for "sc16_item32_le"
+     * \param scale The scale factor of the conversion
+     * \param out The fc32 output buffer
+     * \param nsamps The number of samples
+     */
+    virtual void convert_and_process(const size_t chan,
+        const void* in,
+        const bool big_endian,
+        const float scale,
+        std::complex<float>* out,
+        const size_t nsamps) = 0;
+};
+
+}} // namespace uhd::dsp
+
+#endif /* INCLUDED_UHDLIB_DSP_FUSED_STAGE_HPP */
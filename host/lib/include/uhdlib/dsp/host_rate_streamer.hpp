@@ -0,0 +1,48 @@
+//
+// Copyright 2019 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#ifndef INCLUDED_UHDLIB_DSP_HOST_RATE_STREAMER_HPP
+#define INCLUDED_UHDLIB_DSP_HOST_RATE_STREAMER_HPP
+
+#include <uhd/stream.hpp>
+#include <string>
+
+namespace uhd { namespace dsp {
+
+/*! Wrap an RX streamer into one which resamples to a different rate
+ *
+ * The samples from \p rx_stream are resampled from \p device_rate to
+ * \p host_rate using a polyphase resampler. The rate change is approximated by
+ * a fraction whose numerator is at most \p max_interp; use
+ * get_host_rate_actual() to find out the actual rate.
+ *
+ * Timestamps are carried across the rate change: the timestamp of an output
+ * sample is the timestamp of the input at the same point in time. Bursts are
+ * flushed, and the last output of a burst is flagged with end_of_burst.
+ * Number of samples in stream commands are converted to the device rate.
+ *
+ * \param rx_stream The streamer to wrap
+ * \param cpu_format The CPU format of \p rx_stream, "fc32" or "sc16"
+ * \param device_rate The sample rate of \p rx_stream
+ * \param host_rate The desired output sample rate
+ * \param taps_per_phase Filter length, see polyphase_resampler::design_taps()
+ * \throws uhd::value_error if the rates or the CPU format are not supported
+ */
+rx_streamer::sptr make_host_rate_rx_streamer(rx_streamer::sptr rx_stream,
+    const std::string& cpu_format,
+    const double device_rate,
+    const double host_rate,
+    const size_t taps_per_phase = 32);
+
+//! The largest interpolation factor used by make_host_rate_rx_streamer()
+static const size_t HOST_RATE_MAX_INTERP = 512;
+
+//! Return the rate that make_host_rate_rx_streamer() will actually provide
+double get_host_rate_actual(const double device_rate, const double host_rate);
+
+}} // namespace uhd::dsp
+
+#endif /* INCLUDED_UHDLIB_DSP_HOST_RATE_STREAMER_HPP */
@@ -0,0 +1,117 @@
+//
+// Copyright 2019 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#ifndef INCLUDED_UHDLIB_DSP_PHASOR_HPP
+#define INCLUDED_UHDLIB_DSP_PHASOR_HPP
+
+#include <stdint.h>
+#include <cmath>
+#include <complex>
+
+#if defined(__SSE2__)
+#    include <emmintrin.h>
+#endif
+
+namespace uhd { namespace dsp {
+
+/***********************************************************************
+ * Phase accumulators
+ *
+ * Phases are unsigned 64-bit integers, which wrap around once per cycle.
+ * Oscillators keep the phase exactly, and compute phasors from it once per
+ * segment of samples; within a segment, the phasor is advanced by
+ * multiplying it with a step.
+ **********************************************************************/
+//! The phase accumulator wraps around once per cycle
+constexpr double PHASE_ONE_CYCLE = 18446744073709551616.0; // 2^64
+
+//! Phase increments are multiples of this, to keep them within int64_t
+constexpr uint64_t PHASE_INC_UNIT = 4;
+
+/*! Get the phase increment per sample of a frequency
+ *
+ * The increment is rounded to a multiple of PHASE_INC_UNIT, and frequencies
+ * wrap around at +/- samp_rate / 2.
+ */
+inline uint64_t freq_to_phase_inc(const double freq, const double samp_rate)
+{
+    const double cycles = freq / samp_rate;
+    const double frac   = cycles - std::round(cycles);
+    return uint64_t(std::llround(frac * PHASE_ONE_CYCLE / PHASE_INC_UNIT))
+           * PHASE_INC_UNIT;
+}
+
+//! Get scale * exp(2j * pi * phase / PHASE_ONE_CYCLE)
+inline std::complex<float> phase_to_phasor(const uint64_t phase, const float scale)
+{
+    const double angle = 2.0 * M_PI * double(phase) / PHASE_ONE_CYCLE;
+    return std::complex<float>(
+        float(scale * std::cos(angle)), float(scale * std::sin(angle)));
+}
+
+//! Complex multiplication, without the checks for infinities of operator*
+inline std::complex<float> complex_mul(
+    const std::complex<float>& a, const std::complex<float>& b)
+{
+    return std::complex<float>(a.real() * b.real() - a.imag() * b.imag(),
+        a.real() * b.imag() + a.imag() * b.real());
+}
+
+#if defined(__SSE2__)
+//! The phasors of four consecutive samples, as real and imaginary parts
+struct phasor4_t
+{
+    phasor4_t(const std::complex<float> phasor, const std::complex<float> step)
+    {
+        std::complex<float> p[4] = {phasor};
+        for (size_t i = 1; i < 4; i++) {
+            p[i] = complex_mul(p[i - 1], step);
+        }
+        const std::complex<float> step4 =
+            complex_mul(complex_mul(step, step), complex_mul(step, step));
+        re      = _mm_setr_ps(p[0].real(), p[1].real(), p[2].real(), p[3].real());
+        im      = _mm_setr_ps(p[0].imag(), p[1].imag(), p[2].imag(), p[3].imag());
+        step_re = _mm_set1_ps(step4.real());
+        step_im = _mm_set1_ps(step4.imag());
+    }
+
+    //! Mix four samples, given as real and imaginary parts
+    void mix(const __m128 in_re, const __m128 in_im, __m128& out_re, __m128& out_im) const
+    {
+        out_re = _mm_sub_ps(_mm_mul_ps(in_re, re), _mm_mul_ps(in_im, im));
+        out_im = _mm_add_ps(_mm_mul_ps(in_re, im), _mm_mul_ps(in_im, re));
+    }
+
+    //! Advance by four samples
+    void advance(void)
+    {
+        const __m128 next_re =
+            _mm_sub_ps(_mm_mul_ps(re, step_re), _mm_mul_ps(im, step_im));
+        im = _mm_add_ps(_mm_mul_ps(re, step_im), _mm_mul_ps(im, step_re));
+        re = next_re;
+    }
+
+    //! The phasor of the next sample
+    std::complex<float> get_first(void) const
+    {
+        return std::complex<float>(_mm_cvtss_f32(re), _mm_cvtss_f32(im));
+    }
+
+    __m128 re, im, step_re, step_im;
+};
+
+//! Store four samples from real and imaginary parts as interleaved fc32
+inline void store_fc32x4(std::complex<float>* out, const __m128 re, const __m128 im)
+{
+    float* out_f = reinterpret_cast<float*>(out);
+    _mm_storeu_ps(out_f, _mm_unpacklo_ps(re, im));
+    _mm_storeu_ps(out_f + 4, _mm_unpackhi_ps(re, im));
+}
+#endif
+
+}} // namespace uhd::dsp
+
+#endif /* INCLUDED_UHDLIB_DSP_PHASOR_HPP */
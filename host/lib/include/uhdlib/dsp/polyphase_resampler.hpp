@@ -0,0 +1,118 @@
+//
+// Copyright 2019 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#ifndef INCLUDED_UHDLIB_DSP_POLYPHASE_RESAMPLER_HPP
+#define INCLUDED_UHDLIB_DSP_POLYPHASE_RESAMPLER_HPP
+
+#include <complex>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace uhd { namespace dsp {
+
+/*! Rational polyphase resampler for complex samples
+ *
+ * Resamples by a factor of interp/decim. The prototype lowpass filter is split
+ * into interp phases of taps_per_phase taps each, so every output sample costs
+ * one dot product of taps_per_phase complex samples, regardless of the rate.
+ *
+ * The filter delay is compensated: output sample n corresponds exactly to
+ * input sample n * decim / interp. This means the timestamp of an output
+ * sample can be computed from the timestamp of the first input sample.
+ *
+ * The resampler supports "fc32" and "sc16" samples. Internally, it always
+ * computes in single-precision float; sc16 samples are not scaled.
+ *
+ * An instance handles one channel. Multiple channels can share the filter
+ * table by constructing them from the same taps_type object.
+ */
+class polyphase_resampler
+{
+public:
+    //! Filter table, shared between channels
+    struct taps_type
+    {
+        size_t interp;
+        size_t decim;
+        size_t taps_per_phase;
+        //! Per phase: taps_per_phase taps in reverse order, each one duplicated
+        //  so they can be multiplied with interleaved I/Q samples directly
+        std::vector<float> taps;
+    };
+    typedef std::shared_ptr<const taps_type> taps_sptr;
+
+    /*! Design a filter table for a given rate change
+     *
+     * \param interp Interpolation factor
+     * \param decim Decimation factor
+     * \param taps_per_phase Number of taps per polyphase branch, when not
+     *                       decimating. Rounded up to a multiple of 8, and
+     *                       scaled by the decimation ratio.
+     * \throws uhd::value_error on invalid parameters
+     */
+    static taps_sptr design_taps(
+        const size_t interp, const size_t decim, const size_t taps_per_phase = 32);
+
+    /*! Find the rational approximation of a rate ratio
+     *
+     * \param ratio The desired ratio of output rate to input rate
+     * \param max_interp The largest allowable interpolation factor
+     * \param interp Returns the interpolation factor
+     * \param decim Returns the decimation factor
+     */
+    static void rationalize(
+        const double ratio, const size_t max_interp, size_t& interp, size_t& decim);
+
+    /*!
+     * \param taps The filter table
+     * \param cpu_format Either "fc32" or "sc16"
+     * \throws uhd::value_error if \p cpu_format is not supported
+     */
+    polyphase_resampler(taps_sptr taps, const std::string& cpu_format);
+
+    //! Clear the filter history and start a new stream
+    void reset(void);
+
+    //! Append input samples (in the CPU format)
+    void push(const void* in, const size_t nsamps);
+
+    //! Append zeros, e.g. to flush the filter at the end of a burst
+    void push_zeros(const size_t nsamps);
+
+    //! Number of output samples which can be computed from the input so far
+    size_t get_num_available(void) const;
+
+    /*! Compute output samples (in the CPU format)
+     *
+     * \param out The output buffer
+     * \param max_nsamps The maximum number of samples to compute
+     * \returns the number of samples written to \p out
+     */
+    size_t pull(void* out, const size_t max_nsamps);
+
+    taps_sptr get_taps(void) const
+    {
+        return _taps;
+    }
+
+private:
+    void compact(void);
+
+    const taps_sptr _taps;
+    const bool _sc16;
+    //! Filter history and pending input
+    std::vector<std::complex<float>> _buff;
+    //! Index of the first valid sample in _buff
+    size_t _start;
+    //! Position of the next output, relative to _start, in units of 1/interp
+    //  input samples
+    size_t _pos;
+};
+
+}} // namespace uhd::dsp
+
+#endif /* INCLUDED_UHDLIB_DSP_POLYPHASE_RESAMPLER_HPP */
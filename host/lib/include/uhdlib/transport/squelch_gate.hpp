@@ -0,0 +1,96 @@
+//
+// Copyright 2019 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#ifndef INCLUDED_UHDLIB_TRANSPORT_SQUELCH_GATE_HPP
+#define INCLUDED_UHDLIB_TRANSPORT_SQUELCH_GATE_HPP
+
+#include <uhd/config.hpp>
+#include <uhd/types/metadata.hpp>
+#include <uhd/utils/byteswap.hpp>
+#include <stdint.h>
+#include <cstddef>
+#if defined(__SSE2__)
+#    include <emmintrin.h>
+#endif
+
+namespace uhd { namespace transport {
+
+/*! The interface between an RX streamer and its uhd::rx_squelch
+ *
+ * The streamer runs the gate itself, and only reads the settings and reports
+ * its decisions through this interface. Power levels are the mean of
+ * I * I + Q * Q over a packet, in sc16 units.
+ */
+class squelch_gate
+{
+public:
+    virtual ~squelch_gate(void) {}
+
+    //! Power at which the gate opens
+    virtual float get_open_level(void) const = 0;
+
+    //! Power below which the gate closes
+    virtual float get_close_level(void) const = 0;
+
+    //! Number of packets to pass before the gate opens
+    virtual size_t get_pre_packets(void) const = 0;
+
+    //! Number of packets to pass after the gate closes
+    virtual size_t get_post_packets(void) const = 0;
+
+    //! Count a packet set which was passed to the user
+    virtual void packet_passed(const bool start_of_burst) = 0;
+
+    //! Count (and summarize) a packet set which was not passed to the user
+    virtual void packet_gated(
+        const rx_metadata_t& metadata, const size_t nsamps, const float power) = 0;
+};
+
+/*! Get the mean power of a packet of sc16 items
+ *
+ * \param items The sc16_item32_le or sc16_item32_be items
+ * \param nsamps The number of items
+ * \param big_endian True for sc16_item32_be
+ * \return the mean of I * I + Q * Q
+ */
+UHD_INLINE float get_sc16_item32_power(
+    const uint32_t* items, const size_t nsamps, const bool big_endian)
+{
+    if (nsamps == 0) {
+        return 0.0f;
+    }
+    uint64_t sum = 0;
+    size_t i     = 0;
+#if defined(__SSE2__)
+    // The sum of squares of an I/Q pair fits an unsigned 32-bit word, so
+    // widen to 64 bits before accumulating
+    const __m128i zero = _mm_setzero_si128();
+    __m128i acc        = _mm_setzero_si128();
+    for (; i + 4 <= nsamps; i += 4) {
+        __m128i iq = _mm_loadu_si128(reinterpret_cast<const __m128i*>(items + i));
+        if (big_endian) {
+            iq = _mm_or_si128(_mm_slli_epi16(iq, 8), _mm_srli_epi16(iq, 8));
+        }
+        const __m128i pwr = _mm_madd_epi16(iq, iq);
+        acc = _mm_add_epi64(acc, _mm_unpacklo_epi32(pwr, zero));
+        acc = _mm_add_epi64(acc, _mm_unpackhi_epi32(pwr, zero));
+    }
+    uint64_t lanes[2];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), acc);
+    sum = lanes[0] + lanes[1];
+#endif
+    for (; i < nsamps; i++) {
+        const uint32_t item = big_endian ? uhd::ntohx(items[i]) : uhd::wtohx(items[i]);
+        const int32_t real  = int16_t(item >> 16);
+        const int32_t imag  = int16_t(item & 0xffff);
+        sum += uint32_t(real * real) + uint32_t(imag * imag);
+    }
+    return float(double(sum) / nsamps);
+}
+
+}} // namespace uhd::transport
+
+#endif /* INCLUDED_UHDLIB_TRANSPORT_SQUELCH_GATE_HPP */
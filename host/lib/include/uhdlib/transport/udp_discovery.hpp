@@ -0,0 +1,67 @@
+//
+// Copyright 2019 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#ifndef INCLUDED_UHDLIB_TRANSPORT_UDP_DISCOVERY_HPP
+#define INCLUDED_UHDLIB_TRANSPORT_UDP_DISCOVERY_HPP
+
+#include <uhd/transport/udp_simple.hpp>
+#include <boost/shared_ptr.hpp>
+#include <string>
+
+namespace uhd { namespace transport {
+
+/*!
+ * A broadcast transport for device discovery.
+ *
+ * All discovery transports of a finder to the same address share one socket,
+ * so the concurrent discoveries of a finder (one per device hint) use a single
+ * socket per interface. Finders of different device types use separate
+ * sockets, even when their devices listen on the same port, so a finder never
+ * sees the replies to another finder's requests. A transport receives the
+ * replies which come from its destination port. Repeated identical replies
+ * from the same sender are dropped, so the replies to a concurrent discovery
+ * aren't reported twice.
+ *
+ * The time a device takes to reply is tracked per finder, address and port,
+ * so later discoveries of the same device only wait as long as it needs (see
+ * get_timeout()).
+ */
+class udp_discovery : public udp_simple
+{
+public:
+    typedef boost::shared_ptr<udp_discovery> sptr;
+
+    //! The shortest timeout get_timeout() returns (in seconds)
+    static constexpr double MIN_TIMEOUT = 0.010;
+    //! How much longer than the slowest reply get_timeout() waits
+    static constexpr double TIMEOUT_MARGIN = 4.0;
+
+    /*!
+     * Make a new discovery transport.
+     *
+     * \param finder The name of the finder (e.g. the device type)
+     * \param addr The broadcast (or device) address
+     * \param port The port the devices listen on for discovery requests
+     */
+    static sptr make(
+        const std::string& finder, const std::string& addr, const std::string& port);
+
+    /*!
+     * Returns how long to wait for further replies (in seconds).
+     *
+     * Broadcasts can reach devices which never replied before, so they always
+     * wait \p max_timeout. For a device address, this is \p max_timeout until
+     * a discovery received a reply. Afterwards, it's TIMEOUT_MARGIN times the
+     * time the device took to reply in the last discovery, limited to
+     * MIN_TIMEOUT and \p max_timeout. A discovery without a reply resets it to
+     * \p max_timeout.
+     */
+    virtual double get_timeout(const double max_timeout) = 0;
+};
+
+}} // namespace uhd::transport
+
+#endif /* INCLUDED_UHDLIB_TRANSPORT_UDP_DISCOVERY_HPP */
@@ -124,13 +124,17 @@ private:
 
 #else //non-windows platforms
 
-#define PROFILE_TIMING(context) 
+// Timers are recorded as spans of the UHD_TRACE_FILE trace
+#include <uhdlib/utils/trace.hpp>
 
-#define PROFILE_TIMING_WITH_THRESHOLD(context,threshold) 
+#define PROFILE_TIMING(context) UHD_TRACE_SCOPE(context)
 
-#define PROFILE_TIMING_WITH_SCALE(context,unitScale) 
+#define PROFILE_TIMING_WITH_THRESHOLD(context,threshold) UHD_TRACE_SCOPE(context)
 
-#define PROFILE_TIMING_WITH_THRESHOLD_AND_SCALE(context,threshold,unitScale) 
+#define PROFILE_TIMING_WITH_SCALE(context,unitScale) UHD_TRACE_SCOPE(context)
+
+#define PROFILE_TIMING_WITH_THRESHOLD_AND_SCALE(context,threshold,unitScale) \
+    UHD_TRACE_SCOPE(context)
 
 #endif
 
@@ -0,0 +1,201 @@
+//
+// Copyright 2019 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#ifndef INCLUDED_UHDLIB_UTILS_LATENCY_HISTOGRAM_HPP
+#define INCLUDED_UHDLIB_UTILS_LATENCY_HISTOGRAM_HPP
+
+#include <uhd/config.hpp>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace uhd { namespace latency {
+
+//! Return a monotonic timestamp in nanoseconds
+inline uint64_t now_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+/*! Log-linear latency histogram (HDR histogram style)
+ *
+ * Values below 2 * SUB_BUCKETS nanoseconds are recorded exactly. Above that,
+ * every power of two is split into SUB_BUCKETS linear sub-buckets, which
+ * bounds the relative error of any percentile to 1 / SUB_BUCKETS (~3%).
+ * Recording is lock-free and allocation-free, so it may be called from the
+ * streaming fast path.
+ */
+class UHD_API histogram
+{
+public:
+    static constexpr size_t SUB_BUCKET_BITS = 5;
+    static constexpr size_t SUB_BUCKETS     = 1 << SUB_BUCKET_BITS;
+    static constexpr size_t NUM_BUCKETS     = (65 - SUB_BUCKET_BITS) * SUB_BUCKETS;
+
+    histogram();
+
+    //! Record a single latency value in nanoseconds
+    inline void record(const uint64_t value_ns)
+    {
+        _buckets[get_bucket_index(value_ns)].fetch_add(1, std::memory_order_relaxed);
+        _count.fetch_add(1, std::memory_order_relaxed);
+        _sum.fetch_add(value_ns, std::memory_order_relaxed);
+        uint64_t max = _max.load(std::memory_order_relaxed);
+        while (value_ns > max
+               and not _max.compare_exchange_weak(
+                   max, value_ns, std::memory_order_relaxed)) {
+        }
+        uint64_t min = _min.load(std::memory_order_relaxed);
+        while (value_ns < min
+               and not _min.compare_exchange_weak(
+                   min, value_ns, std::memory_order_relaxed)) {
+        }
+    }
+
+    //! Number of recorded values
+    uint64_t get_count() const;
+
+    //! Smallest recorded value in ns, or 0 if nothing was recorded
+    uint64_t get_min() const;
+
+    //! Largest recorded value in ns
+    uint64_t get_max() const;
+
+    //! Mean of all recorded values in ns
+    double get_mean() const;
+
+    /*! Return the value at a given percentile in ns
+     *
+     * \param percentile Percentile in the range [0, 100]
+     * \returns the upper bound of the bucket containing the percentile (but
+     *          never more than the largest recorded value), or 0 if nothing
+     *          was recorded.
+     */
+    uint64_t get_percentile(const double percentile) const;
+
+    //! Discard all recorded values
+    void reset();
+
+    //! Map a value to its bucket
+    static inline size_t get_bucket_index(const uint64_t value)
+    {
+        if (value < 2 * SUB_BUCKETS) {
+            return size_t(value);
+        }
+        size_t msb = 0;
+        for (uint64_t v = value; v > 1; v >>= 1) {
+            msb++;
+        }
+        const size_t shift = msb - SUB_BUCKET_BITS;
+        return shift * SUB_BUCKETS + size_t(value >> shift);
+    }
+
+    //! Return the largest value that maps to a given bucket
+    static uint64_t get_bucket_upper_bound(const size_t index);
+
+private:
+    std::array<std::atomic<uint64_t>, NUM_BUCKETS> _buckets;
+    std::atomic<uint64_t> _count;
+    std::atomic<uint64_t> _sum;
+    std::atomic<uint64_t> _min;
+    std::atomic<uint64_t> _max;
+};
+
+/*! Return the histogram registered under \p name, creating it if necessary
+ *
+ * The returned reference stays valid for the lifetime of the process, so call
+ * sites can cache it in a function-local static.
+ */
+UHD_API histogram& get_histogram(const std::string& name);
+
+//! Return the names of all histograms created so far, sorted alphabetically
+UHD_API std::vector<std::string> get_histogram_names();
+
+//! Reset all registered histograms
+UHD_API void reset_histograms();
+
+/*! A point in time which a later event is measured against
+ *
+ * The mark may be set and consumed from different threads (e.g., a send()
+ * call sets it, and recv_async_msg() consumes it).
+ */
+class mark_t
+{
+public:
+    mark_t() : _time_ns(0) {}
+
+    inline void set()
+    {
+        _time_ns.store(now_ns(), std::memory_order_relaxed);
+    }
+
+    //! Record the time since the mark was set into \p hist, and clear the mark
+    inline void record_and_clear(histogram& hist)
+    {
+        const uint64_t start = _time_ns.exchange(0, std::memory_order_relaxed);
+        if (start) {
+            hist.record(now_ns() - start);
+        }
+    }
+
+private:
+    std::atomic<uint64_t> _time_ns;
+};
+
+}} // namespace uhd::latency
+
+/*! Latency recording hooks
+ *
+ * These macros compile to nothing unless UHD_LATENCY_HISTOGRAMS is defined
+ * (CMake option ENABLE_LATENCY_HISTOGRAMS). The \p name argument must be a
+ * string literal; the histogram lookup happens once per call site.
+ *
+ * - UHD_LATENCY_START(var): Store the current time in a new local variable
+ * - UHD_LATENCY_RECORD(name, var): Record the time elapsed since
+ *   UHD_LATENCY_START(var)
+ * - UHD_LATENCY_MARK_MEMBER(mark): Declare a mark as a class member
+ * - UHD_LATENCY_MARK_SET(mark): Set a mark to the current time
+ * - UHD_LATENCY_MARK_RECORD(name, mark): Record the time elapsed since the mark
+ *   was set, and clear it. Does nothing if the mark is not set.
+ */
+#ifdef UHD_LATENCY_HISTOGRAMS
+#    define UHD_LATENCY_START(var) const uint64_t var = uhd::latency::now_ns()
+#    define UHD_LATENCY_RECORD(name, var)                                        \
+        do {                                                                     \
+            static uhd::latency::histogram& _uhd_latency_hist =                  \
+                uhd::latency::get_histogram(name);                               \
+            _uhd_latency_hist.record(uhd::latency::now_ns() - var);              \
+        } while (0)
+#    define UHD_LATENCY_MARK_MEMBER(mark) uhd::latency::mark_t mark
+#    define UHD_LATENCY_MARK_SET(mark) (mark).set()
+#    define UHD_LATENCY_MARK_RECORD(name, mark)                                  \
+        do {                                                                     \
+            static uhd::latency::histogram& _uhd_latency_hist =                  \
+                uhd::latency::get_histogram(name);                               \
+            (mark).record_and_clear(_uhd_latency_hist);                          \
+        } while (0)
+#else
+#    define UHD_LATENCY_START(var) \
+        do {                       \
+        } while (0)
+#    define UHD_LATENCY_RECORD(name, var) \
+        do {                              \
+        } while (0)
+#    define UHD_LATENCY_MARK_MEMBER(mark) static_assert(true, "")
+#    define UHD_LATENCY_MARK_SET(mark) \
+        do {                           \
+        } while (0)
+#    define UHD_LATENCY_MARK_RECORD(name, mark) \
+        do {                                    \
+        } while (0)
+#endif /* UHD_LATENCY_HISTOGRAMS */
+
+#endif /* INCLUDED_UHDLIB_UTILS_LATENCY_HISTOGRAM_HPP */
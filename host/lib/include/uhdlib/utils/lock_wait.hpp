@@ -0,0 +1,96 @@
+//
+// Copyright 2019 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#ifndef INCLUDED_UHDLIB_UTILS_LOCK_WAIT_HPP
+#define INCLUDED_UHDLIB_UTILS_LOCK_WAIT_HPP
+
+#include <uhd/config.hpp>
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <thread>
+
+namespace uhd {
+
+//! The time wait_for_lock() waits before polling a second time (in seconds)
+constexpr double LOCK_WAIT_FIRST_INTERVAL = 10e-6;
+//! The default for the longest time between two polls (in seconds)
+constexpr double LOCK_WAIT_MAX_INTERVAL = 1e-3;
+
+/*! Record the time a driver spent waiting for a lock
+ *
+ * The wait is added to the trace as a span of category "lock" (see
+ * uhdlib/utils/trace.hpp), and to the latency histogram "lock/<name>" if UHD
+ * was built with ENABLE_LATENCY_HISTOGRAMS.
+ */
+UHD_API void record_lock_wait(const std::string& name,
+    const std::chrono::steady_clock::time_point start,
+    const std::chrono::steady_clock::time_point end,
+    const bool locked);
+
+/*! Wait for a PLL to lock, or for a calibration to finish
+ *
+ * Polls \p is_locked with exponential back-off: The second poll happens
+ * LOCK_WAIT_FIRST_INTERVAL after the first one, and the interval doubles up to
+ * \p max_interval. PLLs typically lock within microseconds, so this returns
+ * much earlier than polling at a fixed interval of milliseconds, and long
+ * waits still don't flood the bus with reads.
+ *
+ * Lock detect bits which may still show the lock to the previous frequency
+ * for a while after retuning need a \p settle_time before the first poll.
+ *
+ * \code{.cpp}
+ * if (not wait_for_lock("x300::lmk", [&]() { return lmk_locked(); }, 1.0)) {
+ *     throw uhd::runtime_error("LMK failed to lock");
+ * }
+ * \endcode
+ *
+ * \param name The name of the lock, which the wait is recorded under
+ * \param is_locked Returns true when locked. It's called once more after the
+ *                  timeout expired.
+ * \param timeout How long to wait for the lock (in seconds)
+ * \param max_interval The longest time between two polls (in seconds)
+ * \param settle_time How long to wait before the first poll (in seconds). It
+ *                    counts towards \p timeout.
+ * \return true if \p is_locked returned true before the timeout
+ */
+template <typename lock_fn_t>
+bool wait_for_lock(const std::string& name,
+    lock_fn_t&& is_locked,
+    const double timeout,
+    const double max_interval = LOCK_WAIT_MAX_INTERVAL,
+    const double settle_time  = 0.0)
+{
+    typedef std::chrono::steady_clock clock;
+    const auto to_duration = [](const double seconds) {
+        return std::chrono::duration_cast<clock::duration>(
+            std::chrono::duration<double>(seconds));
+    };
+    const auto start    = clock::now();
+    const auto deadline = start + to_duration(timeout);
+    const auto max_wait = to_duration(std::max(max_interval, LOCK_WAIT_FIRST_INTERVAL));
+    auto wait           = to_duration(LOCK_WAIT_FIRST_INTERVAL);
+
+    if (settle_time > 0.0) {
+        std::this_thread::sleep_for(to_duration(std::min(settle_time, timeout)));
+    }
+    bool locked = is_locked();
+    while (not locked) {
+        const auto now = clock::now();
+        if (now >= deadline) {
+            break;
+        }
+        std::this_thread::sleep_for(std::min<clock::duration>(wait, deadline - now));
+        wait   = std::min<clock::duration>(wait * 2, max_wait);
+        locked = is_locked();
+    }
+    record_lock_wait(name, start, clock::now(), locked);
+    return locked;
+}
+
+} // namespace uhd
+
+#endif /* INCLUDED_UHDLIB_UTILS_LOCK_WAIT_HPP */
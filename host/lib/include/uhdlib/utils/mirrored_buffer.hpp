@@ -0,0 +1,49 @@
+//
+// Copyright 2019 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#ifndef INCLUDED_UHDLIB_UTILS_MIRRORED_BUFFER_HPP
+#define INCLUDED_UHDLIB_UTILS_MIRRORED_BUFFER_HPP
+
+#include <uhd/utils/noncopyable.hpp>
+#include <memory>
+
+namespace uhd {
+
+/*! A circular buffer whose memory is mapped twice, back to back
+ *
+ * For any offset i in [0, size()), data()[i] and data()[i + size()] refer to
+ * the same byte. Hence, any range of up to size() bytes starting within the
+ * first mapping is contiguous in memory, and never needs to be split at the
+ * wrap-around point.
+ */
+class mirrored_buffer : uhd::noncopyable
+{
+public:
+    typedef std::unique_ptr<mirrored_buffer> uptr;
+
+    virtual ~mirrored_buffer(void) {}
+
+    /*! Allocate a new mirrored buffer
+     *
+     * \param min_size Minimum size in bytes. The actual size is rounded up to
+     *                 a multiple of both the page size and \p granularity.
+     * \param granularity The size must be a multiple of this value (e.g., the
+     *                    size of one item stored in the buffer).
+     * \throws uhd::not_implemented_error if the platform does not support
+     *         mirrored mappings, or uhd::os_error if the mapping fails.
+     */
+    static uptr make(const size_t min_size, const size_t granularity = 1);
+
+    //! Base address of the first mapping
+    virtual void* data(void) = 0;
+
+    //! Size of one mapping in bytes
+    virtual size_t size(void) const = 0;
+};
+
+} /* namespace uhd */
+
+#endif /* INCLUDED_UHDLIB_UTILS_MIRRORED_BUFFER_HPP */
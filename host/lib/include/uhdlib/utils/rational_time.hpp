@@ -0,0 +1,179 @@
+//
+// Copyright 2019 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#ifndef INCLUDED_UHDLIB_UTILS_RATIONAL_TIME_HPP
+#define INCLUDED_UHDLIB_UTILS_RATIONAL_TIME_HPP
+
+#include <uhd/config.hpp>
+#include <uhd/types/time_spec.hpp>
+#include <cmath>
+#include <cstdint>
+
+namespace uhd {
+
+/*! Exact conversions between samples, ticks and time specs
+ *
+ * The tick rate is held as an integer number of ticks per second, and the
+ * ratio of tick rate to sample rate as a reduced fraction num / den of ticks
+ * per sample. With these, sample counts map onto ticks by integer
+ * multiplication (and a shift or division when the decimation is not an
+ * integer), so timestamps derived from a sample count do not drift over long
+ * streams the way the sums of double sample periods do.
+ *
+ * Rates which can't be represented like this (a fractional tick rate, or a
+ * ratio which needs a denominator above MAX_DENOMINATOR) fall back to the
+ * double conversions of uhd::time_spec_t; see is_exact().
+ */
+class UHD_API rational_time_model
+{
+public:
+    //! The largest denominator of the ticks-per-sample ratio
+    static constexpr int64_t MAX_DENOMINATOR = 1 << 20;
+
+    rational_time_model(const double tick_rate = 1.0, const double samp_rate = 1.0);
+
+    //! Set both rates; the ratio is recomputed
+    void set_rates(const double tick_rate, const double samp_rate);
+
+    void set_tick_rate(const double tick_rate)
+    {
+        set_rates(tick_rate, _samp_rate);
+    }
+
+    void set_samp_rate(const double samp_rate)
+    {
+        set_rates(_tick_rate, samp_rate);
+    }
+
+    double get_tick_rate(void) const
+    {
+        return _tick_rate;
+    }
+
+    double get_samp_rate(void) const
+    {
+        return _samp_rate;
+    }
+
+    //! True if the rates are represented exactly by integers
+    bool is_exact(void) const
+    {
+        return _exact;
+    }
+
+    //! Numerator of the ticks-per-sample ratio
+    int64_t get_ticks_per_samp_num(void) const
+    {
+        return _num;
+    }
+
+    //! Denominator of the ticks-per-sample ratio
+    int64_t get_ticks_per_samp_den(void) const
+    {
+        return _den;
+    }
+
+    //! Number of ticks spanned by \p nsamps samples, rounded to the closest tick
+    int64_t samps_to_ticks(const int64_t nsamps) const
+    {
+        if (not _exact) {
+            return time_spec_t::from_ticks(nsamps, _samp_rate).to_ticks(_tick_rate);
+        }
+        int64_t ticks, remainder;
+        split_samps(nsamps, ticks, remainder);
+        return ticks + ((2 * remainder >= _den) ? 1 : 0);
+    }
+
+    //! Number of whole samples within \p nticks ticks
+    int64_t ticks_to_samps(const int64_t nticks) const
+    {
+        if (not _exact) {
+            return time_spec_t::from_ticks(nticks, _tick_rate).to_ticks(_samp_rate);
+        }
+        // Split off whole periods of num first, so nticks * den can't overflow
+        const int64_t q = floor_div(nticks, _num);
+        return q * _den + ((nticks - q * _num) * _den) / _num;
+    }
+
+    //! The time of a tick count
+    time_spec_t ticks_to_time(const int64_t ticks) const
+    {
+        if (not _exact) {
+            return time_spec_t::from_ticks(ticks, _tick_rate);
+        }
+        const int64_t full_secs = floor_div(ticks, _ticks_per_sec);
+        return time_spec_t(
+            full_secs, double(ticks - full_secs * _ticks_per_sec) / _tick_rate);
+    }
+
+    //! The duration of \p nsamps samples, without rounding to ticks
+    time_spec_t samps_to_time(const int64_t nsamps) const
+    {
+        if (not _exact) {
+            return time_spec_t::from_ticks(nsamps, _samp_rate);
+        }
+        int64_t ticks, remainder;
+        split_samps(nsamps, ticks, remainder);
+        const int64_t full_secs = floor_div(ticks, _ticks_per_sec);
+        const double frac_ticks =
+            double(ticks - full_secs * _ticks_per_sec) + double(remainder) / _den;
+        return time_spec_t(full_secs, frac_ticks / _tick_rate);
+    }
+
+    //! The tick count of a time, rounded to the closest tick
+    int64_t time_to_ticks(const time_spec_t& time) const
+    {
+        if (not _exact) {
+            return time.to_ticks(_tick_rate);
+        }
+        return time.get_full_secs() * _ticks_per_sec
+               + int64_t(std::floor(time.get_frac_secs() * _tick_rate + 0.5));
+    }
+
+private:
+    static int64_t floor_div(const int64_t a, const int64_t b)
+    {
+        const int64_t q = a / b;
+        return (q * b > a) ? q - 1 : q;
+    }
+
+    //! Split nsamps * num / den into whole ticks and a remainder (in 1/den)
+    void split_samps(const int64_t nsamps, int64_t& ticks, int64_t& remainder) const
+    {
+        if (_den_shift >= 0) {
+            // Integer decimation (den == 1) or a power of two: no division
+            const int64_t q = nsamps >> _den_shift;
+            const int64_t r = nsamps & (_den - 1);
+            const int64_t t = r * _num;
+            ticks           = q * _num + (t >> _den_shift);
+            remainder       = t & (_den - 1);
+        } else {
+            // Split off whole periods of den first, so nsamps * num can't overflow
+            int64_t q = nsamps / _den;
+            int64_t r = nsamps % _den;
+            if (r < 0) {
+                q -= 1;
+                r += _den;
+            }
+            const int64_t t = r * _num;
+            ticks           = q * _num + t / _den;
+            remainder       = t % _den;
+        }
+    }
+
+    double _tick_rate;
+    double _samp_rate;
+    bool _exact;
+    int64_t _ticks_per_sec;
+    int64_t _num;
+    int64_t _den;
+    //! log2(_den) if _den is a power of two, -1 otherwise
+    int _den_shift;
+};
+
+} /* namespace uhd */
+
+#endif /* INCLUDED_UHDLIB_UTILS_RATIONAL_TIME_HPP */
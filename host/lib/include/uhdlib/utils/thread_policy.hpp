@@ -0,0 +1,97 @@
+//
+// Copyright 2019 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#ifndef INCLUDED_LIBUHD_UTILS_THREAD_POLICY_HPP
+#define INCLUDED_LIBUHD_UTILS_THREAD_POLICY_HPP
+
+#include <uhd/types/device_addr.hpp>
+#include <string>
+#include <vector>
+
+namespace uhd { namespace thread_policy {
+
+/*! Names of the thread classes UHD spawns internally
+ *
+ * These are the keys used to look up placement settings. Threads spawned
+ * through uhd::task use the task name as their class; unnamed tasks only
+ * get the default settings.
+ */
+static constexpr char LOG[]          = "uhd_log";
+static constexpr char LOG_FASTPATH[] = "uhd_log_fastpth";
+static constexpr char RECV_OFFLOAD[] = "zero_copy_recv";
+static constexpr char MUXED_XPORT[]  = "muxed_0copy_if";
+static constexpr char ASYNC_MSG[]    = "async_msg";
+static constexpr char TX_ASYNC[]     = "tx_async_msgs";
+static constexpr char CLAIMER[]      = "claimer";
+static constexpr char USB_EVENTS[]   = "usb_events";
+static constexpr char CHANNELIZER[]  = "uhd_channelizer";
+//! Settings in this class apply to all threads without specific settings
+static constexpr char DEFAULT[] = "default";
+
+//! Scheduling policy for a thread class
+enum class sched_t {
+    //! Don't touch the scheduling policy or priority
+    UNCHANGED,
+    //! Regular, non-realtime scheduling
+    OTHER,
+    //! Realtime, round-robin
+    RR,
+    //! Realtime, first-in first-out
+    FIFO
+};
+
+//! Placement settings for one thread class
+struct placement_t
+{
+    //! CPUs the thread may run on. Empty means don't touch the affinity.
+    std::vector<size_t> cpus;
+    sched_t sched  = sched_t::UNCHANGED;
+    float priority = 0.0;
+
+    bool empty() const
+    {
+        return cpus.empty() and sched == sched_t::UNCHANGED;
+    }
+};
+
+/*! Parse a CPU list
+ *
+ * Entries are separated by commas, colons or semicolons (colons make it
+ * possible to pass CPU lists through device args), and may be ranges, e.g.
+ * "2,3,6-8" or "2:3:6-8".
+ *
+ * \throws uhd::value_error on invalid input
+ */
+std::vector<size_t> parse_cpu_list(const std::string& cpu_list);
+
+/*! Update the process-wide placement settings from device args
+ *
+ * Recognized keys are `thread_<class>_cpus`, `thread_<class>_sched` and
+ * `thread_<class>_priority`, e.g. `thread_zero_copy_recv_cpus=4:5`. Settings
+ * from device args take precedence over settings from config files, and
+ * apply to all threads created after this call.
+ */
+void update_from_args(const uhd::device_addr_t& args);
+
+/*! Return the placement settings for a thread class
+ *
+ * Settings are read from the `[thread=<class>]` sections of the UHD config
+ * files, the `[thread=default]` section fills in anything a class does not
+ * specify. Finally, anything set through update_from_args() is applied.
+ */
+placement_t get_placement(const std::string& thread_class);
+
+/*! Apply the placement settings of a thread class to the calling thread
+ *
+ * This is meant to be called first thing inside a newly spawned thread. It
+ * does not throw: failures are logged, and the thread runs with whatever
+ * placement it inherited.
+ */
+void apply(const std::string& thread_class);
+
+}} /* namespace uhd::thread_policy */
+
+#endif /* INCLUDED_LIBUHD_UTILS_THREAD_POLICY_HPP */
@@ -0,0 +1,84 @@
+//
+// Copyright 2019 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#ifndef INCLUDED_UHDLIB_UTILS_TRACE_HPP
+#define INCLUDED_UHDLIB_UTILS_TRACE_HPP
+
+#include <uhd/config.hpp>
+#include <chrono>
+#include <string>
+
+namespace uhd { namespace trace {
+
+/*! True if spans are recorded
+ *
+ * Tracing is enabled by setting the environment variable UHD_TRACE_FILE to
+ * the path of the file to write. It is read once, on the first call.
+ */
+UHD_API bool is_enabled(void);
+
+//! Record a span on the calling thread; ignored unless tracing is enabled
+UHD_API void add_span(const std::string& name,
+    const char* category,
+    const std::chrono::steady_clock::time_point start,
+    const std::chrono::steady_clock::time_point end);
+
+/*! Write all spans recorded so far to UHD_TRACE_FILE
+ *
+ * The file is in the Chrome trace event format, which chrome://tracing and
+ * Perfetto (ui.perfetto.dev) load. It is rewritten on every call, so the
+ * file always holds the complete trace. This is called after every
+ * uhd::device::make(), and at exit.
+ */
+UHD_API void write_file(void);
+
+/*! Records a span from its construction to its destruction
+ *
+ * When tracing is disabled, this only costs a check of a flag.
+ */
+class scoped_span
+{
+public:
+    scoped_span(const std::string& name, const char* category = "init")
+        : _enabled(is_enabled())
+    {
+        if (_enabled) {
+            _name     = name;
+            _category = category;
+            _start    = std::chrono::steady_clock::now();
+        }
+    }
+
+    ~scoped_span()
+    {
+        if (_enabled) {
+            add_span(_name, _category, _start, std::chrono::steady_clock::now());
+        }
+    }
+
+private:
+    scoped_span(const scoped_span&) = delete;
+    scoped_span& operator=(const scoped_span&) = delete;
+
+    const bool _enabled;
+    std::string _name;
+    const char* _category = nullptr;
+    std::chrono::steady_clock::time_point _start;
+};
+
+}} // namespace uhd::trace
+
+#define UHD_TRACE_CONCAT_(a, b) a##b
+#define UHD_TRACE_CONCAT(a, b) UHD_TRACE_CONCAT_(a, b)
+
+/*! Trace the rest of the enclosing scope as a span called \p name
+ *
+ * \param name A string describing the phase, e.g. "x300::setup_mb"
+ */
+#define UHD_TRACE_SCOPE(name) \
+    uhd::trace::scoped_span UHD_TRACE_CONCAT(_uhd_trace_span_, __COUNTER__)(name)
+
+#endif /* INCLUDED_UHDLIB_UTILS_TRACE_HPP */
@@ -12,6 +12,7 @@
 #include <uhd/utils/log.hpp>
 #include <uhd/utils/tasks.hpp>
 #include <uhdlib/rfnoc/async_msg_handler.hpp>
+#include <uhdlib/utils/thread_policy.hpp>
 #include <boost/make_shared.hpp>
 #include <mutex>
 
@@ -36,7 +37,8 @@ public:
         : _rx_xport(recv), _tx_xport(send), _sid(sid)
     {
         // Launch receive thread
-        _recv_msg_task = task::make([=]() { this->handle_async_msgs(); });
+        _recv_msg_task = task::make(
+            [=]() { this->handle_async_msgs(); }, uhd::thread_policy::ASYNC_MSG);
     }
 
     ~async_msg_handler_impl() {}
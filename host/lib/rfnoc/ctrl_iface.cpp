@@ -14,6 +14,7 @@
 #include <uhd/utils/byteswap.hpp>
 #include <uhd/utils/safe_call.hpp>
 #include <uhdlib/rfnoc/ctrl_iface.hpp>
+#include <uhdlib/utils/latency_histogram.hpp>
 #include <boost/bind.hpp>
 #include <boost/format.hpp>
 #include <boost/make_shared.hpp>
@@ -61,9 +62,18 @@ public:
         const uint64_t timestamp = 0)
     {
         boost::mutex::scoped_lock lock(_mutex);
+        UHD_LATENCY_START(start_time);
         this->send_pkt(addr, data, timestamp);
-        return this->wait_for_ack(
+        const uint64_t result = this->wait_for_ack(
             readback, bool(timestamp != 0) ? MASSIVE_TIMEOUT : ACK_TIMEOUT);
+        if (readback) {
+            UHD_LATENCY_RECORD("ctrl_peek", start_time);
+        } else if (timestamp != 0) {
+            UHD_LATENCY_RECORD("ctrl_timed_cmd", start_time);
+        } else {
+            UHD_LATENCY_RECORD("ctrl_poke", start_time);
+        }
+        return result;
     }
 
     void set_cmd_fifo_size(const size_t num_lines)
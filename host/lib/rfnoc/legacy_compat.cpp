@@ -19,6 +19,7 @@
 #include <uhd/usrp/subdev_spec.hpp>
 #include <uhd/utils/log.hpp>
 #include <uhdlib/rfnoc/legacy_compat.hpp>
+#include <uhdlib/utils/trace.hpp>
 #include <boost/make_shared.hpp>
 #include <set>
 
@@ -1160,6 +1161,7 @@ legacy_compat::sptr legacy_compat::make(
     uhd::device3::sptr device, const uhd::device_addr_t& args)
 {
     boost::lock_guard<boost::mutex> lock(_make_mutex);
+    UHD_TRACE_SCOPE("legacy_compat::make");
     UHD_ASSERT_THROW(bool(device));
     static std::map<void*, boost::weak_ptr<legacy_compat>> legacy_cache;
 
@@ -12,6 +12,7 @@
 #include <uhd/utils/log.hpp>
 #include <uhdlib/rfnoc/radio_ctrl_impl.hpp>
 #include <uhdlib/rfnoc/wb_iface_adapter.hpp>
+#include <uhdlib/utils/latency_histogram.hpp>
 #include <boost/format.hpp>
 #include <tuple>
 
@@ -347,6 +348,7 @@ void radio_ctrl_impl::enable_rx_timestamps(const bool enable, const size_t chan)
 void radio_ctrl_impl::issue_stream_cmd(
     const uhd::stream_cmd_t& stream_cmd, const size_t chan)
 {
+    UHD_LATENCY_START(cmd_start);
     std::lock_guard<std::mutex> lock(_mutex);
     UHD_RFNOC_BLOCK_TRACE() << "radio_ctrl_impl::issue_stream_cmd() " << chan << " "
                             << char(stream_cmd.stream_mode);
@@ -401,6 +403,7 @@ void radio_ctrl_impl::issue_stream_cmd(
     sr_write(regs::RX_CTRL_CMD, cmd_word, chan);
     sr_write(regs::RX_CTRL_TIME_HI, uint32_t(ticks >> 32), chan);
     sr_write(regs::RX_CTRL_TIME_LO, uint32_t(ticks >> 0), chan); // latches the command
+    UHD_LATENCY_RECORD("radio_stream_cmd", cmd_start);
 }
 
 std::vector<size_t> radio_ctrl_impl::get_active_rx_ports()
@@ -0,0 +1,248 @@
+//
+// Copyright 2019 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include <uhd/convert.hpp>
+#include <uhd/exception.hpp>
+#include <uhd/rx_sample_ring.hpp>
+#include <uhdlib/utils/mirrored_buffer.hpp>
+#include <boost/format.hpp>
+#include <atomic>
+#include <cmath>
+#include <deque>
+#include <mutex>
+
+using namespace uhd;
+
+rx_sample_ring::~rx_sample_ring(void)
+{
+    /* NOP */
+}
+
+namespace {
+
+class rx_sample_ring_impl : public rx_sample_ring
+{
+public:
+    rx_sample_ring_impl(rx_streamer::sptr rx_stream,
+        const std::string& cpu_format,
+        const size_t capacity,
+        const double samp_rate)
+        : _rx_stream(rx_stream)
+        , _bytes_per_item(convert::get_bytes_per_item(cpu_format))
+        , _max_num_samps(rx_stream->get_max_num_samps())
+        , _samp_rate(samp_rate)
+        , _write_index(0)
+        , _guard_index(0)
+    {
+        if (samp_rate <= 0.0) {
+            throw uhd::value_error("rx_sample_ring: Invalid sample rate");
+        }
+        for (size_t chan = 0; chan < rx_stream->get_num_channels(); chan++) {
+            _buffers.push_back(
+                mirrored_buffer::make(capacity * _bytes_per_item, _bytes_per_item));
+        }
+        _capacity = _buffers.front()->size() / _bytes_per_item;
+        if (_capacity < _max_num_samps) {
+            throw uhd::value_error(
+                str(boost::format("rx_sample_ring: Capacity must be at least %d "
+                                  "samples (one packet)")
+                    % _max_num_samps));
+        }
+        _recv_buffs.resize(_buffers.size());
+    }
+
+    size_t get_capacity(void) const
+    {
+        return _capacity;
+    }
+
+    size_t get_num_channels(void) const
+    {
+        return _buffers.size();
+    }
+
+    size_t recv(rx_metadata_t& metadata, const double timeout)
+    {
+        const uint64_t write_index = _write_index.load(std::memory_order_relaxed);
+        const size_t offset        = get_offset(write_index);
+        for (size_t chan = 0; chan < _buffers.size(); chan++) {
+            _recv_buffs[chan] = static_cast<char*>(_buffers[chan]->data()) + offset;
+        }
+
+        // Announce the samples we're about to overwrite before touching them.
+        // Because the buffers are mirrored, a full packet never wraps.
+        _guard_index.store(write_index + _max_num_samps);
+        const size_t nsamps =
+            _rx_stream->recv(_recv_buffs, _max_num_samps, metadata, timeout, true);
+
+        if (nsamps and metadata.has_time_spec) {
+            add_timestamp(write_index, metadata.time_spec);
+        }
+        _write_index.store(write_index + nsamps, std::memory_order_release);
+        _guard_index.store(write_index + nsamps, std::memory_order_release);
+        return nsamps;
+    }
+
+    uint64_t get_write_index(void) const
+    {
+        return _write_index.load(std::memory_order_acquire);
+    }
+
+    uint64_t get_oldest_index(void) const
+    {
+        const uint64_t guard_index = _guard_index.load(std::memory_order_acquire);
+        return guard_index > _capacity ? guard_index - _capacity : 0;
+    }
+
+    time_spec_t get_time_spec(const uint64_t index) const
+    {
+        time_spec_t time_spec;
+        if (index < get_oldest_index() or index >= get_write_index()) {
+            throw uhd::value_error(str(
+                boost::format("rx_sample_ring: Sample %d is not in the ring") % index));
+        }
+        if (not lookup_time_spec(index, time_spec)) {
+            throw uhd::value_error(str(
+                boost::format("rx_sample_ring: No timestamp known for sample %d")
+                % index));
+        }
+        return time_spec;
+    }
+
+    read_status_t get_window(
+        const uint64_t start_index, const size_t nsamps, window_t& window) const
+    {
+        if (nsamps > _capacity) {
+            throw uhd::value_error(
+                "rx_sample_ring: Requested window exceeds the ring capacity");
+        }
+        if (start_index + nsamps > get_write_index()) {
+            return READ_NOT_AVAILABLE;
+        }
+        if (start_index < get_oldest_index()) {
+            return READ_OVERWRITTEN;
+        }
+        const size_t offset = get_offset(start_index);
+        window.buffs.resize(_buffers.size());
+        for (size_t chan = 0; chan < _buffers.size(); chan++) {
+            window.buffs[chan] = static_cast<const char*>(_buffers[chan]->data()) + offset;
+        }
+        window.start_index   = start_index;
+        window.nsamps        = nsamps;
+        window.has_time_spec = lookup_time_spec(start_index, window.time_spec);
+        return READ_OK;
+    }
+
+    read_status_t get_window(
+        const time_spec_t& start_time, const size_t nsamps, window_t& window) const
+    {
+        uint64_t start_index = 0;
+        {
+            std::lock_guard<std::mutex> l(_timestamps_mutex);
+            if (_timestamps.empty()) {
+                return READ_NOT_AVAILABLE;
+            }
+            if (start_time < _timestamps.front().time_spec) {
+                return READ_OVERWRITTEN;
+            }
+            // Find the last contiguous segment that starts before start_time
+            auto it = _timestamps.end();
+            do {
+                --it;
+            } while (start_time < it->time_spec);
+            const auto next = std::next(it);
+            start_index =
+                it->index + uint64_t((start_time - it->time_spec).to_ticks(_samp_rate));
+            // start_time falls into a gap (e.g., after an overrun)
+            if (next != _timestamps.end() and start_index > next->index) {
+                start_index = next->index;
+            }
+        }
+        return get_window(start_index, nsamps, window);
+    }
+
+    bool is_overwritten(const window_t& window) const
+    {
+        // Make sure the reads from the window happen before checking the guard
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return window.start_index < get_oldest_index();
+    }
+
+private:
+    //! The timestamp of the first sample of a contiguous segment
+    struct timestamp_t
+    {
+        uint64_t index;
+        time_spec_t time_spec;
+    };
+
+    size_t get_offset(const uint64_t index) const
+    {
+        return size_t(index % _capacity) * _bytes_per_item;
+    }
+
+    //! Store the timestamp for a new packet, unless it continues the last segment
+    void add_timestamp(const uint64_t index, const time_spec_t& time_spec)
+    {
+        std::lock_guard<std::mutex> l(_timestamps_mutex);
+        if (not _timestamps.empty()) {
+            const timestamp_t& last = _timestamps.back();
+            const time_spec_t expected_time =
+                last.time_spec + time_spec_t::from_ticks(index - last.index, _samp_rate);
+            if (std::abs((time_spec - expected_time).get_real_secs())
+                < 0.5 / _samp_rate) {
+                return;
+            }
+        }
+        _timestamps.push_back({index, time_spec});
+        // Drop segments which have been overwritten entirely
+        const uint64_t oldest_index = index + _max_num_samps > _capacity
+                                          ? index + _max_num_samps - _capacity
+                                          : 0;
+        while (_timestamps.size() > 1 and _timestamps[1].index <= oldest_index) {
+            _timestamps.pop_front();
+        }
+    }
+
+    bool lookup_time_spec(const uint64_t index, time_spec_t& time_spec) const
+    {
+        std::lock_guard<std::mutex> l(_timestamps_mutex);
+        for (auto it = _timestamps.rbegin(); it != _timestamps.rend(); ++it) {
+            if (it->index <= index) {
+                time_spec =
+                    it->time_spec + time_spec_t::from_ticks(index - it->index, _samp_rate);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    rx_streamer::sptr _rx_stream;
+    const size_t _bytes_per_item;
+    const size_t _max_num_samps;
+    const double _samp_rate;
+    size_t _capacity;
+    std::vector<mirrored_buffer::uptr> _buffers;
+    std::vector<void*> _recv_buffs;
+
+    //! Index of the next sample to be written
+    std::atomic<uint64_t> _write_index;
+    //! All samples below (_guard_index - _capacity) may have been overwritten
+    std::atomic<uint64_t> _guard_index;
+
+    mutable std::mutex _timestamps_mutex;
+    std::deque<timestamp_t> _timestamps;
+};
+
+} // namespace
+
+rx_sample_ring::sptr rx_sample_ring::make(rx_streamer::sptr rx_stream,
+    const std::string& cpu_format,
+    const size_t capacity,
+    const double samp_rate)
+{
+    return sptr(new rx_sample_ring_impl(rx_stream, cpu_format, capacity, samp_rate));
+}
@@ -0,0 +1,182 @@
+//
+// Copyright 2019 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include <uhd/exception.hpp>
+#include <uhd/rx_squelch.hpp>
+#include <uhdlib/transport/squelch_gate.hpp>
+#include <atomic>
+#include <cmath>
+#include <deque>
+#include <mutex>
+
+using namespace uhd;
+
+rx_squelch::~rx_squelch(void)
+{
+    /* NOP */
+}
+
+namespace {
+
+constexpr size_t MAX_PRE_PACKETS = 64;
+//! Power of a full-scale complex tone, in sc16 units
+constexpr double FULL_SCALE_POWER = 32767.0 * 32767.0;
+
+float dbfs_to_power(const double dbfs)
+{
+    return float(FULL_SCALE_POWER * std::pow(10.0, dbfs / 10.0));
+}
+
+class rx_squelch_impl : public rx_squelch, public uhd::transport::squelch_gate
+{
+public:
+    rx_squelch_impl(const double threshold_dbfs,
+        const double hysteresis_db,
+        const size_t pre_packets,
+        const size_t post_packets,
+        const mode_t mode,
+        const size_t max_summaries)
+        : _hysteresis_db(hysteresis_db)
+        , _pre_packets(pre_packets)
+        , _post_packets(post_packets)
+        , _mode(mode)
+        , _max_summaries(max_summaries)
+    {
+        if (not(hysteresis_db >= 0.0)) {
+            throw uhd::value_error("rx_squelch: The hysteresis can't be negative");
+        }
+        if (pre_packets > MAX_PRE_PACKETS) {
+            throw uhd::value_error("rx_squelch: Too many pre-trigger packets");
+        }
+        if (post_packets == 0) {
+            throw uhd::value_error("rx_squelch: At least one post-trigger packet is "
+                                   "required to end the burst");
+        }
+        set_threshold(threshold_dbfs);
+    }
+
+    /*******************************************************************
+     * User API
+     ******************************************************************/
+    void set_threshold(const double threshold_dbfs)
+    {
+        if (std::isnan(threshold_dbfs)) {
+            throw uhd::value_error("rx_squelch: Invalid threshold");
+        }
+        std::lock_guard<std::mutex> lock(_threshold_mutex);
+        _threshold_dbfs = threshold_dbfs;
+        _close_level.store(
+            dbfs_to_power(threshold_dbfs - _hysteresis_db), std::memory_order_relaxed);
+        _open_level.store(dbfs_to_power(threshold_dbfs), std::memory_order_relaxed);
+    }
+
+    double get_threshold(void) const
+    {
+        std::lock_guard<std::mutex> lock(_threshold_mutex);
+        return _threshold_dbfs;
+    }
+
+    std::vector<summary_t> get_summaries(void)
+    {
+        std::lock_guard<std::mutex> lock(_summaries_mutex);
+        std::vector<summary_t> summaries(_summaries.begin(), _summaries.end());
+        _summaries.clear();
+        return summaries;
+    }
+
+    stats_t get_stats(void) const
+    {
+        stats_t stats;
+        stats.num_packets_passed = _num_packets_passed.load(std::memory_order_relaxed);
+        stats.num_packets_gated  = _num_packets_gated.load(std::memory_order_relaxed);
+        stats.num_bursts         = _num_bursts.load(std::memory_order_relaxed);
+        stats.num_summaries_lost = _num_summaries_lost.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    /*******************************************************************
+     * Streamer interface
+     ******************************************************************/
+    float get_open_level(void) const
+    {
+        return _open_level.load(std::memory_order_relaxed);
+    }
+
+    float get_close_level(void) const
+    {
+        return _close_level.load(std::memory_order_relaxed);
+    }
+
+    size_t get_pre_packets(void) const
+    {
+        return _pre_packets;
+    }
+
+    size_t get_post_packets(void) const
+    {
+        return _post_packets;
+    }
+
+    void packet_passed(const bool start_of_burst)
+    {
+        _num_packets_passed.fetch_add(1, std::memory_order_relaxed);
+        if (start_of_burst) {
+            _num_bursts.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    void packet_gated(const rx_metadata_t& metadata, const size_t nsamps, const float power)
+    {
+        _num_packets_gated.fetch_add(1, std::memory_order_relaxed);
+        if (_mode != MODE_SUMMARIZE) {
+            return;
+        }
+        summary_t summary;
+        summary.has_time_spec = metadata.has_time_spec;
+        summary.time_spec     = metadata.time_spec;
+        summary.nsamps        = nsamps;
+        summary.power_dbfs    = float(10.0 * std::log10(power / FULL_SCALE_POWER));
+        std::lock_guard<std::mutex> lock(_summaries_mutex);
+        if (_summaries.size() >= _max_summaries) {
+            _summaries.pop_front();
+            _num_summaries_lost.fetch_add(1, std::memory_order_relaxed);
+        }
+        _summaries.push_back(summary);
+    }
+
+private:
+    const double _hysteresis_db;
+    const size_t _pre_packets;
+    const size_t _post_packets;
+    const mode_t _mode;
+    const size_t _max_summaries;
+
+    mutable std::mutex _threshold_mutex;
+    double _threshold_dbfs;
+    std::atomic<float> _open_level{0.0f};
+    std::atomic<float> _close_level{0.0f};
+
+    std::mutex _summaries_mutex;
+    std::deque<summary_t> _summaries;
+
+    std::atomic<uint64_t> _num_packets_passed{0};
+    std::atomic<uint64_t> _num_packets_gated{0};
+    std::atomic<uint64_t> _num_bursts{0};
+    std::atomic<uint64_t> _num_summaries_lost{0};
+};
+
+} // namespace
+
+rx_squelch::sptr rx_squelch::make(const double threshold_dbfs,
+    const double hysteresis_db,
+    const size_t pre_packets,
+    const size_t post_packets,
+    const mode_t mode,
+    const size_t max_summaries)
+{
+    return sptr(new rx_squelch_impl(
+        threshold_dbfs, hysteresis_db, pre_packets, post_packets, mode, max_summaries));
+}
@@ -0,0 +1,678 @@
+//
+// Copyright 2019 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include <uhd/convert.hpp>
+#include <uhd/exception.hpp>
+#include <uhd/shm_stream.hpp>
+#include <boost/format.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/interprocess/shared_memory_object.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+using namespace uhd;
+namespace ipc = boost::interprocess;
+
+shm_rx_source::~shm_rx_source(void)
+{
+    /* NOP */
+}
+
+shm_rx_client::~shm_rx_client(void)
+{
+    /* NOP */
+}
+
+shm_tx_sink::~shm_tx_sink(void)
+{
+    /* NOP */
+}
+
+shm_tx_client::~shm_tx_client(void)
+{
+    /* NOP */
+}
+
+namespace {
+
+constexpr uint32_t SHM_MAGIC    = 0x53444855; // "UHDS"
+constexpr uint32_t SHM_VERSION  = 1;
+constexpr size_t NUM_RECORDS    = 4096;
+constexpr size_t CACHE_LINE     = 64;
+constexpr size_t MAX_FORMAT_LEN = 32;
+//! How often to check the indices while waiting for the other side
+constexpr std::chrono::microseconds POLL_INTERVAL(50);
+
+enum direction_t : uint32_t { DIRECTION_RX = 0, DIRECTION_TX = 1 };
+
+//! Flags of a record
+constexpr uint32_t FLAG_HAS_TIME_SPEC   = 1 << 0;
+constexpr uint32_t FLAG_START_OF_BURST  = 1 << 1;
+constexpr uint32_t FLAG_END_OF_BURST    = 1 << 2;
+constexpr uint32_t FLAG_MORE_FRAGMENTS  = 1 << 3;
+constexpr uint32_t FLAG_OUT_OF_SEQUENCE = 1 << 4;
+
+/***********************************************************************
+ * Segment layout
+ *
+ * The segment starts with a header, followed by the ring of records and the
+ * rings of samples (one per channel). Positions of samples count up forever;
+ * the ring offset of a position is position % capacity. Every record is
+ * contiguous in the ring: a record which would wrap around skips to the
+ * start of the ring instead.
+ **********************************************************************/
+//! The metadata of one packet
+struct shm_record_t
+{
+    uint64_t pos;
+    uint64_t nsamps;
+    uint64_t fragment_offset;
+    int64_t full_secs;
+    double frac_secs;
+    uint32_t flags;
+    uint32_t error_code;
+};
+
+struct shm_header_t
+{
+    //! Written last by the creator, so clients don't see a partial header
+    std::atomic<uint32_t> magic;
+    uint32_t version;
+    uint32_t direction;
+    uint32_t num_chans;
+    uint32_t bytes_per_item;
+    uint32_t num_records;
+    uint64_t capacity;
+    uint64_t chan_stride;
+    double samp_rate;
+    char cpu_format[MAX_FORMAT_LEN];
+
+    //! Written by the producer
+    alignas(CACHE_LINE) std::atomic<uint64_t> num_written;
+    //! RX: end of the samples which may be being overwritten
+    std::atomic<uint64_t> write_guard;
+    //! TX: position for the next record
+    std::atomic<uint64_t> write_pos;
+
+    //! TX: written by the consumer
+    alignas(CACHE_LINE) std::atomic<uint64_t> num_read;
+    std::atomic<uint64_t> read_pos;
+};
+
+size_t round_up(const size_t value, const size_t multiple)
+{
+    return (value + multiple - 1) / multiple * multiple;
+}
+
+size_t get_records_offset(void)
+{
+    return round_up(sizeof(shm_header_t), CACHE_LINE);
+}
+
+size_t get_samples_offset(const size_t num_records)
+{
+    return get_records_offset()
+           + round_up(num_records * sizeof(shm_record_t), CACHE_LINE);
+}
+
+//! The first position at or after pos from which nsamps are contiguous
+uint64_t get_contiguous_pos(
+    const uint64_t pos, const uint64_t nsamps, const uint64_t capacity)
+{
+    const uint64_t offset = pos % capacity;
+    return offset + nsamps > capacity ? pos + capacity - offset : pos;
+}
+
+void check_name(const std::string& name)
+{
+    if (name.empty() or name.find('/') != std::string::npos) {
+        throw uhd::value_error("shm_stream: Invalid segment name: " + name);
+    }
+}
+
+uint32_t get_record_flags(const bool has_time_spec,
+    const bool start_of_burst,
+    const bool end_of_burst,
+    const bool more_fragments = false,
+    const bool out_of_sequence = false)
+{
+    return (has_time_spec ? FLAG_HAS_TIME_SPEC : 0)
+           | (start_of_burst ? FLAG_START_OF_BURST : 0)
+           | (end_of_burst ? FLAG_END_OF_BURST : 0)
+           | (more_fragments ? FLAG_MORE_FRAGMENTS : 0)
+           | (out_of_sequence ? FLAG_OUT_OF_SEQUENCE : 0);
+}
+
+/*! A mapped segment, either created by the owner of a streamer or attached
+ *  to by a client
+ */
+class shm_segment
+{
+public:
+    //! Create a new segment
+    shm_segment(const std::string& name,
+        const direction_t direction,
+        const std::string& cpu_format,
+        const size_t num_chans,
+        const size_t capacity,
+        const double samp_rate)
+        : _name(name), _owner(true)
+    {
+        check_name(name);
+        if (cpu_format.size() >= MAX_FORMAT_LEN) {
+            throw uhd::value_error("shm_stream: Invalid CPU format: " + cpu_format);
+        }
+        if (not std::atomic<uint64_t>().is_lock_free()) {
+            throw uhd::not_implemented_error(
+                "shm_stream: Lock-free atomics are not supported on this platform");
+        }
+        const size_t bytes_per_item = convert::get_bytes_per_item(cpu_format);
+        const size_t chan_stride    = round_up(capacity * bytes_per_item, CACHE_LINE);
+        try {
+            ipc::shared_memory_object::remove(name.c_str());
+            ipc::shared_memory_object shm(
+                ipc::create_only, name.c_str(), ipc::read_write);
+            shm.truncate(ipc::offset_t(
+                get_samples_offset(NUM_RECORDS) + num_chans * chan_stride));
+            _region = ipc::mapped_region(shm, ipc::read_write);
+        } catch (const ipc::interprocess_exception& ex) {
+            throw uhd::os_error(str(
+                boost::format("shm_stream: Unable to create segment %s: %s") % name
+                % ex.what()));
+        }
+
+        // The segment is zero-filled, so the format string is terminated
+        shm_header_t* header = new (_region.get_address()) shm_header_t;
+        header->version        = SHM_VERSION;
+        header->direction      = direction;
+        header->num_chans      = uint32_t(num_chans);
+        header->bytes_per_item = uint32_t(bytes_per_item);
+        header->num_records    = uint32_t(NUM_RECORDS);
+        header->capacity       = capacity;
+        header->chan_stride    = chan_stride;
+        header->samp_rate      = samp_rate;
+        std::memcpy(header->cpu_format, cpu_format.data(), cpu_format.size());
+        header->num_written.store(0, std::memory_order_relaxed);
+        header->write_guard.store(0, std::memory_order_relaxed);
+        header->write_pos.store(0, std::memory_order_relaxed);
+        header->num_read.store(0, std::memory_order_relaxed);
+        header->read_pos.store(0, std::memory_order_relaxed);
+        header->magic.store(SHM_MAGIC, std::memory_order_release);
+        init_pointers();
+    }
+
+    //! Attach to an existing segment
+    shm_segment(const std::string& name, const direction_t direction, const bool writable)
+        : _name(name), _owner(false)
+    {
+        check_name(name);
+        const ipc::mode_t mode = writable ? ipc::read_write : ipc::read_only;
+        try {
+            ipc::shared_memory_object shm(ipc::open_only, name.c_str(), mode);
+            _region = ipc::mapped_region(shm, mode);
+        } catch (const ipc::interprocess_exception& ex) {
+            throw uhd::lookup_error(str(
+                boost::format("shm_stream: Unable to open segment %s: %s") % name
+                % ex.what()));
+        }
+        const shm_header_t* header =
+            static_cast<const shm_header_t*>(_region.get_address());
+        if (_region.get_size() < sizeof(shm_header_t)
+            or header->magic.load(std::memory_order_acquire) != SHM_MAGIC
+            or header->version != SHM_VERSION or header->direction != direction) {
+            throw uhd::lookup_error(str(
+                boost::format("shm_stream: Segment %s is not a UHD %s stream") % name
+                % (direction == DIRECTION_RX ? "RX" : "TX")));
+        }
+        init_pointers();
+    }
+
+    ~shm_segment(void)
+    {
+        if (_owner) {
+            ipc::shared_memory_object::remove(_name.c_str());
+        }
+    }
+
+    shm_header_t* header(void) const
+    {
+        return _header;
+    }
+
+    shm_record_t& record(const uint64_t index) const
+    {
+        return _records[index % _header->num_records];
+    }
+
+    //! Address of a sample in the ring of a channel
+    char* sample(const size_t chan, const uint64_t pos) const
+    {
+        return _samples + chan * _header->chan_stride
+               + (pos % _header->capacity) * _header->bytes_per_item;
+    }
+
+private:
+    void init_pointers(void)
+    {
+        char* base = static_cast<char*>(_region.get_address());
+        _header    = reinterpret_cast<shm_header_t*>(base);
+        _records   = reinterpret_cast<shm_record_t*>(base + get_records_offset());
+        _samples   = base + get_samples_offset(_header->num_records);
+    }
+
+    const std::string _name;
+    const bool _owner;
+    ipc::mapped_region _region;
+    shm_header_t* _header;
+    shm_record_t* _records;
+    char* _samples;
+};
+
+//! Poll until ready() returns true, or the timeout expires
+template <typename ready_fn_t>
+bool wait_until(ready_fn_t ready, const double timeout)
+{
+    const auto deadline = std::chrono::steady_clock::now()
+                          + std::chrono::microseconds(int64_t(timeout * 1e6));
+    while (not ready()) {
+        if (std::chrono::steady_clock::now() >= deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(POLL_INTERVAL);
+    }
+    return true;
+}
+
+/***********************************************************************
+ * RX
+ **********************************************************************/
+class shm_rx_source_impl : public shm_rx_source
+{
+public:
+    shm_rx_source_impl(rx_streamer::sptr rx_stream,
+        const std::string& cpu_format,
+        const std::string& name,
+        const size_t capacity,
+        const double samp_rate)
+        : _rx_stream(rx_stream)
+        , _max_num_samps(rx_stream->get_max_num_samps())
+        , _segment(name,
+              DIRECTION_RX,
+              cpu_format,
+              rx_stream->get_num_channels(),
+              check_capacity(capacity, _max_num_samps),
+              check_samp_rate(samp_rate))
+        , _recv_buffs(rx_stream->get_num_channels())
+    {
+        /* NOP */
+    }
+
+    size_t recv(rx_metadata_t& metadata, const double timeout)
+    {
+        shm_header_t* header = _segment.header();
+        const uint64_t pos =
+            get_contiguous_pos(_write_pos, _max_num_samps, header->capacity);
+        for (size_t chan = 0; chan < _recv_buffs.size(); chan++) {
+            _recv_buffs[chan] = _segment.sample(chan, pos);
+        }
+
+        // Announce the samples we're about to overwrite before touching them
+        header->write_guard.store(pos + _max_num_samps, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        const size_t nsamps =
+            _rx_stream->recv(_recv_buffs, _max_num_samps, metadata, timeout, true);
+        if (nsamps == 0 and metadata.error_code == rx_metadata_t::ERROR_CODE_TIMEOUT) {
+            return 0;
+        }
+
+        const uint64_t num_written = header->num_written.load(std::memory_order_relaxed);
+        shm_record_t& record       = _segment.record(num_written);
+        record.pos                 = pos;
+        record.nsamps              = nsamps;
+        record.fragment_offset     = metadata.fragment_offset;
+        record.full_secs           = metadata.time_spec.get_full_secs();
+        record.frac_secs           = metadata.time_spec.get_frac_secs();
+        record.flags               = get_record_flags(metadata.has_time_spec,
+            metadata.start_of_burst,
+            metadata.end_of_burst,
+            metadata.more_fragments,
+            metadata.out_of_sequence);
+        record.error_code          = uint32_t(metadata.error_code);
+        header->num_written.store(num_written + 1, std::memory_order_release);
+        _write_pos = pos + nsamps;
+        return nsamps;
+    }
+
+private:
+    static size_t check_capacity(const size_t capacity, const size_t max_num_samps)
+    {
+        if (capacity < max_num_samps) {
+            throw uhd::value_error(
+                str(boost::format("shm_rx_source: Capacity must be at least %d "
+                                  "samples (one packet)")
+                    % max_num_samps));
+        }
+        return capacity;
+    }
+
+    static double check_samp_rate(const double samp_rate)
+    {
+        if (not(samp_rate > 0.0)) {
+            throw uhd::value_error("shm_rx_source: Invalid sample rate");
+        }
+        return samp_rate;
+    }
+
+    rx_streamer::sptr _rx_stream;
+    const size_t _max_num_samps;
+    shm_segment _segment;
+    std::vector<void*> _recv_buffs;
+    uint64_t _write_pos = 0;
+};
+
+class shm_rx_client_impl : public shm_rx_client
+{
+public:
+    shm_rx_client_impl(const std::string& name)
+        : _segment(name, DIRECTION_RX, false)
+        , _next_record(_segment.header()->num_written.load(std::memory_order_acquire))
+    {
+        /* NOP */
+    }
+
+    size_t get_num_channels(void) const
+    {
+        return _segment.header()->num_chans;
+    }
+
+    std::string get_cpu_format(void) const
+    {
+        return _segment.header()->cpu_format;
+    }
+
+    size_t recv(const rx_streamer::buffs_type& buffs,
+        const size_t nsamps_per_buff,
+        rx_metadata_t& metadata,
+        const double timeout)
+    {
+        const shm_header_t* header = _segment.header();
+        metadata.reset();
+        if (buffs.size() != header->num_chans) {
+            throw uhd::value_error(
+                str(boost::format("shm_rx_client: Expected %d buffers, got %d")
+                    % header->num_chans % buffs.size()));
+        }
+        uint64_t num_written = 0;
+        if (not wait_until(
+                [&]() {
+                    num_written = header->num_written.load(std::memory_order_acquire);
+                    return num_written != _next_record;
+                },
+                timeout)) {
+            metadata.error_code = rx_metadata_t::ERROR_CODE_TIMEOUT;
+            return 0;
+        }
+        if (is_record_overwritten(num_written)) {
+            return overflow(metadata);
+        }
+
+        // Copy the record, then make sure the source did not start to
+        // overwrite it in the meantime
+        const shm_record_t record = _segment.record(_next_record);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (is_record_overwritten(header->num_written.load(std::memory_order_relaxed))) {
+            return overflow(metadata);
+        }
+
+        const uint64_t offset = _record_offset;
+        const size_t nsamps =
+            size_t(std::min<uint64_t>(nsamps_per_buff, record.nsamps - offset));
+        const uint64_t pos = record.pos + offset;
+        for (size_t chan = 0; chan < buffs.size(); chan++) {
+            std::memcpy(buffs[chan],
+                _segment.sample(chan, pos),
+                nsamps * header->bytes_per_item);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const uint64_t write_guard = header->write_guard.load(std::memory_order_relaxed);
+        if (write_guard > pos + header->capacity) {
+            return overflow(metadata);
+        }
+
+        const bool last_fragment = offset + nsamps == record.nsamps;
+        metadata.has_time_spec   = record.flags & FLAG_HAS_TIME_SPEC;
+        metadata.time_spec       = time_spec_t(record.full_secs, record.frac_secs)
+                             + time_spec_t::from_ticks(offset, header->samp_rate);
+        metadata.start_of_burst  = (record.flags & FLAG_START_OF_BURST) and offset == 0;
+        metadata.end_of_burst    = (record.flags & FLAG_END_OF_BURST) and last_fragment;
+        metadata.more_fragments =
+            (record.flags & FLAG_MORE_FRAGMENTS) or not last_fragment;
+        metadata.fragment_offset = size_t(record.fragment_offset + offset);
+        metadata.out_of_sequence = record.flags & FLAG_OUT_OF_SEQUENCE;
+        if (offset == 0) {
+            metadata.error_code = rx_metadata_t::error_code_t(record.error_code);
+        }
+        if (last_fragment) {
+            _next_record++;
+            _record_offset = 0;
+        } else {
+            _record_offset += nsamps;
+        }
+        return nsamps;
+    }
+
+private:
+    bool is_record_overwritten(const uint64_t num_written) const
+    {
+        // The source may already be writing the record after num_written
+        return num_written - _next_record >= _segment.header()->num_records - 1;
+    }
+
+    //! Skip all samples published so far
+    size_t overflow(rx_metadata_t& metadata)
+    {
+        _next_record   = _segment.header()->num_written.load(std::memory_order_acquire);
+        _record_offset = 0;
+        metadata.error_code = rx_metadata_t::ERROR_CODE_OVERFLOW;
+        return 0;
+    }
+
+    const shm_segment _segment;
+    uint64_t _next_record;
+    uint64_t _record_offset = 0;
+};
+
+/***********************************************************************
+ * TX
+ **********************************************************************/
+class shm_tx_sink_impl : public shm_tx_sink
+{
+public:
+    shm_tx_sink_impl(tx_streamer::sptr tx_stream,
+        const std::string& cpu_format,
+        const std::string& name,
+        const size_t capacity)
+        : _tx_stream(tx_stream)
+        , _segment(name,
+              DIRECTION_TX,
+              cpu_format,
+              tx_stream->get_num_channels(),
+              check_capacity(capacity),
+              0.0)
+        , _send_buffs(tx_stream->get_num_channels())
+    {
+        /* NOP */
+    }
+
+    size_t send(const double timeout)
+    {
+        shm_header_t* header = _segment.header();
+        if (not wait_until(
+                [&]() {
+                    return header->num_written.load(std::memory_order_acquire)
+                           != _next_record;
+                },
+                timeout)) {
+            return 0;
+        }
+
+        // The client does not touch the record until we release it
+        const shm_record_t& record = _segment.record(_next_record);
+        const uint64_t pos         = record.pos + _record_offset;
+        for (size_t chan = 0; chan < _send_buffs.size(); chan++) {
+            _send_buffs[chan] = _segment.sample(chan, pos);
+        }
+        // Only the first part of a record carries the start of the burst
+        const bool first_fragment = _record_offset == 0;
+        tx_metadata_t metadata;
+        metadata.has_time_spec  = (record.flags & FLAG_HAS_TIME_SPEC) and first_fragment;
+        metadata.time_spec      = time_spec_t(record.full_secs, record.frac_secs);
+        metadata.start_of_burst = (record.flags & FLAG_START_OF_BURST) and first_fragment;
+        metadata.end_of_burst   = record.flags & FLAG_END_OF_BURST;
+        const size_t nsamps     = _tx_stream->send(
+            _send_buffs, size_t(record.nsamps - _record_offset), metadata, timeout);
+
+        _record_offset += nsamps;
+        if (_record_offset == record.nsamps) {
+            header->read_pos.store(record.pos + record.nsamps, std::memory_order_relaxed);
+            header->num_read.store(++_next_record, std::memory_order_release);
+            _record_offset = 0;
+        }
+        return nsamps;
+    }
+
+private:
+    static size_t check_capacity(const size_t capacity)
+    {
+        if (capacity < 2) {
+            throw uhd::value_error("shm_tx_sink: Invalid capacity");
+        }
+        return capacity;
+    }
+
+    tx_streamer::sptr _tx_stream;
+    shm_segment _segment;
+    std::vector<const void*> _send_buffs;
+    uint64_t _next_record   = 0;
+    uint64_t _record_offset = 0;
+};
+
+class shm_tx_client_impl : public shm_tx_client
+{
+public:
+    shm_tx_client_impl(const std::string& name) : _segment(name, DIRECTION_TX, true)
+    {
+        /* NOP */
+    }
+
+    size_t get_num_channels(void) const
+    {
+        return _segment.header()->num_chans;
+    }
+
+    std::string get_cpu_format(void) const
+    {
+        return _segment.header()->cpu_format;
+    }
+
+    size_t send(const tx_streamer::buffs_type& buffs,
+        const size_t nsamps_per_buff,
+        const tx_metadata_t& metadata,
+        const double timeout)
+    {
+        shm_header_t* header = _segment.header();
+        if (buffs.size() != header->num_chans) {
+            throw uhd::value_error(
+                str(boost::format("shm_tx_client: Expected %d buffers, got %d")
+                    % header->num_chans % buffs.size()));
+        }
+        // Packets take at most half of the ring, so the sink can send one
+        // while the next one is written
+        const size_t max_num_samps = size_t(header->capacity / 2);
+        size_t num_sent            = 0;
+        do {
+            const size_t nsamps = std::min(nsamps_per_buff - num_sent, max_num_samps);
+            const uint64_t num_written =
+                header->num_written.load(std::memory_order_relaxed);
+            const uint64_t pos =
+                get_contiguous_pos(header->write_pos.load(std::memory_order_relaxed),
+                    nsamps,
+                    header->capacity);
+            if (not wait_until(
+                    [&]() {
+                        return num_written
+                                       - header->num_read.load(std::memory_order_acquire)
+                                   < header->num_records
+                               and pos + nsamps
+                                           - header->read_pos.load(
+                                               std::memory_order_relaxed)
+                                       <= header->capacity;
+                    },
+                    timeout)) {
+                break;
+            }
+
+            for (size_t chan = 0; chan < buffs.size(); chan++) {
+                std::memcpy(_segment.sample(chan, pos),
+                    static_cast<const char*>(buffs[chan])
+                        + num_sent * header->bytes_per_item,
+                    nsamps * header->bytes_per_item);
+            }
+            const bool first       = num_sent == 0;
+            const bool last        = num_sent + nsamps == nsamps_per_buff;
+            shm_record_t& record   = _segment.record(num_written);
+            record.pos             = pos;
+            record.nsamps          = nsamps;
+            record.fragment_offset = 0;
+            record.full_secs       = metadata.time_spec.get_full_secs();
+            record.frac_secs       = metadata.time_spec.get_frac_secs();
+            record.flags           = get_record_flags(metadata.has_time_spec and first,
+                metadata.start_of_burst and first,
+                metadata.end_of_burst and last);
+            record.error_code      = 0;
+            header->write_pos.store(pos + nsamps, std::memory_order_relaxed);
+            header->num_written.store(num_written + 1, std::memory_order_release);
+            num_sent += nsamps;
+        } while (num_sent < nsamps_per_buff);
+        return num_sent;
+    }
+
+private:
+    const shm_segment _segment;
+};
+
+} // namespace
+
+shm_rx_source::sptr shm_rx_source::make(rx_streamer::sptr rx_stream,
+    const std::string& cpu_format,
+    const std::string& name,
+    const size_t capacity,
+    const double samp_rate)
+{
+    return sptr(new shm_rx_source_impl(rx_stream, cpu_format, name, capacity, samp_rate));
+}
+
+shm_rx_client::sptr shm_rx_client::make(const std::string& name)
+{
+    return sptr(new shm_rx_client_impl(name));
+}
+
+shm_tx_sink::sptr shm_tx_sink::make(tx_streamer::sptr tx_stream,
+    const std::string& cpu_format,
+    const std::string& name,
+    const size_t capacity)
+{
+    return sptr(new shm_tx_sink_impl(tx_stream, cpu_format, name, capacity));
+}
+
+shm_tx_client::sptr shm_tx_client::make(const std::string& name)
+{
+    return sptr(new shm_tx_client_impl(name));
+}
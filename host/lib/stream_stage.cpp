@@ -0,0 +1,52 @@
+//
+// Copyright 2019 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include <uhd/stream_stage.hpp>
+#include <chrono>
+
+using namespace uhd;
+
+stream_stage::~stream_stage(void)
+{
+    /* NOP */
+}
+
+void stream_stage::set_time(const size_t, const time_spec_t&)
+{
+    /* NOP */
+}
+
+void stream_stage::run(const size_t chan, void* buff, const size_t nsamps)
+{
+    const auto start_time = std::chrono::steady_clock::now();
+    this->process(chan, buff, nsamps);
+    const auto elapsed    = std::chrono::steady_clock::now() - start_time;
+    update_stats(
+        nsamps, std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+}
+
+void stream_stage::update_stats(const size_t nsamps, const uint64_t elapsed_ns)
+{
+    _num_calls.fetch_add(1, std::memory_order_relaxed);
+    _num_samps.fetch_add(nsamps, std::memory_order_relaxed);
+    _total_ns.fetch_add(elapsed_ns, std::memory_order_relaxed);
+}
+
+stream_stage::stats_t stream_stage::get_stats(void) const
+{
+    stats_t stats;
+    stats.num_calls = _num_calls.load(std::memory_order_relaxed);
+    stats.num_samps = _num_samps.load(std::memory_order_relaxed);
+    stats.total_ns  = _total_ns.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void stream_stage::reset_stats(void)
+{
+    _num_calls.store(0, std::memory_order_relaxed);
+    _num_samps.store(0, std::memory_order_relaxed);
+    _total_ns.store(0, std::memory_order_relaxed);
+}
@@ -11,6 +11,7 @@
 #include <uhd/types/serial.hpp>
 #include <uhd/utils/log.hpp>
 #include <uhd/utils/tasks.hpp>
+#include <uhdlib/utils/thread_policy.hpp>
 #include <boost/bind.hpp>
 #include <boost/thread/mutex.hpp>
 #include <boost/weak_ptr.hpp>
@@ -37,7 +38,8 @@ public:
         UHD_ASSERT_THROW(libusb_init(&_context) == 0);
         libusb_set_debug(_context, debug_level);
         task_handler = task::make(
-            boost::bind(&libusb_session_impl::libusb_event_handler_task, this, _context));
+            boost::bind(&libusb_session_impl::libusb_event_handler_task, this, _context),
+            uhd::thread_policy::USB_EVENTS);
     }
 
     virtual ~libusb_session_impl(void);
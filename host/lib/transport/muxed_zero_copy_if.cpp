@@ -11,6 +11,7 @@
 #include <uhd/transport/muxed_zero_copy_if.hpp>
 #include <uhd/utils/safe_call.hpp>
 #include <uhd/utils/thread.hpp>
+#include <uhdlib/utils/thread_policy.hpp>
 #include <boost/enable_shared_from_this.hpp>
 #include <boost/make_shared.hpp>
 #include <boost/thread.hpp>
@@ -40,7 +41,7 @@ public:
         // Create the receive thread to poll the underlying transport
         // and classify packets into queues
         _recv_thread = boost::thread([this]() { this->_update_queues(); });
-        set_thread_name(&_recv_thread, "muxed_0copy_if");
+        set_thread_name(&_recv_thread, uhd::thread_policy::MUXED_XPORT);
     }
 
     virtual ~muxed_zero_copy_if_impl()
@@ -216,6 +217,7 @@ private:
 
     void _update_queues()
     {
+        uhd::thread_policy::apply(uhd::thread_policy::MUXED_XPORT);
         // Run forever:
         // - Pull packets from the base transport
         // - Classify them
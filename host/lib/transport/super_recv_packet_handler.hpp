@@ -12,17 +12,24 @@
 #include <uhd/convert.hpp>
 #include <uhd/exception.hpp>
 #include <uhd/stream.hpp>
+#include <uhd/stream_stage.hpp>
 #include <uhd/transport/vrt_if_packet.hpp>
 #include <uhd/transport/zero_copy.hpp>
 #include <uhd/types/metadata.hpp>
 #include <uhd/utils/byteswap.hpp>
 #include <uhd/utils/log.hpp>
 #include <uhd/utils/tasks.hpp>
+#include <uhdlib/convert/fast_converter.hpp>
+#include <uhdlib/dsp/fused_stage.hpp>
 #include <uhdlib/rfnoc/rx_stream_terminator.hpp>
+#include <uhdlib/transport/squelch_gate.hpp>
+#include <uhdlib/utils/latency_histogram.hpp>
+#include <uhdlib/utils/rational_time.hpp>
 #include <boost/dynamic_bitset.hpp>
 #include <boost/format.hpp>
 #include <boost/function.hpp>
 #include <boost/make_shared.hpp>
+#include <chrono>
 #include <iostream>
 #include <vector>
 
@@ -122,13 +129,13 @@ public:
     //! Set the rate of ticks per second
     void set_tick_rate(const double rate)
     {
-        _tick_rate = rate;
+        _time_model.set_tick_rate(rate);
     }
 
     //! Set the rate of samples per second
     void set_samp_rate(const double rate)
     {
-        _samp_rate = rate;
+        _time_model.set_samp_rate(rate);
     }
 
     /*!
@@ -152,6 +159,8 @@ public:
      */
     void flush_all(const double timeout = 0.0)
     {
+        release_retained_buffs();
+        _squelch_open = false;
         _flush_all(timeout);
         return;
     }
@@ -183,10 +192,74 @@ public:
     void set_converter(const uhd::convert::id_type& id)
     {
         _num_outputs = id.num_outputs;
-        _converter   = uhd::convert::get_converter(id)();
+        // Rebinding the same conversion reuses the existing converter
+        if (not _converter or id != _converter_id) {
+            _converter    = uhd::convert::get_converter(id)();
+            _conv_fn      = uhd::convert::get_conv_fn(_converter);
+            _converter_id = id;
+        }
         this->set_scale_factor(1 / 32767.); // update after setting converter
         _bytes_per_otw_item = uhd::convert::get_bytes_per_item(id.input_format);
         _bytes_per_cpu_item = uhd::convert::get_bytes_per_item(id.output_format);
+        update_fused_stage();
+    }
+
+    /*! Set the host-side processing stages for all channels
+     *
+     * Must be called after set_converter(). The stages run on the converted
+     * samples in the user's buffers.
+     *
+     * \param stages The stages, in the order in which they run
+     * \param cpu_format The output format of the converter
+     */
+    void set_stages(
+        const std::vector<uhd::stream_stage::sptr>& stages, const std::string& cpu_format)
+    {
+        // Devices set up the streamer once per channel, only init once
+        if (stages == _stages) {
+            return;
+        }
+        for (const auto& stage : stages) {
+            stage->init(cpu_format, this->size() * _num_outputs);
+        }
+        _stages = stages;
+        update_fused_stage();
+    }
+
+    /*! Set the energy gate for all channels
+     *
+     * Must be called after set_converter(). Gating requires sc16 over the
+     * wire.
+     *
+     * \param squelch The gate, or an empty pointer to pass every packet
+     * \throws uhd::value_error if the wire format can't be gated
+     */
+    void set_squelch(const uhd::rx_squelch::sptr& squelch)
+    {
+        // Devices set up the streamer once per channel
+        if (squelch == _squelch_ref) {
+            return;
+        }
+        release_retained_buffs();
+        _squelch     = nullptr;
+        _squelch_ref = squelch;
+        if (not squelch) {
+            return;
+        }
+        const std::string& otw_format = _converter_id.input_format;
+        if (otw_format != "sc16_item32_le" and otw_format != "sc16_item32_be") {
+            throw uhd::value_error(
+                "The RX squelch requires sc16 over the wire, not " + otw_format);
+        }
+        _squelch = dynamic_cast<uhd::transport::squelch_gate*>(squelch.get());
+        if (not _squelch) {
+            throw uhd::value_error("Unsupported RX squelch implementation");
+        }
+        _squelch_big_endian = otw_format == "sc16_item32_be";
+        _squelch_open       = false;
+        _squelch_retained.assign(
+            _squelch->get_pre_packets() + 1, buffers_info_type(this->size()));
+        _squelch_retained_power.assign(_squelch_retained.size(), 0.0f);
     }
 
     //! Set the transport channel's overflow handler
@@ -200,6 +273,7 @@ public:
     void set_scale_factor(const double scale_factor)
     {
         _converter->set_scalar(scale_factor);
+        _scale_factor = float(scale_factor);
     }
 
     //! Set the callback to issue stream commands
@@ -219,10 +293,15 @@ public:
                 "single streamer will fail to time align.");
         }
 
+        UHD_LATENCY_START(issue_start);
+        if (stream_cmd.stream_mode != stream_cmd_t::STREAM_MODE_STOP_CONTINUOUS) {
+            UHD_LATENCY_MARK_SET(_stream_cmd_mark);
+        }
         for (size_t i = 0; i < _props.size(); i++) {
             if (_props[i].issue_stream_cmd)
                 _props[i].issue_stream_cmd(stream_cmd);
         }
+        UHD_LATENCY_RECORD("rx_stream_cmd_issue", issue_start);
     }
 
     /*******************************************************************
@@ -248,6 +327,9 @@ public:
 
         size_t accum_num_samps =
             recv_one_packet(buffs, nsamps_per_buff, metadata, timeout);
+        if (accum_num_samps) {
+            UHD_LATENCY_MARK_RECORD("rx_stream_cmd_to_first_sample", _stream_cmd_mark);
+        }
 
         if (one_packet or metadata.end_of_burst) {
 #ifdef UHD_TXRX_DEBUG_PRINTS
@@ -294,10 +376,12 @@ public:
 private:
     vrt_unpacker_type _vrt_unpacker;
     size_t _header_offset_words32;
-    double _tick_rate, _samp_rate;
+    //! Exact conversions between ticks, samples and time
+    rational_time_model _time_model;
     bool _queue_error_for_next_call;
     size_t _alignment_failure_threshold;
     rx_metadata_t _queue_metadata;
+    UHD_LATENCY_MARK_MEMBER(_stream_cmd_mark);
     struct xport_chan_props_type
     {
         xport_chan_props_type(void)
@@ -317,6 +401,33 @@ private:
     size_t _bytes_per_otw_item; // used in conversion
     size_t _bytes_per_cpu_item; // used in conversion
     uhd::convert::converter::sptr _converter; // used in conversion
+    uhd::convert::conv_fn_type _conv_fn; // used in conversion
+    uhd::convert::id_type _converter_id;
+    std::vector<uhd::stream_stage::sptr> _stages; // run after conversion
+    float _scale_factor = float(1 / 32767.);
+    //! The first stage, if it runs as part of the conversion
+    uhd::dsp::fused_sc16_stage* _fused_stage = nullptr;
+    bool _fused_big_endian                   = false;
+
+    /*! Fuse the first stage with the conversion, if it supports it
+     *
+     * Fusing is possible for sc16 over the wire to fc32, without interleaved
+     * outputs.
+     */
+    void update_fused_stage(void)
+    {
+        _fused_stage = nullptr;
+        if (_stages.empty() or not _converter or _converter_id.num_inputs != 1
+            or _converter_id.num_outputs != 1 or _converter_id.output_format != "fc32") {
+            return;
+        }
+        const std::string& otw_format = _converter_id.input_format;
+        if (otw_format == "sc16_item32_le" or otw_format == "sc16_item32_be") {
+            _fused_stage =
+                dynamic_cast<uhd::dsp::fused_sc16_stage*>(_stages.front().get());
+            _fused_big_endian = otw_format == "sc16_item32_be";
+        }
+    }
 
     //! information stored for a received buffer
     struct per_buffer_info_type
@@ -386,6 +497,18 @@ private:
         _buffers_infos_index = (_buffers_infos_index + 1) % 4;
     }
 
+    //! The energy gate, if any
+    uhd::rx_squelch::sptr _squelch_ref;
+    uhd::transport::squelch_gate* _squelch = nullptr;
+    bool _squelch_big_endian               = false;
+    bool _squelch_open                     = false;
+    size_t _squelch_post_left              = 0;
+    //! A circular queue of packets retained while the gate is closed
+    std::vector<buffers_info_type> _squelch_retained;
+    std::vector<float> _squelch_retained_power;
+    size_t _squelch_first        = 0;
+    size_t _squelch_num_retained = 0;
+
     //! possible return options for the packet receiver
     enum packet_type {
         PACKET_IF_DATA,
@@ -645,7 +768,7 @@ private:
                     std::swap(curr_info, next_info); // save progress from curr -> next
                     curr_info.metadata.has_time_spec = next_info[index].ifpi.has_tsf;
                     curr_info.metadata.time_spec =
-                        time_spec_t::from_ticks(next_info[index].time, _tick_rate);
+                        _time_model.ticks_to_time(next_info[index].time);
                     curr_info.metadata.error_code =
                         rx_metadata_t::error_code_t(get_context_code(
                             next_info[index].vrt_hdr, next_info[index].ifpi));
@@ -684,10 +807,9 @@ private:
                     curr_info.metadata.has_time_spec = prev_info.metadata.has_time_spec;
                     curr_info.metadata.time_spec =
                         prev_info.metadata.time_spec
-                        + time_spec_t::from_ticks(
+                        + _time_model.samps_to_time(
                             prev_info[index].ifpi.num_payload_words32 * sizeof(uint32_t)
-                                / _bytes_per_otw_item,
-                            _samp_rate);
+                            / _bytes_per_otw_item);
                     curr_info.metadata.out_of_sequence = true;
                     curr_info.metadata.error_code = rx_metadata_t::ERROR_CODE_OVERFLOW;
                     UHD_LOG_FASTPATH("D");
@@ -712,13 +834,129 @@ private:
 
         // set the metadata from the buffer information at index zero
         curr_info.metadata.has_time_spec = curr_info[0].ifpi.has_tsf;
-        curr_info.metadata.time_spec =
-            time_spec_t::from_ticks(curr_info[0].time, _tick_rate);
+        curr_info.metadata.time_spec = _time_model.ticks_to_time(curr_info[0].time);
         curr_info.metadata.more_fragments  = false;
         curr_info.metadata.fragment_offset = 0;
         curr_info.metadata.error_code      = rx_metadata_t::ERROR_CODE_NONE;
     }
 
+    /*******************************************************************
+     * Get squelched buffers:
+     * Get aligned buffers, but skip the ones below the squelch level.
+     * The last packets before the gate opens are retained, and passed
+     * first once it does. Errors are passed through.
+     ******************************************************************/
+    void get_squelched_buffs(double timeout)
+    {
+        if (_squelch_open and _squelch_num_retained > 0) {
+            pass_retained_buffs(false);
+            return;
+        }
+
+        const auto deadline = std::chrono::steady_clock::now()
+                              + std::chrono::duration<double>(timeout);
+        while (true) {
+            get_aligned_buffs(timeout);
+            buffers_info_type& info = get_curr_buffer_info();
+            if (info.metadata.error_code != rx_metadata_t::ERROR_CODE_NONE) {
+                // The retained packets would not be contiguous with the next
+                if (info.metadata.error_code != rx_metadata_t::ERROR_CODE_TIMEOUT) {
+                    release_retained_buffs();
+                }
+                return;
+            }
+
+            // gate on the loudest channel
+            const size_t nsamps = info.data_bytes_to_copy / _bytes_per_otw_item;
+            float power         = 0.0f;
+            for (size_t i = 0; i < info.size(); i++) {
+                power = std::max(power,
+                    get_sc16_item32_power(reinterpret_cast<const uint32_t*>(
+                                              info[i].copy_buff),
+                        nsamps,
+                        _squelch_big_endian));
+            }
+
+            if (_squelch_open) {
+                if (power >= _squelch->get_close_level()) {
+                    _squelch_post_left = _squelch->get_post_packets();
+                } else if (--_squelch_post_left == 0) {
+                    info.metadata.end_of_burst = true;
+                    _squelch_open              = false;
+                }
+                _squelch->packet_passed(false);
+                return;
+            }
+
+            retain_buff(info, power);
+            if (power >= _squelch->get_open_level()) {
+                _squelch_open      = true;
+                _squelch_post_left = _squelch->get_post_packets();
+                pass_retained_buffs(true);
+                return;
+            }
+            while (_squelch_num_retained > _squelch->get_pre_packets()) {
+                gate_retained_buff();
+            }
+
+            // The packet is retained, don't copy it now
+            info.data_bytes_to_copy = 0;
+            const double time_left =
+                std::chrono::duration<double>(deadline - std::chrono::steady_clock::now())
+                    .count();
+            if (time_left <= 0.0) {
+                info.metadata.error_code = rx_metadata_t::ERROR_CODE_TIMEOUT;
+                return;
+            }
+            timeout = time_left;
+        }
+    }
+
+    //! Add a packet to the retained packets
+    void retain_buff(const buffers_info_type& info, const float power)
+    {
+        const size_t index =
+            (_squelch_first + _squelch_num_retained) % _squelch_retained.size();
+        _squelch_retained[index]       = info;
+        _squelch_retained_power[index] = power;
+        _squelch_num_retained++;
+    }
+
+    //! Move the oldest retained packet into the current buffer info
+    void pass_retained_buffs(const bool start_of_burst)
+    {
+        buffers_info_type& oldest = _squelch_retained[_squelch_first];
+        buffers_info_type& info   = get_curr_buffer_info();
+        info                      = oldest;
+        oldest.reset();
+        _squelch_first = (_squelch_first + 1) % _squelch_retained.size();
+        _squelch_num_retained--;
+        if (start_of_burst) {
+            info.metadata.start_of_burst = true;
+        }
+        _squelch->packet_passed(start_of_burst);
+    }
+
+    //! Drop the oldest retained packet
+    void gate_retained_buff(void)
+    {
+        buffers_info_type& oldest = _squelch_retained[_squelch_first];
+        _squelch->packet_gated(oldest.metadata,
+            oldest.data_bytes_to_copy / _bytes_per_otw_item,
+            _squelch_retained_power[_squelch_first]);
+        oldest.reset();
+        _squelch_first = (_squelch_first + 1) % _squelch_retained.size();
+        _squelch_num_retained--;
+    }
+
+    //! Drop all retained packets
+    void release_retained_buffs(void)
+    {
+        while (_squelch_num_retained > 0) {
+            gate_retained_buff();
+        }
+    }
+
     /*******************************************************************
      * Receive a single packet on all channels
      * Handles fragmentation, messages, errors, and copy-conversion.
@@ -734,15 +972,18 @@ private:
         // get the next buffer if the current one has expired
         if (get_curr_buffer_info().data_bytes_to_copy == 0) {
             // perform receive with alignment logic
-            get_aligned_buffs(timeout);
+            if (_squelch) {
+                get_squelched_buffs(timeout);
+            } else {
+                get_aligned_buffs(timeout);
+            }
         }
 
         buffers_info_type& info = get_curr_buffer_info();
         metadata                = info.metadata;
 
         // interpolate the time spec (useful when this is a fragment)
-        metadata.time_spec +=
-            time_spec_t::from_ticks(info.fragment_offset_in_samps, _samp_rate);
+        metadata.time_spec += _time_model.samps_to_time(info.fragment_offset_in_samps);
 
         // extract the number of samples available to copy
         const size_t nsamps_available = info.data_bytes_to_copy / _bytes_per_otw_item;
@@ -753,6 +994,7 @@ private:
 
         // setup the data to share with converter threads
         _convert_nsamps              = nsamps_to_copy_per_io_buff;
+        _convert_metadata            = &metadata;
         _convert_buffs               = &buffs;
         _convert_buffer_offset_bytes = buffer_offset_bytes;
         _convert_bytes_to_copy       = bytes_to_copy;
@@ -795,8 +1037,36 @@ private:
         }
         const ref_vector<void*> out_buffs(io_buffs, _num_outputs);
 
-        // perform the conversion operation
-        _converter->conv(info.copy_buff, out_buffs, _convert_nsamps);
+        // let the stages know the time of the samples
+        if (_convert_metadata->has_time_spec) {
+            const time_spec_t& time_spec = _convert_metadata->time_spec;
+            for (const auto& stage : _stages) {
+                for (size_t i = 0; i < _num_outputs; i++) {
+                    stage->set_time(index * _num_outputs + i, time_spec);
+                }
+            }
+        }
+
+        // perform the conversion operation, fused with the first stage if possible
+        auto stage_it = _stages.begin();
+        if (_fused_stage) {
+            _fused_stage->convert_and_process(index,
+                info.copy_buff,
+                _fused_big_endian,
+                _scale_factor,
+                static_cast<std::complex<float>*>(io_buffs[0]),
+                _convert_nsamps);
+            ++stage_it;
+        } else {
+            _conv_fn(_converter.get(), info.copy_buff, out_buffs, _convert_nsamps);
+        }
+
+        // run the stages while the output samples are still in the cache
+        for (; stage_it != _stages.end(); ++stage_it) {
+            for (size_t i = 0; i < _num_outputs; i++) {
+                (*stage_it)->run(index * _num_outputs + i, io_buffs[i], _convert_nsamps);
+            }
+        }
 
         // advance the pointer for the source buffer
         info.copy_buff += _convert_bytes_to_copy;
@@ -809,6 +1079,7 @@ private:
 
     //! Shared variables for the worker threads
     size_t _convert_nsamps;
+    const uhd::rx_metadata_t* _convert_metadata;
     const rx_streamer::buffs_type* _convert_buffs;
     size_t _convert_buffer_offset_bytes;
     size_t _convert_bytes_to_copy;
@@ -877,7 +1148,7 @@ private:
             metadata,
             timeout,
             one_packet,
-            _samp_rate);
+            _time_model.get_samp_rate());
         if (dbg_print_directly) {
             dbg_print_err(data.print_line());
         }
@@ -12,16 +12,22 @@
 #include <uhd/convert.hpp>
 #include <uhd/exception.hpp>
 #include <uhd/stream.hpp>
+#include <uhd/stream_stage.hpp>
 #include <uhd/transport/vrt_if_packet.hpp>
 #include <uhd/transport/zero_copy.hpp>
 #include <uhd/types/metadata.hpp>
 #include <uhd/utils/byteswap.hpp>
 #include <uhd/utils/tasks.hpp>
 #include <uhd/utils/thread.hpp>
+#include <uhdlib/convert/fast_converter.hpp>
 #include <uhdlib/rfnoc/tx_stream_terminator.hpp>
+#include <uhdlib/utils/latency_histogram.hpp>
+#include <uhdlib/utils/rational_time.hpp>
 #include <boost/function.hpp>
 #include <chrono>
+#include <cstring>
 #include <iostream>
+#include <memory>
 #include <thread>
 #include <vector>
 
@@ -57,7 +63,9 @@ public:
      * \param size the number of transport channels
      */
     send_packet_handler(const size_t size = 1)
-        : _next_packet_seq(0), _cached_metadata(false)
+        : _next_packet_seq(0)
+        , _cached_metadata(false)
+        , _eob_mark(std::make_shared<uhd::latency::mark_t>())
     {
         this->set_enable_trailer(true);
         this->resize(size);
@@ -108,13 +116,13 @@ public:
     //! Set the rate of ticks per second
     void set_tick_rate(const double rate)
     {
-        _tick_rate = rate;
+        _time_model.set_tick_rate(rate);
     }
 
     //! Set the rate of samples per second
     void set_samp_rate(const double rate)
     {
-        _samp_rate = rate;
+        _time_model.set_samp_rate(rate);
     }
 
     /*!
@@ -141,12 +149,39 @@ public:
     void set_converter(const uhd::convert::id_type& id)
     {
         _num_inputs = id.num_inputs;
-        _converter  = uhd::convert::get_converter(id)();
+        // Rebinding the same conversion reuses the existing converter
+        if (not _converter or id != _converter_id) {
+            _converter    = uhd::convert::get_converter(id)();
+            _conv_fn      = uhd::convert::get_conv_fn(_converter);
+            _converter_id = id;
+        }
         this->set_scale_factor(32767.); // update after setting converter
         _bytes_per_otw_item = uhd::convert::get_bytes_per_item(id.output_format);
         _bytes_per_cpu_item = uhd::convert::get_bytes_per_item(id.input_format);
     }
 
+    /*! Set the host-side processing stages for all channels
+     *
+     * Must be called after set_converter(). The stages run on a copy of the
+     * user's samples, so the user's buffers are not modified.
+     *
+     * \param stages The stages, in the order in which they run
+     * \param cpu_format The input format of the converter
+     */
+    void set_stages(
+        const std::vector<uhd::stream_stage::sptr>& stages, const std::string& cpu_format)
+    {
+        // Devices set up the streamer once per channel, only init once
+        if (stages == _stages) {
+            return;
+        }
+        for (const auto& stage : stages) {
+            stage->init(cpu_format, this->size() * _num_inputs);
+        }
+        _stages = stages;
+        _stage_buffs.resize(_stages.empty() ? 0 : this->size() * _num_inputs);
+    }
+
     /*!
      * Set the maximum number of samples per host packet.
      * Ex: A USRP1 in dual channel mode would be half.
@@ -169,6 +204,17 @@ public:
         _async_receiver = async_receiver;
     }
 
+    /*!
+     * Get the mark which is set when an end of burst is sent.
+     *
+     * Devices record tx_eob_to_burst_ack against it when their async message
+     * handler receives the burst ACK.
+     */
+    std::shared_ptr<uhd::latency::mark_t> get_eob_mark(void) const
+    {
+        return _eob_mark;
+    }
+
     //! Overload call to get async metadata
     bool recv_async_msg(uhd::async_metadata_t& async_metadata, double timeout = 0.1)
     {
@@ -196,7 +242,7 @@ public:
         if_packet_info.has_tlr = _has_tlr;
         if_packet_info.has_tsi = false;
         if_packet_info.has_tsf = metadata.has_time_spec;
-        if_packet_info.tsf     = metadata.time_spec.to_ticks(_tick_rate);
+        if_packet_info.tsf     = _time_model.time_to_ticks(metadata.time_spec);
         if_packet_info.sob     = metadata.start_of_burst;
         if_packet_info.eob     = metadata.end_of_burst;
         if_packet_info.fc_ack  = false; // This is a data packet
@@ -210,7 +256,8 @@ public:
             // If the new metada has a time_spec, do not use the cached time_spec.
             if (!metadata.has_time_spec) {
                 if_packet_info.has_tsf = _metadata_cache.has_time_spec;
-                if_packet_info.tsf     = _metadata_cache.time_spec.to_ticks(_tick_rate);
+                if_packet_info.tsf =
+                    _time_model.time_to_ticks(_metadata_cache.time_spec);
             }
             if_packet_info.sob = _metadata_cache.start_of_burst;
             if_packet_info.eob = _metadata_cache.end_of_burst;
@@ -246,6 +293,7 @@ public:
             return nsamps_sent;
         }
         size_t total_num_samps_sent = 0;
+        const int64_t start_tsf     = _time_model.time_to_ticks(metadata.time_spec);
 
         // false until final fragment
         if_packet_info.eob = false;
@@ -265,11 +313,10 @@ public:
             if (num_samps_sent == 0)
                 return total_num_samps_sent;
 
-            // setup metadata for the next fragment
-            const time_spec_t time_spec =
-                metadata.time_spec
-                + time_spec_t::from_ticks(total_num_samps_sent, _samp_rate);
-            if_packet_info.tsf = time_spec.to_ticks(_tick_rate);
+            // setup metadata for the next fragment, counting in samples from the
+            // start so the timestamps don't accumulate rounding errors
+            if_packet_info.tsf =
+                start_tsf + _time_model.samps_to_ticks(total_num_samps_sent);
             if_packet_info.sob = false;
         }
 
@@ -291,7 +338,8 @@ public:
 private:
     vrt_packer_type _vrt_packer;
     size_t _header_offset_words32;
-    double _tick_rate, _samp_rate;
+    //! Exact conversions between ticks, samples and time
+    rational_time_model _time_model;
     struct xport_chan_props_type
     {
         xport_chan_props_type(void) : has_sid(false), sid(0) {}
@@ -306,6 +354,10 @@ private:
     size_t _bytes_per_otw_item; // used in conversion
     size_t _bytes_per_cpu_item; // used in conversion
     uhd::convert::converter::sptr _converter; // used in conversion
+    uhd::convert::conv_fn_type _conv_fn; // used in conversion
+    uhd::convert::id_type _converter_id;
+    std::vector<uhd::stream_stage::sptr> _stages; // run before conversion
+    std::vector<std::vector<char>> _stage_buffs; // copies of the input samples
     size_t _max_samples_per_packet;
     std::vector<const void*> _zero_buffs;
     size_t _next_packet_seq;
@@ -313,6 +365,7 @@ private:
     async_receiver_type _async_receiver;
     bool _cached_metadata;
     uhd::tx_metadata_t _metadata_cache;
+    const std::shared_ptr<uhd::latency::mark_t> _eob_mark;
 
 #ifdef UHD_TXRX_DEBUG_PRINTS
     struct dbg_send_stat_t
@@ -362,7 +415,7 @@ private:
             nsamps_sent,
             metadata,
             timeout,
-            _samp_rate);
+            _time_model.get_samp_rate());
         if (dbg_print_directly) {
             dbg_print_err(data.print_line());
         }
@@ -411,6 +464,9 @@ private:
             convert_to_in_buff(i);
         }
 
+        if (if_packet_info.eob) {
+            UHD_LATENCY_MARK_SET(*_eob_mark);
+        }
         _next_packet_seq++; // increment sequence after commits
         return nsamps_per_buff;
     }
@@ -435,6 +491,27 @@ private:
             const char* b = reinterpret_cast<const char*>(buffs[index * _num_inputs + i]);
             io_buffs[i]   = b + _convert_buffer_offset_bytes;
         }
+
+        // run the stages on a copy of the input samples
+        if (not _stages.empty()) {
+            const size_t nbytes = _convert_nsamps * _bytes_per_cpu_item;
+            for (size_t i = 0; i < _num_inputs; i++) {
+                const size_t chan          = index * _num_inputs + i;
+                std::vector<char>& scratch = _stage_buffs[chan];
+                if (scratch.size() < nbytes) {
+                    scratch.resize(nbytes);
+                }
+                std::memcpy(scratch.data(), io_buffs[i], nbytes);
+                for (const auto& stage : _stages) {
+                    if (if_packet_info.has_tsf) {
+                        stage->set_time(chan,
+                            _time_model.ticks_to_time(if_packet_info.tsf));
+                    }
+                    stage->run(chan, scratch.data(), _convert_nsamps);
+                }
+                io_buffs[i] = scratch.data();
+            }
+        }
         const ref_vector<const void*> in_buffs(io_buffs, _num_inputs);
 
         // pack metadata into a vrt header
@@ -445,7 +522,7 @@ private:
         otw_mem += if_packet_info.num_header_words32;
 
         // perform the conversion operation
-        _converter->conv(in_buffs, otw_mem, _convert_nsamps);
+        _conv_fn(_converter.get(), in_buffs, otw_mem, _convert_nsamps);
 
         // commit the samples to the zero-copy interface
         const size_t num_vita_words32 =
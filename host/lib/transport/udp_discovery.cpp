@@ -0,0 +1,273 @@
+//
+// Copyright 2019 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include "udp_common.hpp"
+#include <uhd/transport/if_addrs.hpp>
+#include <uhd/utils/log.hpp>
+#include <uhd/utils/static.hpp>
+#include <uhdlib/transport/udp_discovery.hpp>
+#include <boost/enable_shared_from_this.hpp>
+#include <boost/format.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/weak_ptr.hpp>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <list>
+#include <map>
+#include <mutex>
+#include <set>
+#include <vector>
+
+using namespace uhd::transport;
+namespace asio = boost::asio;
+
+constexpr double udp_discovery::MIN_TIMEOUT;
+constexpr double udp_discovery::TIMEOUT_MARGIN;
+
+namespace {
+
+typedef std::chrono::steady_clock clock_t;
+
+class udp_discovery_impl;
+
+/***********************************************************************
+ * The socket which all discovery transports to an address share
+ **********************************************************************/
+struct shared_socket
+{
+    typedef boost::shared_ptr<shared_socket> sptr;
+
+    shared_socket(const std::string& addr) : socket(io_service)
+    {
+        asio::ip::udp::resolver resolver(io_service);
+        asio::ip::udp::resolver::query query(
+            asio::ip::udp::v4(), addr, "0", asio::ip::resolver_query_base::all_matching);
+        address = resolver.resolve(query)->endpoint().address();
+        socket.open(asio::ip::udp::v4());
+        socket.set_option(asio::socket_base::broadcast(true));
+    }
+
+    asio::io_service io_service;
+    asio::ip::udp::socket socket;
+    asio::ip::address address;
+
+    std::mutex mutex;
+    std::condition_variable datagram_cond;
+    //! True while a transport is receiving on the socket for all of them
+    bool receiving = false;
+    std::list<udp_discovery_impl*> transports;
+};
+
+//! Shared sockets by finder and address, and the last response times by finder,
+// address and port
+struct discovery_registry_t
+{
+    std::mutex mutex;
+    std::map<std::string, boost::weak_ptr<shared_socket>> sockets;
+    std::map<std::string, double> response_times;
+};
+
+UHD_SINGLETON_FCN(discovery_registry_t, get_registry)
+
+/***********************************************************************
+ * Discovery transport implementation
+ **********************************************************************/
+class udp_discovery_impl : public udp_discovery
+{
+public:
+    udp_discovery_impl(
+        const std::string& finder, const std::string& addr, const std::string& port)
+        : _key(finder + "/" + addr + ":" + port)
+    {
+        UHD_LOGGER_TRACE("UDP")
+            << boost::format("Creating udp discovery transport for %s %s %s") % finder
+                   % addr % port;
+        auto& registry = get_registry();
+        {
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            const std::string socket_key = finder + "/" + addr;
+            _socket = registry.sockets[socket_key].lock();
+            if (not _socket) {
+                _socket                      = boost::make_shared<shared_socket>(addr);
+                registry.sockets[socket_key] = _socket;
+            }
+        }
+        asio::ip::udp::resolver resolver(_socket->io_service);
+        asio::ip::udp::resolver::query query(asio::ip::udp::v4(), addr, port);
+        _send_endpoint = asio::ip::udp::endpoint(
+            _socket->address, resolver.resolve(query)->endpoint().port());
+        _broadcast = is_broadcast(_socket->address);
+
+        std::lock_guard<std::mutex> lock(_socket->mutex);
+        _socket->transports.push_back(this);
+    }
+
+    ~udp_discovery_impl(void)
+    {
+        {
+            std::lock_guard<std::mutex> lock(_socket->mutex);
+            _socket->transports.remove(this);
+        }
+        if (not _sent) {
+            return;
+        }
+        auto& registry = get_registry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        if (_max_response_time > 0.0) {
+            registry.response_times[_key] = _max_response_time;
+        } else {
+            // The device didn't answer (in time), so wait for it as long as
+            // the finder allows next time
+            registry.response_times.erase(_key);
+        }
+    }
+
+    size_t send(const asio::const_buffer& buff)
+    {
+        std::lock_guard<std::mutex> lock(_socket->mutex);
+        _send_time = clock_t::now();
+        _sent      = true;
+        return _socket->socket.send_to(asio::buffer(buff), _send_endpoint);
+    }
+
+    size_t recv(const asio::mutable_buffer& buff, double timeout)
+    {
+        const auto deadline = clock_t::now()
+                              + std::chrono::duration_cast<clock_t::duration>(
+                                    std::chrono::duration<double>(timeout));
+        std::vector<uint8_t> datagram(MAX_ETHERNET_MTU);
+        std::unique_lock<std::mutex> lock(_socket->mutex);
+        while (_datagrams.empty()) {
+            const auto now = clock_t::now();
+            if (now >= deadline) {
+                return 0;
+            }
+            if (_socket->receiving) {
+                // Another transport is receiving, and hands over our datagrams
+                _socket->datagram_cond.wait_until(lock, deadline);
+                continue;
+            }
+            // Receive for all transports until a datagram arrives
+            _socket->receiving = true;
+            lock.unlock();
+            size_t len = 0;
+            asio::ip::udp::endpoint sender;
+            const double remaining = std::chrono::duration<double>(deadline - now).count();
+            try {
+                if (wait_for_recv_ready(_socket->socket.native_handle(), remaining)) {
+                    len = _socket->socket.receive_from(asio::buffer(datagram), sender);
+                }
+            } catch (const std::exception& ex) {
+                UHD_LOG_DEBUG("UDP", "Discovery receive error: " << ex.what());
+            }
+            lock.lock();
+            _socket->receiving = false;
+            if (len > 0) {
+                _dispatch(datagram.data(), len, sender);
+            }
+            _socket->datagram_cond.notify_all();
+        }
+
+        const auto& next = _datagrams.front();
+        const size_t len = std::min(next.first.size(), asio::buffer_size(buff));
+        std::memcpy(asio::buffer_cast<void*>(buff), next.first.data(), len);
+        _recv_endpoint = next.second;
+        _datagrams.pop_front();
+        return len;
+    }
+
+    std::string get_recv_addr(void)
+    {
+        return _recv_endpoint.address().to_string();
+    }
+
+    std::string get_send_addr(void)
+    {
+        return _send_endpoint.address().to_string();
+    }
+
+    double get_timeout(const double max_timeout)
+    {
+        if (_broadcast) {
+            return max_timeout;
+        }
+        auto& registry = get_registry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        const auto response_time = registry.response_times.find(_key);
+        if (response_time == registry.response_times.end()) {
+            return max_timeout;
+        }
+        return std::min(
+            max_timeout, std::max(MIN_TIMEOUT, TIMEOUT_MARGIN * response_time->second));
+    }
+
+private:
+    //! True if addr is the broadcast address of any interface
+    static bool is_broadcast(const asio::ip::address& addr)
+    {
+        if (not addr.is_v4()) {
+            return false;
+        }
+        if (addr.to_v4() == asio::ip::address_v4::broadcast()) {
+            return true;
+        }
+        for (const if_addrs_t& if_addrs : get_if_addrs()) {
+            if (if_addrs.bcast == addr.to_string()) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    //! Hands a datagram to every transport which talks to its sender's port.
+    // Must be called with the socket mutex held.
+    void _dispatch(
+        const uint8_t* data, const size_t len, const asio::ip::udp::endpoint& sender)
+    {
+        const auto now = clock_t::now();
+        for (udp_discovery_impl* transport : _socket->transports) {
+            if (transport->_send_endpoint.port() != sender.port()
+                or not transport->_replies
+                           .emplace(sender, std::vector<uint8_t>(data, data + len))
+                           .second) {
+                continue;
+            }
+            transport->_datagrams.emplace_back(
+                std::vector<uint8_t>(data, data + len), sender);
+            if (transport->_sent) {
+                transport->_max_response_time = std::max(transport->_max_response_time,
+                    std::chrono::duration<double>(now - transport->_send_time).count());
+            }
+        }
+    }
+
+    const std::string _key;
+    shared_socket::sptr _socket;
+    bool _broadcast = false;
+    asio::ip::udp::endpoint _send_endpoint;
+    asio::ip::udp::endpoint _recv_endpoint;
+
+    // These are protected by the socket mutex
+    std::deque<std::pair<std::vector<uint8_t>, asio::ip::udp::endpoint>> _datagrams;
+    std::set<std::pair<asio::ip::udp::endpoint, std::vector<uint8_t>>> _replies;
+    bool _sent = false;
+    clock_t::time_point _send_time;
+    double _max_response_time = 0.0;
+};
+
+} // namespace
+
+/***********************************************************************
+ * Factory
+ **********************************************************************/
+udp_discovery::sptr udp_discovery::make(
+    const std::string& finder, const std::string& addr, const std::string& port)
+{
+    return sptr(new udp_discovery_impl(finder, addr, port));
+}
@@ -11,6 +11,7 @@
 #include <uhd/utils/log.hpp>
 #include <uhd/utils/safe_call.hpp>
 #include <uhd/utils/thread.hpp>
+#include <uhdlib/utils/thread_policy.hpp>
 #include <boost/bind.hpp>
 #include <boost/format.hpp>
 #include <boost/make_shared.hpp>
@@ -44,7 +45,7 @@ public:
         // the system calls onto other threads
         _recv_thread =
             boost::thread(boost::bind(&zero_copy_recv_offload_impl::enqueue_recv, this));
-        set_thread_name(&_recv_thread, "zero_copy_recv");
+        set_thread_name(&_recv_thread, uhd::thread_policy::RECV_OFFLOAD);
     }
 
     // Receive thread flags
@@ -73,6 +74,7 @@ public:
     // pulling pointers to managed receiver buffers quickly
     void enqueue_recv()
     {
+        uhd::thread_policy::apply(uhd::thread_policy::RECV_OFFLOAD);
         while (not is_recv_done()) {
             managed_recv_buffer::sptr buff = _transport->get_recv_buff(_timeout);
             if (not buff)
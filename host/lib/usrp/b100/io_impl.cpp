@@ -142,6 +142,8 @@ rx_streamer::sptr b100_impl::get_rx_stream(const uhd::stream_args_t &args_){
     id.output_format = args.cpu_format;
     id.num_outputs = 1;
     my_streamer->set_converter(id);
+    my_streamer->set_stages(args.stages, args.cpu_format);
+    my_streamer->set_squelch(args.squelch);
 
     //bind callbacks for the handler
     for (size_t chan_i = 0; chan_i < args.channels.size(); chan_i++){
@@ -201,6 +203,7 @@ tx_streamer::sptr b100_impl::get_tx_stream(const uhd::stream_args_t &args_){
     id.output_format = args.otw_format + "_item32_le";
     id.num_outputs = 1;
     my_streamer->set_converter(id);
+    my_streamer->set_stages(args.stages, args.cpu_format);
 
     //bind callbacks for the handler
     for (size_t chan_i = 0; chan_i < args.channels.size(); chan_i++){
@@ -450,6 +450,8 @@ rx_streamer::sptr b200_impl::get_rx_stream(const uhd::stream_args_t& args_)
         id.output_format = args.cpu_format;
         id.num_outputs   = 1;
         my_streamer->set_converter(id);
+        my_streamer->set_stages(args.stages, args.cpu_format);
+        my_streamer->set_squelch(args.squelch);
 
         perif.framer->clear();
         perif.framer->set_nsamps_per_packet(spp);
@@ -569,6 +571,7 @@ tx_streamer::sptr b200_impl::get_tx_stream(const uhd::stream_args_t& args_)
         id.output_format = args.otw_format + "_item32_le";
         id.num_outputs   = 1;
         my_streamer->set_converter(id);
+        my_streamer->set_stages(args.stages, args.cpu_format);
 
         perif.deframer->clear();
         perif.deframer->setup(args);
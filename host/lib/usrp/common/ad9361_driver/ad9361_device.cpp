@@ -13,6 +13,7 @@
 #define _USE_MATH_DEFINES
 #include <uhd/exception.hpp>
 #include <uhd/utils/log.hpp>
+#include <uhdlib/utils/lock_wait.hpp>
 
 #include <boost/scoped_array.hpp>
 #include <boost/format.hpp>
@@ -87,6 +88,10 @@ const double ad9361_device_t::AD9361_CAL_VALID_WINDOW = 100e6;
 // Max bandwdith is due to filter rolloff in analog filter stage
 const double ad9361_device_t::AD9361_MIN_BW = 200e3;
 const double ad9361_device_t::AD9361_MAX_BW = 56e6;
+// The RF PLL lock bit is only valid once the VCO calibration after a retune
+// is under way, so it's first read after the time the driver always waited
+const double ad9361_device_t::AD9361_PLL_SETTLE_TIME  = 0.002;
+const double ad9361_device_t::AD9361_PLL_LOCK_TIMEOUT = 0.010;
 
 /* Startup RF frequencies */
 const double ad9361_device_t::DEFAULT_RX_FREQ = 800e6;
@@ -237,6 +242,18 @@ void ad9361_device_t::_setup_tx_fir(size_t num_taps, int32_t interpolation)
  * Calibration functions
  ***********************************************************************/
 
+/* Wait for a calibration to finish.
+ *
+ * The calibrations in register 0x016 are started by setting their bit, and
+ * the bit clears when they're done. */
+bool ad9361_device_t::_wait_for_cal_done(
+    const std::string &name, uint8_t cal_bit, double timeout, double max_interval)
+{
+    return uhd::wait_for_lock(name,
+        [this, cal_bit]() { return (_io_iface->peek8(0x016) & cal_bit) == 0; },
+        timeout, max_interval);
+}
+
 /* Calibrate and lock the BBPLL.
  *
  * This function should be called anytime the BBPLL is tuned. */
@@ -251,14 +268,10 @@ void ad9361_device_t::_calibrate_lock_bbpll()
     _io_iface->poke8(0x04d, 0x05);
 
     /* Wait for BBPLL lock. */
-    size_t count = 0;
-    while (!(_io_iface->peek8(0x05e) & 0x80)) {
-        if (count > 1000) {
-            throw uhd::runtime_error("[ad9361_device_t] BBPLL not locked");
-            break;
-        }
-        count++;
-        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    if (!uhd::wait_for_lock("ad9361::bbpll_lock",
+            [this]() { return (_io_iface->peek8(0x05e) & 0x80) != 0; },
+            2.0, 0.002)) {
+        throw uhd::runtime_error("[ad9361_device_t] BBPLL not locked");
     }
 }
 
@@ -275,28 +288,20 @@ void ad9361_device_t::_calibrate_synth_charge_pumps()
     }
 
     /* Calibrate the RX synthesizer charge pump. */
-    size_t count = 0;
     _io_iface->poke8(0x23d, 0x04);
-    while (!(_io_iface->peek8(0x244) & 0x80)) {
-        if (count > 5) {
-            throw uhd::runtime_error("[ad9361_device_t] RX charge pump cal failure");
-            break;
-        }
-        count++;
-        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    if (!uhd::wait_for_lock("ad9361::rx_charge_pump_cal",
+            [this]() { return (_io_iface->peek8(0x244) & 0x80) != 0; },
+            0.006)) {
+        throw uhd::runtime_error("[ad9361_device_t] RX charge pump cal failure");
     }
     _io_iface->poke8(0x23d, 0x00);
 
     /* Calibrate the TX synthesizer charge pump. */
-    count = 0;
     _io_iface->poke8(0x27d, 0x04);
-    while (!(_io_iface->peek8(0x284) & 0x80)) {
-        if (count > 5) {
-            throw uhd::runtime_error("[ad9361_device_t] TX charge pump cal failure");
-            break;
-        }
-        count++;
-        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    if (!uhd::wait_for_lock("ad9361::tx_charge_pump_cal",
+            [this]() { return (_io_iface->peek8(0x284) & 0x80) != 0; },
+            0.006)) {
+        throw uhd::runtime_error("[ad9361_device_t] TX charge pump cal failure");
     }
     _io_iface->poke8(0x27d, 0x00);
 }
@@ -349,15 +354,9 @@ double ad9361_device_t::_calibrate_baseband_rx_analog_filter(double req_rfbw)
     _io_iface->poke8(0x1e3, 0x02);
 
     /* Run the calibration! */
-    size_t count = 0;
     _io_iface->poke8(0x016, 0x80);
-    while (_io_iface->peek8(0x016) & 0x80) {
-        if (count > 100) {
-            throw uhd::runtime_error("[ad9361_device_t] RX baseband filter cal FAILURE");
-            break;
-        }
-        count++;
-        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    if (!_wait_for_cal_done("ad9361::rx_bbf_cal", 0x80, 0.1, 0.001)) {
+        throw uhd::runtime_error("[ad9361_device_t] RX baseband filter cal FAILURE");
     }
 
     /* Disable RX1 & RX2 filter tuners. */
@@ -405,16 +404,9 @@ double ad9361_device_t::_calibrate_baseband_tx_analog_filter(double req_rfbw)
     _io_iface->poke8(0x0ca, 0x22);
 
     /* Calibrate! */
-    size_t count = 0;
     _io_iface->poke8(0x016, 0x40);
-    while (_io_iface->peek8(0x016) & 0x40) {
-        if (count > 100) {
-            throw uhd::runtime_error("[ad9361_device_t] TX baseband filter cal FAILURE");
-            break;
-        }
-
-        count++;
-        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    if (!_wait_for_cal_done("ad9361::tx_bbf_cal", 0x40, 0.1, 0.001)) {
+        throw uhd::runtime_error("[ad9361_device_t] TX baseband filter cal FAILURE");
     }
 
     /* Disable the filter tuner. */
@@ -726,15 +718,9 @@ void ad9361_device_t::_calibrate_baseband_dc_offset()
     _io_iface->poke8(0x194, 0x01); // More calibration settings
 
     /* Start that calibration, baby. */
-    size_t count = 0;
     _io_iface->poke8(0x016, 0x01);
-    while (_io_iface->peek8(0x016) & 0x01) {
-        if (count > 100) {
-            throw uhd::runtime_error("[ad9361_device_t] Baseband DC Offset Calibration Failure");
-            break;
-        }
-        count++;
-        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    if (!_wait_for_cal_done("ad9361::bb_dc_offset_cal", 0x01, 0.5, 0.005)) {
+        throw uhd::runtime_error("[ad9361_device_t] Baseband DC Offset Calibration Failure");
     }
 }
 
@@ -759,15 +745,9 @@ void ad9361_device_t::_calibrate_rf_dc_offset()
     _io_iface->poke8(0x189, 0x30);
 
     /* Run the calibration! */
-    size_t count = 0;
     _io_iface->poke8(0x016, 0x02);
-    while (_io_iface->peek8(0x016) & 0x02) {
-        if (count > 200) {
-            throw uhd::runtime_error("[ad9361_device_t] RF DC Offset Calibration Failure");
-            break;
-        }
-        count++;
-        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    if (!_wait_for_cal_done("ad9361::rf_dc_offset_cal", 0x02, 10.0, 0.05)) {
+        throw uhd::runtime_error("[ad9361_device_t] RF DC Offset Calibration Failure");
     }
 
     _io_iface->poke8(0x18b, 0x8d); // Enable RF DC tracking
@@ -810,15 +790,9 @@ void ad9361_device_t::_calibrate_rx_quadrature()
     double current_tx_freq = _tx_freq;
     _tune_helper(TX, _rx_freq + _rx_bb_lp_bw / 2.0);
 
-    size_t count = 0;
     _io_iface->poke8(0x016, 0x20);
-    while (_io_iface->peek8(0x016) & 0x20) {
-        if (count > 1000) {
-            throw uhd::runtime_error("[ad9361_device_t] Rx Quadrature Calibration Failure");
-            break;
-        }
-        count++;
-        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    if (!_wait_for_cal_done("ad9361::rx_quadrature_cal", 0x20, 5.0, 0.005)) {
+        throw uhd::runtime_error("[ad9361_device_t] Rx Quadrature Calibration Failure");
     }
 
     _io_iface->poke8(0x057, 0x30); // Re-enable Tx mixers
@@ -878,15 +852,9 @@ void ad9361_device_t::_tx_quadrature_cal_routine() {
     _io_iface->poke8(0x0ae, 0x00); // Cal LPF gain index (split mode)
 
     /* Now, calibrate the TX quadrature! */
-    size_t count = 0;
     _io_iface->poke8(0x016, 0x10);
-    while (_io_iface->peek8(0x016) & 0x10) {
-        if (count > 100) {
-            throw uhd::runtime_error("[ad9361_device_t] TX Quadrature Calibration Failure");
-            break;
-        }
-        count++;
-        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    if (!_wait_for_cal_done("ad9361::tx_quadrature_cal", 0x10, 1.0, 0.01)) {
+        throw uhd::runtime_error("[ad9361_device_t] TX Quadrature Calibration Failure");
     }
 }
 
@@ -1315,9 +1283,11 @@ double ad9361_device_t::_tune_helper(direction_t direction, const double value)
         _io_iface->poke8(0x231, nint & 0xFF);
         _io_iface->poke8(0x005, _regs.vcodivs);
 
-        /* Lock the PLL! */
-        std::this_thread::sleep_for(std::chrono::milliseconds(2));
-        if ((_io_iface->peek8(0x247) & 0x02) == 0) {
+        /* Lock the PLL! The lock bit may still show the old lock at first. */
+        if (!uhd::wait_for_lock("ad9361::rx_pll_lock",
+                [this]() { return (_io_iface->peek8(0x247) & 0x02) != 0; },
+                AD9361_PLL_LOCK_TIMEOUT, uhd::LOCK_WAIT_MAX_INTERVAL,
+                AD9361_PLL_SETTLE_TIME)) {
             throw uhd::runtime_error("[ad9361_device_t] RX PLL NOT LOCKED");
         }
 
@@ -1356,9 +1326,11 @@ double ad9361_device_t::_tune_helper(direction_t direction, const double value)
         _io_iface->poke8(0x271, nint & 0xFF);
         _io_iface->poke8(0x005, _regs.vcodivs);
 
-        /* Lock the PLL! */
-        std::this_thread::sleep_for(std::chrono::milliseconds(2));
-        if ((_io_iface->peek8(0x287) & 0x02) == 0) {
+        /* Lock the PLL! The lock bit may still show the old lock at first. */
+        if (!uhd::wait_for_lock("ad9361::tx_pll_lock",
+                [this]() { return (_io_iface->peek8(0x287) & 0x02) != 0; },
+                AD9361_PLL_LOCK_TIMEOUT, uhd::LOCK_WAIT_MAX_INTERVAL,
+                AD9361_PLL_SETTLE_TIME)) {
             throw uhd::runtime_error("[ad9361_device_t] TX PLL NOT LOCKED");
         }
 
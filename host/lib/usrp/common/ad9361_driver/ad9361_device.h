@@ -256,6 +256,8 @@ public:
     static const double AD9361_CAL_VALID_WINDOW;
     static const double AD9361_MIN_BW;
     static const double AD9361_MAX_BW;
+    static const double AD9361_PLL_SETTLE_TIME;
+    static const double AD9361_PLL_LOCK_TIMEOUT;
     static const double DEFAULT_RX_FREQ;
     static const double DEFAULT_TX_FREQ;
 
@@ -266,6 +268,8 @@ private:    //Methods
     void _program_fir_filter(direction_t direction, chain_t chain, int num_taps, uint16_t *coeffs);
     void _setup_tx_fir(size_t num_taps);
     void _setup_rx_fir(size_t num_taps);
+    bool _wait_for_cal_done(
+        const std::string &name, uint8_t cal_bit, double timeout, double max_interval);
     void _calibrate_lock_bbpll();
     void _calibrate_synth_charge_pumps();
     double _calibrate_baseband_rx_analog_filter(double rfbw);
@@ -10,6 +10,7 @@
 #include <uhd/utils/log.hpp>
 #include <uhdlib/rfnoc/ctrl_iface.hpp>
 #include <uhdlib/rfnoc/graph_impl.hpp>
+#include <uhdlib/utils/trace.hpp>
 #include <boost/make_shared.hpp>
 #include <algorithm>
 
@@ -99,6 +100,7 @@ void device3_impl::enumerate_rfnoc_blocks(size_t device_index,
     const uhd::sid_t& base_sid,
     uhd::device_addr_t transport_args)
 {
+    UHD_TRACE_SCOPE("device3::enumerate_rfnoc_blocks");
     // entries that are already connected to this block
     uhd::sid_t ctrl_sid = base_sid;
     uhd::property_tree::sptr subtree =
@@ -20,7 +20,12 @@
 #include <uhdlib/rfnoc/rx_stream_terminator.hpp>
 #include <uhdlib/rfnoc/tx_stream_terminator.hpp>
 #include <uhdlib/usrp/common/async_packet_handler.hpp>
+#include <uhdlib/utils/latency_histogram.hpp>
+#include <uhdlib/utils/thread_policy.hpp>
+#include <uhdlib/utils/trace.hpp>
 #include <boost/atomic.hpp>
+#include <chrono>
+#include <memory>
 
 #define UHD_TX_STREAMER_LOG() UHD_LOGGER_TRACE("STREAMER")
 #define UHD_RX_STREAMER_LOG() UHD_LOGGER_TRACE("STREAMER")
@@ -191,6 +196,8 @@ struct async_tx_info_t
     size_t device_channel;
     boost::shared_ptr<device3_impl::async_md_type> async_queue;
     boost::shared_ptr<device3_impl::async_md_type> old_async_queue;
+    //! Set by the streamer when it sends an end of burst
+    std::shared_ptr<uhd::latency::mark_t> eob_mark;
 };
 
 /*! Handle incoming messages.
@@ -243,6 +250,9 @@ static void handle_tx_async_msgs(boost::shared_ptr<async_tx_info_t> async_info,
             << "Unexpected flow control message found in async message handling"
             << std::endl;
     } else {
+        if (metadata.event_code == async_metadata_t::EVENT_CODE_BURST_ACK) {
+            UHD_LATENCY_MARK_RECORD("tx_eob_to_burst_ack", *async_info->eob_mark);
+        }
         async_info->async_queue->push_with_pop_on_full(metadata);
         metadata.channel = async_info->device_channel;
         async_info->old_async_queue->push_with_pop_on_full(metadata);
@@ -291,6 +301,7 @@ void device3_impl::update_rx_streamers()
 
 rx_streamer::sptr device3_impl::get_rx_stream(const stream_args_t& args_)
 {
+    uhd::trace::scoped_span setup_span("device3::get_rx_stream", "stream");
     boost::mutex::scoped_lock lock(_transport_setup_mutex);
     stream_args_t args = sanitize_stream_args(args_);
 
@@ -371,12 +382,18 @@ rx_streamer::sptr device3_impl::get_rx_stream(const stream_args_t& args_)
         // allocate sid and create transport
         uhd::sid_t stream_address = blk_ctrl->get_address(block_port);
         UHD_RX_STREAMER_LOG() << "creating rx stream " << rx_hints.to_string();
+        const auto xport_start = std::chrono::steady_clock::now();
         both_xports_t xport = make_transport(stream_address, RX_DATA, rx_hints);
+        uhd::trace::add_span("device3::get_rx_stream: make_transport",
+            "stream",
+            xport_start,
+            std::chrono::steady_clock::now());
         UHD_RX_STREAMER_LOG() << std::hex << "data_sid = " << xport.send_sid << std::dec
                               << " actual recv_buff_size = " << xport.recv_buff_size;
 
         // Configure the block
         // Flow control setup
+        const auto fc_start   = std::chrono::steady_clock::now();
         const size_t pkt_size = xport.recv->get_recv_frame_size();
         // Leave one pkt_size space for overrun packets - TODO make this obsolete
         const size_t fc_window =
@@ -428,6 +445,10 @@ rx_streamer::sptr device3_impl::get_rx_stream(const stream_args_t& args_)
         blk_ctrl->sr_write(
             uhd::rfnoc::SR_RESP_OUT_DST_SID, xport.send_sid.get_src(), block_port);
         UHD_RX_STREAMER_LOG() << "resp_out_dst_sid == " << xport.send_sid.get_src();
+        uhd::trace::add_span("device3::get_rx_stream: flow_control",
+            "stream",
+            fc_start,
+            std::chrono::steady_clock::now());
 
         // Find all upstream radio nodes and set their response in SID to the host
         std::vector<boost::shared_ptr<uhd::rfnoc::radio_ctrl>> upstream_radio_nodes =
@@ -476,6 +497,8 @@ rx_streamer::sptr device3_impl::get_rx_stream(const stream_args_t& args_)
         id.output_format = args.cpu_format;
         id.num_outputs   = 1;
         my_streamer->set_converter(id);
+        my_streamer->set_stages(args.stages, args.cpu_format);
+        my_streamer->set_squelch(args.squelch);
 
         // Give the streamer a functor to handle flow control ACK messages
         my_streamer->set_xport_handle_flowctrl_ack(
@@ -484,10 +507,15 @@ rx_streamer::sptr device3_impl::get_rx_stream(const stream_args_t& args_)
             });
 
         // Give the streamer a functor to get the recv_buffer
+        const auto flush_start = std::chrono::steady_clock::now();
         my_streamer->set_xport_chan_get_buff(stream_i,
             [xport](double timeout) { return xport.recv->get_recv_buff(timeout); },
             true /*flush*/
         );
+        uhd::trace::add_span("device3::get_rx_stream: flush_transport",
+            "stream",
+            flush_start,
+            std::chrono::steady_clock::now());
 
         // Give the streamer a functor to handle overruns
         // bind requires a weak_ptr to break the a streamer->streamer circular dependency
@@ -769,15 +797,17 @@ tx_streamer::sptr device3_impl::get_tx_stream(const uhd::stream_args_t& args_)
         id.output_format = args.otw_format + "_item32_" + conv_endianness;
         id.num_outputs   = 1;
         my_streamer->set_converter(id);
+        my_streamer->set_stages(args.stages, args.cpu_format);
 
         boost::shared_ptr<async_tx_info_t> async_tx_info(new async_tx_info_t());
         async_tx_info->stream_channel  = args.channels[stream_i];
         async_tx_info->device_channel  = mb_index;
         async_tx_info->async_queue     = async_md;
         async_tx_info->old_async_queue = _async_md;
+        async_tx_info->eob_mark        = my_streamer->get_eob_mark();
 
-        task::sptr async_task =
-            task::make([async_tx_info, async_xport, xport, send_terminator]() {
+        task::sptr async_task = task::make(
+            [async_tx_info, async_xport, xport, send_terminator]() {
                 handle_tx_async_msgs(async_tx_info,
                     async_xport.recv,
                     xport.endianness == ENDIANNESS_BIG ? uhd::ntohx<uint32_t>
@@ -785,7 +815,8 @@ tx_streamer::sptr device3_impl::get_tx_stream(const uhd::stream_args_t& args_)
                     xport.endianness == ENDIANNESS_BIG ? vrt::chdr::if_hdr_unpack_be
                                                        : vrt::chdr::if_hdr_unpack_le,
                     [send_terminator]() { return send_terminator->get_tick_rate(); });
-            });
+            },
+            uhd::thread_policy::TX_ASYNC);
         my_streamer->add_async_msg_task(async_task);
 
         // Give the streamer a functor to get the send buffer
@@ -9,6 +9,7 @@
 #include "mpmd_devices.hpp"
 #include "mpmd_impl.hpp"
 #include <uhdlib/transport/dpdk_common.hpp>
+#include <uhdlib/transport/udp_discovery.hpp>
 #include <uhd/transport/if_addrs.hpp>
 #include <uhd/transport/udp_simple.hpp>
 #include <uhd/types/device_addr.hpp>
@@ -45,15 +46,17 @@ device_addrs_t mpmd_find_with_addr(
     UHD_LOG_DEBUG("MPMD", "Discovering MPM devices on port " << mpm_discovery_port);
 
     device_addrs_t addrs;
-    transport::udp_simple::sptr comm =
-        transport::udp_simple::make_broadcast(mgmt_addr, mpm_discovery_port);
+    transport::udp_discovery::sptr comm =
+        transport::udp_discovery::make("mpmd", mgmt_addr, mpm_discovery_port);
+    // Only wait as long as the device takes to reply, if it's not a broadcast
+    const double timeout = comm->get_timeout(MPMD_FIND_TIMEOUT);
     comm->send(boost::asio::buffer(
         mpmd_impl::MPM_DISCOVERY_CMD.c_str(), mpmd_impl::MPM_DISCOVERY_CMD.size()));
     while (true) {
         const size_t MAX_MTU = 8000;
         char buff[MAX_MTU]   = {};
         const size_t nbytes =
-            comm->recv(boost::asio::buffer(buff, MAX_MTU), MPMD_FIND_TIMEOUT);
+            comm->recv(boost::asio::buffer(buff, MAX_MTU), timeout);
         if (nbytes == 0) {
             break;
         }
@@ -14,6 +14,7 @@
 #include <uhd/utils/tasks.hpp>
 #include <uhdlib/rfnoc/radio_ctrl_impl.hpp>
 #include <uhdlib/rfnoc/rpc_block_ctrl.hpp>
+#include <uhdlib/utils/trace.hpp>
 #include <../device3/device3_impl.hpp>
 #include <boost/algorithm/string.hpp>
 #include <boost/asio.hpp>
@@ -257,6 +258,7 @@ mpmd_mboard_impl::uptr mpmd_impl::claim_and_make(const uhd::device_addr_t& devic
 void mpmd_impl::setup_mb(
     mpmd_mboard_impl* mb, const size_t mb_index, const size_t base_xport_addr)
 {
+    UHD_TRACE_SCOPE("mpmd::setup_mb");
     assert_compat_number_throw("MPM",
         MPM_COMPAT_NUM,
         mb->rpc->request<std::vector<size_t>>("get_mpm_compat_num"),
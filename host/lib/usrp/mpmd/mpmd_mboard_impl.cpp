@@ -9,6 +9,8 @@
 #include <uhd/transport/udp_simple.hpp>
 #include <uhd/utils/log.hpp>
 #include <uhd/utils/safe_call.hpp>
+#include <uhdlib/utils/thread_policy.hpp>
+#include <uhdlib/utils/trace.hpp>
 #include <chrono>
 #include <thread>
 
@@ -64,6 +66,7 @@ bool is_pingable(const std::string& ip_addr, const std::string& udp_port)
  */
 void init_device(uhd::rpc_client::sptr rpc, const uhd::device_addr_t mb_args)
 {
+    UHD_TRACE_SCOPE("mpmd::init_device");
     auto init_status = rpc->request_with_token<std::vector<std::string>>(
         MPMD_DEFAULT_INIT_TIMEOUT, "get_init_status");
     if (init_status[0] != "true") {
@@ -157,6 +160,7 @@ uhd::rpc_client::sptr make_mpm_rpc_client(const std::string& rpc_server_addr,
     const uhd::device_addr_t& mb_args,
     const size_t timeout_ms = MPMD_DEFAULT_RPC_TIMEOUT)
 {
+    UHD_TRACE_SCOPE("mpmd::rpc_connect");
     return uhd::rpc_client::make(rpc_server_addr,
         mb_args.cast<size_t>(
             uhd::mpmd::mpmd_impl::MPM_RPC_PORT_KEY, uhd::mpmd::mpmd_impl::MPM_RPC_PORT),
@@ -267,6 +271,7 @@ mpmd_mboard_impl::mpmd_mboard_impl(
     UHD_LOGGER_TRACE("MPMD") << "Initializing mboard, connecting to RPC server address: "
                              << rpc_server_addr << " mboard args: " << mb_args.to_string()
                              << " number of crossbars: " << num_xbars;
+    UHD_TRACE_SCOPE("mpmd::mboard_rpc_setup");
 
     _claimer_task = claim_device_and_make_task();
     if (mb_args_.has_key(MPMD_MEAS_LATENCY_KEY)) {
@@ -446,7 +451,7 @@ uhd::task::sptr mpmd_mboard_impl::claim_device_and_make_task()
             std::this_thread::sleep_until(
                 now + std::chrono::milliseconds(MPMD_RECLAIM_INTERVAL_MS));
         },
-        "mpmd_claimer_task");
+        uhd::thread_policy::CLAIMER);
 }
 
 void mpmd_mboard_impl::dump_logs(const bool dump_to_null)
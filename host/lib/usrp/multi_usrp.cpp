@@ -18,8 +18,11 @@
 #include <uhd/usrp/dboard_eeprom.hpp>
 #include <uhd/convert.hpp>
 #include <uhd/utils/soft_register.hpp>
+#include <uhdlib/dsp/channelizer_streamer.hpp>
+#include <uhdlib/dsp/host_rate_streamer.hpp>
 #include <uhdlib/usrp/gpio_defs.hpp>
 #include <uhdlib/rfnoc/legacy_compat.hpp>
+#include <uhdlib/utils/trace.hpp>
 #include <boost/assign/list_of.hpp>
 #include <boost/format.hpp>
 #include <boost/algorithm/string.hpp>
@@ -992,6 +995,12 @@ public:
      * RX methods
      ******************************************************************/
     rx_streamer::sptr get_rx_stream(const stream_args_t &args) {
+        if (args.args.has_key("channelizer")) {
+            return _get_channelizer_rx_stream(args);
+        }
+        if (args.args.has_key("host_rate")) {
+            return _get_host_rate_rx_stream(args);
+        }
         _check_link_rate(args, false);
         if (is_device3()) {
             return _legacy_compat->get_rx_stream(args);
@@ -999,6 +1008,55 @@ public:
         return this->get_device()->get_rx_stream(args);
     }
 
+    //! Create a streamer which resamples from the RX rate to args["host_rate"]
+    rx_streamer::sptr _get_host_rate_rx_stream(const stream_args_t &args) {
+        stream_args_t device_args = args;
+        const double host_rate = args.args.cast<double>("host_rate", 0.0);
+        const size_t taps_per_phase = args.args.cast<size_t>("host_rate_taps", 32);
+        device_args.args.pop("host_rate");
+        if (device_args.args.has_key("host_rate_taps")) {
+            device_args.args.pop("host_rate_taps");
+        }
+        const size_t chan = args.channels.empty() ? 0 : args.channels.front();
+        const double device_rate = get_rx_rate(chan);
+        const double actual_rate =
+            uhd::dsp::get_host_rate_actual(device_rate, host_rate);
+        UHD_LOGGER_DEBUG("MULTI_USRP") << boost::format(
+            "Resampling RX samples on the host from %f MSps to %f MSps")
+            % (device_rate/1e6) % (actual_rate/1e6);
+        if (std::abs(host_rate - actual_rate) > 1e-9 * host_rate) {
+            UHD_LOGGER_WARNING("MULTI_USRP") << boost::format(
+                "The host-side resampler does not support the requested rate exactly:\n"
+                "Target host sample rate: %f MSps\n"
+                "Actual host sample rate: %f MSps\n"
+            ) % (host_rate/1e6) % (actual_rate/1e6);
+        }
+        return uhd::dsp::make_host_rate_rx_streamer(get_rx_stream(device_args),
+            args.cpu_format, device_rate, host_rate, taps_per_phase);
+    }
+
+    //! Create a streamer which splits one RX channel into args["channelizer"]
+    rx_streamer::sptr _get_channelizer_rx_stream(const stream_args_t &args) {
+        if (args.channels.size() > 1 or args.args.has_key("host_rate")) {
+            throw uhd::value_error("The channelizer requires a single RX channel, "
+                                   "and can't be combined with host_rate");
+        }
+        stream_args_t device_args = args;
+        const size_t num_chans = args.args.cast<size_t>("channelizer", 0);
+        const size_t taps_per_chan = args.args.cast<size_t>("channelizer_taps", 12);
+        const size_t num_threads = args.args.cast<size_t>("channelizer_threads", 1);
+        for (const std::string key : {"channelizer", "channelizer_taps", "channelizer_threads"}) {
+            if (device_args.args.has_key(key)) {
+                device_args.args.pop(key);
+            }
+        }
+        // The filterbank reads the wideband samples as sc16
+        device_args.cpu_format = "sc16";
+        const size_t chan = args.channels.empty() ? 0 : args.channels.front();
+        return uhd::dsp::make_channelizer_rx_streamer(get_rx_stream(device_args),
+            args.cpu_format, get_rx_rate(chan), num_chans, taps_per_chan, num_threads);
+    }
+
     void set_rx_subdev_spec(const subdev_spec_t &spec, size_t mboard){
         if (mboard != ALL_MBOARDS){
             _tree->access<subdev_spec_t>(mb_root(mboard) / "rx_subdev_spec").set(spec);
@@ -2757,5 +2815,12 @@ multi_usrp::~multi_usrp(void){
  **********************************************************************/
 multi_usrp::sptr multi_usrp::make(const device_addr_t &dev_addr){
     UHD_LOGGER_TRACE("MULTI_USRP") << "multi_usrp::make with args " << dev_addr.to_pp_string() ;
-    return sptr(new multi_usrp_impl(dev_addr));
+    sptr usrp;
+    {
+        UHD_TRACE_SCOPE("multi_usrp::make");
+        usrp = sptr(new multi_usrp_impl(dev_addr));
+    }
+    // The trace written by device::make() lacks the multi_usrp setup
+    uhd::trace::write_file();
+    return usrp;
 }
@@ -14,6 +14,7 @@
 #include <uhd/utils/log.hpp>
 #include <uhd/utils/platform.hpp>
 #include <uhd/utils/paths.hpp>
+#include <uhdlib/utils/thread_policy.hpp>
 #include <boost/format.hpp>
 #include <boost/functional/hash.hpp>
 #include <boost/make_shared.hpp>
@@ -118,7 +119,9 @@ n230_resource_manager::n230_resource_manager(
     _check_fw_compat();
 
     //Start the device claimer
-    _claimer_task = uhd::task::make(boost::bind(&n230_resource_manager::_claimer_loop, this));
+    _claimer_task = uhd::task::make(
+        boost::bind(&n230_resource_manager::_claimer_loop, this),
+        uhd::thread_policy::CLAIMER);
 
     //Create common settings interface
     const sid_t core_sid = _generate_sid(CORE, _get_conn(PRI_ETH).type);
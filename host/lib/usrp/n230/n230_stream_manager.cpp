@@ -110,6 +110,8 @@ rx_streamer::sptr n230_stream_manager::get_rx_stream(const uhd::stream_args_t &a
         id.output_format = args.cpu_format;
         id.num_outputs = 1;
         my_streamer->set_converter(id);
+        my_streamer->set_stages(args.stages, args.cpu_format);
+        my_streamer->set_squelch(args.squelch);
 
         perif.framer->clear();
         perif.framer->set_nsamps_per_packet(spp);
@@ -235,6 +237,7 @@ tx_streamer::sptr n230_stream_manager::get_tx_stream(const uhd::stream_args_t &a
         id.output_format = args.otw_format + "_item32_be";
         id.num_outputs = 1;
         my_streamer->set_converter(id);
+        my_streamer->set_stages(args.stages, args.cpu_format);
 
         perif.deframer->clear();
         perif.deframer->setup(args);
@@ -0,0 +1,758 @@
+//
+// Copyright 2019 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include <uhd/exception.hpp>
+#include <uhd/shm_stream.hpp>
+#include <uhd/usrp/session.hpp>
+#include <uhd/utils/log.hpp>
+#include <uhd/utils/platform.hpp>
+#include <boost/algorithm/string.hpp>
+#include <boost/asio.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/format.hpp>
+#include <boost/lexical_cast.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace uhd;
+using namespace uhd::usrp;
+namespace asio = boost::asio;
+
+const size_t session_client::DEFAULT_RING_CAPACITY;
+
+session_server::~session_server(void)
+{
+    /* NOP */
+}
+
+session_client::~session_client(void)
+{
+    /* NOP */
+}
+
+#ifdef BOOST_ASIO_HAS_LOCAL_SOCKETS
+
+namespace {
+
+/***********************************************************************
+ * Wire format
+ *
+ * A request is the name of the method on a line, followed by one line per
+ * argument ("key=value") and an empty line. The response is a single line,
+ * "ok <result>" or "error <message>".
+ **********************************************************************/
+const std::string REQUEST_END    = "\n\n";
+const std::string RESPONSE_OK    = "ok ";
+const std::string RESPONSE_ERROR = "error ";
+
+std::string encode_request(const std::string& method, const device_addr_t& args)
+{
+    if (method.empty() or method.find('\n') != std::string::npos) {
+        throw uhd::value_error("session: Invalid method: " + method);
+    }
+    std::string request = method + "\n";
+    for (const std::string& key : args.keys()) {
+        const std::string& value = args[key];
+        if (key.empty() or key.find_first_of("=\n") != std::string::npos
+            or value.find('\n') != std::string::npos) {
+            throw uhd::value_error("session: Invalid argument: " + key);
+        }
+        request += key + "=" + value + "\n";
+    }
+    return request + "\n";
+}
+
+void decode_request(const std::string& request, std::string& method, device_addr_t& args)
+{
+    std::vector<std::string> lines;
+    boost::split(lines, request, boost::is_any_of("\n"));
+    method = lines.at(0);
+    for (size_t i = 1; i < lines.size(); i++) {
+        if (lines[i].empty()) {
+            continue;
+        }
+        const size_t pos = lines[i].find('=');
+        if (pos == std::string::npos) {
+            throw uhd::value_error("session: Invalid argument: " + lines[i]);
+        }
+        args[lines[i].substr(0, pos)] = lines[i].substr(pos + 1);
+    }
+}
+
+//! Replace the line breaks of a result or message
+std::string to_line(std::string str)
+{
+    std::replace(str.begin(), str.end(), '\n', ' ');
+    return str;
+}
+
+template <typename T> std::string to_str(const T& value)
+{
+    return boost::lexical_cast<std::string>(value);
+}
+
+//! Get a mandatory argument
+template <typename T> T get_arg(const device_addr_t& args, const std::string& key)
+{
+    if (not args.has_key(key)) {
+        throw uhd::key_error("session: Missing argument: " + key);
+    }
+    try {
+        return boost::lexical_cast<T>(args[key]);
+    } catch (const boost::bad_lexical_cast&) {
+        throw uhd::value_error("session: Invalid argument: " + key + "=" + args[key]);
+    }
+}
+
+size_t get_chan(const device_addr_t& args)
+{
+    return args.has_key("chan") ? get_arg<size_t>(args, "chan") : 0;
+}
+
+size_t get_mboard(const device_addr_t& args, const size_t def = 0)
+{
+    return args.has_key("mboard") ? get_arg<size_t>(args, "mboard") : def;
+}
+
+/***********************************************************************
+ * Server
+ **********************************************************************/
+/*! Remove the socket of a server which didn't shut down cleanly
+ *
+ * \throws uhd::os_error if there is something else at \p socket_path, or a
+ *         server still accepts connections on it
+ */
+void remove_stale_socket(const std::string& socket_path)
+{
+    namespace fs = boost::filesystem;
+    boost::system::error_code ec;
+    const fs::file_status status = fs::symlink_status(socket_path, ec);
+    if (status.type() == fs::file_not_found) {
+        return;
+    }
+    if (status.type() != fs::socket_file) {
+        throw uhd::os_error(str(
+            boost::format("session_server: %s already exists and is not a socket")
+            % socket_path));
+    }
+    asio::io_service io_service;
+    asio::local::stream_protocol::socket probe(io_service);
+    probe.connect(asio::local::stream_protocol::endpoint(socket_path), ec);
+    if (not ec) {
+        throw uhd::os_error(
+            str(boost::format("session_server: %s is already in use") % socket_path));
+    }
+    std::remove(socket_path.c_str());
+}
+
+//! Handles a request of a client, identified by a number
+typedef std::function<std::string(
+    const std::string& method, const device_addr_t& args, const size_t client)>
+    client_handler_t;
+
+class session_server_impl : public session_server
+{
+public:
+    session_server_impl(client_handler_t handler,
+        std::function<void(size_t)> on_disconnect,
+        const std::string& socket_path)
+        : _handler(handler)
+        , _on_disconnect(on_disconnect)
+        , _socket_path(socket_path)
+        , _acceptor(_io_service)
+    {
+        remove_stale_socket(socket_path);
+        const asio::local::stream_protocol::endpoint endpoint(socket_path);
+        boost::system::error_code ec;
+        _acceptor.open(endpoint.protocol(), ec);
+        if (not ec) {
+            _acceptor.bind(endpoint, ec);
+        }
+        if (not ec) {
+            _acceptor.listen(asio::socket_base::max_connections, ec);
+        }
+        if (ec) {
+            throw uhd::os_error(str(boost::format("session_server: Could not listen on %s: %s")
+                                    % socket_path % ec.message()));
+        }
+        start_accept();
+        _thread = std::thread([this]() { _io_service.run(); });
+    }
+
+    ~session_server_impl(void)
+    {
+        _io_service.stop();
+        _thread.join();
+        std::remove(_socket_path.c_str());
+    }
+
+    size_t get_num_clients(void) const
+    {
+        return _num_clients;
+    }
+
+private:
+    struct connection_t
+    {
+        connection_t(asio::io_service& io_service, const size_t id)
+            : socket(io_service), id(id)
+        {
+        }
+
+        asio::local::stream_protocol::socket socket;
+        asio::streambuf buffer;
+        std::string response;
+        const size_t id;
+    };
+    typedef std::shared_ptr<connection_t> connection_sptr;
+
+    void start_accept(void)
+    {
+        auto conn = std::make_shared<connection_t>(_io_service, _next_client_id++);
+        _acceptor.async_accept(conn->socket, [this, conn](const boost::system::error_code& ec) {
+            if (not ec) {
+                _num_clients++;
+                start_read(conn);
+            }
+            start_accept();
+        });
+    }
+
+    void start_read(connection_sptr conn)
+    {
+        asio::async_read_until(conn->socket,
+            conn->buffer,
+            REQUEST_END,
+            [this, conn](const boost::system::error_code& ec, const size_t len) {
+                if (ec) {
+                    disconnect(conn);
+                    return;
+                }
+                const auto begin = asio::buffers_begin(conn->buffer.data());
+                const std::string request(begin, begin + len);
+                conn->buffer.consume(len);
+                conn->response = handle_request(request, conn->id) + "\n";
+                asio::async_write(conn->socket,
+                    asio::buffer(conn->response),
+                    [this, conn](const boost::system::error_code& ec, const size_t) {
+                        if (ec) {
+                            disconnect(conn);
+                        } else {
+                            start_read(conn);
+                        }
+                    });
+            });
+    }
+
+    std::string handle_request(const std::string& request, const size_t client)
+    {
+        try {
+            std::string method;
+            device_addr_t args;
+            decode_request(request, method, args);
+            return RESPONSE_OK + to_line(_handler(method, args, client));
+        } catch (const std::exception& ex) {
+            return RESPONSE_ERROR + to_line(ex.what());
+        }
+    }
+
+    void disconnect(connection_sptr conn)
+    {
+        _num_clients--;
+        try {
+            _on_disconnect(conn->id);
+        } catch (const std::exception& ex) {
+            UHD_LOGGER_ERROR("SESSION")
+                << "Error while detaching client " << conn->id << ": " << ex.what();
+        }
+    }
+
+    const client_handler_t _handler;
+    const std::function<void(size_t)> _on_disconnect;
+    const std::string _socket_path;
+    asio::io_service _io_service;
+    asio::local::stream_protocol::acceptor _acceptor;
+    std::thread _thread;
+    size_t _next_client_id = 0;
+    std::atomic<size_t> _num_clients{0};
+};
+
+/***********************************************************************
+ * Device methods
+ *
+ * All requests are handled on the thread of the server, so calls into the
+ * device never overlap.
+ **********************************************************************/
+class usrp_session
+{
+public:
+    usrp_session(multi_usrp::sptr usrp) : _usrp(usrp)
+    {
+        register_methods();
+    }
+
+    ~usrp_session(void)
+    {
+        for (auto& stream : _streams) {
+            stop_stream(*stream.second);
+        }
+    }
+
+    std::string handle(
+        const std::string& method, const device_addr_t& args, const size_t client)
+    {
+        if (method == "open_rx_stream" or method == "open_tx_stream") {
+            return open_stream(method == "open_rx_stream", args, client);
+        }
+        if (method == "issue_stream_cmd") {
+            issue_stream_cmd(args);
+            return "";
+        }
+        if (method == "close_stream") {
+            stop_stream(get_stream(args));
+            _streams.erase(args["stream"]);
+            return "";
+        }
+        const auto it = _methods.find(method);
+        if (it == _methods.end()) {
+            throw uhd::not_implemented_error("session: Unknown method: " + method);
+        }
+        return it->second(args);
+    }
+
+    //! Close the streams of a client
+    void detach(const size_t client)
+    {
+        for (auto it = _streams.begin(); it != _streams.end();) {
+            if (it->second->client == client) {
+                stop_stream(*it->second);
+                it = _streams.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+private:
+    struct stream_t
+    {
+        size_t client;
+        rx_streamer::sptr rx_stream;
+        shm_rx_source::sptr rx_source;
+        shm_tx_sink::sptr tx_sink;
+        std::atomic<bool> running{true};
+        std::thread thread;
+    };
+
+    void register_methods(void)
+    {
+        _methods["get_pp_string"] = [this](const device_addr_t&) {
+            return _usrp->get_pp_string();
+        };
+        _methods["get_num_mboards"] = [this](const device_addr_t&) {
+            return to_str(_usrp->get_num_mboards());
+        };
+        _methods["get_mboard_name"] = [this](const device_addr_t& args) {
+            return _usrp->get_mboard_name(get_mboard(args));
+        };
+        _methods["get_mboard_sensor"] = [this](const device_addr_t& args) {
+            return _usrp
+                ->get_mboard_sensor(get_arg<std::string>(args, "name"), get_mboard(args))
+                .value;
+        };
+        _methods["set_clock_source"] = [this](const device_addr_t& args) {
+            _usrp->set_clock_source(get_arg<std::string>(args, "source"),
+                get_mboard(args, multi_usrp::ALL_MBOARDS));
+            return std::string();
+        };
+        _methods["set_time_source"] = [this](const device_addr_t& args) {
+            _usrp->set_time_source(get_arg<std::string>(args, "source"),
+                get_mboard(args, multi_usrp::ALL_MBOARDS));
+            return std::string();
+        };
+        _methods["get_time_now"] = [this](const device_addr_t& args) {
+            return to_str(_usrp->get_time_now(get_mboard(args)).get_real_secs());
+        };
+        _methods["set_time_now"] = [this](const device_addr_t& args) {
+            _usrp->set_time_now(time_spec_t(get_arg<double>(args, "time")),
+                get_mboard(args, multi_usrp::ALL_MBOARDS));
+            return std::string();
+        };
+        _methods["set_time_next_pps"] = [this](const device_addr_t& args) {
+            _usrp->set_time_next_pps(time_spec_t(get_arg<double>(args, "time")),
+                get_mboard(args, multi_usrp::ALL_MBOARDS));
+            return std::string();
+        };
+
+        for (const bool rx : {true, false}) {
+            const std::string dir = rx ? "rx" : "tx";
+            _methods["get_" + dir + "_num_channels"] = [this, rx](const device_addr_t&) {
+                return to_str(
+                    rx ? _usrp->get_rx_num_channels() : _usrp->get_tx_num_channels());
+            };
+            _methods["get_" + dir + "_rate"] = [this, rx](const device_addr_t& args) {
+                const size_t chan = get_chan(args);
+                return to_str(rx ? _usrp->get_rx_rate(chan) : _usrp->get_tx_rate(chan));
+            };
+            _methods["set_" + dir + "_rate"] = [this, rx](const device_addr_t& args) {
+                const double rate = get_arg<double>(args, "rate");
+                const size_t chan = get_chan(args);
+                if (rx) {
+                    _usrp->set_rx_rate(rate, chan);
+                } else {
+                    _usrp->set_tx_rate(rate, chan);
+                }
+                return to_str(rx ? _usrp->get_rx_rate(chan) : _usrp->get_tx_rate(chan));
+            };
+            _methods["get_" + dir + "_freq"] = [this, rx](const device_addr_t& args) {
+                const size_t chan = get_chan(args);
+                return to_str(rx ? _usrp->get_rx_freq(chan) : _usrp->get_tx_freq(chan));
+            };
+            _methods["set_" + dir + "_freq"] = [this, rx](const device_addr_t& args) {
+                const tune_request_t tune_request(get_arg<double>(args, "freq"));
+                const size_t chan = get_chan(args);
+                if (rx) {
+                    _usrp->set_rx_freq(tune_request, chan);
+                } else {
+                    _usrp->set_tx_freq(tune_request, chan);
+                }
+                return to_str(rx ? _usrp->get_rx_freq(chan) : _usrp->get_tx_freq(chan));
+            };
+            _methods["get_" + dir + "_gain"] = [this, rx](const device_addr_t& args) {
+                const std::string name = args.get("name", multi_usrp::ALL_GAINS);
+                const size_t chan      = get_chan(args);
+                return to_str(
+                    rx ? _usrp->get_rx_gain(name, chan) : _usrp->get_tx_gain(name, chan));
+            };
+            _methods["set_" + dir + "_gain"] = [this, rx](const device_addr_t& args) {
+                const double gain      = get_arg<double>(args, "gain");
+                const std::string name = args.get("name", multi_usrp::ALL_GAINS);
+                const size_t chan      = get_chan(args);
+                if (rx) {
+                    _usrp->set_rx_gain(gain, name, chan);
+                } else {
+                    _usrp->set_tx_gain(gain, name, chan);
+                }
+                return to_str(
+                    rx ? _usrp->get_rx_gain(name, chan) : _usrp->get_tx_gain(name, chan));
+            };
+            _methods["get_" + dir + "_antenna"] = [this, rx](const device_addr_t& args) {
+                const size_t chan = get_chan(args);
+                return rx ? _usrp->get_rx_antenna(chan) : _usrp->get_tx_antenna(chan);
+            };
+            _methods["set_" + dir + "_antenna"] = [this, rx](const device_addr_t& args) {
+                const std::string antenna = get_arg<std::string>(args, "antenna");
+                const size_t chan         = get_chan(args);
+                if (rx) {
+                    _usrp->set_rx_antenna(antenna, chan);
+                } else {
+                    _usrp->set_tx_antenna(antenna, chan);
+                }
+                return std::string();
+            };
+            _methods["get_" + dir + "_bandwidth"] = [this, rx](const device_addr_t& args) {
+                const size_t chan = get_chan(args);
+                return to_str(
+                    rx ? _usrp->get_rx_bandwidth(chan) : _usrp->get_tx_bandwidth(chan));
+            };
+            _methods["set_" + dir + "_bandwidth"] = [this, rx](const device_addr_t& args) {
+                const double bandwidth = get_arg<double>(args, "bandwidth");
+                const size_t chan      = get_chan(args);
+                if (rx) {
+                    _usrp->set_rx_bandwidth(bandwidth, chan);
+                } else {
+                    _usrp->set_tx_bandwidth(bandwidth, chan);
+                }
+                return to_str(
+                    rx ? _usrp->get_rx_bandwidth(chan) : _usrp->get_tx_bandwidth(chan));
+            };
+            _methods["get_" + dir + "_sensor"] = [this, rx](const device_addr_t& args) {
+                const std::string name = get_arg<std::string>(args, "name");
+                const size_t chan      = get_chan(args);
+                return (rx ? _usrp->get_rx_sensor(name, chan)
+                           : _usrp->get_tx_sensor(name, chan))
+                    .value;
+            };
+        }
+    }
+
+    std::string open_stream(const bool rx, const device_addr_t& args, const size_t client)
+    {
+        stream_args_t stream_args(
+            args.get("cpu_format", "fc32"), args.get("otw_format", "sc16"));
+        stream_args.args = device_addr_t(args.get("args", ""));
+        if (args.has_key("channels")) {
+            std::vector<std::string> channels;
+            boost::split(channels, args["channels"], boost::is_any_of(","));
+            for (const std::string& chan : channels) {
+                try {
+                    stream_args.channels.push_back(boost::lexical_cast<size_t>(chan));
+                } catch (const boost::bad_lexical_cast&) {
+                    throw uhd::value_error("session: Invalid channel: " + chan);
+                }
+            }
+        }
+        const size_t capacity =
+            args.has_key("capacity") ? get_arg<size_t>(args, "capacity")
+                                     : session_client::DEFAULT_RING_CAPACITY;
+        const std::string name = str(boost::format("uhd_session_%d_%d")
+                                     % uhd::get_process_id() % _next_stream_id++);
+
+        std::unique_ptr<stream_t> stream(new stream_t);
+        stream->client   = client;
+        stream_t* stream_ptr = stream.get();
+        if (rx) {
+            const size_t chan =
+                stream_args.channels.empty() ? 0 : stream_args.channels.front();
+            stream->rx_stream = _usrp->get_rx_stream(stream_args);
+            stream->rx_source = shm_rx_source::make(stream->rx_stream,
+                stream_args.cpu_format,
+                name,
+                capacity,
+                _usrp->get_rx_rate(chan));
+            stream->thread = std::thread([stream_ptr, name]() {
+                rx_metadata_t md;
+                try {
+                    while (stream_ptr->running) {
+                        stream_ptr->rx_source->recv(md);
+                    }
+                } catch (const std::exception& ex) {
+                    UHD_LOGGER_ERROR("SESSION")
+                        << "Stream " << name << " stopped: " << ex.what();
+                }
+            });
+        } else {
+            stream->tx_sink = shm_tx_sink::make(_usrp->get_tx_stream(stream_args),
+                stream_args.cpu_format,
+                name,
+                capacity);
+            stream->thread = std::thread([stream_ptr, name]() {
+                try {
+                    while (stream_ptr->running) {
+                        stream_ptr->tx_sink->send();
+                    }
+                } catch (const std::exception& ex) {
+                    UHD_LOGGER_ERROR("SESSION")
+                        << "Stream " << name << " stopped: " << ex.what();
+                }
+            });
+        }
+        _streams[name] = std::move(stream);
+        UHD_LOGGER_DEBUG("SESSION") << "Client " << client << " opened stream " << name;
+        return name;
+    }
+
+    stream_t& get_stream(const device_addr_t& args)
+    {
+        const std::string name = get_arg<std::string>(args, "stream");
+        const auto it          = _streams.find(name);
+        if (it == _streams.end()) {
+            throw uhd::key_error("session: Unknown stream: " + name);
+        }
+        return *it->second;
+    }
+
+    void issue_stream_cmd(const device_addr_t& args)
+    {
+        stream_t& stream = get_stream(args);
+        if (not stream.rx_stream) {
+            throw uhd::type_error("session: Stream commands require an RX stream");
+        }
+        static const std::map<std::string, stream_cmd_t::stream_mode_t> modes{
+            {"start_cont", stream_cmd_t::STREAM_MODE_START_CONTINUOUS},
+            {"stop_cont", stream_cmd_t::STREAM_MODE_STOP_CONTINUOUS},
+            {"num_done", stream_cmd_t::STREAM_MODE_NUM_SAMPS_AND_DONE},
+            {"num_more", stream_cmd_t::STREAM_MODE_NUM_SAMPS_AND_MORE}};
+        const std::string mode = get_arg<std::string>(args, "mode");
+        if (not modes.count(mode)) {
+            throw uhd::value_error("session: Invalid stream mode: " + mode);
+        }
+        stream_cmd_t stream_cmd(modes.at(mode));
+        stream_cmd.num_samps =
+            args.has_key("num_samps") ? get_arg<size_t>(args, "num_samps") : 0;
+        stream_cmd.stream_now = not args.has_key("time");
+        if (not stream_cmd.stream_now) {
+            stream_cmd.time_spec = time_spec_t(get_arg<double>(args, "time"));
+        }
+        stream.rx_stream->issue_stream_cmd(stream_cmd);
+    }
+
+    void stop_stream(stream_t& stream)
+    {
+        if (stream.rx_stream) {
+            try {
+                stream.rx_stream->issue_stream_cmd(
+                    stream_cmd_t(stream_cmd_t::STREAM_MODE_STOP_CONTINUOUS));
+            } catch (const std::exception& ex) {
+                UHD_LOGGER_WARNING("SESSION")
+                    << "Could not stop streaming: " << ex.what();
+            }
+        }
+        stream.running = false;
+        stream.thread.join();
+    }
+
+    multi_usrp::sptr _usrp;
+    std::map<std::string, std::function<std::string(const device_addr_t&)>> _methods;
+    std::map<std::string, std::unique_ptr<stream_t>> _streams;
+    size_t _next_stream_id = 0;
+};
+
+/***********************************************************************
+ * Client
+ **********************************************************************/
+class session_client_impl : public session_client
+{
+public:
+    session_client_impl(const std::string& socket_path) : _socket(_io_service)
+    {
+        boost::system::error_code ec;
+        _socket.connect(asio::local::stream_protocol::endpoint(socket_path), ec);
+        if (ec) {
+            throw uhd::io_error(str(boost::format("session_client: Could not attach to %s: %s")
+                                    % socket_path % ec.message()));
+        }
+    }
+
+    std::string call(const std::string& method, const device_addr_t& args)
+    {
+        const std::string request = encode_request(method, args);
+        std::lock_guard<std::mutex> lock(_mutex);
+        boost::system::error_code ec;
+        asio::write(_socket, asio::buffer(request), ec);
+        size_t len = 0;
+        if (not ec) {
+            len = asio::read_until(_socket, _buffer, '\n', ec);
+        }
+        if (ec) {
+            throw uhd::io_error(
+                "session_client: Lost the connection to the server: " + ec.message());
+        }
+        const auto begin = asio::buffers_begin(_buffer.data());
+        const std::string response(begin, begin + len - 1);
+        _buffer.consume(len);
+        if (boost::starts_with(response, RESPONSE_OK)) {
+            return response.substr(RESPONSE_OK.size());
+        }
+        if (boost::starts_with(response, RESPONSE_ERROR)) {
+            throw uhd::runtime_error(response.substr(RESPONSE_ERROR.size()));
+        }
+        throw uhd::io_error("session_client: Invalid response: " + response);
+    }
+
+    std::string open_rx_stream(const stream_args_t& args, const size_t capacity)
+    {
+        return call("open_rx_stream", encode_stream_args(args, capacity));
+    }
+
+    std::string open_tx_stream(const stream_args_t& args, const size_t capacity)
+    {
+        return call("open_tx_stream", encode_stream_args(args, capacity));
+    }
+
+    void issue_stream_cmd(const std::string& stream, const stream_cmd_t& stream_cmd)
+    {
+        static const std::map<stream_cmd_t::stream_mode_t, std::string> modes{
+            {stream_cmd_t::STREAM_MODE_START_CONTINUOUS, "start_cont"},
+            {stream_cmd_t::STREAM_MODE_STOP_CONTINUOUS, "stop_cont"},
+            {stream_cmd_t::STREAM_MODE_NUM_SAMPS_AND_DONE, "num_done"},
+            {stream_cmd_t::STREAM_MODE_NUM_SAMPS_AND_MORE, "num_more"}};
+        device_addr_t args;
+        args["stream"]    = stream;
+        args["mode"]      = modes.at(stream_cmd.stream_mode);
+        args["num_samps"] = to_str(stream_cmd.num_samps);
+        if (not stream_cmd.stream_now) {
+            args["time"] = to_str(stream_cmd.time_spec.get_real_secs());
+        }
+        call("issue_stream_cmd", args);
+    }
+
+    void close_stream(const std::string& stream)
+    {
+        device_addr_t args;
+        args["stream"] = stream;
+        call("close_stream", args);
+    }
+
+private:
+    static device_addr_t encode_stream_args(
+        const stream_args_t& stream_args, const size_t capacity)
+    {
+        device_addr_t args;
+        args["cpu_format"] = stream_args.cpu_format;
+        args["otw_format"] = stream_args.otw_format;
+        args["args"]       = stream_args.args.to_string();
+        args["capacity"]   = to_str(capacity);
+        if (not stream_args.channels.empty()) {
+            std::vector<std::string> channels;
+            for (const size_t chan : stream_args.channels) {
+                channels.push_back(to_str(chan));
+            }
+            args["channels"] = boost::join(channels, ",");
+        }
+        return args;
+    }
+
+    asio::io_service _io_service;
+    asio::local::stream_protocol::socket _socket;
+    asio::streambuf _buffer;
+    std::mutex _mutex;
+};
+
+} // namespace
+
+session_server::sptr session_server::make(
+    multi_usrp::sptr usrp, const std::string& socket_path)
+{
+    auto session = std::make_shared<usrp_session>(usrp);
+    return sptr(new session_server_impl(
+        [session](const std::string& method, const device_addr_t& args, const size_t client) {
+            return session->handle(method, args, client);
+        },
+        [session](const size_t client) { session->detach(client); },
+        socket_path));
+}
+
+session_server::sptr session_server::make(
+    handler_t handler, const std::string& socket_path)
+{
+    return sptr(new session_server_impl(
+        [handler](const std::string& method, const device_addr_t& args, const size_t) {
+            return handler(method, args);
+        },
+        [](const size_t) {},
+        socket_path));
+}
+
+session_client::sptr session_client::make(const std::string& socket_path)
+{
+    return sptr(new session_client_impl(socket_path));
+}
+
+#else
+
+session_server::sptr session_server::make(multi_usrp::sptr, const std::string&)
+{
+    throw uhd::not_implemented_error("session_server: No Unix sockets on this platform");
+}
+
+session_server::sptr session_server::make(handler_t, const std::string&)
+{
+    throw uhd::not_implemented_error("session_server: No Unix sockets on this platform");
+}
+
+session_client::sptr session_client::make(const std::string&)
+{
+    throw uhd::not_implemented_error("session_client: No Unix sockets on this platform");
+}
+
+#endif /* BOOST_ASIO_HAS_LOCAL_SOCKETS */
@@ -442,6 +442,8 @@ rx_streamer::sptr usrp2_impl::get_rx_stream(const uhd::stream_args_t &args_){
     id.output_format = args.cpu_format;
     id.num_outputs = 1;
     my_streamer->set_converter(id);
+    my_streamer->set_stages(args.stages, args.cpu_format);
+    my_streamer->set_squelch(args.squelch);
 
     //bind callbacks for the handler
     for (size_t chan_i = 0; chan_i < args.channels.size(); chan_i++){
@@ -511,6 +513,7 @@ tx_streamer::sptr usrp2_impl::get_tx_stream(const uhd::stream_args_t &args_){
     id.output_format = args.otw_format + "_item32_be";
     id.num_outputs = 1;
     my_streamer->set_converter(id);
+    my_streamer->set_stages(args.stages, args.cpu_format);
 
     //bind callbacks for the handler
     for (size_t chan_i = 0; chan_i < args.channels.size(); chan_i++){
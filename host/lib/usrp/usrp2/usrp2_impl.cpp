@@ -6,6 +6,7 @@
 
 #include "usrp2_impl.hpp"
 #include "fw_common.h"
+#include <uhdlib/transport/udp_discovery.hpp>
 #include <uhdlib/usrp/common/apply_corrections.hpp>
 #include <uhd/utils/log.hpp>
 
@@ -30,6 +31,8 @@ namespace asio = boost::asio;
 
 //A reasonable number of frames for send/recv and async/sync
 static const size_t DEFAULT_NUM_FRAMES = 32;
+//The longest time to wait for discovery replies
+static const double USRP2_FIND_TIMEOUT = 0.1;
 
 /***********************************************************************
  * Discovery over the udp transport
@@ -87,9 +90,11 @@ device_addrs_t usrp2_find(const device_addr_t &hint_){
     //Create a UDP transport to communicate:
     //Some devices will cause a throw when opened for a broadcast address.
     //We print and recover so the caller can loop through all bcast addrs.
-    udp_simple::sptr udp_transport;
+    //The socket is shared with the other USRP2 discoveries on this address.
+    udp_discovery::sptr udp_transport;
     try{
-        udp_transport = udp_simple::make_broadcast(hint["addr"], BOOST_STRINGIZE(USRP2_UDP_CTRL_PORT));
+        udp_transport = udp_discovery::make(
+            "usrp2", hint["addr"], BOOST_STRINGIZE(USRP2_UDP_CTRL_PORT));
     }
     catch(const std::exception &e){
         UHD_LOGGER_ERROR("USRP2") << boost::format("Cannot open UDP transport on %s\n%s") % hint["addr"] % e.what() ;
@@ -113,11 +118,13 @@ device_addrs_t usrp2_find(const device_addr_t &hint_){
         UHD_LOGGER_ERROR("USRP2") << "USRP2 Network discovery unknown error " ;
     }
 
-    //loop and recieve until the timeout
+    //loop and recieve until the timeout,
+    //which adapts to how long a device takes to reply (not for broadcasts)
+    const double timeout = udp_transport->get_timeout(USRP2_FIND_TIMEOUT);
     uint8_t usrp2_ctrl_data_in_mem[udp_simple::mtu]; //allocate max bytes for recv
     const usrp2_ctrl_data_t *ctrl_data_in = reinterpret_cast<const usrp2_ctrl_data_t *>(usrp2_ctrl_data_in_mem);
     while(true){
-        size_t len = udp_transport->recv(asio::buffer(usrp2_ctrl_data_in_mem));
+        size_t len = udp_transport->recv(asio::buffer(usrp2_ctrl_data_in_mem), timeout);
         if (len > offsetof(usrp2_ctrl_data_t, data) and ntohl(ctrl_data_in->id) == USRP2_CTRL_ID_WAZZUP_DUDE){
 
             //make a boost asio ipv4 with the raw addr in host byte order
@@ -0,0 +1,181 @@
+//
+// Copyright 2019 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include "x300_adc_self_cal.hpp"
+#include <uhd/exception.hpp>
+#include <uhd/utils/csv.hpp>
+#include <uhd/utils/log.hpp>
+#include <uhd/utils/paths.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/format.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <mutex>
+
+using namespace uhd;
+using namespace uhd::usrp::x300;
+namespace fs = boost::filesystem;
+
+namespace {
+//! Serializes the accesses to the cache file of all devices of this process
+std::mutex cache_mutex;
+
+constexpr size_t CACHE_NUM_COLUMNS = 5;
+
+fs::path get_cache_path(void)
+{
+    return fs::path(uhd::get_app_path()) / ".uhd" / "cal" / "x300_adc_self_cal.csv";
+}
+
+//! The columns which identify a result
+uhd::csv::row_type make_row(const adc_self_cal_key_t& key, const std::string& name)
+{
+    return {key.serial,
+        str(boost::format("%.3f") % key.master_clock_rate),
+        key.fpga_hash,
+        name};
+}
+
+bool row_matches(const uhd::csv::row_type& row, const uhd::csv::row_type& key_row)
+{
+    return row.size() == CACHE_NUM_COLUMNS
+           and std::equal(key_row.begin(), key_row.end(), row.begin());
+}
+
+uhd::csv::rows_type read_cache(void)
+{
+    std::ifstream cache_file(get_cache_path().string().c_str());
+    if (not cache_file) {
+        return uhd::csv::rows_type();
+    }
+    return uhd::csv::to_rows(cache_file);
+}
+} // namespace
+
+boost::optional<double> uhd::usrp::x300::load_adc_self_cal(
+    const adc_self_cal_key_t& key, const std::string& name)
+{
+    if (key.serial.empty()) {
+        return boost::none;
+    }
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    const uhd::csv::row_type key_row = make_row(key, name);
+    for (const uhd::csv::row_type& row : read_cache()) {
+        if (row_matches(row, key_row)) {
+            return std::strtod(row.back().c_str(), nullptr);
+        }
+    }
+    return boost::none;
+}
+
+void uhd::usrp::x300::store_adc_self_cal(
+    const adc_self_cal_key_t& key, const std::string& name, const double value)
+{
+    if (key.serial.empty()) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    const uhd::csv::row_type key_row = make_row(key, name);
+    const fs::path cache_path        = get_cache_path();
+    const fs::path tmp_path          = fs::path(cache_path.string() + ".tmp");
+    try {
+        fs::create_directories(cache_path.parent_path());
+        // Write a new file and move it over the old one, so concurrent readers
+        // never see a partial file
+        {
+            std::ofstream tmp_file(tmp_path.string().c_str());
+            for (const uhd::csv::row_type& row : read_cache()) {
+                if (row.size() != CACHE_NUM_COLUMNS or row_matches(row, key_row)) {
+                    continue;
+                }
+                tmp_file << row[0] << "," << row[1] << "," << row[2] << "," << row[3]
+                         << "," << row[4] << std::endl;
+            }
+            tmp_file << key_row[0] << "," << key_row[1] << "," << key_row[2] << ","
+                     << key_row[3] << "," << boost::format("%.6f") % value << std::endl;
+            if (not tmp_file) {
+                throw uhd::io_error("could not write " + tmp_path.string());
+            }
+        }
+        fs::rename(tmp_path, cache_path);
+    } catch (const std::exception& ex) {
+        UHD_LOGGER_WARNING("X300") << "Could not store ADC self-cal results in "
+                                   << cache_path.string() << ": " << ex.what();
+    }
+}
+
+std::vector<adc_cal_window_t> uhd::usrp::x300::find_adc_cal_windows(
+    const size_t num_steps,
+    const size_t min_len,
+    const std::function<bool(size_t)>& is_valid,
+    const bool stop_at_first)
+{
+    std::vector<adc_cal_window_t> windows;
+    if (num_steps == 0) {
+        return windows;
+    }
+
+    std::map<long, bool> results;
+    auto test = [&](const long step) {
+        auto it = results.find(step);
+        if (it == results.end()) {
+            it = results.emplace(step, is_valid(size_t(step))).first;
+        }
+        return it->second;
+    };
+    // Find the valid step next to the edge between an invalid and a valid step
+    // (in either order). -1 stands for an invalid step before the first one.
+    auto bisect = [&](long invalid, long valid) {
+        while (std::abs(valid - invalid) > 1) {
+            const long mid = (valid + invalid) / 2;
+            if (test(mid)) {
+                valid = mid;
+            } else {
+                invalid = mid;
+            }
+        }
+        return valid;
+    };
+
+    // Coarse steps are min_len apart, so no window of at least min_len is missed
+    const long stride    = long(std::max<size_t>(min_len, 1));
+    const long last_step = long(num_steps) - 1;
+    long last_invalid = -1, first_valid = -1, last_valid = -1;
+    for (long step = 0;; step = std::min(step + stride, last_step)) {
+        if (test(step)) {
+            if (first_valid == -1) {
+                first_valid = step;
+            }
+            last_valid = step;
+        } else {
+            if (first_valid != -1) { // A valid run turned invalid
+                const size_t start = size_t(bisect(last_invalid, first_valid));
+                const size_t stop  = size_t(bisect(step, last_valid));
+                if (stop - start >= min_len) {
+                    windows.push_back(adc_cal_window_t(start, stop));
+                    if (stop_at_first) {
+                        return windows;
+                    }
+                }
+                first_valid = -1;
+            }
+            last_invalid = step;
+        }
+        if (step == last_step) {
+            break;
+        }
+    }
+    // A valid run which reaches the last step ends there
+    if (first_valid != -1) {
+        const size_t start = size_t(bisect(last_invalid, first_valid));
+        if (size_t(last_step) - start >= min_len) {
+            windows.push_back(adc_cal_window_t(start, size_t(last_step)));
+        }
+    }
+    return windows;
+}
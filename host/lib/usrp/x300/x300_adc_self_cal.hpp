@@ -0,0 +1,67 @@
+//
+// Copyright 2019 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#ifndef INCLUDED_X300_ADC_SELF_CAL_HPP
+#define INCLUDED_X300_ADC_SELF_CAL_HPP
+
+#include <boost/optional.hpp>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace uhd { namespace usrp { namespace x300 {
+
+/*! Identifies the setup an ADC self-cal result is valid for
+ *
+ * The delays depend on the board, the clocking and the FPGA image. An empty
+ * serial disables the cache (e.g., on boards with a blank EEPROM).
+ */
+struct adc_self_cal_key_t
+{
+    std::string serial;
+    double master_clock_rate = 0.0;
+    std::string fpga_hash;
+};
+
+/*! Get a self-cal result from the cache in the UHD calibration directory
+ *
+ * \param key The setup
+ * \param name The name of the calibration, e.g. "capture_delay_A"
+ * \return the cached value, if there is one
+ */
+boost::optional<double> load_adc_self_cal(
+    const adc_self_cal_key_t& key, const std::string& name);
+
+//! Store a self-cal result in the cache, replacing an older value
+void store_adc_self_cal(
+    const adc_self_cal_key_t& key, const std::string& name, const double value);
+
+//! A range of valid steps, including both ends
+typedef std::pair<size_t, size_t> adc_cal_window_t;
+
+/*! Find the windows of steps for which the ADC data is valid
+ *
+ * This gives the same windows as testing every step in order, recording
+ * each run of valid steps which ends on an invalid step, but tests only
+ * every min_len-th step and then bisects the edges of the runs it finds.
+ * This works as long as the valid and invalid runs are at least min_len + 1
+ * steps long, which is the case for the eye of the ADC data.
+ *
+ * \param num_steps The number of steps
+ * \param min_len Windows must span at least this many steps after the first
+ * \param is_valid Tests a step
+ * \param stop_at_first Return as soon as a window is found
+ * \return the windows of at least min_len, in order
+ */
+std::vector<adc_cal_window_t> find_adc_cal_windows(const size_t num_steps,
+    const size_t min_len,
+    const std::function<bool(size_t)>& is_valid,
+    const bool stop_at_first);
+
+}}} // namespace uhd::usrp::x300
+
+#endif /* INCLUDED_X300_ADC_SELF_CAL_HPP */
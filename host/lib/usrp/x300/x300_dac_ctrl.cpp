@@ -11,6 +11,7 @@
 #include <uhd/types/time_spec.hpp>
 #include <uhd/utils/log.hpp>
 #include <uhd/utils/safe_call.hpp>
+#include <uhdlib/utils/lock_wait.hpp>
 #include <boost/format.hpp>
 #include <chrono>
 #include <thread>
@@ -215,20 +216,23 @@ public:
 
         // Verify PLL is Locked. 1 sec timeout.
         // NOTE: Data sheet inconsistent about which pins give PLL lock status. FIXME!
-        const auto exit_time = std::chrono::steady_clock::now() + std::chrono::seconds(1);
-        while (true) {
-            const size_t reg_e = read_ad9146_reg(0x0E); // PLL Status (Expect bit 7 = 1)
-            const size_t reg_6 =
-                read_ad9146_reg(0x06); // Event Flags (Expect bit 7 = 0 and bit 6 = 1)
-            if ((((reg_e >> 7) & 0x1) == 0x1) && (((reg_6 >> 6) & 0x3) == 0x1))
-                break;
-            if (exit_time < std::chrono::steady_clock::now())
-                throw uhd::runtime_error(
-                    "x300_dac_ctrl: timeout waiting for DAC PLL to lock");
-            if (reg_6 & (1 << 7)) // Lock lost?
-                write_ad9146_reg(0x06, 0xC0); // Clear PLL event flags
-            std::this_thread::sleep_for(std::chrono::milliseconds(10));
-        }
+        const bool locked = wait_for_lock("x300::dac_pll_lock",
+            [this]() {
+                // PLL Status (Expect bit 7 = 1)
+                const size_t reg_e = read_ad9146_reg(0x0E);
+                // Event Flags (Expect bit 7 = 0 and bit 6 = 1)
+                const size_t reg_6 = read_ad9146_reg(0x06);
+                if ((((reg_e >> 7) & 0x1) == 0x1) && (((reg_6 >> 6) & 0x3) == 0x1))
+                    return true;
+                if (reg_6 & (1 << 7)) // Lock lost?
+                    write_ad9146_reg(0x06, 0xC0); // Clear PLL event flags
+                return false;
+            },
+            1.0,
+            0.01);
+        if (not locked)
+            throw uhd::runtime_error(
+                "x300_dac_ctrl: timeout waiting for DAC PLL to lock");
     }
 
     //
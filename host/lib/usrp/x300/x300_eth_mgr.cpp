@@ -7,6 +7,7 @@
 #include "x300_eth_mgr.hpp"
 #include "x300_claim.hpp"
 #include "x300_fw_common.h"
+#include "x300_fw_ctrl.hpp"
 #include "x300_mb_eeprom.hpp"
 #include "x300_mb_eeprom_iface.hpp"
 #include "x300_regs.hpp"
@@ -20,13 +21,11 @@
 #    include <uhdlib/transport/dpdk_simple.hpp>
 #    include <uhdlib/transport/dpdk_zero_copy.hpp>
 #endif
+#include <uhdlib/transport/udp_discovery.hpp>
 #include <uhdlib/usrp/cores/i2c_core_100_wb32.hpp>
 #include <boost/asio.hpp>
 #include <string>
 
-uhd::wb_iface::sptr x300_make_ctrl_iface_enet(
-    uhd::transport::udp_simple::sptr udp, bool enable_errors = true);
-
 using namespace uhd;
 using namespace uhd::usrp;
 using namespace uhd::transport;
@@ -45,6 +44,8 @@ constexpr size_t GE_DATA_FRAME_RECV_SIZE  = 1472;
 constexpr size_t ETH_MSG_NUM_FRAMES       = 64;
 constexpr size_t ETH_DATA_NUM_FRAMES      = 32;
 constexpr size_t ETH_MSG_FRAME_SIZE       = uhd::transport::udp_simple::mtu; // bytes
+//! How long discovery waits for further replies (in seconds)
+constexpr double X300_FIND_TIMEOUT        = 0.050;
 constexpr size_t MAX_RATE_10GIGE          = (size_t)( // bytes/s
     10e9 / 8 * // wire speed multiplied by percentage of packets that is sample data
     (float(x300::DATA_FRAME_MAX_SIZE - uhd::usrp::DEVICE3_TX_MAX_HDR_LEN)
@@ -82,7 +83,11 @@ eth_manager::udp_simple_factory_t eth_manager::x300_get_udp_factory(
 
 device_addrs_t eth_manager::find(const device_addr_t& hint)
 {
-    udp_simple_factory_t udp_make_broadcast = udp_simple::make_broadcast;
+    // Share the broadcast socket with the other X300 discoveries on this address
+    udp_simple_factory_t udp_make_broadcast = [](const std::string& addr,
+                                                  const std::string& port) {
+        return udp_simple::sptr(udp_discovery::make("x300", addr, port));
+    };
     udp_simple_factory_t udp_make_connected = x300_get_udp_factory(hint);
 #ifdef HAVE_DPDK
     if (hint.has_key("use_dpdk")) {
@@ -98,6 +103,10 @@ device_addrs_t eth_manager::find(const device_addr_t& hint)
 #endif
     udp_simple::sptr comm =
         udp_make_broadcast(hint["addr"], BOOST_STRINGIZE(X300_FW_COMMS_UDP_PORT));
+    // Only wait as long as the device takes to reply, if it's not a broadcast
+    const auto discovery = boost::dynamic_pointer_cast<udp_discovery>(comm);
+    const double timeout =
+        discovery ? discovery->get_timeout(X300_FIND_TIMEOUT) : X300_FIND_TIMEOUT;
 
     // load request struct
     x300_fw_comms_t request = x300_fw_comms_t();
@@ -111,7 +120,7 @@ device_addrs_t eth_manager::find(const device_addr_t& hint)
     device_addrs_t addrs;
     while (true) {
         char buff[X300_FW_COMMS_MTU] = {};
-        const size_t nbytes          = comm->recv(asio::buffer(buff), 0.050);
+        const size_t nbytes          = comm->recv(asio::buffer(buff), timeout);
         if (nbytes == 0)
             break;
         const x300_fw_comms_t* reply = (const x300_fw_comms_t*)buff;
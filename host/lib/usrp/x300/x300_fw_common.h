@@ -8,6 +8,7 @@
 #ifndef INCLUDED_X300_FW_COMMON_H
 #define INCLUDED_X300_FW_COMMON_H
 
+#include <stddef.h>
 #include <stdint.h>
 
 /*!
@@ -22,7 +23,7 @@ extern "C" {
 #define X300_REVISION_COMPAT 7
 #define X300_REVISION_MIN    2
 #define X300_FW_COMPAT_MAJOR 6
-#define X300_FW_COMPAT_MINOR 0
+#define X300_FW_COMPAT_MINOR 1
 #define X300_FPGA_COMPAT_MAJOR 0x24
 
 //shared memory sections - in between the stack and the program space
@@ -72,6 +73,10 @@ extern "C" {
 #define X300_FW_COMMS_FLAGS_ERROR      (1 << 1)
 #define X300_FW_COMMS_FLAGS_POKE32     (1 << 2)
 #define X300_FW_COMMS_FLAGS_PEEK32     (1 << 3)
+#define X300_FW_COMMS_FLAGS_BATCH      (1 << 4)
+
+//max number of peeks and pokes in one batched request (fits a 1500 byte MTU)
+#define X300_FW_COMMS_BATCH_MAX_OPS 64
 
 #define X300_FPGA_PROG_FLAGS_ACK       (1 << 0)
 #define X300_FPGA_PROG_FLAGS_ERROR     (1 << 1)
@@ -123,6 +128,89 @@ typedef struct
     uint32_t data;
 } x300_fw_comms_t;
 
+typedef struct
+{
+    uint32_t flags; //X300_FW_COMMS_FLAGS_PEEK32 or X300_FW_COMMS_FLAGS_POKE32
+    uint32_t addr;
+    uint32_t data;
+} x300_fw_comms_op_t;
+
+/*!
+ * A batched request or reply (X300_FW_COMMS_FLAGS_BATCH): a header of the size
+ * of x300_fw_comms_t, followed by num_ops operations, which are run in order.
+ * The reply holds the same operations, with the data of peeks filled in.
+ * Firmware without support for batches only echoes the header.
+ */
+typedef struct
+{
+    uint32_t flags;
+    uint32_t sequence;
+    uint32_t num_ops;
+    uint32_t _pad;
+    x300_fw_comms_op_t ops[X300_FW_COMMS_BATCH_MAX_OPS];
+} x300_fw_comms_batch_t;
+
+#define X300_FW_COMMS_BATCH_LEN(num_ops) \
+    (sizeof(x300_fw_comms_t) + (num_ops) * sizeof(x300_fw_comms_op_t))
+
+typedef uint32_t (*x300_fw_comms_peek32_t)(const uint32_t addr);
+typedef void (*x300_fw_comms_poke32_t)(const uint32_t addr, const uint32_t data);
+
+/*!
+ * Run the peeks and pokes of a fw comms request and fill in the reply.
+ * Both are in CPU byte order, and the reply must have room for a
+ * x300_fw_comms_batch_t. This is shared with the host for testing.
+ * \return the number of bytes of the reply
+ */
+static inline size_t x300_fw_comms_handle_request(const void *request,
+    const size_t num_bytes,
+    x300_fw_comms_batch_t *reply,
+    x300_fw_comms_peek32_t peek32,
+    x300_fw_comms_poke32_t poke32)
+{
+    const x300_fw_comms_batch_t *batch = (const x300_fw_comms_batch_t *)request;
+    const size_t num_ops = (num_bytes >= sizeof(x300_fw_comms_t)) ? batch->num_ops : 0;
+    size_t i;
+
+    //the header is the same for single and batched requests
+    reply->flags = batch->flags;
+    reply->sequence = batch->sequence;
+    reply->num_ops = batch->num_ops;
+    reply->_pad = batch->_pad;
+    if (num_bytes < sizeof(x300_fw_comms_t)) {
+        reply->flags |= X300_FW_COMMS_FLAGS_ERROR;
+        return sizeof(x300_fw_comms_t);
+    }
+
+    if (!(batch->flags & X300_FW_COMMS_FLAGS_BATCH)) {
+        const x300_fw_comms_t *single = (const x300_fw_comms_t *)request;
+        if (single->flags & X300_FW_COMMS_FLAGS_PEEK32) {
+            ((x300_fw_comms_t *)reply)->data = peek32(single->addr);
+        }
+        if (single->flags & X300_FW_COMMS_FLAGS_POKE32) {
+            poke32(single->addr, single->data);
+        }
+        return sizeof(x300_fw_comms_t);
+    }
+
+    if (num_ops > X300_FW_COMMS_BATCH_MAX_OPS
+        || num_bytes < X300_FW_COMMS_BATCH_LEN(num_ops)) {
+        reply->flags |= X300_FW_COMMS_FLAGS_ERROR;
+        return sizeof(x300_fw_comms_t);
+    }
+    for (i = 0; i < num_ops; i++) {
+        const x300_fw_comms_op_t *op = &batch->ops[i];
+        reply->ops[i] = *op;
+        if (op->flags & X300_FW_COMMS_FLAGS_PEEK32) {
+            reply->ops[i].data = peek32(op->addr);
+        }
+        if (op->flags & X300_FW_COMMS_FLAGS_POKE32) {
+            poke32(op->addr, op->data);
+        }
+    }
+    return X300_FW_COMMS_BATCH_LEN(num_ops);
+}
+
 typedef struct
 {
     uint32_t flags;
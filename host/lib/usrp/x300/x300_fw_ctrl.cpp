@@ -5,6 +5,7 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 //
 
+#include "x300_fw_ctrl.hpp"
 #include "x300_fw_common.h"
 #include "x300_regs.hpp"
 #include <uhd/exception.hpp>
@@ -16,14 +17,17 @@
 #include <uhd/utils/log.hpp>
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/format.hpp>
+#include <boost/pointer_cast.hpp>
 #include <boost/thread/mutex.hpp>
+#include <algorithm>
 #include <chrono>
 #include <thread>
 
 using namespace uhd;
 using namespace uhd::niusrprio;
+using namespace uhd::usrp::x300;
 
-class x300_ctrl_iface : public wb_iface
+class x300_ctrl_iface : public fw_ctrl_iface
 {
 public:
     enum { num_retries = 3 };
@@ -77,6 +81,26 @@ public:
         return 0;
     }
 
+    void transact32(std::vector<fw_reg_op_t>& ops)
+    {
+        // A retry runs the whole batch again, like a retried poke32() may
+        // write a register twice
+        for (size_t i = 1; i <= num_retries; i++) {
+            boost::mutex::scoped_lock lock(reg_access);
+            try {
+                return this->__transact32(ops);
+            } catch (const uhd::io_error& ex) {
+                std::string error_msg =
+                    str(boost::format("%s: x300 fw communication failure #%u\n%s")
+                        % __loc_info() % i % ex.what());
+                if (errors)
+                    UHD_LOGGER_ERROR("X300") << error_msg;
+                if (i == num_retries)
+                    throw uhd::io_error(error_msg);
+            }
+        }
+    }
+
 protected:
     bool errors;
 
@@ -85,6 +109,18 @@ protected:
     virtual void __flush()                                              = 0;
     virtual std::string __loc_info()                                    = 0;
 
+    //! Run a batch; the default is one __peek32() or __poke32() per operation
+    virtual void __transact32(std::vector<fw_reg_op_t>& ops)
+    {
+        for (fw_reg_op_t& op : ops) {
+            if (op.type == fw_reg_op_t::PEEK32) {
+                op.data = this->__peek32(op.addr);
+            } else {
+                this->__poke32(op.addr, op.data);
+            }
+        }
+    }
+
     boost::mutex reg_access;
 };
 
@@ -96,7 +132,7 @@ class x300_ctrl_iface_enet : public x300_ctrl_iface
 {
 public:
     x300_ctrl_iface_enet(uhd::transport::udp_simple::sptr udp, bool enable_errors = true)
-        : x300_ctrl_iface(enable_errors), udp(udp), seq(0)
+        : x300_ctrl_iface(enable_errors), udp(udp), seq(0), batch_supported(true)
     {
         try {
             this->peek32(0);
@@ -169,6 +205,33 @@ protected:
         return uhd::ntohx<uint32_t>(reply.data);
     }
 
+    virtual void __transact32(std::vector<fw_reg_op_t>& ops)
+    {
+        size_t op_idx = 0;
+        // Firmware support is found out with the first batch, which older
+        // firmware answers with the header only (and without running it)
+        while (batch_supported and ops.size() - op_idx > 1) {
+            const size_t num_ops =
+                std::min(ops.size() - op_idx, size_t(X300_FW_COMMS_BATCH_MAX_OPS));
+            if (not __transact32_batch(&ops[op_idx], num_ops)) {
+                UHD_LOGGER_DEBUG("X300")
+                    << __loc_info()
+                    << ": firmware does not support batched peeks and pokes";
+                batch_supported = false;
+                break;
+            }
+            op_idx += num_ops;
+        }
+        for (; op_idx < ops.size(); op_idx++) {
+            fw_reg_op_t& op = ops[op_idx];
+            if (op.type == fw_reg_op_t::PEEK32) {
+                op.data = __peek32(op.addr);
+            } else {
+                __poke32(op.addr, op.data);
+            }
+        }
+    }
+
     virtual void __flush(void)
     {
         char buff[X300_FW_COMMS_MTU] = {};
@@ -182,8 +245,63 @@ protected:
     }
 
 private:
+    /*!
+     * Run up to X300_FW_COMMS_BATCH_MAX_OPS operations in one round trip
+     * \return false if the firmware doesn't support batches
+     */
+    bool __transact32_batch(fw_reg_op_t* ops, const size_t num_ops)
+    {
+        // load request struct
+        x300_fw_comms_batch_t request = x300_fw_comms_batch_t();
+        request.flags =
+            uhd::htonx<uint32_t>(X300_FW_COMMS_FLAGS_ACK | X300_FW_COMMS_FLAGS_BATCH);
+        request.sequence = uhd::htonx<uint32_t>(seq++);
+        request.num_ops  = uhd::htonx<uint32_t>(num_ops);
+        for (size_t i = 0; i < num_ops; i++) {
+            const bool peek      = ops[i].type == fw_reg_op_t::PEEK32;
+            request.ops[i].flags = uhd::htonx<uint32_t>(
+                peek ? X300_FW_COMMS_FLAGS_PEEK32 : X300_FW_COMMS_FLAGS_POKE32);
+            request.ops[i].addr = uhd::htonx(ops[i].addr);
+            request.ops[i].data = peek ? 0 : uhd::htonx(ops[i].data);
+        }
+        const size_t request_len = X300_FW_COMMS_BATCH_LEN(num_ops);
+
+        // send request
+        __flush();
+        udp->send(boost::asio::buffer(&request, request_len));
+
+        // recv reply
+        x300_fw_comms_batch_t reply = x300_fw_comms_batch_t();
+        const size_t nbytes = udp->recv(boost::asio::buffer(&reply, sizeof(reply)), 1.0);
+        if (nbytes == 0)
+            throw uhd::io_error("x300 fw batch - reply timed out");
+
+        // sanity checks
+        const size_t flags = uhd::ntohx<uint32_t>(reply.flags);
+        UHD_ASSERT_THROW(nbytes >= sizeof(x300_fw_comms_t));
+        UHD_ASSERT_THROW(not(flags & X300_FW_COMMS_FLAGS_ERROR));
+        UHD_ASSERT_THROW(flags & X300_FW_COMMS_FLAGS_ACK);
+        UHD_ASSERT_THROW(reply.sequence == request.sequence);
+        if (nbytes == sizeof(x300_fw_comms_t)) {
+            return false;
+        }
+        UHD_ASSERT_THROW(flags & X300_FW_COMMS_FLAGS_BATCH);
+        UHD_ASSERT_THROW(nbytes == request_len);
+        UHD_ASSERT_THROW(reply.num_ops == request.num_ops);
+
+        // return results!
+        for (size_t i = 0; i < num_ops; i++) {
+            UHD_ASSERT_THROW(reply.ops[i].addr == request.ops[i].addr);
+            if (ops[i].type == fw_reg_op_t::PEEK32) {
+                ops[i].data = uhd::ntohx<uint32_t>(reply.ops[i].data);
+            }
+        }
+        return true;
+    }
+
     uhd::transport::udp_simple::sptr udp;
     size_t seq;
+    bool batch_supported;
 };
 
 
@@ -309,14 +427,30 @@ private:
     static const uint32_t INIT_TIMEOUT_IN_MS = 5000;
 };
 
-wb_iface::sptr x300_make_ctrl_iface_enet(
-    uhd::transport::udp_simple::sptr udp, bool enable_errors = true)
+void uhd::usrp::x300::fw_transact32(wb_iface::sptr iface, std::vector<fw_reg_op_t>& ops)
+{
+    fw_ctrl_iface::sptr fw_ctrl = boost::dynamic_pointer_cast<fw_ctrl_iface>(iface);
+    if (fw_ctrl) {
+        fw_ctrl->transact32(ops);
+        return;
+    }
+    for (fw_reg_op_t& op : ops) {
+        if (op.type == fw_reg_op_t::PEEK32) {
+            op.data = iface->peek32(op.addr);
+        } else {
+            iface->poke32(op.addr, op.data);
+        }
+    }
+}
+
+fw_ctrl_iface::sptr x300_make_ctrl_iface_enet(
+    uhd::transport::udp_simple::sptr udp, bool enable_errors)
 {
-    return wb_iface::sptr(new x300_ctrl_iface_enet(udp, enable_errors));
+    return fw_ctrl_iface::sptr(new x300_ctrl_iface_enet(udp, enable_errors));
 }
 
-wb_iface::sptr x300_make_ctrl_iface_pcie(
-    niriok_proxy::sptr drv_proxy, bool enable_errors = true)
+fw_ctrl_iface::sptr x300_make_ctrl_iface_pcie(
+    niriok_proxy::sptr drv_proxy, bool enable_errors)
 {
-    return wb_iface::sptr(new x300_ctrl_iface_pcie(drv_proxy, enable_errors));
+    return fw_ctrl_iface::sptr(new x300_ctrl_iface_pcie(drv_proxy, enable_errors));
 }
@@ -0,0 +1,72 @@
+//
+// Copyright 2019 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#ifndef INCLUDED_X300_FW_CTRL_HPP
+#define INCLUDED_X300_FW_CTRL_HPP
+
+#include <uhd/transport/nirio/niriok_proxy.h>
+#include <uhd/transport/udp_simple.hpp>
+#include <uhd/types/wb_iface.hpp>
+#include <boost/shared_ptr.hpp>
+#include <vector>
+
+namespace uhd { namespace usrp { namespace x300 {
+
+//! A peek or poke of a batch of register operations
+struct fw_reg_op_t
+{
+    enum op_type_t { PEEK32, POKE32 };
+
+    static fw_reg_op_t peek32(const wb_iface::wb_addr_type addr)
+    {
+        return {PEEK32, addr, 0};
+    }
+
+    static fw_reg_op_t poke32(const wb_iface::wb_addr_type addr, const uint32_t data)
+    {
+        return {POKE32, addr, data};
+    }
+
+    op_type_t type;
+    wb_iface::wb_addr_type addr;
+    //! The value to poke, or the value read by a peek
+    uint32_t data;
+};
+
+/*! Register access to the ZPU firmware
+ *
+ * On top of single peeks and pokes, this runs batches of them. Over Ethernet,
+ * a batch takes one round trip per X300_FW_COMMS_BATCH_MAX_OPS operations
+ * instead of one per operation, if the firmware supports it.
+ */
+class fw_ctrl_iface : public wb_iface
+{
+public:
+    typedef boost::shared_ptr<fw_ctrl_iface> sptr;
+
+    /*! Run register operations in order
+     *
+     * \param ops The operations. The data of peeks is set to the value read.
+     * \throws uhd::io_error if the operations fail after all retries
+     */
+    virtual void transact32(std::vector<fw_reg_op_t>& ops) = 0;
+};
+
+/*! Run register operations in order, batched if \p iface supports it
+ *
+ * Otherwise, this falls back to one peek32() or poke32() per operation.
+ */
+void fw_transact32(wb_iface::sptr iface, std::vector<fw_reg_op_t>& ops);
+
+}}} // namespace uhd::usrp::x300
+
+uhd::usrp::x300::fw_ctrl_iface::sptr x300_make_ctrl_iface_enet(
+    uhd::transport::udp_simple::sptr udp, bool enable_errors = true);
+
+uhd::usrp::x300::fw_ctrl_iface::sptr x300_make_ctrl_iface_pcie(
+    uhd::niusrprio::niriok_proxy::sptr drv_proxy, bool enable_errors = true);
+
+#endif /* INCLUDED_X300_FW_CTRL_HPP */
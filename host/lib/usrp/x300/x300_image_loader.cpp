@@ -282,14 +282,6 @@ static UHD_INLINE bool x300_recv_ok(const x300_fpga_update_data_t* pkt_in, size_
                     != X300_FPGA_PROG_FLAGS_ERROR));
 }
 
-// Image data needs to be bitswapped
-static UHD_INLINE void x300_bitswap(uint8_t* num)
-{
-    *num = ((*num & 0xF0) >> 4) | ((*num & 0x0F) << 4);
-    *num = ((*num & 0xCC) >> 2) | ((*num & 0x33) << 2);
-    *num = ((*num & 0xAA) >> 1) | ((*num & 0x55) << 1);
-}
-
 static void x300_ethernet_load(x300_session_t& session)
 {
     // UDP receive buffer
@@ -358,12 +350,9 @@ static void x300_ethernet_load(x300_session_t& session)
             }
 
             // Data must be bitswapped and byteswapped
-            for (size_t k = 0; k < X300_PACKET_SIZE_BYTES; k++) {
-                x300_bitswap(&pkt_out.data8[k]);
-            }
-            for (size_t k = 0; k < (X300_PACKET_SIZE_BYTES / 2); k++) {
-                pkt_out.data16[k] = htonx<uint16_t>(pkt_out.data16[k]);
-            }
+            bitswap(pkt_out.data8, pkt_out.data8, X300_PACKET_SIZE_BYTES);
+            htonx_buff<uint16_t>(
+                pkt_out.data16, pkt_out.data16, X300_PACKET_SIZE_BYTES / 2);
 
             len =
                 x300_send_and_recv(session.write_xport, flags, &pkt_out, session.data_in);
@@ -463,12 +452,8 @@ static void x300_ethernet_read(x300_session_t& session)
     }
 
     // Data must be bitswapped and byteswapped
-    for (size_t k = 0; k < X300_PACKET_SIZE_BYTES; k++) {
-        x300_bitswap(&pkt_in->data8[k]);
-    }
-    for (size_t k = 0; k < (X300_PACKET_SIZE_BYTES / 2); k++) {
-        pkt_in->data16[k] = htonx<uint16_t>(pkt_in->data16[k]);
-    }
+    bitswap(pkt_in->data8, pkt_in->data8, X300_PACKET_SIZE_BYTES);
+    htonx_buff<uint16_t>(pkt_in->data16, pkt_in->data16, X300_PACKET_SIZE_BYTES / 2);
 
     // Assume the largest size first
     size_t image_size = X300_FPGA_BIT_SIZE_BYTES;
@@ -525,12 +510,9 @@ static void x300_ethernet_read(x300_session_t& session)
             }
 
             // Data must be bitswapped and byteswapped
-            for (size_t k = 0; k < X300_PACKET_SIZE_BYTES; k++) {
-                x300_bitswap(&pkt_in->data8[k]);
-            }
-            for (size_t k = 0; k < (X300_PACKET_SIZE_BYTES / 2); k++) {
-                pkt_in->data16[k] = htonx<uint16_t>(pkt_in->data16[k]);
-            }
+            bitswap(pkt_in->data8, pkt_in->data8, X300_PACKET_SIZE_BYTES);
+            htonx_buff<uint16_t>(
+                pkt_in->data16, pkt_in->data16, X300_PACKET_SIZE_BYTES / 2);
 
             // Calculate the number of bytes to write
             // If this is the last packet, get rid of the extra zero padding
@@ -21,6 +21,9 @@
 #include <uhd/utils/paths.hpp>
 #include <uhd/utils/safe_call.hpp>
 #include <uhd/utils/static.hpp>
+#include <uhdlib/utils/lock_wait.hpp>
+#include <uhdlib/utils/thread_policy.hpp>
+#include <uhdlib/utils/trace.hpp>
 #include <boost/algorithm/string.hpp>
 #include <boost/make_shared.hpp>
 #include <chrono>
@@ -204,6 +207,7 @@ x300_impl::x300_impl(const uhd::device_addr_t& dev_addr) : device3_impl(), _sid_
 
 void x300_impl::setup_mb(const size_t mb_i, const uhd::device_addr_t& dev_addr)
 {
+    UHD_TRACE_SCOPE("x300::setup_mb");
     const fs_path mb_path  = fs_path("/mboards") / mb_i;
     mboard_members_t& mb   = _mb[mb_i];
     mb.args.parse(dev_addr);
@@ -228,8 +232,8 @@ void x300_impl::setup_mb(const size_t mb_i, const uhd::device_addr_t& dev_addr)
     if (not try_to_claim(mb.zpu_ctrl)) {
         throw uhd::runtime_error("Failed to claim device");
     }
-    mb.claimer_task =
-        uhd::task::make([&mb]() { claimer_loop(mb.zpu_ctrl); }, "x300_claimer");
+    mb.claimer_task = uhd::task::make(
+        [&mb]() { claimer_loop(mb.zpu_ctrl); }, uhd::thread_policy::CLAIMER);
 
     // extract the FW path for the X300
     // and live load fw over ethernet link
@@ -345,20 +349,24 @@ void x300_impl::setup_mb(const size_t mb_i, const uhd::device_addr_t& dev_addr)
     ////////////////////////////////////////////////////////////////////
     UHD_LOGGER_DEBUG("X300") << "Setting up RF frontend clocking...";
 
-    // Initialize clock control registers. NOTE: This does not configure the LMK yet.
-    mb.clock = x300_clock_ctrl::make(mb.zpu_spi,
-        1 /*slaveno*/,
-        mb.hw_rev,
-        mb.args.get_master_clock_rate(),
-        mb.args.get_dboard_clock_rate(),
-        mb.args.get_system_ref_rate());
-    mb.fw_regmap->ref_freq_reg.write(
-        fw_regmap_t::ref_freq_reg_t::REF_FREQ, uint32_t(mb.args.get_system_ref_rate()));
-
-    // Initialize clock source to use internal reference and generate
-    // a valid radio clock. This may change after configuration is done.
-    // This will configure the LMK and wait for lock
-    update_clock_source(mb, mb.args.get_clock_source());
+    {
+        UHD_TRACE_SCOPE("x300::clock_init");
+        // Initialize clock control registers. NOTE: This does not configure the LMK
+        // yet.
+        mb.clock = x300_clock_ctrl::make(mb.zpu_spi,
+            1 /*slaveno*/,
+            mb.hw_rev,
+            mb.args.get_master_clock_rate(),
+            mb.args.get_dboard_clock_rate(),
+            mb.args.get_system_ref_rate());
+        mb.fw_regmap->ref_freq_reg.write(fw_regmap_t::ref_freq_reg_t::REF_FREQ,
+            uint32_t(mb.args.get_system_ref_rate()));
+
+        // Initialize clock source to use internal reference and generate
+        // a valid radio clock. This may change after configuration is done.
+        // This will configure the LMK and wait for lock
+        update_clock_source(mb, mb.args.get_clock_source());
+    }
 
     ////////////////////////////////////////////////////////////////////
     // create clock properties
@@ -485,6 +493,13 @@ void x300_impl::setup_mb(const size_t mb_i, const uhd::device_addr_t& dev_addr)
             radio_ids.resize(2);
         }
 
+        // ADC self-cal results are cached per board, clock rate and FPGA image
+        adc_self_cal_key_t self_cal_key;
+        self_cal_key.serial            = mb_eeprom.get("serial", "");
+        self_cal_key.master_clock_rate = mb.clock->get_master_clock_rate();
+        self_cal_key.fpga_hash =
+            _tree->access<std::string>(mb_path / "fpga_version_hash").get();
+
         for (const rfnoc::block_id_t& id : radio_ids) {
             rfnoc::x300_radio_ctrl_impl::sptr radio(
                 get_block_ctrl<rfnoc::x300_radio_ctrl_impl>(id));
@@ -492,20 +507,23 @@ void x300_impl::setup_mb(const size_t mb_i, const uhd::device_addr_t& dev_addr)
             radio->setup_radio(mb.zpu_i2c,
                 mb.clock,
                 mb.args.get_ignore_cal_file(),
-                mb.args.get_self_cal_adc_delay());
+                mb.args.get_self_cal_adc_delay(),
+                self_cal_key);
         }
 
         ////////////////////////////////////////////////////////////////////
         // ADC test and cal
         ////////////////////////////////////////////////////////////////////
         if (mb.args.get_self_cal_adc_delay()) {
+            UHD_TRACE_SCOPE("x300::adc_xfer_delay_cal");
             rfnoc::x300_radio_ctrl_impl::self_cal_adc_xfer_delay(mb.radios,
                 mb.clock,
                 [this, &mb](const double timeout) {
                     return this->wait_for_clk_locked(
                         mb, fw_regmap_t::clk_status_reg_t::LMK_LOCK, timeout);
                 },
-                true /* Apply ADC delay */);
+                true /* Apply ADC delay */,
+                self_cal_key);
         }
         if (mb.args.get_ext_adc_self_test()) {
             rfnoc::x300_radio_ctrl_impl::extended_adc_test(
@@ -773,17 +791,22 @@ void x300_impl::sync_times(mboard_members_t& mb, const uhd::time_spec_t& t)
 
 bool x300_impl::wait_for_clk_locked(mboard_members_t& mb, uint32_t which, double timeout)
 {
-    const auto timeout_time = std::chrono::steady_clock::now()
-                              + std::chrono::milliseconds(int64_t(timeout * 1000));
-    do {
-        if (mb.fw_regmap->clock_status_reg.read(which) == 1) {
-            return true;
-        }
-        std::this_thread::sleep_for(std::chrono::milliseconds(1));
-    } while (std::chrono::steady_clock::now() < timeout_time);
-
-    // Check one last time
-    return (mb.fw_regmap->clock_status_reg.read(which) == 1);
+    std::string name = "x300::clk_lock";
+    switch (which) {
+        case fw_regmap_t::clk_status_reg_t::LMK_LOCK:
+            name = "x300::lmk_lock";
+            break;
+        case fw_regmap_t::clk_status_reg_t::RADIO_CLK_LOCK:
+            name = "x300::radio_clk_lock";
+            break;
+        case fw_regmap_t::clk_status_reg_t::IDELAYCTRL_LOCK:
+            name = "x300::idelayctrl_lock";
+            break;
+    }
+    return wait_for_lock(
+        name,
+        [&mb, which]() { return mb.fw_regmap->clock_status_reg.read(which) == 1; },
+        timeout);
 }
 
 sensor_value_t x300_impl::get_ref_locked(mboard_members_t& mb)
@@ -830,6 +853,7 @@ size_t x300_impl::get_mtu(const size_t mb_index, const uhd::direction_t dir)
  **********************************************************************/
 void x300_impl::check_fw_compat(const fs_path& mb_path, const mboard_members_t& members)
 {
+    UHD_TRACE_SCOPE("x300::check_fw_compat");
     auto iface = members.zpu_ctrl;
     const uint32_t compat_num =
         iface->peek32(SR_ADDR(X300_FW_SHMEM_BASE, X300_FW_SHMEM_COMPAT_NUM));
@@ -866,6 +890,7 @@ void x300_impl::check_fw_compat(const fs_path& mb_path, const mboard_members_t&
 
 void x300_impl::check_fpga_compat(const fs_path& mb_path, const mboard_members_t& members)
 {
+    UHD_TRACE_SCOPE("x300::check_fpga_compat");
     uint32_t compat_num = members.zpu_ctrl->peek32(SR_ADDR(SET0_BASE, ZPU_RB_COMPAT_NUM));
     uint32_t compat_major = (compat_num >> 16);
     uint32_t compat_minor = (compat_num & 0xffff);
@@ -20,6 +20,7 @@
 #include "x300_mb_eeprom_iface.hpp"
 #include "x300_claim.hpp"
 #include "x300_fw_common.h"
+#include "x300_fw_ctrl.hpp"
 #include "x300_impl.hpp"
 #include "x300_regs.hpp"
 #include <uhd/exception.hpp>
@@ -119,10 +120,19 @@ public:
             if (num_bytes == 0)
                 return bytes;
 
+            // Read all words in one batch
+            const size_t bytes_per_word = 4 - offset % 4;
+            const size_t num_words = (num_bytes + bytes_per_word - 1) / bytes_per_word;
+            std::vector<uhd::usrp::x300::fw_reg_op_t> ops;
+            for (size_t word = offset / 4; ops.size() < num_words; word++) {
+                ops.push_back(uhd::usrp::x300::fw_reg_op_t::peek32(
+                    X300_FW_SHMEM_ADDR(X300_FW_SHMEM_IDENT + word)));
+            }
+            uhd::usrp::x300::fw_transact32(_wb, ops);
+
             size_t bytes_read = 0;
-            for (size_t word = offset / 4; bytes_read < num_bytes; word++) {
-                uint32_t value =
-                    byteswap(_wb->peek32(X300_FW_SHMEM_ADDR(X300_FW_SHMEM_IDENT + word)));
+            for (size_t op_idx = 0; bytes_read < num_bytes; op_idx++) {
+                uint32_t value = byteswap(ops[op_idx].data);
                 for (size_t byte = offset % 4; byte < 4 and bytes_read < num_bytes;
                      byte++) {
                     bytes.push_back(uint8_t((value >> (byte * 8)) & 0xff));
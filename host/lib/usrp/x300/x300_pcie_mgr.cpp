@@ -6,6 +6,7 @@
 
 #include "x300_pcie_mgr.hpp"
 #include "x300_claim.hpp"
+#include "x300_fw_ctrl.hpp"
 #include "x300_lvbitx.hpp"
 #include "x300_mb_eeprom.hpp"
 #include "x300_mb_eeprom_iface.hpp"
@@ -54,9 +55,6 @@ constexpr double PCIE_DEFAULT_RECV_TIMEOUT_CTRL = 0.5; // seconds
 constexpr double PCIE_DEFAULT_RECV_TIMEOUT_ASYNC = 0.1; // seconds
 }
 
-uhd::wb_iface::sptr x300_make_ctrl_iface_pcie(
-    uhd::niusrprio::niriok_proxy::sptr drv_proxy, bool enable_errors = true);
-
 using namespace uhd;
 using namespace uhd::transport;
 using namespace uhd::usrp::x300;
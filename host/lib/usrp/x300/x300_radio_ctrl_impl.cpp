@@ -16,10 +16,13 @@
 #include <uhdlib/rfnoc/wb_iface_adapter.hpp>
 #include <uhdlib/usrp/common/apply_corrections.hpp>
 #include <uhdlib/usrp/cores/gpio_atr_3000.hpp>
+#include <uhdlib/utils/trace.hpp>
 #include <boost/algorithm/string.hpp>
 #include <boost/date_time/posix_time/posix_time_io.hpp>
 #include <boost/make_shared.hpp>
 #include <chrono>
+#include <cmath>
+#include <map>
 #include <thread>
 #include <bitset>
 
@@ -790,9 +793,11 @@ uint32_t x300_radio_ctrl_impl::get_gpio_attr(
 void x300_radio_ctrl_impl::setup_radio(uhd::i2c_iface::sptr zpu_i2c,
     x300_clock_ctrl::sptr clock,
     bool ignore_cal_file,
-    bool verbose)
+    bool verbose,
+    const uhd::usrp::x300::adc_self_cal_key_t& cal_key)
 {
-    _self_cal_adc_capture_delay(verbose);
+    UHD_TRACE_SCOPE("x300_radio::setup_radio " + _radio_slot);
+    _self_cal_adc_capture_delay(verbose, cal_key);
     _ignore_cal_file = ignore_cal_file;
 
     ////////////////////////////////////////////////////////////////////
@@ -880,7 +885,10 @@ void x300_radio_ctrl_impl::setup_radio(uhd::i2c_iface::sptr zpu_i2c,
     UHD_ASSERT_THROW(rx_chan or tx_chan);
 
     // Initialize the daughterboards now that frontend cores and connections exist
-    _db_manager->initialize_dboards();
+    {
+        UHD_TRACE_SCOPE("x300_radio::dboard_init " + _radio_slot);
+        _db_manager->initialize_dboards();
+    }
 
     // now that dboard is created -- register into rx antenna event
     if (not _rx_fe_map.empty()) {
@@ -1223,12 +1231,13 @@ double x300_radio_ctrl_impl::self_cal_adc_xfer_delay(
     const std::vector<x300_radio_ctrl_impl::sptr>& radios,
     x300_clock_ctrl::sptr clock,
     boost::function<void(double)> wait_for_clk_locked,
-    bool apply_delay)
+    bool apply_delay,
+    const uhd::usrp::x300::adc_self_cal_key_t& cal_key)
 {
-    UHD_LOGGER_INFO("X300 RADIO") << "Running ADC transfer delay self-cal: ";
-
     // Effective resolution of the self-cal.
     static const size_t NUM_DELAY_STEPS = 100;
+    // 50ms @ 200MHz = 10 million samples
+    static const uint32_t TEST_TIME_MS = 50;
 
     double master_clk_period = (1.0e9 / clock->get_master_clock_rate()); // in ns
     double delay_start       = 0.0;
@@ -1238,103 +1247,80 @@ double x300_radio_ctrl_impl::self_cal_adc_xfer_delay(
     double cached_clk_delay = clock->get_clock_delay(X300_CLOCK_WHICH_ADC0);
     double fpga_clk_delay   = clock->get_clock_delay(X300_CLOCK_WHICH_FPGA);
 
-    // Iterate through several values of delays and measure ADC data integrity
-    std::vector<std::pair<double, bool>> results;
-    for (size_t i = 0; i < NUM_DELAY_STEPS; i++) {
-        // Delay the ADC clock (will set both Ch0 and Ch1 delays)
-        double delay =
-            clock->set_clock_delay(X300_CLOCK_WHICH_ADC0, delay_incr * i + delay_start);
-        wait_for_clk_locked(0.1);
-
-        uint32_t err_code = 0;
+    auto test_radios = [&radios]() {
+        bool valid = true;
         for (size_t r = 0; r < radios.size(); r++) {
-            // Test each channel (I and Q) individually so as to not accidentally trigger
-            // on the data from the other channel if there is a swap
-
-            // -- Test I Channel --
-            // Put ADC in ramp test mode. Tie the other channel to all ones.
-            radios[r]->_adc->set_test_word("ramp", "ones");
-            // Turn on the pattern checker in the FPGA. It will lock when it sees a zero
-            // and count deviations from the expected value
-            radios[r]->_regs->misc_outs_reg.write(
-                radio_regmap_t::misc_outs_reg_t::ADC_CHECKER_ENABLED, 0);
-            radios[r]->_regs->misc_outs_reg.write(
-                radio_regmap_t::misc_outs_reg_t::ADC_CHECKER_ENABLED, 1);
-            // 50ms @ 200MHz = 10 million samples
-            std::this_thread::sleep_for(std::chrono::milliseconds(50));
-            if (radios[r]->_regs->misc_ins_reg.read(
-                    radio_regmap_t::misc_ins_reg_t::ADC_CHECKER1_I_LOCKED)) {
-                err_code += radios[r]->_regs->misc_ins_reg.get(
-                    radio_regmap_t::misc_ins_reg_t::ADC_CHECKER1_I_ERROR);
-            } else {
-                err_code += 100; // Increment error code by 100 to indicate no lock
-            }
-
-            // -- Test Q Channel --
-            // Put ADC in ramp test mode. Tie the other channel to all ones.
-            radios[r]->_adc->set_test_word("ones", "ramp");
-            // Turn on the pattern checker in the FPGA. It will lock when it sees a zero
-            // and count deviations from the expected value
+            valid = radios[r]->_test_adc_ramp(true, TEST_TIME_MS) and valid;
+        }
+        return valid;
+    };
+    auto teardown = [&radios]() {
+        for (size_t r = 0; r < radios.size(); r++) {
+            radios[r]->_adc->set_test_word("normal", "normal");
             radios[r]->_regs->misc_outs_reg.write(
                 radio_regmap_t::misc_outs_reg_t::ADC_CHECKER_ENABLED, 0);
-            radios[r]->_regs->misc_outs_reg.write(
-                radio_regmap_t::misc_outs_reg_t::ADC_CHECKER_ENABLED, 1);
-            // 50ms @ 200MHz = 10 million samples
-            std::this_thread::sleep_for(std::chrono::milliseconds(50));
-            if (radios[r]->_regs->misc_ins_reg.read(
-                    radio_regmap_t::misc_ins_reg_t::ADC_CHECKER1_Q_LOCKED)) {
-                err_code += radios[r]->_regs->misc_ins_reg.get(
-                    radio_regmap_t::misc_ins_reg_t::ADC_CHECKER1_Q_ERROR);
-            } else {
-                err_code += 100; // Increment error code by 100 to indicate no lock
-            }
         }
-        // UHD_LOGGER_INFO("X300 RADIO") << (boost::format("XferDelay=%fns, Error=%d") %
-        // delay % err_code);
-        results.push_back(std::pair<double, bool>(delay, err_code == 0));
-    }
+    };
 
-    // Calculate the valid window
-    int win_start_idx = -1, win_stop_idx = -1, cur_start_idx = -1, cur_stop_idx = -1;
-    for (size_t i = 0; i < results.size(); i++) {
-        std::pair<double, bool>& item = results[i];
-        if (item.second) { // If data is stable
-            if (cur_start_idx == -1) { // This is the first window
-                cur_start_idx = i;
-                cur_stop_idx  = i;
-            } else { // We are extending the window
-                cur_stop_idx = i;
-            }
-        } else {
-            if (cur_start_idx == -1) { // We haven't yet seen valid data
-                // Do nothing
-            } else if (win_start_idx == -1) { // We passed the first valid window
-                win_start_idx = cur_start_idx;
-                win_stop_idx  = cur_stop_idx;
-            } else { // Update cached window if current window is larger
-                double cur_win_len =
-                    results[cur_stop_idx].first - results[cur_start_idx].first;
-                double cached_win_len =
-                    results[win_stop_idx].first - results[win_start_idx].first;
-                if (cur_win_len > cached_win_len) {
-                    win_start_idx = cur_start_idx;
-                    win_stop_idx  = cur_stop_idx;
-                }
+    // A cached delay is used if the ADC data is still valid with it
+    const std::string cal_name = "xfer_delay";
+    boost::optional<double> cached_delay =
+        apply_delay ? uhd::usrp::x300::load_adc_self_cal(cal_key, cal_name)
+                    : boost::optional<double>();
+    if (cached_delay) {
+        const double delay = clock->set_clock_delay(X300_CLOCK_WHICH_ADC0, *cached_delay);
+        wait_for_clk_locked(0.1);
+        if (test_radios()) {
+            for (size_t r = 0; r < radios.size(); r++) {
+                radios[r]->self_test_adc(2000);
             }
-            // Reset current window
-            cur_start_idx = -1;
-            cur_stop_idx  = -1;
+            teardown();
+            UHD_LOGGER_INFO("X300 RADIO")
+                << (boost::format("ADC transfer delay self-cal verified (%.3fns)")
+                       % delay);
+            return delay;
         }
+        UHD_LOGGER_DEBUG("X300 RADIO")
+            << "Cached ADC transfer delay failed verification, running self-cal";
     }
-    if (win_start_idx == -1) {
+
+    UHD_LOGGER_INFO("X300 RADIO") << "Running ADC transfer delay self-cal: ";
+
+    // Search the windows of valid ADC data over the delays. Windows narrower
+    // than a quarter of a clock period are rejected below anyway.
+    std::map<size_t, double> delays;
+    auto test_step = [&](const size_t i) {
+        // Delay the ADC clock (will set both Ch0 and Ch1 delays)
+        delays[i] =
+            clock->set_clock_delay(X300_CLOCK_WHICH_ADC0, delay_incr * i + delay_start);
+        wait_for_clk_locked(0.1);
+        return test_radios();
+    };
+    const size_t min_window_steps =
+        size_t(std::floor(master_clk_period / 4 / delay_incr));
+    const std::vector<uhd::usrp::x300::adc_cal_window_t> windows =
+        uhd::usrp::x300::find_adc_cal_windows(
+            NUM_DELAY_STEPS, min_window_steps, test_step, false /* find all */);
+    if (windows.empty()) {
+        clock->set_clock_delay(X300_CLOCK_WHICH_ADC0, cached_clk_delay);
+        teardown();
         throw uhd::runtime_error(
             "self_cal_adc_xfer_delay: Self calibration failed. Convergence error.");
     }
 
-    double win_center =
-        (results[win_stop_idx].first + results[win_start_idx].first) / 2.0;
-    double win_length = results[win_stop_idx].first - results[win_start_idx].first;
+    // Use the largest window
+    double win_start = 0.0, win_stop = 0.0;
+    for (const auto& window : windows) {
+        if (delays.at(window.second) - delays.at(window.first) > win_stop - win_start) {
+            win_start = delays.at(window.first);
+            win_stop  = delays.at(window.second);
+        }
+    }
+    double win_center = (win_stop + win_start) / 2.0;
+    double win_length = win_stop - win_start;
     if (win_length < master_clk_period / 4) {
+        clock->set_clock_delay(X300_CLOCK_WHICH_ADC0, cached_clk_delay);
+        teardown();
         throw uhd::runtime_error(
             "self_cal_adc_xfer_delay: Self calibration failed. Valid window too narrow.");
     }
@@ -1355,6 +1341,7 @@ double x300_radio_ctrl_impl::self_cal_adc_xfer_delay(
         for (size_t r = 0; r < radios.size(); r++) {
             radios[r]->self_test_adc(2000);
         }
+        uhd::usrp::x300::store_adc_self_cal(cal_key, cal_name, win_center);
     } else {
         // Restore delay
         clock->set_clock_delay(
@@ -1362,11 +1349,7 @@ double x300_radio_ctrl_impl::self_cal_adc_xfer_delay(
     }
 
     // Teardown
-    for (size_t r = 0; r < radios.size(); r++) {
-        radios[r]->_adc->set_test_word("normal", "normal");
-        radios[r]->_regs->misc_outs_reg.write(
-            radio_regmap_t::misc_outs_reg_t::ADC_CHECKER_ENABLED, 0);
-    }
+    teardown();
     UHD_LOGGER_INFO("X300 RADIO")
         << (boost::format(
                 "ADC transfer delay self-cal done (FPGA->ADC=%.3fns%s, Window=%.3fns)")
@@ -1392,116 +1375,116 @@ void x300_radio_ctrl_impl::_update_atr_leds(const std::string& rx_ant, const siz
     _leds.at(chan)->set_atr_reg(gpio_atr::ATR_REG_FULL_DUPLEX, RX2_RX | TXRX_TX);
 }
 
-void x300_radio_ctrl_impl::_self_cal_adc_capture_delay(bool print_status)
+bool x300_radio_ctrl_impl::_test_adc_ramp(const bool use_checker1, const uint32_t time_ms)
 {
-    if (print_status)
-        UHD_LOGGER_INFO("X300 RADIO") << "Running ADC capture delay self-cal...";
+    typedef radio_regmap_t::misc_ins_reg_t misc_ins_reg_t;
+    uint32_t err_code = 0;
+    // Test each channel (I and Q) individually so as to not accidentally trigger
+    // on the data from the other channel if there is a swap
+    for (const bool test_i : {true, false}) {
+        // Put ADC in ramp test mode. Tie the other channel to all ones.
+        _adc->set_test_word(test_i ? "ramp" : "ones", test_i ? "ones" : "ramp");
+        // Turn on the pattern checker in the FPGA. It will lock when it sees a zero
+        // and count deviations from the expected value
+        _regs->misc_outs_reg.write(radio_regmap_t::misc_outs_reg_t::ADC_CHECKER_ENABLED, 0);
+        _regs->misc_outs_reg.write(radio_regmap_t::misc_outs_reg_t::ADC_CHECKER_ENABLED, 1);
+        std::this_thread::sleep_for(std::chrono::milliseconds(time_ms));
+        const uhd::soft_reg_field_t locked =
+            use_checker1 ? (test_i ? misc_ins_reg_t::ADC_CHECKER1_I_LOCKED
+                                   : misc_ins_reg_t::ADC_CHECKER1_Q_LOCKED)
+                         : (test_i ? misc_ins_reg_t::ADC_CHECKER0_I_LOCKED
+                                   : misc_ins_reg_t::ADC_CHECKER0_Q_LOCKED);
+        const uhd::soft_reg_field_t error =
+            use_checker1 ? (test_i ? misc_ins_reg_t::ADC_CHECKER1_I_ERROR
+                                   : misc_ins_reg_t::ADC_CHECKER1_Q_ERROR)
+                         : (test_i ? misc_ins_reg_t::ADC_CHECKER0_I_ERROR
+                                   : misc_ins_reg_t::ADC_CHECKER0_Q_ERROR);
+        if (_regs->misc_ins_reg.read(locked)) {
+            err_code += _regs->misc_ins_reg.get(error);
+        } else {
+            err_code += 100; // Increment error code by 100 to indicate no lock
+        }
+    }
+    return err_code == 0;
+}
+
+void x300_radio_ctrl_impl::_set_adc_capture_tap(const uint32_t dly_tap)
+{
+    _regs->misc_outs_reg.write(radio_regmap_t::misc_outs_reg_t::ADC_DATA_DLY_VAL, dly_tap);
+    _regs->misc_outs_reg.write(radio_regmap_t::misc_outs_reg_t::ADC_DATA_DLY_STB, 1);
+    _regs->misc_outs_reg.write(radio_regmap_t::misc_outs_reg_t::ADC_DATA_DLY_STB, 0);
+}
 
+void x300_radio_ctrl_impl::_self_cal_adc_capture_delay(
+    bool print_status, const uhd::usrp::x300::adc_self_cal_key_t& cal_key)
+{
+    UHD_TRACE_SCOPE("x300_radio::adc_capture_delay_cal " + _radio_slot);
     static const uint32_t NUM_DELAY_STEPS = 32; // The IDELAYE2 element has 32 steps
     static const uint32_t NUM_RETRIES =
         2; // Retry self-cal if it fails in warmup situations
-    static const int32_t MIN_WINDOW_LEN = 4;
-
-    int32_t win_start = -1, win_stop = -1;
-    uint32_t iter = 0;
-    while (iter++ < NUM_RETRIES) {
-        for (uint32_t dly_tap = 0; dly_tap < NUM_DELAY_STEPS; dly_tap++) {
-            // Apply delay
-            _regs->misc_outs_reg.write(
-                radio_regmap_t::misc_outs_reg_t::ADC_DATA_DLY_VAL, dly_tap);
-            _regs->misc_outs_reg.write(
-                radio_regmap_t::misc_outs_reg_t::ADC_DATA_DLY_STB, 1);
-            _regs->misc_outs_reg.write(
-                radio_regmap_t::misc_outs_reg_t::ADC_DATA_DLY_STB, 0);
-
-            uint32_t err_code = 0;
-
-            // -- Test I Channel --
-            // Put ADC in ramp test mode. Tie the other channel to all ones.
-            _adc->set_test_word("ramp", "ones");
-            // Turn on the pattern checker in the FPGA. It will lock when it sees a zero
-            // and count deviations from the expected value
-            _regs->misc_outs_reg.write(
-                radio_regmap_t::misc_outs_reg_t::ADC_CHECKER_ENABLED, 0);
-            _regs->misc_outs_reg.write(
-                radio_regmap_t::misc_outs_reg_t::ADC_CHECKER_ENABLED, 1);
-            // 5ms @ 200MHz = 1 million samples
-            std::this_thread::sleep_for(std::chrono::milliseconds(5));
-            if (_regs->misc_ins_reg.read(
-                    radio_regmap_t::misc_ins_reg_t::ADC_CHECKER0_I_LOCKED)) {
-                err_code += _regs->misc_ins_reg.get(
-                    radio_regmap_t::misc_ins_reg_t::ADC_CHECKER0_I_ERROR);
-            } else {
-                err_code += 100; // Increment error code by 100 to indicate no lock
-            }
+    static const uint32_t MIN_WINDOW_LEN = 4;
+    static const uint32_t TEST_TIME_MS   = 5; // 5ms @ 200MHz = 1 million samples
 
-            // -- Test Q Channel --
-            // Put ADC in ramp test mode. Tie the other channel to all ones.
-            _adc->set_test_word("ones", "ramp");
-            // Turn on the pattern checker in the FPGA. It will lock when it sees a zero
-            // and count deviations from the expected value
-            _regs->misc_outs_reg.write(
-                radio_regmap_t::misc_outs_reg_t::ADC_CHECKER_ENABLED, 0);
-            _regs->misc_outs_reg.write(
-                radio_regmap_t::misc_outs_reg_t::ADC_CHECKER_ENABLED, 1);
-            // 5ms @ 200MHz = 1 million samples
-            std::this_thread::sleep_for(std::chrono::milliseconds(5));
-            if (_regs->misc_ins_reg.read(
-                    radio_regmap_t::misc_ins_reg_t::ADC_CHECKER0_Q_LOCKED)) {
-                err_code += _regs->misc_ins_reg.get(
-                    radio_regmap_t::misc_ins_reg_t::ADC_CHECKER0_Q_ERROR);
-            } else {
-                err_code += 100; // Increment error code by 100 to indicate no lock
-            }
+    auto test_tap = [this](const size_t dly_tap) {
+        _set_adc_capture_tap(uint32_t(dly_tap));
+        return _test_adc_ramp(false, TEST_TIME_MS);
+    };
+    auto teardown = [this]() {
+        _adc->set_test_word("normal", "normal");
+        _regs->misc_outs_reg.write(
+            radio_regmap_t::misc_outs_reg_t::ADC_CHECKER_ENABLED, 0);
+    };
 
-            if (err_code == 0) {
-                if (win_start == -1) { // This is the first window
-                    win_start = dly_tap;
-                    win_stop  = dly_tap;
-                } else { // We are extending the window
-                    win_stop = dly_tap;
-                }
-            } else {
-                if (win_start != -1) { // A valid window turned invalid
-                    if (win_stop - win_start >= MIN_WINDOW_LEN) {
-                        break; // Valid window found
-                    } else {
-                        win_start = -1; // Reset window
-                    }
-                }
+    // A cached tap is used if the taps half a minimum window away on either
+    // side are still valid
+    const std::string cal_name = "capture_delay_" + _radio_slot;
+    boost::optional<double> cached_tap =
+        uhd::usrp::x300::load_adc_self_cal(cal_key, cal_name);
+    if (cached_tap) {
+        const uint32_t tap = uint32_t(*cached_tap);
+        if (tap >= MIN_WINDOW_LEN / 2 and tap + MIN_WINDOW_LEN / 2 < NUM_DELAY_STEPS
+            and test_tap(tap - MIN_WINDOW_LEN / 2) and test_tap(tap + MIN_WINDOW_LEN / 2)
+            and test_tap(tap)) {
+            teardown();
+            if (print_status) {
+                UHD_LOGGER_INFO("X300 RADIO")
+                    << boost::format("ADC capture delay self-cal verified (Tap=%d)")
+                           % tap;
             }
-            // UHD_LOGGER_INFO("X300 RADIO") << (boost::format("CapTap=%d, Error=%d") %
-            // dly_tap % err_code);
+            return;
         }
+        UHD_LOGGER_DEBUG("X300 RADIO")
+            << "Cached ADC capture delay failed verification, running self-cal";
+    }
+
+    if (print_status)
+        UHD_LOGGER_INFO("X300 RADIO") << "Running ADC capture delay self-cal...";
+
+    std::vector<uhd::usrp::x300::adc_cal_window_t> windows;
+    uint32_t iter = 0;
+    while (iter++ < NUM_RETRIES) {
+        windows = uhd::usrp::x300::find_adc_cal_windows(
+            NUM_DELAY_STEPS, MIN_WINDOW_LEN, test_tap, true /* stop at first */);
 
         // Retry the self-cal if it fails
-        if ((win_start == -1 || (win_stop - win_start) < MIN_WINDOW_LEN)
-            && iter < NUM_RETRIES /*not last iteration*/) {
-            win_start = -1;
-            win_stop  = -1;
+        if (windows.empty() && iter < NUM_RETRIES /*not last iteration*/) {
             std::this_thread::sleep_for(std::chrono::milliseconds(2000));
         } else {
             break;
         }
     }
-    _adc->set_test_word("normal", "normal");
-    _regs->misc_outs_reg.write(radio_regmap_t::misc_outs_reg_t::ADC_CHECKER_ENABLED, 0);
+    teardown();
 
-    if (win_start == -1) {
+    if (windows.empty()) {
         throw uhd::runtime_error(
             "self_cal_adc_capture_delay: Self calibration failed. Convergence error.");
     }
 
-    if (win_stop - win_start < MIN_WINDOW_LEN) {
-        throw uhd::runtime_error("self_cal_adc_capture_delay: Self calibration failed. "
-                                 "Valid window too narrow.");
-    }
-
-    uint32_t ideal_tap = (win_stop + win_start) / 2;
-    _regs->misc_outs_reg.write(
-        radio_regmap_t::misc_outs_reg_t::ADC_DATA_DLY_VAL, ideal_tap);
-    _regs->misc_outs_reg.write(radio_regmap_t::misc_outs_reg_t::ADC_DATA_DLY_STB, 1);
-    _regs->misc_outs_reg.write(radio_regmap_t::misc_outs_reg_t::ADC_DATA_DLY_STB, 0);
+    const uint32_t win_start = uint32_t(windows.front().first);
+    const uint32_t win_stop  = uint32_t(windows.front().second);
+    uint32_t ideal_tap       = (win_stop + win_start) / 2;
+    _set_adc_capture_tap(ideal_tap);
+    uhd::usrp::x300::store_adc_self_cal(cal_key, cal_name, ideal_tap);
 
     if (print_status) {
         double tap_delay = (1.0e12 / _radio_clk_rate) / (2 * 32); // in ps
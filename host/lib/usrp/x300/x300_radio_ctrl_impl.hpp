@@ -9,6 +9,7 @@
 #define INCLUDED_LIBUHD_RFNOC_X300_RADIO_CTRL_IMPL_HPP
 
 #include "x300_adc_ctrl.hpp"
+#include "x300_adc_self_cal.hpp"
 #include "x300_clock_ctrl.hpp"
 #include "x300_dac_ctrl.hpp"
 #include "x300_regs.hpp"
@@ -90,11 +91,14 @@ public:
      * Hardware setup and control
      ***********************************************************************/
     /*! Set up the radio. No API calls may be made before this one.
+     *
+     * The ADC capture delay self-cal result is cached for \p cal_key.
      */
     void setup_radio(uhd::i2c_iface::sptr zpu_i2c,
         x300_clock_ctrl::sptr clock,
         bool ignore_cal_file,
-        bool verbose);
+        bool verbose,
+        const uhd::usrp::x300::adc_self_cal_key_t& cal_key);
 
     void reset_codec();
 
@@ -109,7 +113,8 @@ public:
         const std::vector<x300_radio_ctrl_impl::sptr>& radios,
         x300_clock_ctrl::sptr clock,
         boost::function<void(double)> wait_for_clk_locked,
-        bool apply_delay);
+        bool apply_delay,
+        const uhd::usrp::x300::adc_self_cal_key_t& cal_key);
 
 protected:
     virtual bool check_radio_config();
@@ -183,7 +188,13 @@ private:
 
     void _update_atr_leds(const std::string& rx_ant, const size_t chan);
 
-    void _self_cal_adc_capture_delay(bool print_status);
+    //! Run the FPGA ADC pattern checker on ramps; true if there were no errors
+    bool _test_adc_ramp(const bool use_checker1, const uint32_t time_ms);
+
+    void _set_adc_capture_tap(const uint32_t dly_tap);
+
+    void _self_cal_adc_capture_delay(
+        bool print_status, const uhd::usrp::x300::adc_self_cal_key_t& cal_key);
 
     void _check_adc(const uint32_t val);
 
@@ -58,15 +58,7 @@ typedef struct {
 } octoclock_session_t;
 
 static void octoclock_calculate_crc(octoclock_session_t &session){
-    session.crc = 0xFFFF;
-    for(size_t i = 0; i < session.image.size(); i++)
-    {
-        session.crc ^= session.image[i];
-        for(uint8_t j = 0; j < 8; ++j){
-            if(session.crc & 1) session.crc = (session.crc >> 1) ^ 0xA001;
-            else session.crc = (session.crc >> 1);
-        }
-    }
+    session.crc = uhd::crc16(session.image.data(), session.image.size());
 }
 
 static void octoclock_read_bin(octoclock_session_t &session)
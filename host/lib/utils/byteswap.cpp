@@ -0,0 +1,189 @@
+//
+// Copyright 2019 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include <uhd/utils/byteswap.hpp>
+#if defined(__SSE2__)
+#    include <emmintrin.h>
+#endif
+
+namespace {
+
+#if defined(__SSE2__)
+UHD_INLINE __m128i load(const void* p)
+{
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+}
+
+UHD_INLINE void store(void* p, const __m128i v)
+{
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v);
+}
+
+//! Swap the bytes of every 16-bit lane
+UHD_INLINE __m128i swap_bytes16(const __m128i v)
+{
+    return _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+}
+
+//! Swap the 16-bit halves of every 32-bit lane
+UHD_INLINE __m128i swap_halves32(const __m128i v)
+{
+    return _mm_shufflehi_epi16(
+        _mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+}
+
+//! Reverse the 16-bit quarters of every 64-bit lane
+UHD_INLINE __m128i reverse_quarters64(const __m128i v)
+{
+    return _mm_shufflehi_epi16(
+        _mm_shufflelo_epi16(v, _MM_SHUFFLE(0, 1, 2, 3)), _MM_SHUFFLE(0, 1, 2, 3));
+}
+
+/*! Swap the bits selected by \p mask with the ones \p shift bits above them,
+ * in every byte
+ *
+ * The masks keep the bits within their bytes, so 16-bit shifts do.
+ */
+UHD_INLINE __m128i swap_bits(const __m128i v, const int shift, const __m128i mask)
+{
+    const __m128i count = _mm_cvtsi32_si128(shift);
+    return _mm_or_si128(_mm_and_si128(_mm_srl_epi16(v, count), mask),
+        _mm_sll_epi16(_mm_and_si128(v, mask), count));
+}
+#endif
+
+UHD_INLINE uint8_t bitswap_byte(uint8_t byte)
+{
+    byte = uint8_t(((byte & 0xF0) >> 4) | ((byte & 0x0F) << 4));
+    byte = uint8_t(((byte & 0xCC) >> 2) | ((byte & 0x33) << 2));
+    return uint8_t(((byte & 0xAA) >> 1) | ((byte & 0x55) << 1));
+}
+
+//! Tables for computing the CRC-16 of 8 bytes at a time ("slicing-by-8")
+struct crc16_tables_t
+{
+    crc16_tables_t(void)
+    {
+        for (size_t byte = 0; byte < 256; byte++) {
+            uint16_t crc = uint16_t(byte);
+            for (size_t bit = 0; bit < 8; bit++) {
+                crc = (crc & 1) ? uint16_t((crc >> 1) ^ 0xA001) : uint16_t(crc >> 1);
+            }
+            table[0][byte] = crc;
+        }
+        // table[k][byte] is the CRC of the byte followed by k zero bytes
+        for (size_t k = 1; k < 8; k++) {
+            for (size_t byte = 0; byte < 256; byte++) {
+                const uint16_t prev = table[k - 1][byte];
+                table[k][byte]      = uint16_t((prev >> 8) ^ table[0][prev & 0xFF]);
+            }
+        }
+    }
+
+    uint16_t table[8][256];
+};
+
+const crc16_tables_t& get_crc16_tables(void)
+{
+    static const crc16_tables_t tables;
+    return tables;
+}
+
+} // namespace
+
+void uhd::byteswap(const uint16_t* in, uint16_t* out, const size_t num_items)
+{
+    size_t i = 0;
+#if defined(__SSE2__)
+    // Two vectors per iteration, so loads and stores overlap
+    for (; i + 16 <= num_items; i += 16) {
+        const __m128i v0 = swap_bytes16(load(in + i));
+        const __m128i v1 = swap_bytes16(load(in + i + 8));
+        store(out + i, v0);
+        store(out + i + 8, v1);
+    }
+    for (; i + 8 <= num_items; i += 8) {
+        store(out + i, swap_bytes16(load(in + i)));
+    }
+#endif
+    for (; i < num_items; i++) {
+        out[i] = uhd::byteswap(in[i]);
+    }
+}
+
+void uhd::byteswap(const uint32_t* in, uint32_t* out, const size_t num_items)
+{
+    size_t i = 0;
+#if defined(__SSE2__)
+    for (; i + 8 <= num_items; i += 8) {
+        const __m128i v0 = swap_bytes16(swap_halves32(load(in + i)));
+        const __m128i v1 = swap_bytes16(swap_halves32(load(in + i + 4)));
+        store(out + i, v0);
+        store(out + i + 4, v1);
+    }
+    for (; i + 4 <= num_items; i += 4) {
+        store(out + i, swap_bytes16(swap_halves32(load(in + i))));
+    }
+#endif
+    for (; i < num_items; i++) {
+        out[i] = uhd::byteswap(in[i]);
+    }
+}
+
+void uhd::byteswap(const uint64_t* in, uint64_t* out, const size_t num_items)
+{
+    size_t i = 0;
+#if defined(__SSE2__)
+    for (; i + 4 <= num_items; i += 4) {
+        const __m128i v0 = swap_bytes16(reverse_quarters64(load(in + i)));
+        const __m128i v1 = swap_bytes16(reverse_quarters64(load(in + i + 2)));
+        store(out + i, v0);
+        store(out + i + 2, v1);
+    }
+    for (; i + 2 <= num_items; i += 2) {
+        store(out + i, swap_bytes16(reverse_quarters64(load(in + i))));
+    }
+#endif
+    for (; i < num_items; i++) {
+        out[i] = uhd::byteswap(in[i]);
+    }
+}
+
+void uhd::bitswap(const uint8_t* in, uint8_t* out, const size_t num_bytes)
+{
+    size_t i = 0;
+#if defined(__SSE2__)
+    const __m128i mask4 = _mm_set1_epi8(0x0F);
+    const __m128i mask2 = _mm_set1_epi8(0x33);
+    const __m128i mask1 = _mm_set1_epi8(0x55);
+    for (; i + 16 <= num_bytes; i += 16) {
+        __m128i v = load(in + i);
+        v         = swap_bits(v, 4, mask4);
+        v         = swap_bits(v, 2, mask2);
+        v         = swap_bits(v, 1, mask1);
+        store(out + i, v);
+    }
+#endif
+    for (; i < num_bytes; i++) {
+        out[i] = bitswap_byte(in[i]);
+    }
+}
+
+uint16_t uhd::crc16(const void* data, size_t len, uint16_t crc)
+{
+    const auto& table = get_crc16_tables().table;
+    const uint8_t* p  = static_cast<const uint8_t*>(data);
+    for (; len >= 8; len -= 8, p += 8) {
+        const uint16_t c = uint16_t(crc ^ (p[0] | (p[1] << 8)));
+        crc = uint16_t(table[7][c & 0xFF] ^ table[6][c >> 8] ^ table[5][p[2]]
+                       ^ table[4][p[3]] ^ table[3][p[4]] ^ table[2][p[5]]
+                       ^ table[1][p[6]] ^ table[0][p[7]]);
+    }
+    for (; len > 0; len--, p++) {
+        crc = uint16_t((crc >> 8) ^ table[0][(crc ^ *p) & 0xFF]);
+    }
+    return crc;
+}
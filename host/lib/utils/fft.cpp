@@ -0,0 +1,406 @@
+//
+// Copyright 2019 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include <uhd/exception.hpp>
+#include <uhd/utils/fft.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/weak_ptr.hpp>
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <mutex>
+
+#if defined(__SSE2__)
+#    include <emmintrin.h>
+#endif
+
+using namespace uhd;
+
+namespace {
+
+typedef std::complex<float> fc32_t;
+
+bool is_power_of_two(const size_t n)
+{
+    return n and not(n & (n - 1));
+}
+
+//! Complex multiplication, without the NaN/Inf handling of operator*
+inline fc32_t mul(const fc32_t& a, const fc32_t& b)
+{
+    return fc32_t(a.real() * b.real() - a.imag() * b.imag(),
+        a.real() * b.imag() + a.imag() * b.real());
+}
+
+//! Multiply by -j
+inline fc32_t mul_minus_j(const fc32_t& a)
+{
+    return fc32_t(a.imag(), -a.real());
+}
+
+/***********************************************************************
+ * Radix-4 butterflies
+ *
+ * One radix-4 stage combines four consecutive DFTs A, B, C, D of size q into
+ * one of size 4q. With the input in bit-reversed order, A holds the samples
+ * with index 0 mod 4, B those with index 2 mod 4, C 1 mod 4, and D 3 mod 4.
+ * With w = exp(-2j*pi*k/(4q)):
+ *
+ *     X[k]      = (A + w^2 B) + (w C + w^3 D)
+ *     X[k + q]  = (A - w^2 B) - j (w C - w^3 D)
+ *     X[k + 2q] = (A + w^2 B) - (w C + w^3 D)
+ *     X[k + 3q] = (A - w^2 B) + j (w C - w^3 D)
+ **********************************************************************/
+void radix4_butterflies_generic(fc32_t* x,
+    const size_t q,
+    const fc32_t* w1,
+    const fc32_t* w2,
+    const fc32_t* w3,
+    const size_t first)
+{
+    for (size_t k = first; k < q; k++) {
+        const fc32_t a  = x[k];
+        const fc32_t b  = mul(x[k + q], w2[k]);
+        const fc32_t c  = mul(x[k + 2 * q], w1[k]);
+        const fc32_t d  = mul(x[k + 3 * q], w3[k]);
+        const fc32_t t0 = a + b;
+        const fc32_t t1 = a - b;
+        const fc32_t t2 = c + d;
+        const fc32_t t3 = mul_minus_j(c - d);
+        x[k]            = t0 + t2;
+        x[k + q]        = t1 + t3;
+        x[k + 2 * q]    = t0 - t2;
+        x[k + 3 * q]    = t1 - t3;
+    }
+}
+
+#if defined(__SSE2__)
+//! Multiply two pairs of interleaved complex floats
+inline __m128 mul_ps(const __m128 a, const __m128 b)
+{
+    const __m128 sign   = _mm_castsi128_ps(_mm_set_epi32(0, INT32_MIN, 0, INT32_MIN));
+    const __m128 b_re   = _mm_shuffle_ps(b, b, _MM_SHUFFLE(2, 2, 0, 0));
+    const __m128 b_im   = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 3, 1, 1));
+    const __m128 a_swap = _mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1));
+    return _mm_add_ps(_mm_mul_ps(a, b_re), _mm_xor_ps(_mm_mul_ps(a_swap, b_im), sign));
+}
+
+//! Multiply two interleaved complex floats by -j
+inline __m128 mul_minus_j_ps(const __m128 a)
+{
+    const __m128 sign = _mm_castsi128_ps(_mm_set_epi32(INT32_MIN, 0, INT32_MIN, 0));
+    return _mm_xor_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1)), sign);
+}
+
+void radix4_butterflies(
+    fc32_t* x, const size_t q, const fc32_t* w1, const fc32_t* w2, const fc32_t* w3)
+{
+    float* xf = reinterpret_cast<float*>(x);
+    size_t k  = 0;
+    for (; k + 2 <= q; k += 2) {
+        const __m128 a = _mm_loadu_ps(xf + 2 * k);
+        const __m128 b = mul_ps(_mm_loadu_ps(xf + 2 * (k + q)),
+            _mm_loadu_ps(reinterpret_cast<const float*>(w2 + k)));
+        const __m128 c = mul_ps(_mm_loadu_ps(xf + 2 * (k + 2 * q)),
+            _mm_loadu_ps(reinterpret_cast<const float*>(w1 + k)));
+        const __m128 d = mul_ps(_mm_loadu_ps(xf + 2 * (k + 3 * q)),
+            _mm_loadu_ps(reinterpret_cast<const float*>(w3 + k)));
+        const __m128 t0 = _mm_add_ps(a, b);
+        const __m128 t1 = _mm_sub_ps(a, b);
+        const __m128 t2 = _mm_add_ps(c, d);
+        const __m128 t3 = mul_minus_j_ps(_mm_sub_ps(c, d));
+        _mm_storeu_ps(xf + 2 * k, _mm_add_ps(t0, t2));
+        _mm_storeu_ps(xf + 2 * (k + q), _mm_add_ps(t1, t3));
+        _mm_storeu_ps(xf + 2 * (k + 2 * q), _mm_sub_ps(t0, t2));
+        _mm_storeu_ps(xf + 2 * (k + 3 * q), _mm_sub_ps(t1, t3));
+    }
+    radix4_butterflies_generic(x, q, w1, w2, w3, k);
+}
+#else
+void radix4_butterflies(
+    fc32_t* x, const size_t q, const fc32_t* w1, const fc32_t* w2, const fc32_t* w3)
+{
+    radix4_butterflies_generic(x, q, w1, w2, w3, 0);
+}
+#endif
+
+/***********************************************************************
+ * FFT plan
+ **********************************************************************/
+class fft_impl : public fft
+{
+public:
+    fft_impl(const size_t size) : _size(size)
+    {
+        if (not is_power_of_two(size)) {
+            _dft_matrix.resize(size * size);
+            for (size_t k = 0; k < size; k++) {
+                for (size_t n = 0; n < size; n++) {
+                    _dft_matrix[k * size + n] = get_twiddle((k * n) % size);
+                }
+            }
+            return;
+        }
+
+        size_t num_bits = 0;
+        while ((size_t(1) << num_bits) < size) {
+            num_bits++;
+        }
+        _bit_reverse.resize(size);
+        for (size_t i = 0; i < size; i++) {
+            size_t rev = 0;
+            for (size_t bit = 0; bit < num_bits; bit++) {
+                rev |= ((i >> bit) & 1) << (num_bits - 1 - bit);
+            }
+            _bit_reverse[i] = rev;
+        }
+
+        // An odd number of bits needs one radix-2 stage up front, all other
+        // stages are radix-4. Every radix-4 stage gets its own contiguous
+        // twiddle tables, so the butterflies can load them as vectors.
+        _radix2_first = num_bits % 2;
+        for (size_t q = _radix2_first ? 2 : 1; 4 * q <= size; q *= 4) {
+            _stage_offsets.push_back(_twiddles.size());
+            const size_t step = size / (4 * q);
+            for (size_t p = 1; p <= 3; p++) {
+                for (size_t k = 0; k < q; k++) {
+                    _twiddles.push_back(get_twiddle(p * k * step));
+                }
+            }
+        }
+    }
+
+    size_t size(void) const
+    {
+        return _size;
+    }
+
+    void execute(const fc32_t* in, fc32_t* out) const
+    {
+        if (_bit_reverse.empty()) {
+            execute_dft(in, out);
+            return;
+        }
+
+        if (in == out) {
+            for (size_t i = 0; i < _size; i++) {
+                if (i < _bit_reverse[i]) {
+                    std::swap(out[i], out[_bit_reverse[i]]);
+                }
+            }
+        } else {
+            for (size_t i = 0; i < _size; i++) {
+                out[_bit_reverse[i]] = in[i];
+            }
+        }
+
+        if (_radix2_first) {
+            for (size_t i = 0; i < _size; i += 2) {
+                const fc32_t a = out[i];
+                const fc32_t b = out[i + 1];
+                out[i]         = a + b;
+                out[i + 1]     = a - b;
+            }
+        }
+        size_t q = _radix2_first ? 2 : 1;
+        for (const size_t offset : _stage_offsets) {
+            const fc32_t* w1 = &_twiddles[offset];
+            const fc32_t* w2 = w1 + q;
+            const fc32_t* w3 = w2 + q;
+            for (size_t i = 0; i < _size; i += 4 * q) {
+                radix4_butterflies(out + i, q, w1, w2, w3);
+            }
+            q *= 4;
+        }
+    }
+
+private:
+    fc32_t get_twiddle(const size_t i) const
+    {
+        const double phase = -2.0 * M_PI * double(i) / double(_size);
+        return fc32_t(float(std::cos(phase)), float(std::sin(phase)));
+    }
+
+    void execute_dft(const fc32_t* in, fc32_t* out) const
+    {
+        std::vector<fc32_t> copy;
+        if (in == out) {
+            copy.assign(in, in + _size);
+            in = copy.data();
+        }
+        for (size_t k = 0; k < _size; k++) {
+            const fc32_t* row = &_dft_matrix[k * _size];
+            fc32_t acc(0.0f, 0.0f);
+            for (size_t n = 0; n < _size; n++) {
+                acc += mul(in[n], row[n]);
+            }
+            out[k] = acc;
+        }
+    }
+
+    const size_t _size;
+    std::vector<size_t> _bit_reverse;
+    bool _radix2_first = false;
+    //! Start of the twiddle tables of every radix-4 stage
+    std::vector<size_t> _stage_offsets;
+    std::vector<fc32_t> _twiddles;
+    //! For sizes which are not a power of two
+    std::vector<fc32_t> _dft_matrix;
+};
+
+/***********************************************************************
+ * Power spectrum
+ **********************************************************************/
+class power_spectrum_impl : public power_spectrum
+{
+public:
+    power_spectrum_impl(const size_t fft_size, const fft::window_type window)
+        : _fft(fft::make(fft_size))
+        , _window(fft::make_window(window, fft_size))
+        , _buff(fft_size)
+        , _accum(fft_size, 0.0)
+    {
+        double win_pwr = 0.0;
+        for (const float w : _window) {
+            win_pwr += double(w) * w;
+        }
+        _scale = 1.0 / (fft_size * win_pwr);
+    }
+
+    size_t get_fft_size(void) const
+    {
+        return _fft->size();
+    }
+
+    size_t process(const fc32_t* samps, const size_t nsamps)
+    {
+        const size_t fft_size   = _fft->size();
+        const size_t num_frames = nsamps / fft_size;
+        for (size_t frame = 0; frame < num_frames; frame++) {
+            const fc32_t* frame_samps = samps + frame * fft_size;
+            for (size_t i = 0; i < fft_size; i++) {
+                _buff[i] = frame_samps[i] * _window[i];
+            }
+            _fft->execute(_buff.data(), _buff.data());
+            for (size_t i = 0; i < fft_size; i++) {
+                _accum[i] += std::norm(_buff[i]);
+            }
+        }
+        _num_averaged += num_frames;
+        return num_frames;
+    }
+
+    size_t get_num_averaged(void) const
+    {
+        return _num_averaged;
+    }
+
+    std::vector<float> get_log_power(const bool reset_avg)
+    {
+        std::vector<float> log_power;
+        if (_num_averaged == 0) {
+            return log_power;
+        }
+        log_power.resize(_accum.size());
+        const double scale = _scale / _num_averaged;
+        for (size_t i = 0; i < _accum.size(); i++) {
+            log_power[i] =
+                float(10.0 * std::log10(std::max(_accum[i] * scale, 1e-30)) + 3.0);
+        }
+        if (reset_avg) {
+            reset();
+        }
+        return log_power;
+    }
+
+    void reset(void)
+    {
+        std::fill(_accum.begin(), _accum.end(), 0.0);
+        _num_averaged = 0;
+    }
+
+private:
+    const fft::sptr _fft;
+    const std::vector<float> _window;
+    std::vector<fc32_t> _buff;
+    std::vector<double> _accum;
+    size_t _num_averaged = 0;
+    //! Normalization of the power, for the window and the FFT size
+    double _scale;
+};
+
+} // namespace
+
+/***********************************************************************
+ * Factories
+ **********************************************************************/
+fft::~fft(void)
+{
+    /* NOP */
+}
+
+fft::sptr fft::make(const size_t size)
+{
+    if (size == 0) {
+        throw uhd::value_error("fft: Size must be positive");
+    }
+    static std::mutex cache_mutex;
+    static std::map<size_t, boost::weak_ptr<fft>> cache;
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    fft::sptr plan = cache[size].lock();
+    if (not plan) {
+        plan        = boost::make_shared<fft_impl>(size);
+        cache[size] = plan;
+    }
+    return plan;
+}
+
+std::vector<float> fft::make_window(const window_type window, const size_t size)
+{
+    std::vector<float> coeffs(size, 1.0f);
+    if (size < 2) {
+        return coeffs;
+    }
+    std::vector<double> a;
+    switch (window) {
+        case WINDOW_RECTANGULAR:
+            return coeffs;
+        case WINDOW_HANN:
+            a = {0.5, 0.5};
+            break;
+        case WINDOW_HAMMING:
+            a = {0.54, 0.46};
+            break;
+        case WINDOW_BLACKMAN_HARRIS:
+            a = {0.35875, 0.48829, 0.14128, 0.01168};
+            break;
+        case WINDOW_FLAT_TOP:
+            a = {0.21557895, 0.41663158, 0.277263158, 0.083578947, 0.006947368};
+            break;
+        default:
+            throw uhd::value_error("fft: Unknown window type");
+    }
+    for (size_t n = 0; n < size; n++) {
+        double w = 0.0;
+        for (size_t i = 0; i < a.size(); i++) {
+            const double sign = (i % 2) ? -1.0 : 1.0;
+            w += sign * a[i] * std::cos(2.0 * M_PI * i * n / (size - 1));
+        }
+        coeffs[n] = float(w);
+    }
+    return coeffs;
+}
+
+power_spectrum::~power_spectrum(void)
+{
+    /* NOP */
+}
+
+power_spectrum::sptr power_spectrum::make(
+    const size_t fft_size, const fft::window_type window)
+{
+    return sptr(new power_spectrum_impl(fft_size, window));
+}
@@ -0,0 +1,134 @@
+//
+// Copyright 2019 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include <uhdlib/utils/latency_histogram.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+
+using namespace uhd::latency;
+
+namespace {
+std::mutex& get_registry_mutex()
+{
+    static std::mutex registry_mutex;
+    return registry_mutex;
+}
+
+std::map<std::string, std::unique_ptr<histogram>>& get_registry()
+{
+    static std::map<std::string, std::unique_ptr<histogram>> registry;
+    return registry;
+}
+} // namespace
+
+constexpr size_t histogram::SUB_BUCKET_BITS;
+constexpr size_t histogram::SUB_BUCKETS;
+constexpr size_t histogram::NUM_BUCKETS;
+
+histogram::histogram()
+{
+    reset();
+}
+
+uint64_t histogram::get_count() const
+{
+    return _count.load(std::memory_order_relaxed);
+}
+
+uint64_t histogram::get_min() const
+{
+    return get_count() ? _min.load(std::memory_order_relaxed) : 0;
+}
+
+uint64_t histogram::get_max() const
+{
+    return _max.load(std::memory_order_relaxed);
+}
+
+double histogram::get_mean() const
+{
+    const uint64_t count = get_count();
+    return count ? double(_sum.load(std::memory_order_relaxed)) / count : 0.0;
+}
+
+uint64_t histogram::get_percentile(const double percentile) const
+{
+    // Take a snapshot first, the buckets may be updated while we're iterating
+    std::vector<uint64_t> snapshot(NUM_BUCKETS);
+    uint64_t total = 0;
+    for (size_t i = 0; i < NUM_BUCKETS; i++) {
+        snapshot[i] = _buckets[i].load(std::memory_order_relaxed);
+        total += snapshot[i];
+    }
+    if (total == 0) {
+        return 0;
+    }
+    const double clipped_percentile = std::min(std::max(percentile, 0.0), 100.0);
+    const uint64_t target           = std::max(
+        uint64_t(1), uint64_t(std::ceil(clipped_percentile / 100.0 * total)));
+    uint64_t accum = 0;
+    for (size_t i = 0; i < NUM_BUCKETS; i++) {
+        accum += snapshot[i];
+        if (accum >= target) {
+            return std::min(get_bucket_upper_bound(i), get_max());
+        }
+    }
+    return get_max();
+}
+
+void histogram::reset()
+{
+    for (auto& bucket : _buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    _count.store(0, std::memory_order_relaxed);
+    _sum.store(0, std::memory_order_relaxed);
+    _min.store(std::numeric_limits<uint64_t>::max(), std::memory_order_relaxed);
+    _max.store(0, std::memory_order_relaxed);
+}
+
+uint64_t histogram::get_bucket_upper_bound(const size_t index)
+{
+    if (index < 2 * SUB_BUCKETS) {
+        return index;
+    }
+    const size_t shift      = index / SUB_BUCKETS - 1;
+    const uint64_t mantissa = index % SUB_BUCKETS + SUB_BUCKETS;
+    return ((mantissa + 1) << shift) - 1;
+}
+
+histogram& uhd::latency::get_histogram(const std::string& name)
+{
+    std::lock_guard<std::mutex> l(get_registry_mutex());
+    auto& registry = get_registry();
+    auto it        = registry.find(name);
+    if (it == registry.end()) {
+        it = registry.emplace(name, std::unique_ptr<histogram>(new histogram())).first;
+    }
+    return *it->second;
+}
+
+std::vector<std::string> uhd::latency::get_histogram_names()
+{
+    std::lock_guard<std::mutex> l(get_registry_mutex());
+    std::vector<std::string> names;
+    for (const auto& entry : get_registry()) {
+        names.push_back(entry.first);
+    }
+    return names;
+}
+
+void uhd::latency::reset_histograms()
+{
+    std::lock_guard<std::mutex> l(get_registry_mutex());
+    for (auto& entry : get_registry()) {
+        entry.second->reset();
+    }
+}
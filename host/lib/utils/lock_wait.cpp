@@ -0,0 +1,26 @@
+//
+// Copyright 2019 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include <uhd/utils/log.hpp>
+#include <uhdlib/utils/latency_histogram.hpp>
+#include <uhdlib/utils/lock_wait.hpp>
+#include <uhdlib/utils/trace.hpp>
+
+void uhd::record_lock_wait(const std::string& name,
+    const std::chrono::steady_clock::time_point start,
+    const std::chrono::steady_clock::time_point end,
+    const bool locked)
+{
+    const auto wait_ns =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    trace::add_span(name, "lock", start, end);
+#ifdef UHD_LATENCY_HISTOGRAMS
+    latency::get_histogram("lock/" + name).record(uint64_t(wait_ns));
+#endif
+    UHD_LOG_TRACE("LOCK",
+        name << (locked ? " locked after " : " failed to lock within ")
+             << (wait_ns / 1000) << " us");
+}
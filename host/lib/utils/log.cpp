@@ -13,6 +13,7 @@
 #include <uhd/utils/static.hpp>
 #include <uhd/version.hpp>
 #include <uhdlib/utils/isatty.hpp>
+#include <uhdlib/utils/thread_policy.hpp>
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/make_shared.hpp>
 #include <atomic>
@@ -305,6 +306,7 @@ public:
 
     void pop_task()
     {
+        uhd::thread_policy::apply(uhd::thread_policy::LOG);
         uhd::log::logging_info log_info;
         log_info.message = "";
 
@@ -333,6 +335,7 @@ public:
     void pop_fastpath_task()
     {
 #ifndef UHD_LOG_FASTPATH_DISABLE
+        uhd::thread_policy::apply(uhd::thread_policy::LOG_FASTPATH);
         std::string msg;
         while (!_exit) {
 #    ifdef BOOST_MSVC
@@ -357,6 +360,7 @@ public:
     void pop_fastpath_dummy_task()
     {
 #ifndef UHD_LOG_FASTPATH_DISABLE
+        uhd::thread_policy::apply(uhd::thread_policy::LOG_FASTPATH);
         std::string msg;
         while (!_exit) {
 #    ifdef BOOST_MSVC
@@ -0,0 +1,130 @@
+//
+// Copyright 2019 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include <uhd/exception.hpp>
+#include <uhd/utils/paths.hpp>
+#include <uhdlib/utils/mirrored_buffer.hpp>
+#include <boost/format.hpp>
+
+using namespace uhd;
+
+#ifdef HAVE_MMAP_MIRROR
+#    include <sys/mman.h>
+#    include <unistd.h>
+#    include <algorithm>
+#    include <cerrno>
+#    include <cstdlib>
+#    include <cstring>
+
+namespace {
+size_t gcd(size_t a, size_t b)
+{
+    while (b) {
+        const size_t t = a % b;
+        a              = b;
+        b              = t;
+    }
+    return a;
+}
+
+//! Round \p size up to a multiple of both \p page_size and \p granularity
+size_t get_mirrored_size(
+    const size_t size, const size_t page_size, const size_t granularity)
+{
+    const size_t step = page_size / gcd(page_size, granularity) * granularity;
+    return std::max<size_t>(1, (size + step - 1) / step) * step;
+}
+
+class mirrored_buffer_impl : public mirrored_buffer
+{
+public:
+    mirrored_buffer_impl(const size_t min_size, const size_t granularity)
+        : _size(get_mirrored_size(min_size, size_t(sysconf(_SC_PAGESIZE)), granularity))
+    {
+        const int fd = open_backing_file();
+        if (ftruncate(fd, off_t(_size)) != 0) {
+            close(fd);
+            throw_os_error("ftruncate");
+        }
+
+        // Reserve the address space for both mappings first, so nothing else
+        // can end up between them
+        _base = mmap(nullptr, 2 * _size, PROT_NONE, MAP_PRIVATE | MAP_ANON, -1, 0);
+        if (_base == MAP_FAILED) {
+            close(fd);
+            throw_os_error("mmap");
+        }
+        char* base = static_cast<char*>(_base);
+        for (char* addr : {base, base + _size}) {
+            if (mmap(addr, _size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0)
+                == MAP_FAILED) {
+                munmap(_base, 2 * _size);
+                close(fd);
+                throw_os_error("mmap");
+            }
+        }
+        // The mappings keep the file alive
+        close(fd);
+    }
+
+    ~mirrored_buffer_impl(void)
+    {
+        munmap(_base, 2 * _size);
+    }
+
+    void* data(void)
+    {
+        return _base;
+    }
+
+    size_t size(void) const
+    {
+        return _size;
+    }
+
+private:
+    //! Create an unlinked temporary file, preferably on a RAM-backed file system
+    static int open_backing_file(void)
+    {
+        for (const std::string& dir : {std::string("/dev/shm"), uhd::get_tmp_path()}) {
+            std::string path = dir + "/uhd_mirrored_buffer_XXXXXX";
+            const int fd     = mkstemp(&path[0]);
+            if (fd != -1) {
+                unlink(path.c_str());
+                return fd;
+            }
+        }
+        throw_os_error("mkstemp");
+        return -1;
+    }
+
+    static void throw_os_error(const std::string& what)
+    {
+        throw uhd::os_error(str(boost::format("Unable to create mirrored buffer: "
+                                              "%s failed: %s")
+                                % what % std::strerror(errno)));
+    }
+
+    void* _base;
+    const size_t _size;
+};
+} // namespace
+
+mirrored_buffer::uptr mirrored_buffer::make(
+    const size_t min_size, const size_t granularity)
+{
+    return uptr(new mirrored_buffer_impl(min_size, granularity));
+}
+
+#else
+
+mirrored_buffer::uptr mirrored_buffer::make(const size_t, const size_t)
+{
+    throw uhd::not_implemented_error(
+        "Mirrored buffers are not supported on this platform");
+}
+
+#endif /* HAVE_MMAP_MIRROR */
@@ -11,6 +11,7 @@
 #include <uhdlib/utils/paths.hpp>
 #include <boost/filesystem.hpp>
 #include <cstdlib>
+#include <mutex>
 
 using namespace uhd;
 
@@ -71,6 +72,10 @@ config_parser& uhd::prefs::get_uhd_config()
 {
     static config_parser _conf_files{};
     static bool init_done = false;
+    // Internal threads may query the config files while the first caller is
+    // still reading them, see thread_policy::apply()
+    static std::mutex init_mutex;
+    std::lock_guard<std::mutex> l(init_mutex);
     if (not init_done) {
         UHD_LOG_TRACE("CONF", "Initializing config file object...");
         const std::string sys_conf_file = path_expandvars(UHD_SYS_CONF_FILE);
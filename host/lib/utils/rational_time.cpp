@@ -0,0 +1,85 @@
+//
+// Copyright 2019 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include <uhdlib/utils/rational_time.hpp>
+#include <cmath>
+#include <limits>
+
+using namespace uhd;
+
+namespace {
+//! Tick rates within this distance of an integer are treated as integers
+constexpr double TICK_RATE_TOLERANCE = 1e-6;
+//! Relative error within which a fraction matches the ticks-per-sample ratio
+constexpr double RATIO_TOLERANCE = 1e-14;
+//! Bound for num * den, so the split products in the conversions can't overflow
+constexpr int64_t MAX_PRODUCT = std::numeric_limits<int64_t>::max() >> 2;
+} // namespace
+
+constexpr int64_t rational_time_model::MAX_DENOMINATOR;
+
+rational_time_model::rational_time_model(const double tick_rate, const double samp_rate)
+{
+    set_rates(tick_rate, samp_rate);
+}
+
+void rational_time_model::set_rates(const double tick_rate, const double samp_rate)
+{
+    _tick_rate     = tick_rate;
+    _samp_rate     = samp_rate;
+    _exact         = false;
+    _ticks_per_sec = 1;
+    _num           = 1;
+    _den           = 1;
+    _den_shift     = 0;
+
+    if (not(tick_rate >= 1.0 and samp_rate > 0.0)
+        or tick_rate > double(std::numeric_limits<int32_t>::max())) {
+        return;
+    }
+    const int64_t ticks_per_sec = int64_t(std::llround(tick_rate));
+    if (std::abs(tick_rate - double(ticks_per_sec)) > TICK_RATE_TOLERANCE) {
+        return;
+    }
+
+    // Find the first convergent of the continued fraction of the ratio which
+    // matches it, i.e., the one with the smallest denominator
+    const double ratio = double(ticks_per_sec) / samp_rate;
+    int64_t h_prev = 1, h = int64_t(std::floor(ratio));
+    int64_t k_prev = 0, k = 1;
+    double x = ratio - std::floor(ratio);
+    while (std::abs(double(h) / double(k) - ratio) > RATIO_TOLERANCE * ratio) {
+        if (x <= 0.0) {
+            return;
+        }
+        x               = 1.0 / x;
+        const double a  = std::floor(x);
+        x               = x - a;
+        const double hn = a * double(h) + double(h_prev);
+        const double kn = a * double(k) + double(k_prev);
+        if (kn > double(MAX_DENOMINATOR) or hn * kn > double(MAX_PRODUCT)) {
+            return;
+        }
+        h_prev = h;
+        k_prev = k;
+        h      = int64_t(hn);
+        k      = int64_t(kn);
+    }
+    if (h < 1) {
+        return;
+    }
+
+    _exact         = true;
+    _ticks_per_sec = ticks_per_sec;
+    _num           = h;
+    _den           = k;
+    _den_shift     = -1;
+    for (int shift = 0; (int64_t(1) << shift) <= _den; shift++) {
+        if ((int64_t(1) << shift) == _den) {
+            _den_shift = shift;
+        }
+    }
+}
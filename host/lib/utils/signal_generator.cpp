@@ -0,0 +1,511 @@
+//
+// Copyright 2019 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include <uhd/exception.hpp>
+#include <uhd/utils/signal_generator.hpp>
+#include <uhdlib/dsp/phasor.hpp>
+#include <boost/format.hpp>
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__)
+#    include <emmintrin.h>
+#endif
+
+using namespace uhd;
+using namespace uhd::dsp;
+
+signal_generator::~signal_generator(void)
+{
+    /* NOP */
+}
+
+namespace {
+
+typedef std::complex<float> fc32_t;
+typedef std::complex<int16_t> sc16_t;
+
+//! The phasor of a tone is recomputed from its phase accumulator this often
+constexpr size_t TONE_SEGMENT_LEN = 1024;
+//! Chirps use two recurrences, and are recomputed more often
+constexpr size_t CHIRP_SEGMENT_LEN = 256;
+//! sc16 samples are generated as fc32 in chunks of this size, then converted
+constexpr size_t SC16_CHUNK_LEN = 256;
+
+/***********************************************************************
+ * Kernels
+ **********************************************************************/
+//! Convert fc32 samples into sc16 samples, clipping at full scale
+void fc32_to_sc16(const fc32_t* in, sc16_t* out, const size_t nsamps)
+{
+    const float* in_f = reinterpret_cast<const float*>(in);
+    int16_t* out_s    = reinterpret_cast<int16_t*>(out);
+    size_t i          = 0;
+#if defined(__SSE2__)
+    const __m128 scale = _mm_set1_ps(32767.0f);
+    const __m128 max   = _mm_set1_ps(32767.0f);
+    const __m128 min   = _mm_set1_ps(-32768.0f);
+    for (; i + 8 <= 2 * nsamps; i += 8) {
+        const __m128 a =
+            _mm_max_ps(min, _mm_min_ps(max, _mm_mul_ps(_mm_loadu_ps(in_f + i), scale)));
+        const __m128 b = _mm_max_ps(
+            min, _mm_min_ps(max, _mm_mul_ps(_mm_loadu_ps(in_f + i + 4), scale)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out_s + i),
+            _mm_packs_epi32(_mm_cvtps_epi32(a), _mm_cvtps_epi32(b)));
+    }
+#endif
+    for (; i < 2 * nsamps; i++) {
+        out_s[i] = int16_t(
+            std::max(-32768.0f, std::min(32767.0f, std::nearbyint(in_f[i] * 32767.0f))));
+    }
+}
+
+//! Write phasor * step^i into out[i], or add it if add is true
+void write_tone(
+    fc32_t* out, const size_t nsamps, fc32_t phasor, const fc32_t step, const bool add)
+{
+    size_t i = 0;
+#if defined(__SSE2__)
+    phasor4_t phasor4(phasor, step);
+    float* out_f = reinterpret_cast<float*>(out);
+    for (; i + 4 <= nsamps; i += 4) {
+        __m128 lo = _mm_unpacklo_ps(phasor4.re, phasor4.im);
+        __m128 hi = _mm_unpackhi_ps(phasor4.re, phasor4.im);
+        if (add) {
+            lo = _mm_add_ps(lo, _mm_loadu_ps(out_f + 2 * i));
+            hi = _mm_add_ps(hi, _mm_loadu_ps(out_f + 2 * i + 4));
+        }
+        _mm_storeu_ps(out_f + 2 * i, lo);
+        _mm_storeu_ps(out_f + 2 * i + 4, hi);
+        phasor4.advance();
+    }
+    phasor = phasor4.get_first();
+#endif
+    for (; i < nsamps; i++) {
+        out[i] = add ? out[i] + phasor : phasor;
+        phasor = complex_mul(phasor, step);
+    }
+}
+
+/*! Write the samples of a chirp into out
+ *
+ * Sample i has the phase phase + i * phase_inc + i * (i - 1) / 2 *
+ * phase_inc_rate, i.e., the phasor advances by a step, and the step by a rate,
+ * after every sample. The phasors which start the recurrences are computed from the exact
+ * phases, as repeated squaring of the rate would let the amplitude drift.
+ */
+void write_chirp(fc32_t* out,
+    const size_t nsamps,
+    const uint64_t phase,
+    const uint64_t phase_inc,
+    const uint64_t phase_inc_rate,
+    const float ampl)
+{
+    size_t i          = 0;
+    fc32_t phasor     = phase_to_phasor(phase, ampl);
+    fc32_t step       = phase_to_phasor(phase_inc, 1.0f);
+    const fc32_t rate = phase_to_phasor(phase_inc_rate, 1.0f);
+#if defined(__SSE2__)
+    if (nsamps >= 4) {
+        // Four samples ahead, the phasor of lane j advances by the phase of
+        // 4 * phase_inc + (4 * j + 6) * phase_inc_rate, which in turn
+        // advances by 16 * phase_inc_rate
+        float p_re[4], p_im[4], q_re[4], q_im[4];
+        for (uint64_t j = 0; j < 4; j++) {
+            const fc32_t p = phase_to_phasor(
+                phase + j * phase_inc + j * (j - 1) / 2 * phase_inc_rate, ampl);
+            const fc32_t q =
+                phase_to_phasor(4 * phase_inc + (4 * j + 6) * phase_inc_rate, 1.0f);
+            p_re[j] = p.real();
+            p_im[j] = p.imag();
+            q_re[j] = q.real();
+            q_im[j] = q.imag();
+        }
+        const fc32_t rate16 = phase_to_phasor(16 * phase_inc_rate, 1.0f);
+        phasor4_t phasor4(phasor, step);
+        phasor4.re        = _mm_loadu_ps(p_re);
+        phasor4.im        = _mm_loadu_ps(p_im);
+        phasor4.step_re   = _mm_loadu_ps(q_re);
+        phasor4.step_im   = _mm_loadu_ps(q_im);
+        const __m128 r_re = _mm_set1_ps(rate16.real());
+        const __m128 r_im = _mm_set1_ps(rate16.imag());
+        for (; i + 4 <= nsamps; i += 4) {
+            store_fc32x4(out + i, phasor4.re, phasor4.im);
+            phasor4.advance();
+            const __m128 next_step_re = _mm_sub_ps(
+                _mm_mul_ps(phasor4.step_re, r_re), _mm_mul_ps(phasor4.step_im, r_im));
+            phasor4.step_im = _mm_add_ps(
+                _mm_mul_ps(phasor4.step_re, r_im), _mm_mul_ps(phasor4.step_im, r_re));
+            phasor4.step_re = next_step_re;
+        }
+        phasor = phasor4.get_first();
+        step   = phase_to_phasor(phase_inc + i * phase_inc_rate, 1.0f);
+    }
+#endif
+    for (; i < nsamps; i++) {
+        out[i] = phasor;
+        phasor = complex_mul(phasor, step);
+        step   = complex_mul(step, rate);
+    }
+}
+
+/***********************************************************************
+ * Generators
+ **********************************************************************/
+//! Implements sc16 output on top of fc32 output
+class signal_generator_base : public signal_generator
+{
+public:
+    using signal_generator::generate;
+
+    void generate(sc16_t* buff, const size_t nsamps)
+    {
+        fc32_t chunk[SC16_CHUNK_LEN];
+        for (size_t offset = 0; offset < nsamps; offset += SC16_CHUNK_LEN) {
+            const size_t count = std::min(nsamps - offset, SC16_CHUNK_LEN);
+            generate(chunk, count);
+            fc32_to_sc16(chunk, buff + offset, count);
+        }
+    }
+};
+
+class const_generator : public signal_generator_base
+{
+public:
+    const_generator(const fc32_t& value) : _value(value) {}
+
+    using signal_generator_base::generate;
+
+    void generate(fc32_t* buff, const size_t nsamps)
+    {
+        std::fill(buff, buff + nsamps, _value);
+    }
+
+private:
+    const fc32_t _value;
+};
+
+class multi_tone_generator : public signal_generator_base
+{
+public:
+    multi_tone_generator(
+        const double samp_rate, const std::vector<double>& freqs, const float ampl)
+        : _ampl(ampl / freqs.size())
+    {
+        if (not(samp_rate > 0.0)) {
+            throw uhd::value_error("signal_generator: The sample rate must be positive");
+        }
+        if (freqs.empty()) {
+            throw uhd::value_error("signal_generator: No tones given");
+        }
+        const size_t num_tones = freqs.size();
+        for (size_t k = 0; k < num_tones; k++) {
+            tone_t tone;
+            // Newman phases: pi * k^2 / N, i.e. k^2 / (2 * N) cycles
+            const double cycles = std::fmod(double(k) * k / (2.0 * num_tones), 1.0);
+            tone.phase =
+                uint64_t(std::llround(cycles * PHASE_ONE_CYCLE / PHASE_INC_UNIT))
+                * PHASE_INC_UNIT;
+            tone.phase_inc = freq_to_phase_inc(freqs[k], samp_rate);
+            tone.step      = phase_to_phasor(tone.phase_inc, 1.0f);
+            _tones.push_back(tone);
+        }
+    }
+
+    using signal_generator_base::generate;
+
+    void generate(fc32_t* buff, const size_t nsamps)
+    {
+        for (size_t offset = 0; offset < nsamps; offset += TONE_SEGMENT_LEN) {
+            const size_t count = std::min(nsamps - offset, TONE_SEGMENT_LEN);
+            bool add           = false;
+            for (tone_t& tone : _tones) {
+                write_tone(buff + offset,
+                    count,
+                    phase_to_phasor(tone.phase, _ampl),
+                    tone.step,
+                    add);
+                tone.phase += tone.phase_inc * count;
+                add = true;
+            }
+        }
+    }
+
+private:
+    struct tone_t
+    {
+        uint64_t phase;
+        uint64_t phase_inc;
+        fc32_t step;
+    };
+
+    const float _ampl;
+    std::vector<tone_t> _tones;
+};
+
+class chirp_generator : public signal_generator_base
+{
+public:
+    chirp_generator(const double samp_rate,
+        const double start_freq,
+        const double stop_freq,
+        const double sweep_time,
+        const float ampl)
+        : _ampl(ampl)
+    {
+        if (not(samp_rate > 0.0)) {
+            throw uhd::value_error("signal_generator: The sample rate must be positive");
+        }
+        const double sweep_len = std::round(sweep_time * samp_rate);
+        if (not(sweep_len >= 2.0)) {
+            throw uhd::value_error(
+                "signal_generator: The chirp must sweep for at least two samples");
+        }
+        _sweep_len       = uint64_t(sweep_len);
+        _start_phase_inc = freq_to_phase_inc(start_freq, samp_rate);
+        // The change of the phase increment per sample, which may be negative
+        const double rate = (stop_freq - start_freq) / samp_rate / sweep_len;
+        _phase_inc_rate =
+            uint64_t(std::llround(rate * PHASE_ONE_CYCLE / PHASE_INC_UNIT))
+            * PHASE_INC_UNIT;
+        _phase_inc = _start_phase_inc;
+    }
+
+    using signal_generator_base::generate;
+
+    void generate(fc32_t* buff, const size_t nsamps)
+    {
+        size_t offset = 0;
+        while (offset < nsamps) {
+            const uint64_t count = std::min<uint64_t>(
+                std::min(nsamps - offset, CHIRP_SEGMENT_LEN), _sweep_len - _sweep_pos);
+            write_chirp(buff + offset, count, _phase, _phase_inc, _phase_inc_rate, _ampl);
+            // All of this wraps around like the phase
+            _phase += count * _phase_inc + count * (count - 1) / 2 * _phase_inc_rate;
+            _phase_inc += count * _phase_inc_rate;
+            _sweep_pos += count;
+            if (_sweep_pos == _sweep_len) {
+                _sweep_pos = 0;
+                _phase_inc = _start_phase_inc;
+            }
+            offset += count;
+        }
+    }
+
+private:
+    const float _ampl;
+    uint64_t _sweep_len;
+    uint64_t _start_phase_inc;
+    uint64_t _phase_inc_rate;
+    uint64_t _phase     = 0;
+    uint64_t _phase_inc = 0;
+    uint64_t _sweep_pos = 0;
+};
+
+class prbs_generator : public signal_generator_base
+{
+public:
+    prbs_generator(const size_t order, const float ampl) : _order(order)
+    {
+        // The polynomials of ITU-T O.150, as x^order + x^tap + 1
+        switch (order) {
+            case 7:
+                _tap = 6;
+                break;
+            case 9:
+                _tap = 5;
+                break;
+            case 11:
+                _tap = 9;
+                break;
+            case 15:
+                _tap = 14;
+                break;
+            case 20:
+                _tap = 3;
+                break;
+            case 23:
+                _tap = 18;
+                break;
+            case 31:
+                _tap = 28;
+                break;
+            default:
+                throw uhd::value_error(
+                    str(boost::format("signal_generator: Unsupported PRBS order %d")
+                        % order));
+        }
+        _mask         = (uint64_t(1) << order) - 1;
+        _state        = _mask;
+        const float a = ampl / std::sqrt(2.0f);
+        // Indexed by the I bit, then the Q bit
+        _symbols[0] = fc32_t(-a, -a);
+        _symbols[1] = fc32_t(-a, a);
+        _symbols[2] = fc32_t(a, -a);
+        _symbols[3] = fc32_t(a, a);
+    }
+
+    using signal_generator_base::generate;
+
+    void generate(fc32_t* buff, const size_t nsamps)
+    {
+        for (size_t i = 0; i < nsamps; i++) {
+            if (_num_bits < 2) {
+                refill();
+            }
+            buff[i] = _symbols[(_bits >> (_num_bits - 2)) & 0x3];
+            _num_bits -= 2;
+        }
+    }
+
+private:
+    /*! Advance the register by as many bits as possible at once
+     *
+     * Bit i of the state is the bit output i + 1 steps ago. Every new bit is
+     * the XOR of the bits order and tap steps ago, so the next tap bits can
+     * be computed in parallel.
+     */
+    void refill(void)
+    {
+        const size_t width = _tap;
+        const uint64_t new_bits =
+            ((_state >> (_order - width)) ^ (_state >> (_tap - width)))
+            & ((uint64_t(1) << width) - 1);
+        _state = ((_state << width) | new_bits) & _mask;
+        // The oldest new bit is the most significant one
+        _bits = (_bits << width) | new_bits;
+        _num_bits += width;
+    }
+
+    const size_t _order;
+    size_t _tap;
+    uint64_t _mask;
+    uint64_t _state;
+    uint64_t _bits   = 0;
+    size_t _num_bits = 0;
+    fc32_t _symbols[4];
+};
+
+class noise_generator : public signal_generator_base
+{
+public:
+    noise_generator(const float ampl, const uint32_t seed)
+        // A sum of four uniform int16 values has a standard deviation of
+        // 65536 / sqrt(3); scale it to ampl / sqrt(2) for each of I and Q
+        : _scale(ampl / std::sqrt(2.0f) * std::sqrt(3.0f) / 65536.0f)
+    {
+        // Seed the two xorshift generators (for I and Q) with splitmix64
+        uint64_t x = seed;
+        for (uint64_t& state : _state) {
+            x += 0x9E3779B97F4A7C15ull;
+            uint64_t z = x;
+            z          = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z          = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            state      = (z ^ (z >> 31)) | 1;
+        }
+    }
+
+    using signal_generator_base::generate;
+
+    void generate(fc32_t* buff, const size_t nsamps)
+    {
+        size_t i = 0;
+#if defined(__SSE2__)
+        // The I and Q generators run in the two 64-bit lanes
+        __m128i state      = _mm_loadu_si128(reinterpret_cast<const __m128i*>(_state));
+        const __m128i ones = _mm_set1_epi16(1);
+        const __m128 scale = _mm_set1_ps(_scale);
+        float* out_f       = reinterpret_cast<float*>(buff);
+        for (; i + 2 <= nsamps; i += 2) {
+            state              = xorshift(state);
+            const __m128 first = sum_int16x4(state, ones);
+            state              = xorshift(state);
+            const __m128 second = sum_int16x4(state, ones);
+            _mm_storeu_ps(out_f + 2 * i,
+                _mm_mul_ps(_mm_shuffle_ps(first, second, _MM_SHUFFLE(2, 0, 2, 0)),
+                    scale));
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(_state), state);
+#endif
+        for (; i < nsamps; i++) {
+            const float re = float(sum_int16x4(xorshift(_state[0])));
+            const float im = float(sum_int16x4(xorshift(_state[1])));
+            buff[i]        = fc32_t(re * _scale, im * _scale);
+        }
+    }
+
+private:
+    static uint64_t xorshift(uint64_t& state)
+    {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    }
+
+    static int32_t sum_int16x4(const uint64_t x)
+    {
+        return int32_t(int16_t(x)) + int16_t(x >> 16) + int16_t(x >> 32)
+               + int16_t(x >> 48);
+    }
+
+#if defined(__SSE2__)
+    static __m128i xorshift(__m128i state)
+    {
+        state = _mm_xor_si128(state, _mm_slli_epi64(state, 13));
+        state = _mm_xor_si128(state, _mm_srli_epi64(state, 7));
+        return _mm_xor_si128(state, _mm_slli_epi64(state, 17));
+    }
+
+    //! Sum the int16 values of each 64-bit lane, into 32-bit lanes 0 and 2
+    static __m128 sum_int16x4(const __m128i x, const __m128i ones)
+    {
+        const __m128i pairs = _mm_madd_epi16(x, ones);
+        return _mm_cvtepi32_ps(_mm_add_epi32(pairs, _mm_srli_epi64(pairs, 32)));
+    }
+#endif
+
+    const float _scale;
+    uint64_t _state[2];
+};
+
+} // namespace
+
+signal_generator::sptr signal_generator::make_const(const std::complex<float>& value)
+{
+    return sptr(new const_generator(value));
+}
+
+signal_generator::sptr signal_generator::make_tone(
+    const double samp_rate, const double freq, const float ampl)
+{
+    return sptr(new multi_tone_generator(samp_rate, {freq}, ampl));
+}
+
+signal_generator::sptr signal_generator::make_multi_tone(
+    const double samp_rate, const std::vector<double>& freqs, const float ampl)
+{
+    return sptr(new multi_tone_generator(samp_rate, freqs, ampl));
+}
+
+signal_generator::sptr signal_generator::make_chirp(const double samp_rate,
+    const double start_freq,
+    const double stop_freq,
+    const double sweep_time,
+    const float ampl)
+{
+    return sptr(new chirp_generator(samp_rate, start_freq, stop_freq, sweep_time, ampl));
+}
+
+signal_generator::sptr signal_generator::make_prbs(const size_t order, const float ampl)
+{
+    return sptr(new prbs_generator(order, ampl));
+}
+
+signal_generator::sptr signal_generator::make_noise(const float ampl, const uint32_t seed)
+{
+    return sptr(new noise_generator(ampl, seed));
+}
@@ -10,6 +10,7 @@
 #include <uhd/utils/thread.hpp>
 #include <uhd/utils/log.hpp>
 #include <uhd/exception.hpp>
+#include <uhdlib/utils/thread_policy.hpp>
 #include <boost/thread/thread.hpp>
 #include <boost/thread/barrier.hpp>
 #include <exception>
@@ -26,7 +27,11 @@ public:
     task_impl(const task_fcn_type &task_fcn, const std::string &name):
         _exit(false)
     {
-        _task = std::thread([this, task_fcn](){ this->task_loop(task_fcn); });
+        _task = std::thread([this, task_fcn, name](){
+            uhd::thread_policy::apply(
+                name.empty() ? uhd::thread_policy::DEFAULT : name);
+            this->task_loop(task_fcn);
+        });
         if (not name.empty()) {
 #ifdef HAVE_PTHREAD_SETNAME
             pthread_setname_np(_task->native_handle(), name.substr(0,16).c_str());
@@ -99,6 +99,62 @@ static void check_priority_range(float priority){
 
 #endif /* HAVE_THREAD_PRIO_DUMMY */
 
+/***********************************************************************
+ * Set thread affinity
+ **********************************************************************/
+#ifdef HAVE_PTHREAD_SETAFFINITY_NP
+    #include <pthread.h>
+
+    void uhd::set_thread_affinity(const std::vector<size_t> &cpu_affinity_list){
+        if (cpu_affinity_list.empty()) {
+            return;
+        }
+
+        cpu_set_t cpu_set;
+        CPU_ZERO(&cpu_set);
+        for (const size_t cpu_num : cpu_affinity_list) {
+            if (cpu_num >= CPU_SETSIZE) {
+                throw uhd::value_error(str(
+                    boost::format("CPU index %d exceeds CPU_SETSIZE") % cpu_num));
+            }
+            CPU_SET(cpu_num, &cpu_set);
+        }
+
+        int ret = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+        if (ret != 0) throw uhd::os_error("error in pthread_setaffinity_np");
+    }
+#endif /* HAVE_PTHREAD_SETAFFINITY_NP */
+
+#ifdef HAVE_WIN_SETTHREADAFFINITYMASK
+    #include <windows.h>
+
+    void uhd::set_thread_affinity(const std::vector<size_t> &cpu_affinity_list){
+        if (cpu_affinity_list.empty()) {
+            return;
+        }
+
+        DWORD_PTR mask = 0;
+        for (const size_t cpu_num : cpu_affinity_list) {
+            if (cpu_num >= sizeof(DWORD_PTR) * 8) {
+                throw uhd::value_error(str(
+                    boost::format("CPU index %d exceeds the affinity mask width") % cpu_num));
+            }
+            mask |= DWORD_PTR(1) << cpu_num;
+        }
+
+        if (SetThreadAffinityMask(GetCurrentThread(), mask) == 0)
+            throw uhd::os_error("error in SetThreadAffinityMask");
+    }
+#endif /* HAVE_WIN_SETTHREADAFFINITYMASK */
+
+#ifdef HAVE_THREAD_SETAFFINITY_DUMMY
+    void uhd::set_thread_affinity(const std::vector<size_t> &cpu_affinity_list){
+        if (not cpu_affinity_list.empty()) {
+            throw uhd::not_implemented_error("set thread affinity not implemented");
+        }
+    }
+#endif /* HAVE_THREAD_SETAFFINITY_DUMMY */
+
 void uhd::set_thread_name(
     boost::thread *thrd,
     const std::string &name
@@ -0,0 +1,228 @@
+//
+// Copyright 2019 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include <uhd/exception.hpp>
+#include <uhd/utils/log.hpp>
+#include <uhd/utils/thread.hpp>
+#include <uhdlib/utils/prefs.hpp>
+#include <uhdlib/utils/thread_policy.hpp>
+#include <boost/algorithm/string.hpp>
+#include <boost/format.hpp>
+#include <boost/lexical_cast.hpp>
+#include <mutex>
+
+#ifdef HAVE_PTHREAD_SETSCHEDPARAM
+#    include <pthread.h>
+#endif /* HAVE_PTHREAD_SETSCHEDPARAM */
+
+using namespace uhd;
+using namespace uhd::thread_policy;
+
+namespace {
+constexpr char LOG_ID[] = "THREAD";
+
+constexpr char CONF_SECTION_KEY[] = "thread";
+constexpr char ARGS_PREFIX[]      = "thread_";
+constexpr char CPUS_KEY[]         = "cpus";
+constexpr char SCHED_KEY[]        = "sched";
+constexpr char PRIORITY_KEY[]     = "priority";
+
+//! Protects the device-arg overrides and access to the config files
+std::mutex& get_policy_mutex()
+{
+    static std::mutex policy_mutex;
+    return policy_mutex;
+}
+
+//! Settings that were passed in via device args, stored as <class, key> -> value
+uhd::device_addr_t& get_arg_overrides()
+{
+    static uhd::device_addr_t arg_overrides;
+    return arg_overrides;
+}
+
+sched_t parse_sched(const std::string& sched)
+{
+    const std::string sched_lower = boost::algorithm::to_lower_copy(sched);
+    if (sched_lower == "other" or sched_lower == "normal") {
+        return sched_t::OTHER;
+    }
+    if (sched_lower == "rr") {
+        return sched_t::RR;
+    }
+    if (sched_lower == "fifo") {
+        return sched_t::FIFO;
+    }
+    throw uhd::value_error(
+        str(boost::format("Invalid thread scheduling policy `%s', must be one of "
+                          "`other', `rr' or `fifo'")
+            % sched));
+}
+
+//! Apply one key/value pair to a placement
+void update_placement(
+    placement_t& placement, const std::string& key, const std::string& value)
+{
+    if (key == CPUS_KEY) {
+        placement.cpus = parse_cpu_list(value);
+    } else if (key == SCHED_KEY) {
+        placement.sched = parse_sched(value);
+    } else if (key == PRIORITY_KEY) {
+        placement.priority = boost::lexical_cast<float>(value);
+        if (placement.priority > 1.0 or placement.priority < -1.0) {
+            throw uhd::value_error("Thread priority out of range [-1.0, +1.0]");
+        }
+    }
+}
+
+void update_from_conf(placement_t& placement, const std::string& thread_class)
+{
+    const std::string section = std::string(CONF_SECTION_KEY) + "=" + thread_class;
+    auto& conf                = uhd::prefs::get_uhd_config();
+    for (const auto& key : conf.options(section)) {
+        update_placement(placement, key, conf.get<std::string>(section, key));
+    }
+}
+
+void update_from_overrides(placement_t& placement, const std::string& thread_class)
+{
+    const auto& overrides = get_arg_overrides();
+    for (const std::string key : {CPUS_KEY, SCHED_KEY, PRIORITY_KEY}) {
+        const std::string arg_key = thread_class + "=" + key;
+        if (overrides.has_key(arg_key)) {
+            update_placement(placement, key, overrides[arg_key]);
+        }
+    }
+}
+
+void set_sched(const sched_t sched, const float priority)
+{
+    switch (sched) {
+        case sched_t::UNCHANGED:
+            return;
+        case sched_t::OTHER:
+            uhd::set_thread_priority(priority, false);
+            return;
+        case sched_t::RR:
+            uhd::set_thread_priority(priority, true);
+            return;
+        case sched_t::FIFO: {
+#ifdef HAVE_PTHREAD_SETSCHEDPARAM
+            const int min_pri = sched_get_priority_min(SCHED_FIFO);
+            const int max_pri = sched_get_priority_max(SCHED_FIFO);
+            if (min_pri == -1 or max_pri == -1) {
+                throw uhd::os_error("error in sched_get_priority_min/max");
+            }
+            sched_param sp;
+            sp.sched_priority =
+                int(std::max(priority, float(0.0)) * (max_pri - min_pri)) + min_pri;
+            if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &sp) != 0) {
+                throw uhd::os_error("error in pthread_setschedparam");
+            }
+            return;
+#else
+            throw uhd::not_implemented_error(
+                "FIFO scheduling is not supported on this platform");
+#endif /* HAVE_PTHREAD_SETSCHEDPARAM */
+        }
+    }
+}
+} // namespace
+
+std::vector<size_t> uhd::thread_policy::parse_cpu_list(const std::string& cpu_list)
+{
+    std::vector<std::string> tokens;
+    boost::split(tokens, cpu_list, boost::is_any_of(",:;"), boost::token_compress_on);
+
+    std::vector<size_t> cpus;
+    for (std::string token : tokens) {
+        boost::algorithm::trim(token);
+        if (token.empty()) {
+            continue;
+        }
+        try {
+            const size_t dash_pos = token.find('-');
+            if (dash_pos == std::string::npos) {
+                cpus.push_back(boost::lexical_cast<size_t>(token));
+                continue;
+            }
+            const size_t first = boost::lexical_cast<size_t>(
+                boost::algorithm::trim_copy(token.substr(0, dash_pos)));
+            const size_t last = boost::lexical_cast<size_t>(
+                boost::algorithm::trim_copy(token.substr(dash_pos + 1)));
+            if (last < first) {
+                throw uhd::value_error("");
+            }
+            for (size_t cpu = first; cpu <= last; cpu++) {
+                cpus.push_back(cpu);
+            }
+        } catch (const std::exception&) {
+            throw uhd::value_error(
+                str(boost::format("Invalid CPU list entry `%s' in `%s'") % token
+                    % cpu_list));
+        }
+    }
+    return cpus;
+}
+
+void uhd::thread_policy::update_from_args(const uhd::device_addr_t& args)
+{
+    std::lock_guard<std::mutex> l(get_policy_mutex());
+    auto& overrides = get_arg_overrides();
+    for (const std::string& arg_key : args.keys()) {
+        if (not boost::algorithm::starts_with(arg_key, ARGS_PREFIX)) {
+            continue;
+        }
+        const std::string class_and_key = arg_key.substr(sizeof(ARGS_PREFIX) - 1);
+        const size_t sep_pos            = class_and_key.rfind('_');
+        if (sep_pos == std::string::npos or sep_pos == 0) {
+            continue;
+        }
+        const std::string key = class_and_key.substr(sep_pos + 1);
+        if (key != CPUS_KEY and key != SCHED_KEY and key != PRIORITY_KEY) {
+            continue;
+        }
+        // Validate now, so bad args fail at device creation time
+        placement_t dummy;
+        update_placement(dummy, key, args[arg_key]);
+        const std::string thread_class = class_and_key.substr(0, sep_pos);
+        UHD_LOG_DEBUG(LOG_ID,
+            "Setting " << key << "=" << args[arg_key] << " for thread class "
+                       << thread_class);
+        overrides[thread_class + "=" + key] = args[arg_key];
+    }
+}
+
+placement_t uhd::thread_policy::get_placement(const std::string& thread_class)
+{
+    std::lock_guard<std::mutex> l(get_policy_mutex());
+    placement_t placement;
+    update_from_conf(placement, DEFAULT);
+    update_from_overrides(placement, DEFAULT);
+    if (thread_class != DEFAULT) {
+        update_from_conf(placement, thread_class);
+        update_from_overrides(placement, thread_class);
+    }
+    return placement;
+}
+
+void uhd::thread_policy::apply(const std::string& thread_class)
+{
+    try {
+        const placement_t placement = get_placement(thread_class);
+        if (placement.empty()) {
+            return;
+        }
+        UHD_LOG_TRACE(LOG_ID, "Applying placement for thread class " << thread_class);
+        uhd::set_thread_affinity(placement.cpus);
+        set_sched(placement.sched, placement.priority);
+    } catch (const std::exception& ex) {
+        UHD_LOG_WARNING(LOG_ID,
+            "Unable to apply placement for thread class `"
+                << thread_class << "': " << ex.what()
+                << " Performance may be negatively affected.");
+    }
+}
@@ -0,0 +1,148 @@
+//
+// Copyright 2019 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include <uhd/utils/log.hpp>
+#include <uhd/utils/platform.hpp>
+#include <uhdlib/utils/trace.hpp>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace uhd::trace;
+
+namespace {
+struct span_t
+{
+    std::string name;
+    const char* category;
+    size_t tid;
+    std::chrono::steady_clock::time_point start;
+    std::chrono::steady_clock::time_point end;
+};
+
+/*! Holds the spans of this process
+ *
+ * This is never destroyed, so spans can be recorded and written during static
+ * destruction, too.
+ */
+struct tracer
+{
+    tracer()
+    {
+        const char* trace_file_env = std::getenv("UHD_TRACE_FILE");
+        if (trace_file_env and *trace_file_env) {
+            path    = trace_file_env;
+            enabled = true;
+        }
+    }
+
+    //! Small thread IDs, in the order threads first record a span
+    size_t get_tid(void)
+    {
+        const auto it = tids.find(std::this_thread::get_id());
+        if (it != tids.end()) {
+            return it->second;
+        }
+        const size_t tid = tids.size() + 1;
+        tids.emplace(std::this_thread::get_id(), tid);
+        return tid;
+    }
+
+    bool enabled = false;
+    std::string path;
+    std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+    std::mutex mutex;
+    std::vector<span_t> spans;
+    std::map<std::thread::id, size_t> tids;
+};
+
+tracer& get_tracer(void)
+{
+    static tracer* t = []() {
+        tracer* new_tracer = new tracer();
+        if (new_tracer->enabled) {
+            std::atexit(&uhd::trace::write_file);
+        }
+        return new_tracer;
+    }();
+    return *t;
+}
+
+std::string escape_json(const std::string& str)
+{
+    std::string escaped;
+    for (const char c : str) {
+        switch (c) {
+            case '"':
+                escaped += "\\\"";
+                break;
+            case '\\':
+                escaped += "\\\\";
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    escaped += ' ';
+                } else {
+                    escaped += c;
+                }
+        }
+    }
+    return escaped;
+}
+
+//! Microseconds since the first use of the tracer
+long long to_us(const tracer& t, const std::chrono::steady_clock::time_point time)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(time - t.epoch).count();
+}
+} // namespace
+
+bool uhd::trace::is_enabled(void)
+{
+    return get_tracer().enabled;
+}
+
+void uhd::trace::add_span(const std::string& name,
+    const char* category,
+    const std::chrono::steady_clock::time_point start,
+    const std::chrono::steady_clock::time_point end)
+{
+    tracer& t = get_tracer();
+    if (not t.enabled) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(t.mutex);
+    t.spans.push_back({name, category, t.get_tid(), start, end});
+}
+
+void uhd::trace::write_file(void)
+{
+    tracer& t = get_tracer();
+    if (not t.enabled) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(t.mutex);
+    std::ofstream trace_file(t.path.c_str());
+    const int32_t pid = uhd::get_process_id();
+    trace_file << "{\"traceEvents\":[" << std::endl;
+    trace_file << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << pid
+               << ",\"tid\":0,\"args\":{\"name\":\"UHD\"}}";
+    for (const span_t& span : t.spans) {
+        trace_file << "," << std::endl
+                   << "{\"name\":\"" << escape_json(span.name) << "\",\"cat\":\""
+                   << escape_json(span.category) << "\",\"ph\":\"X\",\"ts\":"
+                   << to_us(t, span.start)
+                   << ",\"dur\":" << to_us(t, span.end) - to_us(t, span.start)
+                   << ",\"pid\":" << pid << ",\"tid\":" << span.tid << "}";
+    }
+    trace_file << std::endl << "]}" << std::endl;
+    if (not trace_file) {
+        UHD_LOG_WARNING("TRACE", "Could not write the trace file " << t.path);
+    }
+}
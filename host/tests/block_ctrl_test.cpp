@@ -0,0 +1,121 @@
+//
+// Copyright 2019 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include "mock_ctrl_endpoint.hpp"
+#include <uhd/rfnoc/block_ctrl.hpp>
+#include <uhd/rfnoc/constants.hpp>
+#include <uhd/rfnoc/ddc_block_ctrl.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/test/unit_test.hpp>
+
+using namespace uhd::rfnoc;
+
+namespace {
+const uhd::sid_t TEST_SID = 0x00000200; // 0.0>2.0
+
+ctrl_iface::sptr make_ctrl_iface(mock_ctrl_endpoint::sptr endpoint)
+{
+    return ctrl_iface::make(endpoint->get_xports(), "mock");
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(test_ctrl_iface_registers)
+{
+    auto endpoint = boost::make_shared<mock_ctrl_endpoint>(TEST_SID);
+    endpoint->set_readback(SR_READBACK_REG_ID, 0x0123456789ABCDEF);
+    endpoint->set_user_readback(3, 0xFEDCBA9876543210);
+    ctrl_iface::sptr ctrl = make_ctrl_iface(endpoint);
+
+    ctrl->send_cmd_pkt(130, 0xAAAA);
+    ctrl->send_cmd_pkt(131, 0xBBBB, false, 1000);
+    BOOST_CHECK_EQUAL(
+        ctrl->send_cmd_pkt(SR_READBACK, SR_READBACK_REG_ID, true), 0x0123456789ABCDEF);
+    ctrl->send_cmd_pkt(SR_READBACK_ADDR, 3);
+    BOOST_CHECK_EQUAL(
+        ctrl->send_cmd_pkt(SR_READBACK, SR_READBACK_REG_USER, true), 0xFEDCBA9876543210);
+    // Unknown readback registers read as zero
+    BOOST_CHECK_EQUAL(ctrl->send_cmd_pkt(SR_READBACK, 42, true), 0);
+
+    BOOST_CHECK(endpoint->has_reg(130));
+    BOOST_CHECK(not endpoint->has_reg(132));
+    BOOST_CHECK_EQUAL(endpoint->get_reg(130), 0xAAAA);
+    BOOST_CHECK_EQUAL(endpoint->get_reg(131), 0xBBBB);
+    const auto cmds = endpoint->get_cmds();
+    BOOST_REQUIRE_EQUAL(cmds.size(), 6);
+    BOOST_CHECK_EQUAL(cmds[0].timestamp, 0);
+    BOOST_CHECK_EQUAL(cmds[1].addr, 131);
+    BOOST_CHECK_EQUAL(cmds[1].timestamp, 1000);
+}
+
+BOOST_AUTO_TEST_CASE(test_ctrl_iface_pipelining)
+{
+    constexpr size_t num_recv_frames = 4;
+    auto endpoint = boost::make_shared<mock_ctrl_endpoint>(TEST_SID, num_recv_frames);
+    endpoint->set_latency(100e-6, 200e-6);
+    ctrl_iface::sptr ctrl = make_ctrl_iface(endpoint);
+
+    // Pokes don't wait for their ACKs until the response frames run out
+    for (uint32_t i = 0; i < 32; i++) {
+        ctrl->send_cmd_pkt(130, i);
+    }
+    BOOST_CHECK_EQUAL(endpoint->get_max_in_flight(), num_recv_frames);
+    // A peek waits for all outstanding ACKs
+    BOOST_CHECK_EQUAL(ctrl->send_cmd_pkt(SR_READBACK, SR_READBACK_COMPAT, true),
+        uint64_t(NOC_SHELL_COMPAT_MAJOR) << 32 | NOC_SHELL_COMPAT_MINOR);
+    BOOST_CHECK_EQUAL(endpoint->get_reg(130), 31);
+
+    // Peeks are never pipelined
+    endpoint->clear_cmds();
+    for (size_t i = 0; i < 8; i++) {
+        ctrl->send_cmd_pkt(SR_READBACK, SR_READBACK_REG_ID, true);
+    }
+    BOOST_CHECK_EQUAL(endpoint->get_max_in_flight(), 1);
+    BOOST_CHECK_EQUAL(endpoint->get_num_cmds(), 8);
+}
+
+BOOST_AUTO_TEST_CASE(test_block_ctrl_base)
+{
+    mock_block_fixture fixture(DEFAULT_NOC_ID);
+    fixture.set_user_readback(7, 0x1234);
+    auto block = fixture.make_block<block_ctrl>();
+    BOOST_CHECK_EQUAL(block->get_block_id().get(), "0/Block_0");
+
+    // Initialization of noc_shell
+    auto endpoint = fixture.endpoints.front();
+    BOOST_CHECK_EQUAL(endpoint->get_reg(SR_BLOCK_SID), block->get_address(0));
+    BOOST_CHECK_EQUAL(endpoint->get_reg(SR_RESP_IN_DST_SID), 0xFFFF);
+    BOOST_CHECK_EQUAL(endpoint->get_reg(SR_RESP_OUT_DST_SID), 0xFFFF);
+    BOOST_CHECK_EQUAL(
+        fixture.tree->access<size_t>("xbar/Block_0/input_buffer_size/0").get(), 0x8000);
+    BOOST_CHECK_EQUAL(fixture.tree->access<size_t>("xbar/Block_0/mtu/0").get(), 8192);
+
+    fixture.clear_cmds();
+    block->sr_write(130, 0x5678);
+    BOOST_CHECK_EQUAL(endpoint->get_reg(130), 0x5678);
+    BOOST_CHECK_EQUAL(block->user_reg_read64(7), 0x1234);
+    BOOST_CHECK_EQUAL(endpoint->get_num_cmds(), 3);
+}
+
+BOOST_AUTO_TEST_CASE(test_ddc_block_ctrl)
+{
+    mock_block_fixture fixture(0xDDC0000000000000, 2);
+    fixture.set_latency(10e-6, 10e-6);
+    // The readback registers of the DDC: compat number, number of halfbands
+    // and max. CIC decimation
+    fixture.set_user_readback(0, uint64_t(2) << 32);
+    fixture.set_user_readback(1, 3);
+    fixture.set_user_readback(2, 255);
+    auto ddc = fixture.make_block<ddc_block_ctrl>();
+    BOOST_CHECK_EQUAL(ddc->get_block_id().get(), "0/DDC_0");
+
+    const size_t dds_freq_reg =
+        fixture.tree->access<size_t>("xbar/DDC_0/registers/sr/DDS_FREQ").get();
+    fixture.clear_cmds();
+    // A quarter of the default input rate of 1.0
+    ddc->set_arg<double>("freq", 0.25, 1);
+    BOOST_CHECK_EQUAL(fixture.endpoints[1]->get_reg(dds_freq_reg), 0x40000000);
+    BOOST_CHECK_EQUAL(fixture.endpoints[0]->get_num_cmds(), 0);
+}
@@ -0,0 +1,139 @@
+//
+// Copyright 2019 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+// Benchmark of the buffer byteswap, bitswap and CRC routines, compared to
+// loops over every item, as the firmware and image loader code used them.
+
+#include <uhd/utils/byteswap.hpp>
+#include <uhd/utils/safe_main.hpp>
+#include <boost/format.hpp>
+#include <boost/program_options.hpp>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <vector>
+
+namespace po = boost::program_options;
+
+namespace {
+//! Prevents the compiler from optimizing away the result of a loop
+volatile uint32_t sink;
+
+void benchmark(const std::string& name,
+    const size_t num_bytes,
+    const size_t iterations,
+    const std::function<void(void)>& fn)
+{
+    fn(); // Warm up the caches
+    const auto start_time = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; i++) {
+        fn();
+    }
+    const std::chrono::duration<double> elapsed_time(
+        std::chrono::steady_clock::now() - start_time);
+    std::cout << boost::format("%-28s %10.1f MB/s") % name
+                     % (num_bytes * iterations / elapsed_time.count() / 1e6)
+              << std::endl;
+}
+
+uint8_t bitswap_byte(uint8_t byte)
+{
+    byte = uint8_t(((byte & 0xF0) >> 4) | ((byte & 0x0F) << 4));
+    byte = uint8_t(((byte & 0xCC) >> 2) | ((byte & 0x33) << 2));
+    return uint8_t(((byte & 0xAA) >> 1) | ((byte & 0x55) << 1));
+}
+
+uint16_t crc16_bitwise(const uint8_t* data, const size_t len)
+{
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (size_t bit = 0; bit < 8; bit++) {
+            crc = (crc & 1) ? uint16_t((crc >> 1) ^ 0xA001) : uint16_t(crc >> 1);
+        }
+    }
+    return crc;
+}
+} // namespace
+
+int UHD_SAFE_MAIN(int argc, char* argv[])
+{
+    size_t num_bytes, iterations;
+
+    po::options_description desc("Allowed options");
+    // clang-format off
+    desc.add_options()
+        ("help", "help message")
+        ("bytes", po::value<size_t>(&num_bytes)->default_value(64 * 1024), "size of the buffers")
+        ("iterations", po::value<size_t>(&iterations)->default_value(2000), "number of passes over each buffer")
+    ;
+    // clang-format on
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    po::notify(vm);
+
+    // Print the help message
+    if (vm.count("help")) {
+        std::cout << boost::format("UHD Byteswap Benchmark %s") % desc << std::endl;
+        std::cout << "    Benchmark of the buffer byteswap, bitswap and CRC routines\n"
+                     "    against loops over every item.\n"
+                  << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    num_bytes -= num_bytes % sizeof(uint64_t);
+    std::vector<uint64_t> in(num_bytes / sizeof(uint64_t)), out(in.size());
+    uint8_t* in8 = reinterpret_cast<uint8_t*>(in.data());
+    for (size_t i = 0; i < num_bytes; i++) {
+        in8[i] = uint8_t(i * 13 + 7);
+    }
+    uint8_t* out8   = reinterpret_cast<uint8_t*>(out.data());
+    uint16_t* in16  = reinterpret_cast<uint16_t*>(in.data());
+    uint16_t* out16 = reinterpret_cast<uint16_t*>(out.data());
+    uint32_t* in32  = reinterpret_cast<uint32_t*>(in.data());
+    uint32_t* out32 = reinterpret_cast<uint32_t*>(out.data());
+
+    std::cout << "Buffer size: " << num_bytes << " bytes" << std::endl;
+    benchmark("byteswap16 per item", num_bytes, iterations, [&]() {
+        for (size_t i = 0; i < num_bytes / 2; i++) {
+            out16[i] = uhd::byteswap(in16[i]);
+        }
+    });
+    benchmark("byteswap16 buffer", num_bytes, iterations, [&]() {
+        uhd::byteswap(in16, out16, num_bytes / 2);
+    });
+    benchmark("byteswap32 per item", num_bytes, iterations, [&]() {
+        for (size_t i = 0; i < num_bytes / 4; i++) {
+            out32[i] = uhd::byteswap(in32[i]);
+        }
+    });
+    benchmark("byteswap32 buffer", num_bytes, iterations, [&]() {
+        uhd::byteswap(in32, out32, num_bytes / 4);
+    });
+    benchmark("byteswap64 per item", num_bytes, iterations, [&]() {
+        for (size_t i = 0; i < in.size(); i++) {
+            out[i] = uhd::byteswap(in[i]);
+        }
+    });
+    benchmark("byteswap64 buffer", num_bytes, iterations, [&]() {
+        uhd::byteswap(in.data(), out.data(), in.size());
+    });
+    benchmark("bitswap per byte", num_bytes, iterations, [&]() {
+        for (size_t i = 0; i < num_bytes; i++) {
+            out8[i] = bitswap_byte(in8[i]);
+        }
+    });
+    benchmark("bitswap buffer", num_bytes, iterations, [&]() {
+        uhd::bitswap(in8, out8, num_bytes);
+    });
+    benchmark("crc16 bitwise", num_bytes, iterations / 10 + 1, [&]() {
+        sink = crc16_bitwise(in8, num_bytes);
+    });
+    benchmark("crc16", num_bytes, iterations, [&]() {
+        sink = uhd::crc16(in8, num_bytes);
+    });
+    sink = out8[num_bytes / 2];
+    return EXIT_SUCCESS;
+}
@@ -7,6 +7,8 @@
 
 #include <uhd/utils/byteswap.hpp>
 #include <boost/test/unit_test.hpp>
+#include <string>
+#include <vector>
 
 BOOST_AUTO_TEST_CASE(test_byteswap16)
 {
@@ -29,3 +31,75 @@ BOOST_AUTO_TEST_CASE(test_byteswap64)
     uint64_t y = 0xefcdab89 | (uint64_t(0x67452301) << 32);
     BOOST_CHECK_EQUAL(uhd::byteswap(x), y);
 }
+
+BOOST_AUTO_TEST_CASE(test_byteswap_buffers)
+{
+    // Odd sizes cover both the SIMD loops and the remainders
+    for (const size_t num_items : {0, 1, 7, 8, 9, 33}) {
+        std::vector<uint16_t> in16(num_items), out16(num_items);
+        std::vector<uint32_t> in32(num_items), out32(num_items);
+        std::vector<uint64_t> in64(num_items), out64(num_items);
+        for (size_t i = 0; i < num_items; i++) {
+            in16[i] = uint16_t(0x0123 * (i + 1));
+            in32[i] = uint32_t(0x01234567 * (i + 1));
+            in64[i] = (uint64_t(0x89abcdef) << 32 | 0x01234567) * (i + 1);
+        }
+        uhd::byteswap(in16.data(), out16.data(), num_items);
+        uhd::byteswap(in32.data(), out32.data(), num_items);
+        uhd::byteswap(in64.data(), out64.data(), num_items);
+        for (size_t i = 0; i < num_items; i++) {
+            BOOST_CHECK_EQUAL(out16[i], uhd::byteswap(in16[i]));
+            BOOST_CHECK_EQUAL(out32[i], uhd::byteswap(in32[i]));
+            BOOST_CHECK_EQUAL(out64[i], uhd::byteswap(in64[i]));
+        }
+
+        // In place, and network order
+        uhd::htonx_buff(in32.data(), in32.data(), num_items);
+        for (size_t i = 0; i < num_items; i++) {
+            BOOST_CHECK_EQUAL(in32[i], uhd::htonx(uint32_t(0x01234567 * (i + 1))));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_bitswap)
+{
+    std::vector<uint8_t> buff(300);
+    for (size_t i = 0; i < buff.size(); i++) {
+        buff[i] = uint8_t(i);
+    }
+    uhd::bitswap(buff.data(), buff.data(), buff.size());
+    for (size_t i = 0; i < buff.size(); i++) {
+        uint8_t expected = 0;
+        for (size_t bit = 0; bit < 8; bit++) {
+            if (i & (1 << bit)) {
+                expected |= uint8_t(0x80 >> bit);
+            }
+        }
+        BOOST_CHECK_EQUAL(buff[i], expected);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_crc16)
+{
+    // Check value of CRC-16/MODBUS
+    const std::string check = "123456789";
+    BOOST_CHECK_EQUAL(uhd::crc16(check.data(), check.size()), 0x4B37);
+    BOOST_CHECK_EQUAL(uhd::crc16(nullptr, 0), 0xFFFF);
+
+    // Same result as bit by bit, also when computed in pieces
+    std::vector<uint8_t> data(1001);
+    for (size_t i = 0; i < data.size(); i++) {
+        data[i] = uint8_t(i * 7 + (i >> 3));
+    }
+    uint16_t expected = 0xFFFF;
+    for (const uint8_t byte : data) {
+        expected ^= byte;
+        for (size_t bit = 0; bit < 8; bit++) {
+            expected = (expected & 1) ? uint16_t((expected >> 1) ^ 0xA001)
+                                      : uint16_t(expected >> 1);
+        }
+    }
+    BOOST_CHECK_EQUAL(uhd::crc16(data.data(), data.size()), expected);
+    const uint16_t first = uhd::crc16(data.data(), 13);
+    BOOST_CHECK_EQUAL(uhd::crc16(data.data() + 13, data.size() - 13, first), expected);
+}
@@ -0,0 +1,199 @@
+//
+// Copyright 2019 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include <uhd/exception.hpp>
+#include <uhdlib/dsp/channelizer_streamer.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/test/unit_test.hpp>
+#include <cmath>
+#include <complex>
+#include <vector>
+
+using namespace uhd;
+using namespace uhd::dsp;
+
+namespace {
+typedef std::complex<float> fc32_t;
+
+constexpr double DEVICE_RATE = 1e6;
+constexpr size_t DEVICE_SPP  = 300;
+constexpr size_t NUM_CHANS   = 8;
+
+//! Streamer that produces bursts of a complex tone as sc16, with timestamps
+class tone_rx_streamer : public rx_streamer
+{
+public:
+    tone_rx_streamer(const size_t burst_len, const double freq)
+        : _burst_len(burst_len), _freq(freq)
+    {
+    }
+
+    size_t get_num_channels(void) const
+    {
+        return 1;
+    }
+
+    size_t get_max_num_samps(void) const
+    {
+        return DEVICE_SPP;
+    }
+
+    size_t recv(const buffs_type& buffs,
+        const size_t nsamps_per_buff,
+        rx_metadata_t& metadata,
+        const double,
+        const bool)
+    {
+        metadata.reset();
+        if (_burst_index == 2) {
+            metadata.error_code = rx_metadata_t::ERROR_CODE_TIMEOUT;
+            return 0;
+        }
+        const size_t nsamps = std::min(nsamps_per_buff, _burst_len - _offset);
+        int16_t* buff       = static_cast<int16_t*>(buffs[0]);
+        for (size_t i = 0; i < nsamps; i++) {
+            const fc32_t samp =
+                std::polar(10000.0f, float(2.0 * M_PI * _freq * (_offset + i)));
+            buff[2 * i]     = int16_t(std::round(samp.real()));
+            buff[2 * i + 1] = int16_t(std::round(samp.imag()));
+        }
+        metadata.has_time_spec = true;
+        metadata.time_spec     = get_burst_time(_burst_index)
+                             + time_spec_t::from_ticks(_offset, DEVICE_RATE);
+        metadata.start_of_burst = _offset == 0;
+        _offset += nsamps;
+        metadata.end_of_burst = _offset == _burst_len;
+        if (metadata.end_of_burst) {
+            _offset = 0;
+            _burst_index++;
+        }
+        return nsamps;
+    }
+
+    void issue_stream_cmd(const stream_cmd_t& stream_cmd)
+    {
+        last_num_samps = stream_cmd.num_samps;
+    }
+
+    static time_spec_t get_burst_time(const size_t burst_index)
+    {
+        return time_spec_t(2.25) + time_spec_t(double(burst_index));
+    }
+
+    size_t last_num_samps = 0;
+
+private:
+    const size_t _burst_len;
+    const double _freq;
+    size_t _burst_index = 0;
+    size_t _offset      = 0;
+};
+
+//! Receive one burst from every channel of \p stream
+std::vector<std::vector<fc32_t>> recv_burst(
+    rx_streamer::sptr stream, const size_t burst_index)
+{
+    std::vector<std::vector<fc32_t>> bursts(NUM_CHANS);
+    std::vector<std::vector<fc32_t>> buffs(NUM_CHANS, std::vector<fc32_t>(29));
+    std::vector<void*> buff_ptrs;
+    for (auto& buff : buffs) {
+        buff_ptrs.push_back(buff.data());
+    }
+    rx_metadata_t md;
+    do {
+        const size_t nsamps = stream->recv(buff_ptrs, buffs[0].size(), md, 0.1, false);
+        BOOST_REQUIRE_EQUAL(md.error_code, rx_metadata_t::ERROR_CODE_NONE);
+        BOOST_CHECK_EQUAL(md.start_of_burst, bursts[0].empty());
+        // Output m carries the time of input m * NUM_CHANS
+        BOOST_REQUIRE(md.has_time_spec);
+        const time_spec_t expected_time =
+            tone_rx_streamer::get_burst_time(burst_index)
+            + time_spec_t::from_ticks(bursts[0].size() * NUM_CHANS, DEVICE_RATE);
+        BOOST_CHECK_EQUAL(md.time_spec.get_full_secs(), expected_time.get_full_secs());
+        BOOST_CHECK_CLOSE_FRACTION(
+            md.time_spec.get_frac_secs(), expected_time.get_frac_secs(), 1e-12);
+        for (size_t chan = 0; chan < NUM_CHANS; chan++) {
+            bursts[chan].insert(
+                bursts[chan].end(), buffs[chan].begin(), buffs[chan].begin() + nsamps);
+        }
+    } while (not md.end_of_burst);
+    return bursts;
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(test_channelizer_tone)
+{
+    // A tone in the center of channel 3 shows up in channel 3 only, at the
+    // phase the wideband tone had at the time of the output sample
+    const size_t tone_chan = 3;
+    const double freq      = double(tone_chan) / NUM_CHANS;
+    const size_t burst_len = 4567;
+    auto device_stream     = boost::make_shared<tone_rx_streamer>(burst_len, freq);
+    rx_streamer::sptr stream =
+        make_channelizer_rx_streamer(device_stream, "fc32", DEVICE_RATE, NUM_CHANS);
+    BOOST_CHECK_EQUAL(stream->get_num_channels(), NUM_CHANS);
+
+    stream_cmd_t stream_cmd(stream_cmd_t::STREAM_MODE_NUM_SAMPS_AND_DONE);
+    stream_cmd.num_samps = 100;
+    stream->issue_stream_cmd(stream_cmd);
+    BOOST_CHECK_EQUAL(device_stream->last_num_samps, 100 * NUM_CHANS);
+
+    for (size_t burst = 0; burst < 2; burst++) {
+        const auto bursts = recv_burst(stream, burst);
+        // Every input sample is covered by an output sample
+        BOOST_CHECK_EQUAL(bursts[0].size(), (burst_len + NUM_CHANS - 1) / NUM_CHANS);
+        // Skip the filter transients at either end of the burst
+        for (size_t m = 20; m < bursts[0].size() - 20; m++) {
+            const fc32_t expected =
+                std::polar(10000.0f / 32767.0f, float(2.0 * M_PI * freq * m * NUM_CHANS));
+            BOOST_REQUIRE_SMALL(std::abs(bursts[tone_chan][m] - expected), 2e-3f);
+            for (size_t chan = 0; chan < NUM_CHANS; chan++) {
+                if (chan != tone_chan) {
+                    BOOST_REQUIRE_SMALL(std::abs(bursts[chan][m]), 2e-3f);
+                }
+            }
+        }
+    }
+    rx_metadata_t md;
+    std::vector<fc32_t> buff(NUM_CHANS * 10);
+    std::vector<void*> buff_ptrs;
+    for (size_t chan = 0; chan < NUM_CHANS; chan++) {
+        buff_ptrs.push_back(&buff[chan * 10]);
+    }
+    stream->recv(buff_ptrs, 10, md, 0.1, false);
+    BOOST_CHECK_EQUAL(md.error_code, rx_metadata_t::ERROR_CODE_TIMEOUT);
+}
+
+BOOST_AUTO_TEST_CASE(test_channelizer_threads)
+{
+    // The output does not depend on the number of threads
+    const double freq = 5.3 / NUM_CHANS;
+    rx_streamer::sptr stream1 = make_channelizer_rx_streamer(
+        boost::make_shared<tone_rx_streamer>(3000, freq), "fc32", DEVICE_RATE, NUM_CHANS);
+    rx_streamer::sptr stream3 =
+        make_channelizer_rx_streamer(boost::make_shared<tone_rx_streamer>(3000, freq),
+            "fc32",
+            DEVICE_RATE,
+            NUM_CHANS,
+            12,
+            3);
+    for (size_t burst = 0; burst < 2; burst++) {
+        BOOST_CHECK(recv_burst(stream1, burst) == recv_burst(stream3, burst));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_channelizer_args)
+{
+    auto device_stream = boost::make_shared<tone_rx_streamer>(1000, 0.0);
+    BOOST_CHECK_THROW(
+        make_channelizer_rx_streamer(device_stream, "sc8", DEVICE_RATE, NUM_CHANS),
+        uhd::value_error);
+    BOOST_CHECK_THROW(make_channelizer_rx_streamer(device_stream, "fc32", DEVICE_RATE, 1),
+        uhd::value_error);
+    BOOST_CHECK_THROW(
+        make_channelizer_rx_streamer(device_stream, "fc32", DEVICE_RATE, NUM_CHANS, 0),
+        uhd::value_error);
+}
@@ -0,0 +1,281 @@
+//
+// Copyright 2019 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include "mock_ctrl_endpoint.hpp"
+#include <uhd/rfnoc/constants.hpp>
+#include <uhd/transport/chdr.hpp>
+#include <uhd/utils/byteswap.hpp>
+#include <boost/make_shared.hpp>
+#include <algorithm>
+
+using namespace uhd::rfnoc;
+using namespace uhd::transport;
+
+/***********************************************************************
+ * mock_ctrl_endpoint
+ **********************************************************************/
+mock_ctrl_endpoint::mock_ctrl_endpoint(const uhd::sid_t& sid,
+    const size_t num_recv_frames,
+    const uhd::endianness_t endianness)
+    : _sid(sid)
+    , _num_recv_frames(num_recv_frames)
+    , _endianness(endianness)
+    , _cmd_buffer(this)
+    // One more than the ctrl_iface holds, so a buffer is never reused while
+    // it's referenced
+    , _response_buffers(num_recv_frames + 1)
+{
+    UHD_ASSERT_THROW(num_recv_frames > 0);
+    // Defaults which make block_ctrl_base happy
+    _readbacks[SR_READBACK_REG_ID] = DEFAULT_NOC_ID;
+    // 64 command FIFO lines, 32 kiB input buffer
+    _readbacks[SR_READBACK_REG_FIFOSIZE] = (uint64_t(64) << 32) | 0x8000;
+    // 8 * 2^10 bytes
+    _readbacks[SR_READBACK_REG_MTU] = 10;
+    _readbacks[SR_READBACK_COMPAT] = uint64_t(NOC_SHELL_COMPAT_MAJOR) << 32
+                                     | uint64_t(NOC_SHELL_COMPAT_MINOR);
+}
+
+uhd::both_xports_t mock_ctrl_endpoint::get_xports(void)
+{
+    uhd::both_xports_t xports;
+    xports.send           = shared_from_this();
+    xports.recv           = shared_from_this();
+    xports.send_sid       = _sid;
+    xports.recv_sid       = _sid.reversed();
+    xports.send_buff_size = FRAME_SIZE;
+    xports.recv_buff_size = FRAME_SIZE;
+    xports.endianness     = _endianness;
+    return xports;
+}
+
+void mock_ctrl_endpoint::set_latency(const double latency, const double jitter)
+{
+    UHD_ASSERT_THROW(latency >= 0.0 and jitter >= 0.0);
+    std::lock_guard<std::mutex> lock(_mutex);
+    _latency = std::chrono::duration_cast<clock_t::duration>(
+        std::chrono::duration<double>(latency));
+    _jitter = jitter;
+}
+
+void mock_ctrl_endpoint::set_readback(const uint32_t reg, const uint64_t value)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _readbacks[reg] = value;
+}
+
+void mock_ctrl_endpoint::set_user_readback(const uint32_t addr, const uint64_t value)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _user_readbacks[addr] = value;
+}
+
+uint32_t mock_ctrl_endpoint::get_reg(const uint32_t addr) const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    const auto reg = _regs.find(addr);
+    return (reg == _regs.end()) ? 0 : reg->second;
+}
+
+bool mock_ctrl_endpoint::has_reg(const uint32_t addr) const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _regs.count(addr) > 0;
+}
+
+std::vector<mock_ctrl_endpoint::cmd_t> mock_ctrl_endpoint::get_cmds(void) const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _cmds;
+}
+
+size_t mock_ctrl_endpoint::get_num_cmds(void) const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _cmds.size();
+}
+
+void mock_ctrl_endpoint::clear_cmds(void)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _cmds.clear();
+    _max_in_flight = _responses.size();
+}
+
+size_t mock_ctrl_endpoint::get_max_in_flight(void) const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _max_in_flight;
+}
+
+managed_recv_buffer::sptr mock_ctrl_endpoint::get_recv_buff(double timeout)
+{
+    const auto deadline = clock_t::now()
+                          + std::chrono::duration_cast<clock_t::duration>(
+                                std::chrono::duration<double>(timeout));
+    std::unique_lock<std::mutex> lock(_mutex);
+    // Wait for the next response to be sent, and then for its latency to pass
+    while (true) {
+        const auto now = clock_t::now();
+        if (not _responses.empty() and _responses.front().ready_time <= now) {
+            break;
+        }
+        if (now >= deadline) {
+            return managed_recv_buffer::sptr(); // timeout
+        }
+        _response_cond.wait_until(lock,
+            _responses.empty() ? deadline
+                               : std::min(deadline, _responses.front().ready_time));
+    }
+
+    const response_t& response = _responses.front();
+    managed_recv_buffer::sptr buff =
+        _response_buffers[_next_response_buffer].get_new(response.frame, response.len);
+    _next_response_buffer = (_next_response_buffer + 1) % _response_buffers.size();
+    _responses.pop_front();
+    return buff;
+}
+
+managed_send_buffer::sptr mock_ctrl_endpoint::get_send_buff(double)
+{
+    return _cmd_buffer.get_new();
+}
+
+void mock_ctrl_endpoint::_handle_cmd(const frame_t& frame, const size_t len)
+{
+    const bool big_endian = (_endianness == uhd::ENDIANNESS_BIG);
+    vrt::if_packet_info_t packet_info;
+    packet_info.link_type          = vrt::if_packet_info_t::LINK_TYPE_CHDR;
+    packet_info.num_packet_words32 = len / sizeof(uint32_t);
+    if (big_endian) {
+        vrt::chdr::if_hdr_unpack_be(frame.data, packet_info);
+    } else {
+        vrt::chdr::if_hdr_unpack_le(frame.data, packet_info);
+    }
+    UHD_ASSERT_THROW(packet_info.packet_type == vrt::if_packet_info_t::PACKET_TYPE_CMD);
+    UHD_ASSERT_THROW(packet_info.sid == _sid.get());
+    UHD_ASSERT_THROW(packet_info.num_payload_words32 == 2);
+    const uint32_t* payload = frame.data + packet_info.num_header_words32;
+    const uint32_t addr = big_endian ? uhd::ntohx(payload[0]) : uhd::wtohx(payload[0]);
+    const uint32_t data = big_endian ? uhd::ntohx(payload[1]) : uhd::wtohx(payload[1]);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _cmds.push_back({addr, data, packet_info.has_tsf ? packet_info.tsf : 0});
+    const uint64_t value = _read(addr, data);
+    _regs[addr]          = data;
+
+    // Build the response
+    response_t response;
+    vrt::if_packet_info_t resp_info;
+    resp_info.link_type           = vrt::if_packet_info_t::LINK_TYPE_CHDR;
+    resp_info.packet_type         = vrt::if_packet_info_t::PACKET_TYPE_RESP;
+    resp_info.num_payload_words32 = 2;
+    resp_info.num_payload_bytes   = resp_info.num_payload_words32 * sizeof(uint32_t);
+    resp_info.packet_count        = packet_info.packet_count;
+    resp_info.sid                 = _sid.reversed().get();
+    resp_info.has_sid             = true;
+    resp_info.has_tsf             = false;
+    if (big_endian) {
+        vrt::chdr::if_hdr_pack_be(response.frame.data, resp_info);
+        response.frame.data[resp_info.num_header_words32 + 0] =
+            uhd::htonx(uint32_t(value >> 32));
+        response.frame.data[resp_info.num_header_words32 + 1] =
+            uhd::htonx(uint32_t(value));
+    } else {
+        vrt::chdr::if_hdr_pack_le(response.frame.data, resp_info);
+        response.frame.data[resp_info.num_header_words32 + 0] =
+            uhd::htowx(uint32_t(value >> 32));
+        response.frame.data[resp_info.num_header_words32 + 1] =
+            uhd::htowx(uint32_t(value));
+    }
+    response.len = resp_info.num_packet_words32 * sizeof(uint32_t);
+
+    // Apply the latency, but keep the responses in order
+    response.ready_time = clock_t::now() + _latency;
+    if (_jitter > 0.0) {
+        response.ready_time += std::chrono::duration_cast<clock_t::duration>(
+            std::chrono::duration<double>(
+                std::uniform_real_distribution<double>(0.0, _jitter)(_rng)));
+    }
+    if (not _responses.empty()) {
+        response.ready_time = std::max(response.ready_time, _responses.back().ready_time);
+    }
+    _responses.push_back(response);
+    _max_in_flight = std::max(_max_in_flight, _responses.size());
+    _response_cond.notify_all();
+}
+
+uint64_t mock_ctrl_endpoint::_read(const uint32_t addr, const uint32_t data)
+{
+    if (addr != SR_READBACK) {
+        return 0;
+    }
+    if (data == SR_READBACK_REG_USER) {
+        const auto user_addr     = _regs.find(SR_READBACK_ADDR);
+        const auto user_readback = _user_readbacks.find(
+            (user_addr == _regs.end()) ? 0 : user_addr->second);
+        return (user_readback == _user_readbacks.end()) ? 0 : user_readback->second;
+    }
+    const auto readback = _readbacks.find(data);
+    return (readback == _readbacks.end()) ? 0 : readback->second;
+}
+
+/***********************************************************************
+ * mock_block_fixture
+ **********************************************************************/
+constexpr double mock_block_fixture::DEFAULT_TICK_RATE;
+
+mock_block_fixture::mock_block_fixture(
+    const uint64_t noc_id, const size_t num_ports, const size_t num_recv_frames)
+    : tree(uhd::property_tree::make()), _noc_id(noc_id)
+{
+    // Block controllers subscribe to these nodes of the motherboard
+    tree->create<uhd::time_spec_t>("time/cmd");
+    tree->create<double>("tick_rate").set(DEFAULT_TICK_RATE);
+    for (size_t port = 0; port < num_ports; port++) {
+        // Control SIDs as device3 assigns them: 0.0 to 2.0/port
+        uhd::sid_t sid(0);
+        sid.set_dst_addr(2);
+        sid.set_dst_endpoint(port);
+        auto endpoint = boost::make_shared<mock_ctrl_endpoint>(sid, num_recv_frames);
+        endpoint->set_readback(SR_READBACK_REG_ID, noc_id);
+        endpoints.push_back(endpoint);
+    }
+}
+
+void mock_block_fixture::set_latency(const double latency, const double jitter)
+{
+    for (auto& endpoint : endpoints) {
+        endpoint->set_latency(latency, jitter);
+    }
+}
+
+void mock_block_fixture::set_user_readback(const uint32_t addr, const uint64_t value)
+{
+    for (auto& endpoint : endpoints) {
+        endpoint->set_user_readback(addr, value);
+    }
+}
+
+void mock_block_fixture::clear_cmds(void)
+{
+    for (auto& endpoint : endpoints) {
+        endpoint->clear_cmds();
+    }
+}
+
+make_args_t mock_block_fixture::_get_make_args(void)
+{
+    make_args_t make_args;
+    for (size_t port = 0; port < endpoints.size(); port++) {
+        make_args.ctrl_ifaces[port] = ctrl_iface::make(endpoints[port]->get_xports(),
+            str(boost::format("mock/%d") % port));
+    }
+    make_args.base_address = endpoints.front()->get_xports().send_sid.get_dst();
+    make_args.device_index = 0;
+    make_args.tree         = tree;
+    return make_args;
+}
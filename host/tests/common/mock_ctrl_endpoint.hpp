@@ -0,0 +1,271 @@
+//
+// Copyright 2019 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#ifndef INCLUDED_MOCK_CTRL_ENDPOINT_HPP
+#define INCLUDED_MOCK_CTRL_ENDPOINT_HPP
+
+#include <uhd/exception.hpp>
+#include <uhd/property_tree.hpp>
+#include <uhd/rfnoc/block_ctrl_base.hpp>
+#include <uhd/transport/zero_copy.hpp>
+#include <uhd/types/endianness.hpp>
+#include <uhd/types/sid.hpp>
+#include <uhdlib/rfnoc/ctrl_iface.hpp>
+#include <uhdlib/rfnoc/xports.hpp>
+#include <boost/enable_shared_from_this.hpp>
+#include <boost/format.hpp>
+#include <boost/shared_ptr.hpp>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <random>
+#include <vector>
+
+/*! Emulates the command endpoint of a noc_shell
+ *
+ * This is the transport pair that a uhd::rfnoc::ctrl_iface sends its command
+ * packets to. Every command is applied to an in-memory register file, and
+ * answered with a response packet, which becomes available after a
+ * configurable latency. Responses are pipelined like on the device: the
+ * latency of a command starts when it is sent, not when the previous
+ * response was received.
+ *
+ * The register file behaves like noc_shell:
+ * - A write to any settings register stores its value (see get_reg()).
+ * - A write to SR_READBACK_ADDR selects the user readback register.
+ * - A write to SR_READBACK returns the noc_shell readback register given in its
+ *   data in the response (see set_readback()); SR_READBACK_REG_USER returns
+ *   the selected user readback register (see set_user_readback()).
+ * - All other responses have a payload of zero.
+ */
+class mock_ctrl_endpoint : public uhd::transport::zero_copy_if,
+                           public boost::enable_shared_from_this<mock_ctrl_endpoint>
+{
+public:
+    typedef boost::shared_ptr<mock_ctrl_endpoint> sptr;
+    typedef std::chrono::steady_clock clock_t;
+
+    //! A command as it was received
+    struct cmd_t
+    {
+        uint32_t addr;
+        uint32_t data;
+        uint64_t timestamp;
+    };
+
+    /*!
+     * \param sid The SID of the command packets, i.e. the send SID of the
+     *            ctrl_iface
+     * \param num_recv_frames The number of responses a ctrl_iface may have
+     *                        outstanding
+     * \param endianness The endianness of the packets
+     */
+    mock_ctrl_endpoint(const uhd::sid_t& sid,
+        const size_t num_recv_frames       = 8,
+        const uhd::endianness_t endianness = uhd::ENDIANNESS_BIG);
+
+    //! Returns the transports a ctrl_iface uses to talk to this endpoint
+    uhd::both_xports_t get_xports(void);
+
+    /*! Set the time a command takes to be answered
+     *
+     * Every response is delayed by \p latency plus a uniformly distributed
+     * random time between 0 and \p jitter (both in seconds). Responses never
+     * overtake each other.
+     */
+    void set_latency(const double latency, const double jitter = 0.0);
+
+    //! Set the value of a noc_shell readback register (e.g. SR_READBACK_REG_ID)
+    void set_readback(const uint32_t reg, const uint64_t value);
+
+    //! Set the value of a user readback register
+    void set_user_readback(const uint32_t addr, const uint64_t value);
+
+    //! Returns the last value written to a settings register, or 0
+    uint32_t get_reg(const uint32_t addr) const;
+
+    //! Returns true if a settings register was written
+    bool has_reg(const uint32_t addr) const;
+
+    //! Returns all commands received since the last call to clear_cmds()
+    std::vector<cmd_t> get_cmds(void) const;
+
+    //! Returns the number of commands received since the last call to clear_cmds()
+    size_t get_num_cmds(void) const;
+
+    //! Forgets all received commands, and resets get_max_in_flight()
+    void clear_cmds(void);
+
+    /*! Returns the largest number of commands that were waiting for their
+     * response at the same time
+     *
+     * This is 1 if every command waited for the previous one to be
+     * acknowledged, and larger if commands were pipelined.
+     */
+    size_t get_max_in_flight(void) const;
+
+    /***********************************************************************
+     * zero_copy_if API
+     **********************************************************************/
+    uhd::transport::managed_recv_buffer::sptr get_recv_buff(double timeout);
+    uhd::transport::managed_send_buffer::sptr get_send_buff(double timeout);
+
+    size_t get_num_recv_frames(void) const
+    {
+        return _num_recv_frames;
+    }
+    size_t get_num_send_frames(void) const
+    {
+        return 1;
+    }
+    size_t get_recv_frame_size(void) const
+    {
+        return FRAME_SIZE;
+    }
+    size_t get_send_frame_size(void) const
+    {
+        return FRAME_SIZE;
+    }
+
+private:
+    static constexpr size_t FRAME_SIZE = 64;
+
+    struct frame_t
+    {
+        uint32_t data[FRAME_SIZE / sizeof(uint32_t)];
+    };
+
+    struct response_t
+    {
+        clock_t::time_point ready_time;
+        frame_t frame;
+        size_t len;
+    };
+
+    class cmd_buffer : public uhd::transport::managed_send_buffer
+    {
+    public:
+        cmd_buffer(mock_ctrl_endpoint* endpoint) : _endpoint(endpoint) {}
+
+        void release(void)
+        {
+            _endpoint->_handle_cmd(_frame, size());
+        }
+
+        sptr get_new(void)
+        {
+            return make(this, _frame.data, FRAME_SIZE);
+        }
+
+    private:
+        mock_ctrl_endpoint* _endpoint;
+        frame_t _frame;
+    };
+
+    class response_buffer : public uhd::transport::managed_recv_buffer
+    {
+    public:
+        void release(void) {}
+
+        sptr get_new(const frame_t& frame, const size_t len)
+        {
+            _frame = frame;
+            return make(this, _frame.data, len);
+        }
+
+    private:
+        frame_t _frame;
+    };
+
+    void _handle_cmd(const frame_t& frame, const size_t len);
+    uint64_t _read(const uint32_t addr, const uint32_t data);
+
+    const uhd::sid_t _sid;
+    const size_t _num_recv_frames;
+    const uhd::endianness_t _endianness;
+
+    mutable std::mutex _mutex;
+    std::condition_variable _response_cond;
+    std::deque<response_t> _responses;
+    cmd_buffer _cmd_buffer;
+    std::vector<response_buffer> _response_buffers;
+    size_t _next_response_buffer = 0;
+
+    clock_t::duration _latency = clock_t::duration::zero();
+    double _jitter             = 0.0;
+    std::mt19937 _rng;
+
+    std::map<uint32_t, uint32_t> _regs;
+    std::map<uint32_t, uint64_t> _readbacks;
+    std::map<uint32_t, uint64_t> _user_readbacks;
+    std::vector<cmd_t> _cmds;
+    size_t _max_in_flight = 0;
+};
+
+/*! Makes real block controllers which talk to mock command endpoints
+ *
+ * Every control port of a block gets its own mock_ctrl_endpoint, which answers
+ * the readback registers that block_ctrl_base::block_ctrl_base() reads. The
+ * user readback registers that a block controller reads in its constructor
+ * need to be set before calling make_block():
+ *
+ * \code{.cpp}
+ * mock_block_fixture fixture(0xDDC0000000000000, 2);
+ * fixture.set_user_readback(1, 3); // Number of halfbands
+ * auto ddc = fixture.make_block<ddc_block_ctrl>();
+ * \endcode
+ *
+ * The property tree has the time/cmd and tick_rate nodes of a motherboard.
+ * The block definitions are found through UHD_RFNOC_DIR, which the unit tests
+ * set to the source tree.
+ */
+class mock_block_fixture
+{
+public:
+    static constexpr double DEFAULT_TICK_RATE = 200e6;
+
+    /*!
+     * \param noc_id The NoC ID of the block, which selects its controller
+     * \param num_ports The number of control ports
+     * \param num_recv_frames The number of outstanding responses per port
+     */
+    mock_block_fixture(
+        const uint64_t noc_id, const size_t num_ports = 1, const size_t num_recv_frames = 8);
+
+    //! Set the latency of all endpoints (see mock_ctrl_endpoint::set_latency())
+    void set_latency(const double latency, const double jitter = 0.0);
+
+    //! Set a user readback register on all endpoints
+    void set_user_readback(const uint32_t addr, const uint64_t value);
+
+    //! Forget the received commands on all endpoints
+    void clear_cmds(void);
+
+    //! Make a block controller, and cast it to \p block_type
+    template <typename block_type> boost::shared_ptr<block_type> make_block(void)
+    {
+        auto block = boost::dynamic_pointer_cast<block_type>(
+            uhd::rfnoc::block_ctrl_base::make(_get_make_args(), _noc_id));
+        if (not block) {
+            throw uhd::type_error(
+                str(boost::format("Block with NoC ID 0x%016X has another controller")
+                    % _noc_id));
+        }
+        return block;
+    }
+
+    uhd::property_tree::sptr tree;
+    std::vector<mock_ctrl_endpoint::sptr> endpoints;
+
+private:
+    uhd::rfnoc::make_args_t _get_make_args(void);
+
+    const uint64_t _noc_id;
+};
+
+#endif /* INCLUDED_MOCK_CTRL_ENDPOINT_HPP */
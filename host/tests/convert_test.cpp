@@ -6,6 +6,7 @@
 //
 
 #include <uhd/convert.hpp>
+#include <uhdlib/convert/fast_converter.hpp>
 #include <stdint.h>
 #include <boost/test/unit_test.hpp>
 #include <complex>
@@ -651,3 +652,36 @@ BOOST_AUTO_TEST_CASE(test_convert_types_f32_and_f32)
         test_convert_types_f32(nsamps, id);
     }
 }
+
+BOOST_AUTO_TEST_CASE(test_convert_fast_path)
+{
+    convert::id_type id;
+    id.input_format  = "sc16";
+    id.num_inputs    = 1;
+    id.output_format = "sc16_item32_be";
+    id.num_outputs   = 1;
+
+    // Repeated lookups hit the cache and must still yield working converters
+    convert::converter::sptr c0 = convert::get_converter(id)();
+    convert::converter::sptr c1 = convert::get_converter(id)();
+    BOOST_REQUIRE(c0 != c1);
+    c0->set_scalar(32767.);
+    c1->set_scalar(32767.);
+
+    const size_t nsamps = 17;
+    std::vector<sc16_t> input(nsamps);
+    for (size_t i = 0; i < nsamps; i++) {
+        input[i] = sc16_t(int16_t(i), int16_t(-int(i)));
+    }
+    std::vector<uint32_t> output0(nsamps), output1(nsamps);
+    std::vector<const void*> in(1, &input[0]);
+    std::vector<void*> out0(1, &output0[0]), out1(1, &output1[0]);
+
+    // The direct conversion function must produce the same output as conv()
+    c0->conv(in, out0, nsamps);
+    convert::conv_fn_type conv_fn = convert::get_conv_fn(c1);
+    BOOST_CHECK(conv_fn != &convert::conv_generic);
+    conv_fn(c1.get(), in, out1, nsamps);
+    BOOST_CHECK_EQUAL_COLLECTIONS(
+        output0.begin(), output0.end(), output1.begin(), output1.end());
+}
@@ -0,0 +1,81 @@
+//
+// Copyright 2019 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+// Benchmark of the FFT plans and the averaged power spectrum, for work on the
+// butterflies.
+
+#include <uhd/utils/fft.hpp>
+#include <uhd/utils/safe_main.hpp>
+#include <boost/format.hpp>
+#include <boost/program_options.hpp>
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <functional>
+#include <iostream>
+#include <vector>
+
+namespace po = boost::program_options;
+
+namespace {
+typedef std::complex<float> fc32_t;
+
+void benchmark(const std::string& name,
+    const size_t size,
+    const size_t iterations,
+    const std::function<void(void)>& fn)
+{
+    fn(); // Warm up the caches
+    const auto start_time = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; i++) {
+        fn();
+    }
+    const std::chrono::duration<double> elapsed_time(
+        std::chrono::steady_clock::now() - start_time);
+    std::cout << boost::format("%-24s %6d points %10.2f us %10.1f MS/s") % name % size
+                     % (elapsed_time.count() / iterations * 1e6)
+                     % (size * iterations / elapsed_time.count() / 1e6)
+              << std::endl;
+}
+} // namespace
+
+int UHD_SAFE_MAIN(int argc, char* argv[])
+{
+    size_t iterations;
+
+    po::options_description desc("Allowed options");
+    // clang-format off
+    desc.add_options()
+        ("help", "help message")
+        ("iterations", po::value<size_t>(&iterations)->default_value(2000), "number of transforms per size")
+    ;
+    // clang-format on
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    po::notify(vm);
+
+    // Print the help message
+    if (vm.count("help")) {
+        std::cout << boost::format("UHD FFT Benchmark %s") % desc << std::endl;
+        std::cout << "    Benchmark of the FFT plans and the averaged power spectrum.\n"
+                  << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    for (const size_t size : {64, 256, 1024, 4096, 16384}) {
+        std::vector<fc32_t> in(size), out(size);
+        for (size_t n = 0; n < size; n++) {
+            in[n] = fc32_t(std::cos(0.3f * n), std::sin(1.7f * n) + 0.5f);
+        }
+        uhd::fft::sptr plan = uhd::fft::make(size);
+        benchmark(
+            "fft", size, iterations, [&]() { plan->execute(in.data(), out.data()); });
+        uhd::power_spectrum::sptr spectrum = uhd::power_spectrum::make(size);
+        benchmark("power spectrum", size, iterations, [&]() {
+            spectrum->process(in.data(), size);
+        });
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,115 @@
+//
+// Copyright 2019 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include <uhd/exception.hpp>
+#include <uhd/utils/fft.hpp>
+#include <boost/test/unit_test.hpp>
+#include <cmath>
+#include <complex>
+#include <vector>
+
+using namespace uhd;
+
+namespace {
+typedef std::complex<float> fc32_t;
+
+std::vector<fc32_t> make_input(const size_t size)
+{
+    std::vector<fc32_t> in(size);
+    for (size_t n = 0; n < size; n++) {
+        in[n] = fc32_t(std::cos(0.3f * n), std::sin(1.7f * n) + 0.5f);
+    }
+    return in;
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(test_fft_against_dft)
+{
+    for (const size_t size : {1, 2, 4, 8, 32, 128, 2048, 6, 25}) {
+        fft::sptr plan                = fft::make(size);
+        const std::vector<fc32_t> in  = make_input(size);
+        std::vector<fc32_t> out(size);
+        std::vector<fc32_t> in_place = in;
+        plan->execute(in.data(), out.data());
+        plan->execute(in_place.data(), in_place.data());
+        for (size_t k = 0; k < size; k++) {
+            std::complex<double> expected(0.0, 0.0);
+            for (size_t n = 0; n < size; n++) {
+                expected += std::complex<double>(in[n])
+                            * std::polar(1.0, -2.0 * M_PI * double((k * n) % size) / size);
+            }
+            const double tolerance = 1e-5 * size;
+            BOOST_CHECK_SMALL(std::abs(std::complex<double>(out[k]) - expected), tolerance);
+            BOOST_CHECK_SMALL(
+                std::abs(std::complex<double>(in_place[k]) - expected), tolerance);
+        }
+    }
+    BOOST_CHECK_THROW(fft::make(0), uhd::value_error);
+}
+
+BOOST_AUTO_TEST_CASE(test_fft_plan_cache)
+{
+    fft::sptr plan = fft::make(256);
+    BOOST_CHECK_EQUAL(plan->size(), 256);
+    BOOST_CHECK(fft::make(256) == plan);
+    BOOST_CHECK(fft::make(512) != plan);
+}
+
+BOOST_AUTO_TEST_CASE(test_fft_windows)
+{
+    for (const auto window : {fft::WINDOW_RECTANGULAR,
+             fft::WINDOW_HANN,
+             fft::WINDOW_HAMMING,
+             fft::WINDOW_BLACKMAN_HARRIS,
+             fft::WINDOW_FLAT_TOP}) {
+        const std::vector<float> coeffs = fft::make_window(window, 101);
+        BOOST_REQUIRE_EQUAL(coeffs.size(), 101);
+        // Symmetric, with the peak in the center
+        BOOST_CHECK_CLOSE(coeffs[50], 1.0f, 0.1);
+        for (size_t n = 0; n < coeffs.size(); n++) {
+            BOOST_CHECK_CLOSE_FRACTION(coeffs[n] + 1.0f, coeffs[100 - n] + 1.0f, 1e-5);
+            BOOST_CHECK_LE(coeffs[n], 1.0f + 1e-3f);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_power_spectrum)
+{
+    const size_t fft_size = 64;
+    const size_t tone_bin = 5;
+    power_spectrum::sptr spectrum =
+        power_spectrum::make(fft_size, fft::WINDOW_RECTANGULAR);
+    BOOST_CHECK_EQUAL(spectrum->get_fft_size(), fft_size);
+    BOOST_CHECK(spectrum->get_log_power().empty());
+
+    // A full-scale tone in the center of a bin reads 3 dBFS, and averages to
+    // the same value; the incomplete frame at the end is ignored
+    std::vector<fc32_t> samps(3 * fft_size + 10);
+    for (size_t n = 0; n < samps.size(); n++) {
+        samps[n] = std::polar(1.0f, float(2.0 * M_PI * tone_bin * n / fft_size));
+    }
+    BOOST_CHECK_EQUAL(spectrum->process(samps.data(), samps.size()), 3);
+    BOOST_CHECK_EQUAL(spectrum->get_num_averaged(), 3);
+    std::vector<float> log_power = spectrum->get_log_power(false);
+    BOOST_REQUIRE_EQUAL(log_power.size(), fft_size);
+    BOOST_CHECK_CLOSE(log_power[tone_bin], 3.0f, 0.1);
+    for (size_t i = 0; i < fft_size; i++) {
+        if (i != tone_bin) {
+            BOOST_CHECK_LT(log_power[i], -100.0f);
+        }
+    }
+    BOOST_CHECK_EQUAL(spectrum->get_num_averaged(), 3);
+
+    // Averaging with a frame of silence halves the power
+    const std::vector<fc32_t> silence(fft_size);
+    spectrum->process(samps.data(), fft_size);
+    spectrum->reset();
+    spectrum->process(samps.data(), fft_size);
+    spectrum->process(silence.data(), fft_size);
+    log_power = spectrum->get_log_power();
+    BOOST_CHECK_CLOSE(log_power[tone_bin], float(3.0 - 10.0 * std::log10(2.0)), 0.1);
+    BOOST_CHECK_EQUAL(spectrum->get_num_averaged(), 0);
+}
@@ -0,0 +1,109 @@
+//
+// Copyright 2019 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include <uhd/exception.hpp>
+#include <uhd/host_nco.hpp>
+#include <boost/test/unit_test.hpp>
+#include <atomic>
+#include <cmath>
+#include <complex>
+#include <thread>
+#include <vector>
+
+using namespace uhd;
+
+namespace {
+typedef std::complex<float> fc32_t;
+constexpr double SAMP_RATE = 1e6;
+} // namespace
+
+BOOST_AUTO_TEST_CASE(test_host_nco_fc32)
+{
+    const double freq = 12345.0;
+    host_nco::sptr nco = host_nco::make(SAMP_RATE, freq);
+    nco->init("fc32", 2);
+    BOOST_CHECK_LT(nco->get_freq_resolution(), 1e-9);
+
+    // Odd block sizes, and more than one phasor segment per block
+    std::vector<fc32_t> buff(3001);
+    size_t n = 0;
+    for (const size_t nsamps : {1, 7, 3001, 500}) {
+        std::fill(buff.begin(), buff.end(), fc32_t(0.5f, 0.0f));
+        nco->run(1, buff.data(), nsamps);
+        for (size_t i = 0; i < nsamps; i++, n++) {
+            const fc32_t expected =
+                std::polar(0.5f, float(2.0 * M_PI * std::fmod(freq * n / SAMP_RATE, 1.0)));
+            BOOST_REQUIRE_SMALL(std::abs(buff[i] - expected), 1e-5f);
+        }
+    }
+    BOOST_CHECK_EQUAL(nco->get_stats().num_samps, n);
+    BOOST_CHECK_EQUAL(nco->get_stats().num_calls, 4);
+}
+
+BOOST_AUTO_TEST_CASE(test_host_nco_timed_sc16)
+{
+    // A quarter of the sample rate turns I into Q, then into -I, ...
+    host_nco::sptr nco = host_nco::make(SAMP_RATE, SAMP_RATE / 4);
+    nco->init("sc16", 1);
+    nco->set_freq(0.0, time_spec_t(2.0) + time_spec_t::from_ticks(6, SAMP_RATE));
+    nco->set_time(0, time_spec_t(2.0));
+
+    std::vector<int16_t> buff(2 * 10);
+    for (size_t i = 0; i < 10; i++) {
+        buff[2 * i]     = 1000;
+        buff[2 * i + 1] = 0;
+    }
+    nco->process(0, buff.data(), 10);
+    const int16_t expected[] = {1000, 0, 0, 1000, -1000, 0, 0, -1000, 1000, 0, 0, 1000};
+    for (size_t i = 0; i < 12; i++) {
+        BOOST_CHECK_EQUAL(buff[i], expected[i]);
+    }
+    // The frequency changes at sample 6, the phase stays where it was
+    for (size_t i = 6; i < 10; i++) {
+        BOOST_CHECK_EQUAL(buff[2 * i], -1000);
+        BOOST_CHECK_EQUAL(buff[2 * i + 1], 0);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_host_nco_concurrent_retune)
+{
+    // Retuning from another thread never disturbs the amplitude, and the last
+    // frequency wins
+    host_nco::sptr nco = host_nco::make(SAMP_RATE);
+    nco->init("fc32", 1);
+    std::atomic<bool> done{false};
+    std::thread tuner([&]() {
+        for (size_t i = 0; not done; i++) {
+            nco->set_freq(double(i % 1000));
+        }
+        nco->set_freq(SAMP_RATE / 2);
+    });
+    std::vector<fc32_t> buff(1000);
+    for (size_t i = 0; i < 1000; i++) {
+        std::fill(buff.begin(), buff.end(), fc32_t(1.0f, 0.0f));
+        nco->process(0, buff.data(), buff.size());
+        for (const auto& samp : buff) {
+            BOOST_REQUIRE_CLOSE(std::abs(samp), 1.0f, 0.01);
+        }
+    }
+    done = true;
+    tuner.join();
+
+    // Every other sample is inverted at half the sample rate
+    std::fill(buff.begin(), buff.end(), fc32_t(1.0f, 0.0f));
+    nco->process(0, buff.data(), buff.size());
+    for (size_t i = 1; i < buff.size(); i++) {
+        BOOST_REQUIRE_SMALL(std::abs(buff[i] + buff[i - 1]), 1e-4f);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_host_nco_args)
+{
+    BOOST_CHECK_THROW(host_nco::make(0.0), uhd::value_error);
+    host_nco::sptr nco = host_nco::make(SAMP_RATE);
+    BOOST_CHECK_THROW(nco->init("sc8", 1), uhd::value_error);
+    BOOST_CHECK_EQUAL(nco->get_name(), "host_nco");
+}
@@ -0,0 +1,277 @@
+//
+// Copyright 2019 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+// This file contains a latency benchmark for the control and streaming paths.
+// It drives the latency histogram hooks (see uhdlib/utils/latency_histogram.hpp)
+// either with the mock transports, or with a real device, and prints a
+// percentile table for every histogram.
+
+#include "../lib/transport/super_recv_packet_handler.hpp"
+#include "../lib/transport/super_send_packet_handler.hpp"
+#include "../lib/usrp/device3/device3_flow_ctrl.hpp"
+#include "common/mock_ctrl_endpoint.hpp"
+#include "common/mock_zero_copy.hpp"
+#include <uhd/convert.hpp>
+#include <uhd/rfnoc/constants.hpp>
+#include <uhd/transport/chdr.hpp>
+#include <uhd/types/sid.hpp>
+#include <uhd/usrp/multi_usrp.hpp>
+#include <uhd/utils/safe_main.hpp>
+#include <uhd/utils/thread.hpp>
+#include <uhdlib/rfnoc/ctrl_iface.hpp>
+#include <uhdlib/utils/latency_histogram.hpp>
+#include <boost/format.hpp>
+#include <boost/program_options.hpp>
+#include <complex>
+#include <iostream>
+#include <vector>
+
+namespace po = boost::program_options;
+using namespace uhd::transport;
+using namespace uhd::usrp;
+
+/***********************************************************************
+ * Mock benchmarks
+ **********************************************************************/
+void benchmark_mock_ctrl(
+    const size_t iterations, const double ctrl_latency, const double ctrl_jitter)
+{
+    mock_ctrl_endpoint::sptr endpoint(new mock_ctrl_endpoint(uhd::sid_t(0x00000010)));
+    endpoint->set_latency(ctrl_latency, ctrl_jitter);
+    uhd::rfnoc::ctrl_iface::sptr ctrl =
+        uhd::rfnoc::ctrl_iface::make(endpoint->get_xports(), "mock");
+    for (size_t i = 0; i < iterations; i++) {
+        ctrl->send_cmd_pkt(uhd::rfnoc::SR_READBACK, 0, true);
+        ctrl->send_cmd_pkt(0, 0, false);
+        ctrl->send_cmd_pkt(0, 0, false, i + 1);
+    }
+}
+
+void benchmark_mock_rx(const size_t iterations, const size_t spp)
+{
+    const size_t frame_size = spp * sizeof(uint32_t) + DEVICE3_RX_MAX_HDR_LEN;
+    mock_zero_copy::sptr xport(new mock_zero_copy(
+        vrt::if_packet_info_t::LINK_TYPE_CHDR, frame_size, frame_size));
+
+    sph::recv_packet_streamer streamer(spp);
+    streamer.set_vrt_unpacker(&vrt::chdr::if_hdr_unpack_be);
+    streamer.set_tick_rate(1.0);
+    streamer.set_samp_rate(1.0);
+
+    uhd::convert::id_type id;
+    id.output_format = "sc16";
+    id.num_inputs    = 1;
+    id.input_format  = "sc16_item32_be";
+    id.num_outputs   = 1;
+    streamer.set_converter(id);
+
+    streamer.set_xport_chan_get_buff(0,
+        [xport](double timeout) { return xport->get_recv_buff(timeout); },
+        false // flush
+    );
+
+    // Emulate a device which answers every stream command with one burst
+    size_t packet_count = 0;
+    const std::vector<uint32_t> recv_data(spp, 0);
+    streamer.set_issue_stream_cmd(
+        0, [xport, &packet_count, &recv_data](const uhd::stream_cmd_t&) {
+            vrt::if_packet_info_t packet_info;
+            packet_info.packet_type = vrt::if_packet_info_t::PACKET_TYPE_DATA;
+            packet_info.num_payload_words32 = recv_data.size();
+            packet_info.num_payload_bytes =
+                packet_info.num_payload_words32 * sizeof(uint32_t);
+            packet_info.packet_count = packet_count++ & 0xfff;
+            packet_info.has_tsf      = true;
+            packet_info.tsf          = 1;
+            packet_info.eob          = true;
+            xport->push_back_recv_packet(packet_info, recv_data);
+        });
+
+    std::vector<uint32_t> buffer(spp);
+    std::vector<void*> buffers(1, buffer.data());
+    uhd::stream_cmd_t stream_cmd(uhd::stream_cmd_t::STREAM_MODE_NUM_SAMPS_AND_DONE);
+    stream_cmd.num_samps  = spp;
+    stream_cmd.stream_now = true;
+    uhd::rx_metadata_t md;
+    for (size_t i = 0; i < iterations; i++) {
+        streamer.issue_stream_cmd(stream_cmd);
+        streamer.recv(buffers, spp, md, 1.0, false);
+    }
+}
+
+void benchmark_mock_tx(const size_t iterations, const size_t spp)
+{
+    const size_t frame_size = spp * sizeof(uint32_t) + DEVICE3_TX_MAX_HDR_LEN;
+    mock_zero_copy::sptr xport(new mock_zero_copy(
+        vrt::if_packet_info_t::LINK_TYPE_CHDR, frame_size, frame_size));
+    xport->set_reuse_send_memory(true);
+
+    sph::send_packet_streamer streamer(spp);
+    streamer.set_vrt_packer(&vrt::chdr::if_hdr_pack_be);
+    streamer.set_tick_rate(1.0);
+    streamer.set_samp_rate(1.0);
+
+    uhd::convert::id_type id;
+    id.input_format  = "sc16";
+    id.num_inputs    = 1;
+    id.output_format = "sc16_item32_be";
+    id.num_outputs   = 1;
+    streamer.set_converter(id);
+    streamer.set_enable_trailer(false);
+
+    streamer.set_xport_chan_get_buff(
+        0, [xport](double timeout) { return xport->get_send_buff(timeout); });
+
+    // Emulate a device which acknowledges every burst immediately. Devices
+    // record the ACK when their async message handler receives it.
+    const auto eob_mark = streamer.get_eob_mark();
+    streamer.set_async_receiver([eob_mark](uhd::async_metadata_t& md, const double) {
+        UHD_LATENCY_MARK_RECORD("tx_eob_to_burst_ack", *eob_mark);
+        md.event_code = uhd::async_metadata_t::EVENT_CODE_BURST_ACK;
+        return true;
+    });
+
+    std::vector<uint32_t> buffer(spp);
+    std::vector<const void*> buffers(1, buffer.data());
+    uhd::tx_metadata_t md;
+    md.start_of_burst = true;
+    md.end_of_burst   = true;
+    uhd::async_metadata_t async_md;
+    for (size_t i = 0; i < iterations; i++) {
+        streamer.send(buffers, spp, md, 1.0);
+        streamer.recv_async_msg(async_md, 1.0);
+    }
+}
+
+/***********************************************************************
+ * Device benchmarks
+ **********************************************************************/
+void benchmark_device(const std::string& args, const size_t iterations, const double rate)
+{
+    multi_usrp::sptr usrp = multi_usrp::make(args);
+    usrp->set_rx_rate(rate);
+    usrp->set_tx_rate(rate);
+
+    std::cout << "Running control path benchmark..." << std::endl;
+    for (size_t i = 0; i < iterations; i++) {
+        usrp->get_time_now();
+    }
+    for (size_t i = 0; i < iterations; i++) {
+        usrp->set_command_time(usrp->get_time_now() + uhd::time_spec_t(0.1));
+        usrp->set_rx_gain(usrp->get_rx_gain());
+        usrp->clear_command_time();
+    }
+
+    std::cout << "Running RX benchmark..." << std::endl;
+    uhd::stream_args_t stream_args("sc16");
+    uhd::rx_streamer::sptr rx_stream = usrp->get_rx_stream(stream_args);
+    const size_t rx_spp              = rx_stream->get_max_num_samps();
+    std::vector<std::complex<short>> rx_buff(rx_spp);
+    uhd::stream_cmd_t stream_cmd(uhd::stream_cmd_t::STREAM_MODE_NUM_SAMPS_AND_DONE);
+    stream_cmd.num_samps  = rx_spp;
+    stream_cmd.stream_now = true;
+    uhd::rx_metadata_t rx_md;
+    for (size_t i = 0; i < iterations; i++) {
+        rx_stream->issue_stream_cmd(stream_cmd);
+        do {
+            rx_stream->recv(&rx_buff.front(), rx_buff.size(), rx_md, 1.0);
+        } while (rx_md.error_code == uhd::rx_metadata_t::ERROR_CODE_NONE
+                 and not rx_md.end_of_burst);
+    }
+    rx_stream.reset();
+
+    std::cout << "Running TX benchmark..." << std::endl;
+    uhd::tx_streamer::sptr tx_stream = usrp->get_tx_stream(stream_args);
+    const size_t tx_spp              = tx_stream->get_max_num_samps();
+    std::vector<std::complex<short>> tx_buff(tx_spp);
+    uhd::tx_metadata_t tx_md;
+    tx_md.start_of_burst = true;
+    tx_md.end_of_burst   = true;
+    uhd::async_metadata_t async_md;
+    for (size_t i = 0; i < iterations; i++) {
+        tx_stream->send(&tx_buff.front(), tx_buff.size(), tx_md, 1.0);
+        while (tx_stream->recv_async_msg(async_md, 1.0)
+               and async_md.event_code != uhd::async_metadata_t::EVENT_CODE_BURST_ACK) {
+        }
+    }
+}
+
+/***********************************************************************
+ * Output
+ **********************************************************************/
+void print_histograms()
+{
+    const auto names = uhd::latency::get_histogram_names();
+    if (names.empty()) {
+        std::cout << "No latencies were recorded. To record latencies in libuhd, "
+                     "configure UHD with -DENABLE_LATENCY_HISTOGRAMS=ON.\n";
+        return;
+    }
+    const std::string row_fmt = "%-30s %9s %9s %9s %9s %9s %9s %9s %9s\n";
+    auto us = [](const double ns) { return str(boost::format("%.2f") % (ns / 1e3)); };
+    std::cout << boost::format(row_fmt) % "Latency [us]" % "count" % "min" % "mean"
+                     % "p50" % "p90" % "p99" % "p99.9" % "max";
+    for (const auto& name : names) {
+        const auto& hist = uhd::latency::get_histogram(name);
+        std::cout << boost::format(row_fmt) % name % hist.get_count()
+                         % us(hist.get_min()) % us(hist.get_mean())
+                         % us(hist.get_percentile(50)) % us(hist.get_percentile(90))
+                         % us(hist.get_percentile(99)) % us(hist.get_percentile(99.9))
+                         % us(hist.get_max());
+    }
+}
+
+int UHD_SAFE_MAIN(int argc, char* argv[])
+{
+    std::string args;
+    size_t iterations, spp;
+    double rate, ctrl_latency, ctrl_jitter;
+
+    // clang-format off
+    po::options_description desc("Allowed options");
+    desc.add_options()
+        ("help", "help message")
+        ("args", po::value<std::string>(&args), "device address args; if omitted, the mock transports are used")
+        ("iterations", po::value<size_t>(&iterations)->default_value(10000), "number of measurements per histogram")
+        ("spp", po::value<size_t>(&spp)->default_value(1000), "samples per packet (mock only)")
+        ("ctrl-latency", po::value<double>(&ctrl_latency)->default_value(0.0), "response latency of the control endpoint in seconds (mock only)")
+        ("ctrl-jitter", po::value<double>(&ctrl_jitter)->default_value(0.0), "random extra response latency of the control endpoint in seconds (mock only)")
+        ("rate", po::value<double>(&rate)->default_value(1e6), "sample rate (device only)")
+    ;
+    // clang-format on
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    po::notify(vm);
+
+    // Print the help message
+    if (vm.count("help")) {
+        std::cout << boost::format("UHD Latency Benchmark %s") % desc << std::endl;
+        std::cout
+            << "    Measures the latency distribution of control peeks, pokes, timed\n"
+               "    commands, the time from a stream command to the first sample,\n"
+               "    and the time from an end-of-burst to its burst ACK.\n"
+               "    Without --args, the mock transports are used, which measures\n"
+               "    the host overhead only, unless a control latency is given.\n"
+               "    With --args, libuhd must be built with\n"
+               "    -DENABLE_LATENCY_HISTOGRAMS=ON.\n"
+            << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    uhd::set_thread_priority_safe();
+
+    if (vm.count("args")) {
+        benchmark_device(args, iterations, rate);
+    } else {
+        benchmark_mock_ctrl(iterations, ctrl_latency, ctrl_jitter);
+        benchmark_mock_rx(iterations, spp);
+        benchmark_mock_tx(iterations, spp);
+    }
+
+    std::cout << std::endl;
+    print_histograms();
+
+    return EXIT_SUCCESS;
+}
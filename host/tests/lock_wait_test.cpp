@@ -0,0 +1,87 @@
+//
+// Copyright 2019 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include <uhdlib/utils/lock_wait.hpp>
+#include <boost/test/unit_test.hpp>
+#include <chrono>
+
+using namespace uhd;
+
+namespace {
+typedef std::chrono::steady_clock clock_type;
+
+double seconds_since(const clock_type::time_point start)
+{
+    return std::chrono::duration<double>(clock_type::now() - start).count();
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(test_lock_wait_locked)
+{
+    size_t num_polls = 0;
+    BOOST_CHECK(wait_for_lock("test::locked",
+        [&num_polls]() {
+            num_polls++;
+            return true;
+        },
+        1.0));
+    BOOST_CHECK_EQUAL(num_polls, 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_lock_wait_backoff)
+{
+    // A PLL which locks within 200 us is polled after 10, 30, 70, 150 and
+    // 310 us, and not only after the first millisecond
+    const auto start = clock_type::now();
+    size_t num_polls = 0;
+    BOOST_CHECK(wait_for_lock("test::backoff",
+        [start, &num_polls]() {
+            num_polls++;
+            return seconds_since(start) > 200e-6;
+        },
+        1.0));
+    BOOST_CHECK_LT(seconds_since(start), 0.1);
+    BOOST_CHECK_GE(num_polls, 2);
+}
+
+BOOST_AUTO_TEST_CASE(test_lock_wait_timeout)
+{
+    constexpr double timeout      = 0.05;
+    constexpr double max_interval = 0.01;
+    const auto start              = clock_type::now();
+    size_t num_polls              = 0;
+    BOOST_CHECK(not wait_for_lock("test::timeout",
+        [&num_polls]() {
+            num_polls++;
+            return false;
+        },
+        timeout,
+        max_interval));
+    BOOST_CHECK_GE(seconds_since(start), timeout);
+    // The interval stops growing at max_interval: The polls at 0, 10, 30, 70,
+    // ... 2550 us and 5.11 ms, then every 10 ms, and a last one at the timeout
+    BOOST_CHECK_GE(num_polls, 5);
+    BOOST_CHECK_LE(num_polls, 16);
+}
+
+BOOST_AUTO_TEST_CASE(test_lock_wait_settle)
+{
+    // A stale lock bit is not read before the settle time
+    constexpr double settle_time = 0.005;
+    const auto start             = clock_type::now();
+    double first_poll            = -1.0;
+    BOOST_CHECK(wait_for_lock("test::settle",
+        [start, &first_poll]() {
+            if (first_poll < 0.0) {
+                first_poll = seconds_since(start);
+            }
+            return true;
+        },
+        1.0,
+        LOCK_WAIT_MAX_INTERVAL,
+        settle_time));
+    BOOST_CHECK_GE(first_poll, settle_time);
+}
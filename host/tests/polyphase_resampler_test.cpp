@@ -0,0 +1,251 @@
+//
+// Copyright 2019 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include <uhd/exception.hpp>
+#include <uhdlib/dsp/host_rate_streamer.hpp>
+#include <uhdlib/dsp/polyphase_resampler.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/test/unit_test.hpp>
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <iostream>
+#include <vector>
+
+using namespace uhd;
+using namespace uhd::dsp;
+
+namespace {
+typedef std::complex<float> fc32_t;
+
+std::vector<fc32_t> make_tone(const size_t nsamps, const double freq)
+{
+    std::vector<fc32_t> tone(nsamps);
+    for (size_t i = 0; i < nsamps; i++) {
+        tone[i] = std::polar(1.0f, float(2.0 * M_PI * freq * i));
+    }
+    return tone;
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(test_rationalize)
+{
+    size_t interp, decim;
+    polyphase_resampler::rationalize(1.0, 512, interp, decim);
+    BOOST_CHECK_EQUAL(interp, 1);
+    BOOST_CHECK_EQUAL(decim, 1);
+    polyphase_resampler::rationalize(0.75, 512, interp, decim);
+    BOOST_CHECK_EQUAL(interp, 3);
+    BOOST_CHECK_EQUAL(decim, 4);
+    polyphase_resampler::rationalize(7.68e6 / 25e6, 512, interp, decim);
+    BOOST_CHECK_EQUAL(interp, 192);
+    BOOST_CHECK_EQUAL(decim, 625);
+    polyphase_resampler::rationalize(M_PI, 512, interp, decim);
+    BOOST_CHECK_LE(interp, 512);
+    BOOST_CHECK_CLOSE(double(interp) / decim, M_PI, 1e-3);
+    BOOST_CHECK_THROW(
+        polyphase_resampler::rationalize(0.0, 512, interp, decim), uhd::value_error);
+    BOOST_CHECK_THROW(polyphase_resampler::design_taps(1, 100), uhd::value_error);
+}
+
+BOOST_AUTO_TEST_CASE(test_resampler_alignment)
+{
+    // A slow tone must come out at the same phase it had at the corresponding
+    // input time, i.e., the filter delay is compensated
+    const double freq = 0.01;
+    for (const auto& ratio : std::vector<std::pair<size_t, size_t>>{
+             {1, 1}, {3, 4}, {4, 3}, {192, 625}, {5, 1}}) {
+        const size_t interp = ratio.first;
+        const size_t decim  = ratio.second;
+        polyphase_resampler resampler(
+            polyphase_resampler::design_taps(interp, decim), "fc32");
+        const std::vector<fc32_t> in = make_tone(10000, freq);
+        resampler.push(in.data(), in.size());
+        std::vector<fc32_t> out(resampler.get_num_available());
+        BOOST_REQUIRE_EQUAL(resampler.pull(out.data(), out.size()), out.size());
+        BOOST_CHECK_EQUAL(resampler.get_num_available(), 0);
+        BOOST_REQUIRE_GT(out.size(), 1000);
+
+        // Skip the start-up transient
+        for (size_t n = 200 * interp / decim + 100; n < out.size(); n++) {
+            const double t = double(n) * decim / interp;
+            const fc32_t expected = std::polar(1.0f, float(2.0 * M_PI * freq * t));
+            BOOST_REQUIRE_SMALL(std::abs(out[n] - expected), 1e-3f);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_resampler_flush_and_sc16)
+{
+    const size_t interp = 3;
+    const size_t decim  = 4;
+    auto taps           = polyphase_resampler::design_taps(interp, decim);
+    polyphase_resampler resampler(taps, "sc16");
+
+    // Push in odd chunks, pull in odd chunks
+    std::vector<int16_t> in(2 * 333);
+    for (size_t i = 0; i < in.size(); i += 2) {
+        in[i]     = 1000;
+        in[i + 1] = -2000;
+    }
+    std::vector<int16_t> out(2 * 1000);
+    size_t num_in = 0, num_out = 0;
+    for (size_t i = 0; i < 3; i++) {
+        resampler.push(in.data(), in.size() / 2);
+        num_in += in.size() / 2;
+        num_out += resampler.pull(&out[2 * num_out], 7);
+        num_out += resampler.pull(&out[2 * num_out], 1000 - num_out);
+    }
+    // Flushing yields one output for every input time up to the last input
+    resampler.push_zeros(taps->taps_per_phase);
+    num_out += resampler.pull(&out[2 * num_out], 1000 - num_out);
+    BOOST_CHECK_GE(num_out, (num_in * interp + decim - 1) / decim);
+
+    for (size_t n = 100; n < (num_in * interp / decim) - 100; n++) {
+        BOOST_CHECK_CLOSE(double(out[2 * n]), 1000.0, 0.1);
+        BOOST_CHECK_CLOSE(double(out[2 * n + 1]), -2000.0, 0.1);
+    }
+    BOOST_CHECK_THROW(polyphase_resampler(taps, "sc8"), uhd::value_error);
+}
+
+namespace {
+constexpr double DEVICE_RATE = 1e6;
+constexpr size_t DEVICE_SPP  = 100;
+
+//! Streamer that produces bursts of a tone, with timestamps
+class burst_rx_streamer : public rx_streamer
+{
+public:
+    burst_rx_streamer(const size_t burst_len) : _burst_len(burst_len) {}
+
+    size_t get_num_channels(void) const
+    {
+        return 2;
+    }
+
+    size_t get_max_num_samps(void) const
+    {
+        return DEVICE_SPP;
+    }
+
+    size_t recv(const buffs_type& buffs,
+        const size_t nsamps_per_buff,
+        rx_metadata_t& metadata,
+        const double,
+        const bool)
+    {
+        metadata.reset();
+        if (_burst_index == 2) {
+            metadata.error_code = rx_metadata_t::ERROR_CODE_TIMEOUT;
+            return 0;
+        }
+        const size_t nsamps = std::min(nsamps_per_buff, _burst_len - _offset);
+        for (size_t chan = 0; chan < buffs.size(); chan++) {
+            fc32_t* buff = static_cast<fc32_t*>(buffs[chan]);
+            for (size_t i = 0; i < nsamps; i++) {
+                buff[i] = fc32_t(1.0f, float(chan));
+            }
+        }
+        metadata.has_time_spec  = true;
+        metadata.time_spec      = get_burst_time(_burst_index)
+                             + time_spec_t::from_ticks(_offset, DEVICE_RATE);
+        metadata.start_of_burst = _offset == 0;
+        _offset += nsamps;
+        metadata.end_of_burst = _offset == _burst_len;
+        if (metadata.end_of_burst) {
+            _offset = 0;
+            _burst_index++;
+        }
+        return nsamps;
+    }
+
+    void issue_stream_cmd(const stream_cmd_t& stream_cmd)
+    {
+        last_num_samps = stream_cmd.num_samps;
+    }
+
+    static time_spec_t get_burst_time(const size_t burst_index)
+    {
+        return time_spec_t(1.5) + time_spec_t(double(burst_index));
+    }
+
+    size_t last_num_samps = 0;
+
+private:
+    const size_t _burst_len;
+    size_t _burst_index = 0;
+    size_t _offset      = 0;
+};
+} // namespace
+
+BOOST_AUTO_TEST_CASE(test_host_rate_rx_streamer)
+{
+    const double host_rate  = 768e3; // 96/125 of the device rate
+    const size_t burst_len  = 1234;
+    auto device_stream      = boost::make_shared<burst_rx_streamer>(burst_len);
+    rx_streamer::sptr stream = make_host_rate_rx_streamer(
+        device_stream, "fc32", DEVICE_RATE, host_rate);
+    BOOST_CHECK_EQUAL(stream->get_num_channels(), 2);
+    BOOST_CHECK_EQUAL(get_host_rate_actual(DEVICE_RATE, host_rate), host_rate);
+
+    stream_cmd_t stream_cmd(stream_cmd_t::STREAM_MODE_NUM_SAMPS_AND_DONE);
+    stream_cmd.num_samps = 96;
+    stream->issue_stream_cmd(stream_cmd);
+    BOOST_CHECK_EQUAL(device_stream->last_num_samps, 125);
+
+    std::vector<fc32_t> buff0(77), buff1(77);
+    std::vector<void*> buffs{buff0.data(), buff1.data()};
+    rx_metadata_t md;
+    for (size_t burst = 0; burst < 2; burst++) {
+        size_t num_out = 0;
+        do {
+            const size_t nsamps = stream->recv(buffs, buff0.size(), md, 0.1, false);
+            BOOST_REQUIRE_EQUAL(md.error_code, rx_metadata_t::ERROR_CODE_NONE);
+            BOOST_CHECK_EQUAL(md.start_of_burst, num_out == 0);
+            // Timestamps are exact across the rate change
+            BOOST_REQUIRE(md.has_time_spec);
+            BOOST_CHECK_EQUAL(md.time_spec.get_full_secs(),
+                (burst_rx_streamer::get_burst_time(burst)
+                    + time_spec_t::from_ticks(num_out, host_rate))
+                    .get_full_secs());
+            BOOST_CHECK_CLOSE_FRACTION(md.time_spec.get_frac_secs(),
+                (burst_rx_streamer::get_burst_time(burst)
+                    + time_spec_t::from_ticks(num_out, host_rate))
+                    .get_frac_secs(),
+                1e-12);
+            if (num_out > 100 and not md.end_of_burst) {
+                BOOST_CHECK_CLOSE(buff0[0].real(), 1.0f, 0.1);
+                BOOST_CHECK_CLOSE(buff1[0].imag(), 1.0f, 0.1);
+            }
+            num_out += nsamps;
+        } while (not md.end_of_burst);
+        BOOST_CHECK_EQUAL(num_out, (burst_len * 96 + 124) / 125);
+    }
+    stream->recv(buffs, buff0.size(), md, 0.1, false);
+    BOOST_CHECK_EQUAL(md.error_code, rx_metadata_t::ERROR_CODE_TIMEOUT);
+}
+
+BOOST_AUTO_TEST_CASE(test_resampler_throughput)
+{
+    // Not a pass/fail criterion, but useful when working on the kernel
+    const size_t interp = 192;
+    const size_t decim  = 625;
+    polyphase_resampler resampler(
+        polyphase_resampler::design_taps(interp, decim), "fc32");
+    const std::vector<fc32_t> in = make_tone(8192, 0.01);
+    std::vector<fc32_t> out(8192);
+    const auto start = std::chrono::steady_clock::now();
+    size_t num_in    = 0;
+    for (size_t i = 0; i < 500; i++) {
+        resampler.push(in.data(), in.size());
+        num_in += in.size();
+        resampler.pull(out.data(), out.size());
+    }
+    const double elapsed =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Resampled " << interp << "/" << decim << " at "
+              << (num_in / elapsed / 1e6) << " MS/s input rate" << std::endl;
+}
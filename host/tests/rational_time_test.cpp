@@ -0,0 +1,77 @@
+//
+// Copyright 2019 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include <uhdlib/utils/rational_time.hpp>
+#include <boost/test/unit_test.hpp>
+#include <cmath>
+
+using namespace uhd;
+
+BOOST_AUTO_TEST_CASE(test_rational_time_integer_decimation)
+{
+    const double tick_rate = 200e6;
+    rational_time_model model(tick_rate, tick_rate / 7);
+    BOOST_CHECK(model.is_exact());
+    BOOST_CHECK_EQUAL(model.get_ticks_per_samp_num(), 7);
+    BOOST_CHECK_EQUAL(model.get_ticks_per_samp_den(), 1);
+    BOOST_CHECK_EQUAL(model.samps_to_ticks(1000), 7000);
+    BOOST_CHECK_EQUAL(model.ticks_to_samps(7006), 1000);
+
+    // Tick counts map onto full and fractional seconds
+    const time_spec_t time = model.ticks_to_time(int64_t(tick_rate) * 5 + 3);
+    BOOST_CHECK_EQUAL(time.get_full_secs(), 5);
+    BOOST_CHECK_CLOSE(time.get_frac_secs(), 3 / tick_rate, 1e-9);
+    BOOST_CHECK_EQUAL(model.time_to_ticks(time), int64_t(tick_rate) * 5 + 3);
+}
+
+BOOST_AUTO_TEST_CASE(test_rational_time_fractional_decimation)
+{
+    // 2.5 ticks per sample: the denominator is a power of two
+    rational_time_model model(184.32e6, 184.32e6 / 2.5);
+    BOOST_CHECK(model.is_exact());
+    BOOST_CHECK_EQUAL(model.get_ticks_per_samp_num(), 5);
+    BOOST_CHECK_EQUAL(model.get_ticks_per_samp_den(), 2);
+    BOOST_CHECK_EQUAL(model.samps_to_ticks(2), 5);
+    BOOST_CHECK_EQUAL(model.samps_to_ticks(3), 8);
+    BOOST_CHECK_EQUAL(model.ticks_to_samps(8), 3);
+
+    // 10/3 ticks per sample
+    model.set_rates(200e6, 60e6);
+    BOOST_CHECK(model.is_exact());
+    BOOST_CHECK_EQUAL(model.get_ticks_per_samp_num(), 10);
+    BOOST_CHECK_EQUAL(model.get_ticks_per_samp_den(), 3);
+
+    // No drift over long streams: compare against integer arithmetic
+    for (int64_t nsamps = 1; nsamps < (int64_t(1) << 50); nsamps = nsamps * 3 + 1) {
+        BOOST_CHECK_EQUAL(model.samps_to_ticks(nsamps), (nsamps * 10 + 1) / 3);
+        const int64_t ticks = nsamps * 10 / 3;
+        BOOST_CHECK_EQUAL(model.ticks_to_samps(ticks), ticks * 3 / 10);
+
+        const time_spec_t time = model.samps_to_time(nsamps);
+        BOOST_CHECK_EQUAL(time.get_full_secs(), nsamps / int64_t(60e6));
+        const double frac = double(nsamps % int64_t(60e6)) / 60e6;
+        BOOST_CHECK_SMALL(time.get_frac_secs() - frac, 1e-12);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_rational_time_fallback)
+{
+    // Fractional tick rates and irrational ratios use the double conversions
+    rational_time_model model(100.5, 10.0);
+    BOOST_CHECK(not model.is_exact());
+    BOOST_CHECK_EQUAL(model.samps_to_ticks(20), 201);
+    BOOST_CHECK_EQUAL(model.time_to_ticks(time_spec_t(2.0)), 201);
+
+    model.set_rates(200e6, 200e6 / M_PI);
+    BOOST_CHECK(not model.is_exact());
+    BOOST_CHECK_EQUAL(model.samps_to_ticks(1000), 3142);
+
+    // Sample rates above the tick rate are fine, as long as the ratio is exact
+    model.set_rates(1.0, 1e6);
+    BOOST_CHECK(model.is_exact());
+    BOOST_CHECK_EQUAL(model.get_ticks_per_samp_den(), 1000000);
+    BOOST_CHECK_EQUAL(model.samps_to_ticks(2500000), 3);
+}
@@ -0,0 +1,145 @@
+//
+// Copyright 2019 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include <uhd/exception.hpp>
+#include <uhd/rx_sample_ring.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/test/unit_test.hpp>
+#include <cstring>
+
+using namespace uhd;
+
+namespace {
+constexpr size_t SPP         = 100;
+constexpr double SAMP_RATE   = 1e6;
+constexpr double START_TIME  = 10.0;
+constexpr size_t CPU_ITEM_SZ = sizeof(uint32_t);
+
+//! Streamer that returns a counter as samples ("s32" items), one packet at a time
+class ramp_rx_streamer : public rx_streamer
+{
+public:
+    size_t get_num_channels(void) const
+    {
+        return 2;
+    }
+
+    size_t get_max_num_samps(void) const
+    {
+        return SPP;
+    }
+
+    size_t recv(const buffs_type& buffs,
+        const size_t nsamps_per_buff,
+        rx_metadata_t& metadata,
+        const double,
+        const bool)
+    {
+        const size_t nsamps = std::min(nsamps_per_buff, SPP);
+        for (size_t chan = 0; chan < buffs.size(); chan++) {
+            uint32_t* buff = static_cast<uint32_t*>(buffs[chan]);
+            for (size_t i = 0; i < nsamps; i++) {
+                buff[i] = uint32_t(_counter + i + chan * 1000000);
+            }
+        }
+        metadata.reset();
+        metadata.has_time_spec = true;
+        metadata.time_spec =
+            time_spec_t(START_TIME) + time_spec_t::from_ticks(_counter, SAMP_RATE);
+        _counter += nsamps;
+        return nsamps;
+    }
+
+    void issue_stream_cmd(const stream_cmd_t&) {}
+
+private:
+    uint64_t _counter = 0;
+};
+
+rx_sample_ring::sptr make_ring(const size_t capacity)
+{
+    try {
+        return rx_sample_ring::make(
+            boost::make_shared<ramp_rx_streamer>(), "s32", capacity, SAMP_RATE);
+    } catch (const uhd::not_implemented_error&) {
+        return rx_sample_ring::sptr();
+    }
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(test_rx_sample_ring_wrap)
+{
+    auto ring = make_ring(1);
+    if (not ring) {
+        BOOST_TEST_MESSAGE("Sample rings not supported on this platform, skipping");
+        return;
+    }
+    const size_t capacity = ring->get_capacity();
+    BOOST_REQUIRE_GE(capacity, SPP);
+    BOOST_CHECK_EQUAL(capacity * CPU_ITEM_SZ % 4096, 0);
+    BOOST_CHECK_EQUAL(ring->get_num_channels(), 2);
+
+    // Fill the ring more than twice, so windows wrap around
+    rx_metadata_t md;
+    while (ring->get_write_index() < 2 * capacity + SPP / 2) {
+        BOOST_CHECK_EQUAL(ring->recv(md), SPP);
+    }
+    const uint64_t write_index = ring->get_write_index();
+    BOOST_CHECK_EQUAL(ring->get_oldest_index(), write_index - capacity);
+
+    // A full-capacity window is contiguous, even across the wrap-around point
+    rx_sample_ring::window_t window;
+    BOOST_REQUIRE_EQUAL(
+        ring->get_window(ring->get_oldest_index(), capacity, window),
+        rx_sample_ring::READ_OK);
+    for (size_t chan = 0; chan < 2; chan++) {
+        const uint32_t* samps = static_cast<const uint32_t*>(window.buffs[chan]);
+        for (size_t i = 0; i < capacity; i++) {
+            BOOST_REQUIRE_EQUAL(samps[i], window.start_index + i + chan * 1000000);
+        }
+    }
+    BOOST_CHECK(window.has_time_spec);
+    BOOST_CHECK_EQUAL(window.time_spec.to_ticks(SAMP_RATE),
+        time_spec_t(START_TIME).to_ticks(SAMP_RATE) + window.start_index);
+    BOOST_CHECK(not ring->is_overwritten(window));
+
+    // Falling behind is reported
+    ring->recv(md);
+    BOOST_CHECK(ring->is_overwritten(window));
+    BOOST_CHECK_EQUAL(ring->get_window(window.start_index, 1, window),
+        rx_sample_ring::READ_OVERWRITTEN);
+    BOOST_CHECK_EQUAL(ring->get_window(ring->get_write_index(), 1, window),
+        rx_sample_ring::READ_NOT_AVAILABLE);
+    BOOST_CHECK_THROW(ring->get_window(0, capacity + 1, window), uhd::value_error);
+}
+
+BOOST_AUTO_TEST_CASE(test_rx_sample_ring_time)
+{
+    auto ring = make_ring(10 * SPP);
+    if (not ring) {
+        return;
+    }
+    rx_metadata_t md;
+    rx_sample_ring::window_t window;
+    BOOST_CHECK_EQUAL(ring->get_window(time_spec_t(START_TIME), 1, window),
+        rx_sample_ring::READ_NOT_AVAILABLE);
+    for (size_t i = 0; i < 5; i++) {
+        ring->recv(md);
+    }
+
+    const uint64_t index = 3 * SPP + 17;
+    const time_spec_t time_spec = ring->get_time_spec(index);
+    BOOST_CHECK_EQUAL(time_spec.to_ticks(SAMP_RATE),
+        time_spec_t(START_TIME).to_ticks(SAMP_RATE) + index);
+    BOOST_REQUIRE_EQUAL(
+        ring->get_window(time_spec, 10, window), rx_sample_ring::READ_OK);
+    BOOST_CHECK_EQUAL(window.start_index, index);
+    BOOST_CHECK_EQUAL(static_cast<const uint32_t*>(window.buffs[0])[0], index);
+
+    BOOST_CHECK_EQUAL(ring->get_window(time_spec_t(START_TIME - 1.0), 1, window),
+        rx_sample_ring::READ_OVERWRITTEN);
+    BOOST_CHECK_THROW(ring->get_time_spec(ring->get_write_index()), uhd::value_error);
+}
@@ -0,0 +1,142 @@
+//
+// Copyright 2019 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include <uhd/exception.hpp>
+#include <uhd/usrp/session.hpp>
+#include <boost/asio.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <thread>
+
+using namespace uhd;
+using namespace uhd::usrp;
+namespace fs = boost::filesystem;
+
+namespace {
+std::string make_socket_path(void)
+{
+    return (fs::temp_directory_path() / fs::unique_path("uhd_session_%%%%%%%%.sock"))
+        .string();
+}
+
+//! Echoes the method and its arguments, and fails the method "fail"
+std::string echo_handler(const std::string& method, const device_addr_t& args)
+{
+    if (method == "fail") {
+        throw uhd::value_error("failed\nas requested");
+    }
+    return method + ":" + args.to_string();
+}
+
+void wait_for_clients(session_server::sptr server, const size_t num_clients)
+{
+    for (int i = 0; i < 100 and server->get_num_clients() != num_clients; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(test_session_calls)
+{
+    const std::string socket_path = make_socket_path();
+    session_server::sptr server   = session_server::make(&echo_handler, socket_path);
+    BOOST_CHECK(fs::exists(socket_path));
+
+    session_client::sptr client = session_client::make(socket_path);
+    BOOST_CHECK_EQUAL(client->call("get_pp_string"), "get_pp_string:");
+    BOOST_CHECK_EQUAL(client->call("set_rx_freq", device_addr_t("freq=1e9,chan=1")),
+        "set_rx_freq:" + device_addr_t("freq=1e9,chan=1").to_string());
+    // Values may contain the separators of device_addr_t
+    device_addr_t args;
+    args["args"] = "spp=200,fullscale=1.0";
+    BOOST_CHECK_EQUAL(client->call("echo", args), "echo:" + args.to_string());
+
+    // Errors are passed on, and the connection stays usable
+    BOOST_CHECK_THROW(client->call("fail"), uhd::runtime_error);
+    try {
+        client->call("fail");
+    } catch (const uhd::runtime_error& ex) {
+        BOOST_CHECK(std::string(ex.what()).find("failed as requested")
+                    != std::string::npos);
+    }
+    BOOST_CHECK_EQUAL(client->call("get_pp_string"), "get_pp_string:");
+
+    // Requests which can't be encoded are rejected by the client
+    args["bad"] = "line\nbreak";
+    BOOST_CHECK_THROW(client->call("echo", args), uhd::value_error);
+    BOOST_CHECK_THROW(client->call(""), uhd::value_error);
+
+    server.reset();
+    BOOST_CHECK(not fs::exists(socket_path));
+    BOOST_CHECK_THROW(client->call("get_pp_string"), uhd::io_error);
+    BOOST_CHECK_THROW(session_client::make(socket_path), uhd::io_error);
+}
+
+BOOST_AUTO_TEST_CASE(test_session_clients)
+{
+    const std::string socket_path = make_socket_path();
+    session_server::sptr server   = session_server::make(&echo_handler, socket_path);
+
+    session_client::sptr client0 = session_client::make(socket_path);
+    {
+        session_client::sptr client1 = session_client::make(socket_path);
+        wait_for_clients(server, 2);
+        BOOST_CHECK_EQUAL(server->get_num_clients(), 2);
+
+        // Calls from several threads and clients don't get mixed up
+        std::atomic<size_t> num_mismatches{0};
+        auto run_calls = [&](session_client::sptr client, const std::string& method) {
+            for (int i = 0; i < 100; i++) {
+                const device_addr_t arg("i=" + std::to_string(i));
+                if (client->call(method, arg) != method + ":" + arg.to_string()) {
+                    num_mismatches++;
+                }
+            }
+        };
+        std::thread thread0(run_calls, client0, "a");
+        std::thread thread1(run_calls, client0, "b");
+        std::thread thread2(run_calls, client1, "c");
+        thread0.join();
+        thread1.join();
+        thread2.join();
+        BOOST_CHECK_EQUAL(num_mismatches, 0);
+    }
+    wait_for_clients(server, 1);
+    BOOST_CHECK_EQUAL(server->get_num_clients(), 1);
+
+}
+
+BOOST_AUTO_TEST_CASE(test_session_socket_in_use)
+{
+    const std::string socket_path = make_socket_path();
+    session_server::sptr server   = session_server::make(&echo_handler, socket_path);
+
+    // A second server doesn't take over the socket of a live one
+    BOOST_CHECK_THROW(session_server::make(&echo_handler, socket_path), uhd::os_error);
+    BOOST_CHECK_EQUAL(session_client::make(socket_path)->call("x"), "x:");
+
+    // A new server replaces a stale socket
+    server.reset();
+    {
+        boost::asio::io_service io_service;
+        boost::asio::local::stream_protocol::acceptor acceptor(io_service,
+            boost::asio::local::stream_protocol::endpoint(socket_path));
+    }
+    BOOST_REQUIRE(fs::exists(socket_path));
+    server = session_server::make(&echo_handler, socket_path);
+    BOOST_CHECK_EQUAL(session_client::make(socket_path)->call("x"), "x:");
+    server.reset();
+
+    // Files which aren't sockets are left alone
+    std::ofstream(socket_path.c_str()) << "not a socket";
+    BOOST_CHECK_THROW(session_server::make(&echo_handler, socket_path), uhd::os_error);
+    BOOST_CHECK(fs::exists(socket_path));
+    fs::remove(socket_path);
+}
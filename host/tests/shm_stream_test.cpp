@@ -0,0 +1,273 @@
+//
+// Copyright 2019 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include <uhd/exception.hpp>
+#include <uhd/shm_stream.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/test/unit_test.hpp>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace uhd;
+
+namespace {
+constexpr size_t NUM_CHANS  = 2;
+constexpr size_t SPP        = 100;
+constexpr double SAMP_RATE  = 1e6;
+constexpr double START_TIME = 10.0;
+
+//! A segment name which is not used by any other test run
+std::string make_name(const std::string& prefix)
+{
+    return prefix + "_"
+           + std::to_string(
+                 std::chrono::steady_clock::now().time_since_epoch().count());
+}
+
+//! Streamer that returns a counter as samples ("s32" items), one packet at a time
+class ramp_rx_streamer : public rx_streamer
+{
+public:
+    size_t get_num_channels(void) const
+    {
+        return NUM_CHANS;
+    }
+
+    size_t get_max_num_samps(void) const
+    {
+        return SPP;
+    }
+
+    size_t recv(const buffs_type& buffs,
+        const size_t nsamps_per_buff,
+        rx_metadata_t& metadata,
+        const double,
+        const bool)
+    {
+        metadata.reset();
+        if (overflow) {
+            overflow            = false;
+            metadata.error_code = rx_metadata_t::ERROR_CODE_OVERFLOW;
+            return 0;
+        }
+        const size_t nsamps = std::min(nsamps_per_buff, SPP);
+        for (size_t chan = 0; chan < buffs.size(); chan++) {
+            uint32_t* buff = static_cast<uint32_t*>(buffs[chan]);
+            for (size_t i = 0; i < nsamps; i++) {
+                buff[i] = uint32_t(counter + i + chan * 1000000);
+            }
+        }
+        metadata.has_time_spec  = true;
+        metadata.start_of_burst = counter == 0;
+        metadata.time_spec =
+            time_spec_t(START_TIME) + time_spec_t::from_ticks(counter, SAMP_RATE);
+        counter += nsamps;
+        return nsamps;
+    }
+
+    void issue_stream_cmd(const stream_cmd_t&) {}
+
+    uint64_t counter = 0;
+    bool overflow    = false;
+};
+
+//! Streamer that records everything which is sent
+class capture_tx_streamer : public tx_streamer
+{
+public:
+    size_t get_num_channels(void) const
+    {
+        return NUM_CHANS;
+    }
+
+    size_t get_max_num_samps(void) const
+    {
+        return SPP;
+    }
+
+    size_t send(const buffs_type& buffs,
+        const size_t nsamps_per_buff,
+        const tx_metadata_t& metadata,
+        const double)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (size_t chan = 0; chan < buffs.size(); chan++) {
+            const uint32_t* buff = static_cast<const uint32_t*>(buffs[chan]);
+            samps[chan].insert(samps[chan].end(), buff, buff + nsamps_per_buff);
+        }
+        metadatas.push_back(metadata);
+        return nsamps_per_buff;
+    }
+
+    bool recv_async_msg(async_metadata_t&, double)
+    {
+        return false;
+    }
+
+    size_t get_num_samps(void)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return samps[0].size();
+    }
+
+    std::mutex mutex;
+    std::vector<uint32_t> samps[NUM_CHANS];
+    std::vector<tx_metadata_t> metadatas;
+};
+} // namespace
+
+BOOST_AUTO_TEST_CASE(test_shm_rx_stream)
+{
+    const std::string name = make_name("uhd_shm_rx_test");
+    auto rx_stream         = boost::make_shared<ramp_rx_streamer>();
+    shm_rx_source::sptr source =
+        shm_rx_source::make(rx_stream, "s32", name, 1000, SAMP_RATE);
+
+    // Clients start with the packets received after they attached
+    rx_metadata_t md;
+    BOOST_CHECK_EQUAL(source->recv(md), SPP);
+    shm_rx_client::sptr client = shm_rx_client::make(name);
+    BOOST_CHECK_EQUAL(client->get_num_channels(), NUM_CHANS);
+    BOOST_CHECK_EQUAL(client->get_cpu_format(), "s32");
+    for (size_t i = 0; i < 5; i++) {
+        BOOST_CHECK_EQUAL(source->recv(md), SPP);
+    }
+
+    // Packets can be read in fragments
+    std::vector<uint32_t> buff0(60), buff1(60);
+    std::vector<void*> buffs = {buff0.data(), buff1.data()};
+    uint64_t counter         = SPP;
+    for (size_t i = 0; i < 10; i++) {
+        const size_t nsamps = client->recv(buffs, buff0.size(), md, 0.0);
+        BOOST_REQUIRE_EQUAL(md.error_code, rx_metadata_t::ERROR_CODE_NONE);
+        BOOST_REQUIRE_EQUAL(nsamps, i % 2 ? 40 : 60);
+        BOOST_CHECK_EQUAL(md.more_fragments, i % 2 == 0);
+        BOOST_CHECK_EQUAL(md.fragment_offset, i % 2 ? 60 : 0);
+        BOOST_CHECK(md.has_time_spec);
+        BOOST_CHECK_EQUAL(md.time_spec.to_ticks(SAMP_RATE),
+            (time_spec_t(START_TIME) + time_spec_t::from_ticks(counter, SAMP_RATE))
+                .to_ticks(SAMP_RATE));
+        for (size_t n = 0; n < nsamps; n++) {
+            BOOST_CHECK_EQUAL(buff0[n], counter + n);
+            BOOST_CHECK_EQUAL(buff1[n], counter + n + 1000000);
+        }
+        counter += nsamps;
+    }
+    client->recv(buffs, buff0.size(), md, 0.01);
+    BOOST_CHECK_EQUAL(md.error_code, rx_metadata_t::ERROR_CODE_TIMEOUT);
+
+    // Errors of the streamer are passed on
+    rx_stream->overflow = true;
+    BOOST_CHECK_EQUAL(source->recv(md), 0);
+    BOOST_CHECK_EQUAL(client->recv(buffs, buff0.size(), md, 0.0), 0);
+    BOOST_CHECK_EQUAL(md.error_code, rx_metadata_t::ERROR_CODE_OVERFLOW);
+
+    // A client which falls behind by more than the capacity gets an overflow,
+    // then continues with new packets
+    for (size_t i = 0; i < 20; i++) {
+        source->recv(md);
+    }
+    BOOST_CHECK_EQUAL(client->recv(buffs, buff0.size(), md, 0.0), 0);
+    BOOST_CHECK_EQUAL(md.error_code, rx_metadata_t::ERROR_CODE_OVERFLOW);
+    counter = rx_stream->counter;
+    source->recv(md);
+    BOOST_CHECK_EQUAL(client->recv(buffs, buff0.size(), md, 0.0), 60);
+    BOOST_CHECK_EQUAL(md.error_code, rx_metadata_t::ERROR_CODE_NONE);
+    BOOST_CHECK_EQUAL(buff0[0], counter);
+}
+
+BOOST_AUTO_TEST_CASE(test_shm_tx_stream)
+{
+    const std::string name     = make_name("uhd_shm_tx_test");
+    auto tx_stream             = boost::make_shared<capture_tx_streamer>();
+    shm_tx_sink::sptr sink     = shm_tx_sink::make(tx_stream, "s32", name, 1000);
+    shm_tx_client::sptr client = shm_tx_client::make(name);
+    BOOST_CHECK_EQUAL(client->get_num_channels(), NUM_CHANS);
+
+    const size_t num_samps = 20000;
+    std::thread sink_thread([&]() {
+        while (tx_stream->get_num_samps() < num_samps) {
+            sink->send(0.1);
+        }
+    });
+
+    // Send a burst in buffers of varying size, which are larger than the ring
+    // at times
+    std::vector<uint32_t> buff0(1700), buff1(1700);
+    const std::vector<const void*> buffs = {buff0.data(), buff1.data()};
+    tx_metadata_t md;
+    md.start_of_burst = true;
+    md.has_time_spec  = true;
+    md.time_spec      = time_spec_t(START_TIME);
+    size_t counter    = 0;
+    for (size_t i = 0; counter < num_samps; i++) {
+        const size_t nsamps = std::min((i * 397) % buff0.size(), num_samps - counter);
+        for (size_t n = 0; n < nsamps; n++) {
+            buff0[n] = uint32_t(counter + n);
+            buff1[n] = uint32_t(counter + n + 1000000);
+        }
+        md.end_of_burst = counter + nsamps == num_samps;
+        BOOST_REQUIRE_EQUAL(client->send(buffs, nsamps, md, 1.0), nsamps);
+        md.start_of_burst = false;
+        md.has_time_spec  = false;
+        counter += nsamps;
+    }
+    sink_thread.join();
+
+    BOOST_REQUIRE_EQUAL(tx_stream->samps[0].size(), num_samps);
+    for (size_t n = 0; n < num_samps; n++) {
+        BOOST_CHECK_EQUAL(tx_stream->samps[0][n], n);
+        BOOST_CHECK_EQUAL(tx_stream->samps[1][n], n + 1000000);
+    }
+    const std::vector<tx_metadata_t>& metadatas = tx_stream->metadatas;
+    for (size_t i = 0; i < metadatas.size(); i++) {
+        BOOST_CHECK_EQUAL(metadatas[i].start_of_burst, i == 0);
+        BOOST_CHECK_EQUAL(metadatas[i].has_time_spec, i == 0);
+        BOOST_CHECK_EQUAL(metadatas[i].end_of_burst, i == metadatas.size() - 1);
+    }
+    BOOST_CHECK_EQUAL(metadatas.front().time_spec.get_real_secs(), START_TIME);
+
+    // Without a sink sending, the client times out once the ring is full
+    std::vector<uint32_t> large_buff0(2000), large_buff1(2000);
+    md.end_of_burst = false;
+    const size_t nsamps =
+        client->send(std::vector<const void*>{large_buff0.data(), large_buff1.data()},
+            large_buff0.size(),
+            md,
+            0.01);
+    BOOST_CHECK_GT(nsamps, 0);
+    BOOST_CHECK_LT(nsamps, large_buff0.size());
+}
+
+BOOST_AUTO_TEST_CASE(test_shm_stream_errors)
+{
+    const std::string name = make_name("uhd_shm_error_test");
+    BOOST_CHECK_THROW(shm_rx_client::make(name), uhd::lookup_error);
+    BOOST_CHECK_THROW(shm_tx_client::make(name), uhd::lookup_error);
+    BOOST_CHECK_THROW(shm_rx_client::make("uhd/shm"), uhd::value_error);
+
+    auto rx_stream = boost::make_shared<ramp_rx_streamer>();
+    BOOST_CHECK_THROW(shm_rx_source::make(rx_stream, "s32", name, SPP - 1, SAMP_RATE),
+        uhd::value_error);
+    BOOST_CHECK_THROW(
+        shm_rx_source::make(rx_stream, "s32", name, SPP, 0.0), uhd::value_error);
+
+    // Clients must attach to a segment of the right direction
+    shm_rx_source::sptr source =
+        shm_rx_source::make(rx_stream, "s32", name, SPP, SAMP_RATE);
+    BOOST_CHECK_THROW(shm_tx_client::make(name), uhd::lookup_error);
+    shm_rx_client::sptr client = shm_rx_client::make(name);
+    std::vector<uint32_t> buff(SPP);
+    rx_metadata_t md;
+    BOOST_CHECK_THROW(client->recv(buff.data(), buff.size(), md), uhd::value_error);
+
+    // The segment is removed with its source
+    source.reset();
+    BOOST_CHECK_THROW(shm_rx_client::make(name), uhd::lookup_error);
+}
@@ -0,0 +1,218 @@
+//
+// Copyright 2019 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include <uhd/exception.hpp>
+#include <uhd/utils/signal_generator.hpp>
+#include <boost/test/unit_test.hpp>
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace uhd;
+
+namespace {
+typedef std::complex<float> fc32_t;
+typedef std::complex<int16_t> sc16_t;
+
+//! Generate in chunks of varying size, to cover the ends of the SIMD loops
+std::vector<fc32_t> generate_chunked(
+    signal_generator::sptr generator, const size_t nsamps)
+{
+    std::vector<fc32_t> buff(nsamps);
+    size_t offset = 0;
+    for (size_t chunk = 1; offset < nsamps; chunk = (chunk * 7 + 3) % 1500) {
+        const size_t count = std::min(chunk, nsamps - offset);
+        generator->generate(buff.data() + offset, count);
+        offset += count;
+    }
+    return buff;
+}
+
+void check_phase(const fc32_t samp, const double phase, const double ampl)
+{
+    const std::complex<double> expected = std::polar(ampl, 2.0 * M_PI * phase);
+    BOOST_CHECK_SMALL(std::abs(std::complex<double>(samp) - expected), 1e-4 * ampl);
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(test_const)
+{
+    signal_generator::sptr generator = signal_generator::make_const(fc32_t(0.5f, -2.0f));
+    std::vector<sc16_t> buff(300);
+    generator->generate(buff.data(), buff.size());
+    for (const sc16_t samp : buff) {
+        // Clipped to full scale
+        BOOST_CHECK_EQUAL(samp.real(), 16384);
+        BOOST_CHECK_EQUAL(samp.imag(), -32768);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_tone)
+{
+    const double rate  = 10e6;
+    const double freq  = -1.234567e6;
+    const float ampl   = 0.7f;
+    const size_t count = 100000;
+    const std::vector<fc32_t> samps =
+        generate_chunked(signal_generator::make_tone(rate, freq, ampl), count);
+    for (size_t n = 0; n < count; n++) {
+        const double cycles = freq * n / rate;
+        check_phase(samps[n], cycles - std::floor(cycles), ampl);
+    }
+
+    // The sc16 samples are the scaled fc32 samples
+    signal_generator::sptr generator = signal_generator::make_tone(rate, freq, ampl);
+    std::vector<sc16_t> samps_sc16(count);
+    generator->generate(samps_sc16.data(), count);
+    for (size_t n = 0; n < count; n++) {
+        BOOST_CHECK_SMALL(samps_sc16[n].real() - samps[n].real() * 32767.0f, 1.5f);
+        BOOST_CHECK_SMALL(samps_sc16[n].imag() - samps[n].imag() * 32767.0f, 1.5f);
+    }
+
+    BOOST_CHECK_THROW(signal_generator::make_tone(0.0, freq, ampl), uhd::value_error);
+}
+
+BOOST_AUTO_TEST_CASE(test_multi_tone)
+{
+    const double rate               = 1e6;
+    const std::vector<double> freqs = {-200e3, 1e3, 123.4e3, 300e3};
+    const float ampl                = 0.8f;
+    const size_t count              = 20000;
+    const std::vector<fc32_t> samps =
+        generate_chunked(signal_generator::make_multi_tone(rate, freqs, ampl), count);
+    for (size_t n = 0; n < count; n += 7) {
+        std::complex<double> expected(0.0, 0.0);
+        for (size_t k = 0; k < freqs.size(); k++) {
+            const double cycles =
+                std::fmod(freqs[k] * n / rate, 1.0) + double(k * k) / (2 * freqs.size());
+            expected += std::polar(double(ampl) / freqs.size(), 2.0 * M_PI * cycles);
+        }
+        BOOST_CHECK_SMALL(std::abs(std::complex<double>(samps[n]) - expected), 1e-4);
+    }
+
+    BOOST_CHECK_THROW(
+        signal_generator::make_multi_tone(rate, {}, ampl), uhd::value_error);
+}
+
+BOOST_AUTO_TEST_CASE(test_chirp)
+{
+    const double rate       = 1e6;
+    const double start_freq = -100e3;
+    const double stop_freq  = 250e3;
+    const double sweep_time = 5e-3;
+    const size_t sweep_len  = 5000;
+    const std::vector<fc32_t> samps = generate_chunked(
+        signal_generator::make_chirp(rate, start_freq, stop_freq, sweep_time, 1.0f),
+        2 * sweep_len + 100);
+
+    // The phase of sample n is the sum of the frequencies before it
+    const double freq_step = (stop_freq - start_freq) / sweep_len;
+    double cycles          = 0.0;
+    for (size_t n = 0; n < samps.size(); n++) {
+        check_phase(samps[n], cycles, 1.0);
+        const double freq = start_freq + freq_step * (n % sweep_len);
+        cycles            = std::fmod(cycles + freq / rate, 1.0);
+    }
+
+    BOOST_CHECK_THROW(
+        signal_generator::make_chirp(rate, start_freq, stop_freq, 1e-6, 1.0f),
+        uhd::value_error);
+}
+
+BOOST_AUTO_TEST_CASE(test_prbs)
+{
+    const size_t count = 5000;
+    // The orders and taps of the polynomials of ITU-T O.150
+    const std::vector<std::pair<size_t, size_t>> polynomials = {
+        {7, 6}, {9, 5}, {11, 9}, {15, 14}, {20, 3}, {23, 18}, {31, 28}};
+    for (const auto& polynomial : polynomials) {
+        const size_t order = polynomial.first;
+        const size_t tap   = polynomial.second;
+        const std::vector<fc32_t> samps =
+            generate_chunked(signal_generator::make_prbs(order, 1.0f), count);
+        // Compare against a serial implementation of the register
+        const uint64_t mask = (uint64_t(1) << order) - 1;
+        uint64_t state      = mask;
+        auto next_bit       = [&]() {
+            const uint64_t bit = ((state >> (order - 1)) ^ (state >> (tap - 1))) & 1;
+            state              = ((state << 1) | bit) & mask;
+            return bit;
+        };
+        const float a = float(1.0 / std::sqrt(2.0));
+        for (size_t n = 0; n < count; n++) {
+            const float real = next_bit() ? a : -a;
+            const float imag = next_bit() ? a : -a;
+            BOOST_REQUIRE_EQUAL(samps[n], fc32_t(real, imag));
+        }
+    }
+
+    // PRBS7 repeats after 127 samples (254 bits), with 64 ones per 127 bits
+    const std::vector<fc32_t> samps =
+        generate_chunked(signal_generator::make_prbs(7, 1.0f), 3 * 127);
+    size_t num_ones = 0;
+    for (size_t n = 0; n < 127; n++) {
+        BOOST_CHECK_EQUAL(samps[n], samps[n + 127]);
+        BOOST_CHECK_EQUAL(samps[n], samps[n + 254]);
+        num_ones += (samps[n].real() > 0) + (samps[n].imag() > 0);
+    }
+    BOOST_CHECK_EQUAL(num_ones, 128);
+
+    BOOST_CHECK_THROW(signal_generator::make_prbs(8, 1.0f), uhd::value_error);
+}
+
+BOOST_AUTO_TEST_CASE(test_noise)
+{
+    const float ampl   = 0.1f;
+    const size_t count = 1000000;
+    const std::vector<fc32_t> samps =
+        generate_chunked(signal_generator::make_noise(ampl, 42), count);
+    double power = 0.0;
+    std::complex<double> mean(0.0, 0.0);
+    for (const fc32_t samp : samps) {
+        power += std::norm(samp);
+        mean += std::complex<double>(samp);
+        BOOST_CHECK_LE(std::abs(samp.real()), 2.45f * ampl);
+        BOOST_CHECK_LE(std::abs(samp.imag()), 2.45f * ampl);
+    }
+    BOOST_CHECK_CLOSE(std::sqrt(power / count), ampl, 1.0);
+    BOOST_CHECK_SMALL(std::abs(mean / double(count)), 1e-3);
+
+    // The same seed gives the same samples, regardless of the chunk sizes
+    signal_generator::sptr generator = signal_generator::make_noise(ampl, 42);
+    std::vector<fc32_t> again(count);
+    generator->generate(again.data(), count);
+    BOOST_CHECK(again == samps);
+    signal_generator::make_noise(ampl, 43)->generate(again.data(), count);
+    BOOST_CHECK(again != samps);
+}
+
+BOOST_AUTO_TEST_CASE(test_signal_generator_throughput)
+{
+    // Not a pass/fail criterion, but useful when working on the kernels
+    const size_t count          = 10000;
+    const size_t num_iterations = 1000;
+    std::vector<fc32_t> buff(count);
+    const std::vector<std::pair<std::string, signal_generator::sptr>> generators = {
+        {"tone", signal_generator::make_tone(1e6, 1e3, 1.0f)},
+        {"chirp", signal_generator::make_chirp(1e6, -1e3, 1e3, 1.0, 1.0f)},
+        {"prbs", signal_generator::make_prbs(23, 1.0f)},
+        {"noise", signal_generator::make_noise(1.0f)}};
+    for (const auto& generator : generators) {
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < num_iterations; i++) {
+            generator.second->generate(buff.data(), count);
+        }
+        const double elapsed =
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+                .count();
+        std::cout << generator.first << ": " << (count * num_iterations / elapsed / 1e6)
+                  << " Msps" << std::endl;
+    }
+}
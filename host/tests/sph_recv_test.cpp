@@ -7,7 +7,9 @@
 
 #include "../common/mock_zero_copy.hpp"
 #include "../lib/transport/super_recv_packet_handler.hpp"
+#include <uhd/host_nco.hpp>
 #include <boost/bind.hpp>
+#include <boost/make_shared.hpp>
 #include <boost/shared_array.hpp>
 #include <boost/test/unit_test.hpp>
 #include <complex>
@@ -794,3 +796,325 @@ BOOST_AUTO_TEST_CASE(test_sph_recv_multi_channel_fragment)
     BOOST_REQUIRE_THROW(
         handler.recv(buffs, NUM_SAMPS_PER_BUFF, metadata, 1.0, true), uhd::io_error);
 }
+
+////////////////////////////////////////////////////////////////////////
+BOOST_AUTO_TEST_CASE(test_sph_recv_one_channel_stages)
+{
+    ////////////////////////////////////////////////////////////////////////
+    //! Stage that adds a per-channel offset to the I component
+    class offset_stage : public uhd::stream_stage
+    {
+    public:
+        offset_stage(const float offset) : _offset(offset) {}
+
+        std::string get_name(void) const
+        {
+            return "offset";
+        }
+
+        void init(const std::string& cpu_format, const size_t num_chans)
+        {
+            BOOST_CHECK_EQUAL(cpu_format, "fc32");
+            BOOST_CHECK_EQUAL(num_chans, 1);
+            num_inits++;
+        }
+
+        void process(const size_t chan, void* buff, const size_t nsamps)
+        {
+            BOOST_CHECK_EQUAL(chan, 0);
+            std::complex<float>* samps = static_cast<std::complex<float>*>(buff);
+            for (size_t i = 0; i < nsamps; i++) {
+                samps[i] += _offset;
+            }
+        }
+
+        size_t num_inits = 0;
+
+    private:
+        const float _offset;
+    };
+
+    uhd::convert::id_type id;
+    id.input_format  = "sc16_item32_be";
+    id.num_inputs    = 1;
+    id.output_format = "fc32";
+    id.num_outputs   = 1;
+
+    mock_zero_copy xport(vrt::if_packet_info_t::LINK_TYPE_VRLP);
+
+    vrt::if_packet_info_t ifpi;
+    ifpi.packet_type         = vrt::if_packet_info_t::PACKET_TYPE_DATA;
+    ifpi.num_payload_words32 = 10;
+    ifpi.packet_count        = 0;
+    ifpi.sob                 = true;
+    ifpi.eob                 = false;
+    ifpi.has_sid             = false;
+    ifpi.has_cid             = false;
+    ifpi.has_tsi             = true;
+    ifpi.has_tsf             = true;
+    ifpi.tsi                 = 0;
+    ifpi.tsf                 = 0;
+    ifpi.has_tlr             = false;
+
+    static const size_t NUM_PKTS_TO_TEST = 3;
+    for (size_t i = 0; i < NUM_PKTS_TO_TEST; i++) {
+        std::vector<uint32_t> data(ifpi.num_payload_words32, 0);
+        xport.push_back_recv_packet(ifpi, data);
+        ifpi.packet_count++;
+        ifpi.tsf += ifpi.num_payload_words32 * 10;
+    }
+
+    auto stage0 = boost::make_shared<offset_stage>(1.0f);
+    auto stage1 = boost::make_shared<offset_stage>(2.0f);
+    const std::vector<uhd::stream_stage::sptr> stages{stage0, stage1};
+
+    uhd::transport::sph::recv_packet_handler handler(1);
+    handler.set_vrt_unpacker(&uhd::transport::vrt::if_hdr_unpack_be);
+    handler.set_tick_rate(100e6);
+    handler.set_samp_rate(10e6);
+    handler.set_xport_chan_get_buff(
+        0, [&xport](double timeout) { return xport.get_recv_buff(timeout); });
+    handler.set_converter(id);
+    handler.set_stages(stages, id.output_format);
+    handler.set_stages(stages, id.output_format);
+    BOOST_CHECK_EQUAL(stage0->num_inits, 1);
+
+    // The stages run in order on every fragment
+    std::vector<std::complex<float>> buff(4);
+    uhd::rx_metadata_t metadata;
+    size_t num_accum_samps = 0;
+    while (num_accum_samps < NUM_PKTS_TO_TEST * 10) {
+        const size_t num_samps_ret =
+            handler.recv(&buff.front(), buff.size(), metadata, 1.0, true);
+        BOOST_REQUIRE_EQUAL(metadata.error_code, uhd::rx_metadata_t::ERROR_CODE_NONE);
+        for (size_t i = 0; i < num_samps_ret; i++) {
+            BOOST_CHECK_EQUAL(buff[i], std::complex<float>(3.0f, 0.0f));
+        }
+        num_accum_samps += num_samps_ret;
+    }
+    BOOST_CHECK_EQUAL(stage0->get_stats().num_samps, num_accum_samps);
+    BOOST_CHECK_EQUAL(stage1->get_stats().num_samps, num_accum_samps);
+    BOOST_CHECK_EQUAL(stage0->get_stats().num_calls, 9);
+    stage0->reset_stats();
+    BOOST_CHECK_EQUAL(stage0->get_stats().num_calls, 0);
+}
+
+////////////////////////////////////////////////////////////////////////
+BOOST_AUTO_TEST_CASE(test_sph_recv_one_channel_host_nco)
+{
+    ////////////////////////////////////////////////////////////////////////
+    //! Stage that does nothing, but keeps the NCO from being fused
+    class nop_stage : public uhd::stream_stage
+    {
+    public:
+        std::string get_name(void) const
+        {
+            return "nop";
+        }
+        void init(const std::string&, const size_t) {}
+        void process(const size_t, void*, const size_t) {}
+    };
+
+    static const double SAMP_RATE         = 10e6;
+    static const size_t NUM_PKTS_TO_TEST  = 3;
+    static const size_t SAMPS_PER_PACKET  = 10;
+    static const size_t RETUNE_SAMP_INDEX = 13;
+
+    // Receive a constant I of 1000 through the given stages
+    auto recv_samps = [](const std::vector<uhd::stream_stage::sptr>& stages) {
+        uhd::convert::id_type id;
+        id.input_format  = "sc16_item32_be";
+        id.num_inputs    = 1;
+        id.output_format = "fc32";
+        id.num_outputs   = 1;
+
+        auto xport = boost::make_shared<mock_zero_copy>(
+            vrt::if_packet_info_t::LINK_TYPE_VRLP);
+        vrt::if_packet_info_t ifpi;
+        ifpi.packet_type         = vrt::if_packet_info_t::PACKET_TYPE_DATA;
+        ifpi.num_payload_words32 = SAMPS_PER_PACKET;
+        ifpi.packet_count        = 0;
+        ifpi.sob                 = true;
+        ifpi.eob                 = false;
+        ifpi.has_sid             = false;
+        ifpi.has_cid             = false;
+        ifpi.has_tsi             = true;
+        ifpi.has_tsf             = true;
+        ifpi.tsi                 = 0;
+        ifpi.tsf                 = 0;
+        ifpi.has_tlr             = false;
+        for (size_t i = 0; i < NUM_PKTS_TO_TEST; i++) {
+            std::vector<uint32_t> data(
+                ifpi.num_payload_words32, uhd::htonx(uint32_t(1000) << 16));
+            xport->push_back_recv_packet(ifpi, data);
+            ifpi.packet_count++;
+            ifpi.tsf += ifpi.num_payload_words32 * 10;
+        }
+
+        uhd::transport::sph::recv_packet_handler handler(1);
+        handler.set_vrt_unpacker(&uhd::transport::vrt::if_hdr_unpack_be);
+        handler.set_tick_rate(100e6);
+        handler.set_samp_rate(SAMP_RATE);
+        handler.set_xport_chan_get_buff(
+            0, [xport](double timeout) { return xport->get_recv_buff(timeout); });
+        handler.set_converter(id);
+        handler.set_stages(stages, id.output_format);
+
+        std::vector<std::complex<float>> samps;
+        std::vector<std::complex<float>> buff(4);
+        uhd::rx_metadata_t metadata;
+        while (samps.size() < NUM_PKTS_TO_TEST * SAMPS_PER_PACKET) {
+            const size_t num_samps_ret =
+                handler.recv(&buff.front(), buff.size(), metadata, 1.0, true);
+            BOOST_REQUIRE_EQUAL(metadata.error_code, uhd::rx_metadata_t::ERROR_CODE_NONE);
+            samps.insert(samps.end(), buff.begin(), buff.begin() + num_samps_ret);
+        }
+        return samps;
+    };
+
+    // Mix up by a quarter of the sample rate, and back down from sample 13 on
+    auto make_nco = []() {
+        uhd::host_nco::sptr nco = uhd::host_nco::make(SAMP_RATE, SAMP_RATE / 4);
+        nco->set_freq(
+            -SAMP_RATE / 4, uhd::time_spec_t::from_ticks(RETUNE_SAMP_INDEX, SAMP_RATE));
+        BOOST_CHECK_EQUAL(nco->get_freq(), -SAMP_RATE / 4);
+        return nco;
+    };
+
+    // The NCO runs fused with the conversion if it comes first
+    uhd::host_nco::sptr fused_nco = make_nco();
+    const std::vector<std::complex<float>> fused_samps = recv_samps({fused_nco});
+    BOOST_CHECK_EQUAL(fused_nco->get_stats().num_samps, fused_samps.size());
+
+    uhd::host_nco::sptr nco = make_nco();
+    const std::vector<std::complex<float>> samps =
+        recv_samps({boost::make_shared<nop_stage>(), nco});
+    BOOST_CHECK_EQUAL(nco->get_stats().num_samps, samps.size());
+
+    const std::complex<float> j(0.0f, 1.0f);
+    std::complex<float> expected(1000 / 32767.f, 0.0f);
+    for (size_t i = 0; i < samps.size(); i++) {
+        BOOST_CHECK_SMALL(std::abs(fused_samps[i] - expected), 1e-5f);
+        BOOST_CHECK_SMALL(std::abs(samps[i] - expected), 1e-5f);
+        expected *= (i < RETUNE_SAMP_INDEX) ? j : -j;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////
+BOOST_AUTO_TEST_CASE(test_sph_recv_one_channel_squelch)
+{
+    ////////////////////////////////////////////////////////////////////////
+    //! Receive buffer with its own memory, so several can be held at once
+    class held_mrb : public uhd::transport::managed_recv_buffer
+    {
+    public:
+        held_mrb(const managed_recv_buffer& mrb)
+            : _mem(mrb.cast<const uint8_t*>(), mrb.cast<const uint8_t*>() + mrb.size())
+        {
+        }
+        void release(void) {}
+        sptr get(void)
+        {
+            return make(this, _mem.data(), _mem.size());
+        }
+
+    private:
+        std::vector<uint8_t> _mem;
+    };
+
+    uhd::convert::id_type id;
+    id.input_format  = "sc16_item32_le";
+    id.num_inputs    = 1;
+    id.output_format = "fc32";
+    id.num_outputs   = 1;
+
+    auto xport = boost::make_shared<mock_zero_copy>(
+        vrt::if_packet_info_t::LINK_TYPE_VRLP);
+    vrt::if_packet_info_t ifpi;
+    ifpi.packet_type         = vrt::if_packet_info_t::PACKET_TYPE_DATA;
+    ifpi.num_payload_words32 = 10;
+    ifpi.packet_count        = 0;
+    ifpi.sob                 = false;
+    ifpi.eob                 = false;
+    ifpi.has_sid             = false;
+    ifpi.has_cid             = false;
+    ifpi.has_tsi             = true;
+    ifpi.has_tsf             = true;
+    ifpi.tsi                 = 0;
+    ifpi.tsf                 = 0;
+    ifpi.has_tlr             = false;
+
+    static const double TICK_RATE = 100e6;
+    static const double SAMP_RATE = 10e6;
+    // Noise at -67 dBFS, with signals at -27 dBFS in packets 3, 4 and 10
+    static const size_t NUM_PKTS_TO_TEST = 12;
+    const std::vector<bool> loud         = {
+        false, false, false, true, true, false, false, false, false, false, true, false};
+    for (size_t i = 0; i < NUM_PKTS_TO_TEST; i++) {
+        const int16_t amplitude = loud[i] ? 1000 : 10;
+        std::vector<uint32_t> data(ifpi.num_payload_words32,
+            uhd::htowx(uint32_t(uint16_t(amplitude)) << 16 | uint16_t(-amplitude)));
+        xport->push_back_recv_packet(ifpi, data);
+        ifpi.packet_count++;
+        ifpi.tsf += ifpi.num_payload_words32 * size_t(TICK_RATE / SAMP_RATE);
+    }
+
+    // create the super receive packet handler
+    uhd::transport::sph::recv_packet_handler handler(1);
+    handler.set_vrt_unpacker(&uhd::transport::vrt::if_hdr_unpack_be);
+    handler.set_tick_rate(TICK_RATE);
+    handler.set_samp_rate(SAMP_RATE);
+    // The squelch holds on to the packets before a signal
+    std::list<held_mrb> held_mrbs;
+    handler.set_xport_chan_get_buff(0, [xport, &held_mrbs](double timeout) {
+        managed_recv_buffer::sptr mrb = xport->get_recv_buff(timeout);
+        if (not mrb) {
+            return mrb;
+        }
+        held_mrbs.emplace_back(*mrb);
+        return held_mrbs.back().get();
+    });
+    handler.set_converter(id);
+    uhd::rx_squelch::sptr squelch =
+        uhd::rx_squelch::make(-50.0, 3.0, 1, 2, uhd::rx_squelch::MODE_SUMMARIZE);
+    handler.set_squelch(squelch);
+
+    // Each signal is passed as a burst, with one packet before it and two after
+    std::vector<std::complex<float>> buff(1000);
+    uhd::rx_metadata_t metadata;
+    const std::vector<std::pair<size_t, size_t>> bursts = {{2, 7}, {9, 12}};
+    for (const auto& burst : bursts) {
+        const size_t num_samps_ret =
+            handler.recv(&buff.front(), buff.size(), metadata, 1.0, false);
+        BOOST_CHECK_EQUAL(metadata.error_code, uhd::rx_metadata_t::ERROR_CODE_NONE);
+        BOOST_CHECK_EQUAL(num_samps_ret, (burst.second - burst.first) * 10);
+        BOOST_CHECK(metadata.start_of_burst);
+        BOOST_CHECK_TS_CLOSE(
+            metadata.time_spec, uhd::time_spec_t::from_ticks(burst.first * 10, SAMP_RATE));
+        for (size_t pkt = burst.first; pkt < burst.second; pkt++) {
+            const float amplitude = (loud[pkt] ? 1000 : 10) / 32767.f;
+            BOOST_CHECK_CLOSE(buff[(pkt - burst.first) * 10].real(), amplitude, 0.01);
+            BOOST_CHECK_CLOSE(buff[(pkt - burst.first) * 10].imag(), -amplitude, 0.01);
+        }
+    }
+    // The first burst ended with the gate, the second one with the stream
+    BOOST_CHECK(not metadata.end_of_burst);
+    handler.recv(&buff.front(), buff.size(), metadata, 1.0, true);
+    BOOST_CHECK_EQUAL(metadata.error_code, uhd::rx_metadata_t::ERROR_CODE_TIMEOUT);
+
+    const uhd::rx_squelch::stats_t stats = squelch->get_stats();
+    BOOST_CHECK_EQUAL(stats.num_packets_passed, 8);
+    BOOST_CHECK_EQUAL(stats.num_packets_gated, 4);
+    BOOST_CHECK_EQUAL(stats.num_bursts, 2);
+    const std::vector<uhd::rx_squelch::summary_t> summaries = squelch->get_summaries();
+    BOOST_REQUIRE_EQUAL(summaries.size(), 4);
+    const size_t gated_pkts[] = {0, 1, 7, 8};
+    for (size_t i = 0; i < summaries.size(); i++) {
+        BOOST_CHECK(summaries[i].has_time_spec);
+        BOOST_CHECK_TS_CLOSE(summaries[i].time_spec,
+            uhd::time_spec_t::from_ticks(gated_pkts[i] * 10, SAMP_RATE));
+        BOOST_CHECK_EQUAL(summaries[i].nsamps, 10);
+        BOOST_CHECK_CLOSE(summaries[i].power_dbfs, -67.3f, 0.1);
+    }
+    BOOST_CHECK(squelch->get_summaries().empty());
+}
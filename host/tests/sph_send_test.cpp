@@ -8,9 +8,11 @@
 #include "../common/mock_zero_copy.hpp"
 #include "../lib/transport/super_send_packet_handler.hpp"
 #include <boost/bind.hpp>
+#include <boost/make_shared.hpp>
 #include <boost/shared_array.hpp>
 #include <boost/test/unit_test.hpp>
 #include <complex>
+#include <cstring>
 #include <list>
 #include <vector>
 
@@ -127,3 +129,63 @@ BOOST_AUTO_TEST_CASE(test_sph_send_one_channel_full_buffer_mode)
         num_accum_samps += ifpi.num_payload_words32;
     }
 }
+
+////////////////////////////////////////////////////////////////////////
+BOOST_AUTO_TEST_CASE(test_sph_send_one_channel_stages)
+{
+    ////////////////////////////////////////////////////////////////////////
+    //! Stage that overwrites the samples, to check the user buffer is untouched
+    class clear_stage : public uhd::stream_stage
+    {
+    public:
+        std::string get_name(void) const
+        {
+            return "clear";
+        }
+
+        void init(const std::string& cpu_format, const size_t num_chans)
+        {
+            BOOST_CHECK_EQUAL(cpu_format, "fc32");
+            BOOST_CHECK_EQUAL(num_chans, 1);
+        }
+
+        void process(const size_t, void* buff, const size_t nsamps)
+        {
+            std::memset(buff, 0, nsamps * sizeof(std::complex<float>));
+        }
+    };
+
+    uhd::convert::id_type id;
+    id.input_format  = "fc32";
+    id.num_inputs    = 1;
+    id.output_format = "sc16_item32_be";
+    id.num_outputs   = 1;
+
+    mock_zero_copy xport(vrt::if_packet_info_t::LINK_TYPE_VRLP);
+
+    auto stage = boost::make_shared<clear_stage>();
+
+    sph::send_packet_handler handler(1);
+    handler.set_vrt_packer(&vrt::if_hdr_pack_be);
+    handler.set_tick_rate(100e6);
+    handler.set_samp_rate(10e6);
+    handler.set_xport_chan_get_buff(
+        0, [&xport](double timeout) { return xport.get_send_buff(timeout); });
+    handler.set_converter(id);
+    handler.set_stages({stage}, id.input_format);
+    handler.set_max_samples_per_packet(20);
+
+    std::vector<std::complex<float>> buff(50, std::complex<float>(0.5f, -0.5f));
+    uhd::tx_metadata_t metadata;
+    metadata.start_of_burst = true;
+    metadata.end_of_burst   = true;
+    const size_t num_sent = handler.send(&buff.front(), buff.size(), metadata, 1.0);
+    BOOST_CHECK_EQUAL(num_sent, buff.size());
+
+    // The stage ran once per packet, on a copy of the user's samples
+    BOOST_CHECK_EQUAL(stage->get_stats().num_calls, 3);
+    BOOST_CHECK_EQUAL(stage->get_stats().num_samps, buff.size());
+    for (const auto& samp : buff) {
+        BOOST_CHECK_EQUAL(samp, std::complex<float>(0.5f, -0.5f));
+    }
+}
@@ -0,0 +1,55 @@
+//
+// Copyright 2019 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include <uhd/exception.hpp>
+#include <uhdlib/utils/thread_policy.hpp>
+#include <boost/test/unit_test.hpp>
+#include <vector>
+
+using namespace uhd::thread_policy;
+
+BOOST_AUTO_TEST_CASE(test_parse_cpu_list)
+{
+    const std::vector<size_t> expected{2, 3, 6, 7, 8};
+    const std::vector<size_t> cpus_comma = parse_cpu_list("2,3,6-8");
+    const std::vector<size_t> cpus_colon = parse_cpu_list("2:3: 6 - 8");
+    BOOST_CHECK_EQUAL_COLLECTIONS(
+        cpus_comma.begin(), cpus_comma.end(), expected.begin(), expected.end());
+    BOOST_CHECK_EQUAL_COLLECTIONS(
+        cpus_colon.begin(), cpus_colon.end(), expected.begin(), expected.end());
+    BOOST_CHECK(parse_cpu_list("").empty());
+
+    BOOST_CHECK_THROW(parse_cpu_list("foo"), uhd::value_error);
+    BOOST_CHECK_THROW(parse_cpu_list("5-3"), uhd::value_error);
+    BOOST_CHECK_THROW(parse_cpu_list("1,-2"), uhd::value_error);
+}
+
+BOOST_AUTO_TEST_CASE(test_placement_from_args)
+{
+    update_from_args(uhd::device_addr_t("thread_zero_copy_recv_cpus=4:5,"
+                                        "thread_zero_copy_recv_sched=fifo,"
+                                        "thread_default_priority=0.25,"
+                                        "master_clock_rate=200e6"));
+
+    const placement_t offload = get_placement(RECV_OFFLOAD);
+    BOOST_REQUIRE_EQUAL(offload.cpus.size(), 2);
+    BOOST_CHECK_EQUAL(offload.cpus[0], 4);
+    BOOST_CHECK_EQUAL(offload.cpus[1], 5);
+    BOOST_CHECK(offload.sched == sched_t::FIFO);
+    BOOST_CHECK_EQUAL(offload.priority, 0.25);
+
+    // Only the default settings apply here
+    const placement_t log = get_placement(LOG);
+    BOOST_CHECK(log.cpus.empty());
+    BOOST_CHECK(log.sched == sched_t::UNCHANGED);
+    BOOST_CHECK_EQUAL(log.priority, 0.25);
+
+    BOOST_CHECK_THROW(update_from_args(uhd::device_addr_t("thread_uhd_log_sched=idle")),
+        uhd::value_error);
+    BOOST_CHECK_THROW(
+        update_from_args(uhd::device_addr_t("thread_uhd_log_priority=2.0")),
+        uhd::value_error);
+}
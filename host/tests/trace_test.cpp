@@ -0,0 +1,61 @@
+//
+// Copyright 2019 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include <uhdlib/utils/trace.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+#include <boost/test/unit_test.hpp>
+#include <cstdlib>
+#include <map>
+#include <set>
+#include <string>
+#include <thread>
+
+namespace fs = boost::filesystem;
+namespace pt = boost::property_tree;
+
+BOOST_AUTO_TEST_CASE(test_trace_file)
+{
+    // The variable is read on the first use of the tracer
+    const fs::path trace_path =
+        fs::temp_directory_path() / fs::unique_path("uhd_trace_%%%%%%%%.json");
+    setenv("UHD_TRACE_FILE", trace_path.string().c_str(), 1);
+    BOOST_REQUIRE(uhd::trace::is_enabled());
+
+    {
+        UHD_TRACE_SCOPE("outer \"phase\"");
+        UHD_TRACE_SCOPE("inner");
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    std::thread other_thread([]() { UHD_TRACE_SCOPE("other thread"); });
+    other_thread.join();
+    uhd::trace::write_file();
+
+    pt::ptree trace;
+    pt::read_json(trace_path.string(), trace);
+    std::map<std::string, pt::ptree> spans;
+    std::set<int> tids;
+    for (const auto& event : trace.get_child("traceEvents")) {
+        if (event.second.get<std::string>("ph") == "X") {
+            spans[event.second.get<std::string>("name")] = event.second;
+            tids.insert(event.second.get<int>("tid"));
+        }
+    }
+    BOOST_REQUIRE_EQUAL(spans.size(), 3);
+    BOOST_REQUIRE(spans.count("outer \"phase\""));
+    BOOST_CHECK_EQUAL(spans["inner"].get<std::string>("cat"), "init");
+    BOOST_CHECK_GE(spans["inner"].get<long>("dur"), 2000);
+    // The inner span lies within the outer one
+    BOOST_CHECK_LE(spans["outer \"phase\""].get<long>("ts"), spans["inner"].get<long>("ts"));
+    BOOST_CHECK_GE(spans["outer \"phase\""].get<long>("dur"), spans["inner"].get<long>("dur"));
+    BOOST_CHECK_EQUAL(
+        spans["outer \"phase\""].get<int>("tid"), spans["inner"].get<int>("tid"));
+    BOOST_CHECK_EQUAL(tids.size(), 2);
+
+    fs::remove(trace_path);
+    unsetenv("UHD_TRACE_FILE");
+}
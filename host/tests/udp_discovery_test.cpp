@@ -0,0 +1,128 @@
+//
+// Copyright 2019 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include <uhdlib/transport/udp_discovery.hpp>
+#include <boost/asio.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/test/unit_test.hpp>
+#include <string>
+
+using namespace uhd::transport;
+namespace asio = boost::asio;
+
+namespace {
+constexpr double RECV_TIMEOUT = 0.1;
+
+//! A device on the loopback interface which answers discovery requests
+struct responder_t
+{
+    responder_t()
+        : socket(io_service,
+              asio::ip::udp::endpoint(asio::ip::address_v4::loopback(), 0))
+        , port(boost::lexical_cast<std::string>(socket.local_endpoint().port()))
+    {
+    }
+
+    //! Receives a request, and returns where it came from
+    asio::ip::udp::endpoint get_request(void)
+    {
+        char request[64];
+        asio::ip::udp::endpoint sender;
+        socket.receive_from(asio::buffer(request), sender);
+        return sender;
+    }
+
+    void reply(const asio::ip::udp::endpoint& dest, const std::string& reply)
+    {
+        socket.send_to(asio::buffer(reply), dest);
+    }
+
+    asio::io_service io_service;
+    asio::ip::udp::socket socket;
+    const std::string port;
+};
+
+std::string recv_string(udp_discovery::sptr xport)
+{
+    char buff[64];
+    const size_t len = xport->recv(asio::buffer(buff), RECV_TIMEOUT);
+    return std::string(buff, len);
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(test_udp_discovery_shared_socket)
+{
+    responder_t responder;
+    auto xport0 = udp_discovery::make("test", "127.0.0.1", responder.port);
+    auto xport1 = udp_discovery::make("test", "127.0.0.1", responder.port);
+
+    xport0->send(asio::buffer("find", 4));
+    xport1->send(asio::buffer("find", 4));
+    const auto sender = responder.get_request();
+    // Both requests come from the same socket
+    BOOST_CHECK(responder.get_request() == sender);
+
+    // Every transport gets every reply, but only once
+    responder.reply(sender, "reply");
+    responder.reply(sender, "reply");
+    responder.reply(sender, "other reply");
+    for (auto xport : {xport0, xport1}) {
+        BOOST_CHECK_EQUAL(recv_string(xport), "reply");
+        BOOST_CHECK_EQUAL(recv_string(xport), "other reply");
+        BOOST_CHECK_EQUAL(recv_string(xport), "");
+        BOOST_CHECK_EQUAL(xport->get_recv_addr(), "127.0.0.1");
+    }
+
+    // Another finder has its own socket, and doesn't see these replies
+    auto other_xport = udp_discovery::make("other", "127.0.0.1", responder.port);
+    other_xport->send(asio::buffer("find", 4));
+    BOOST_CHECK(responder.get_request() != sender);
+    responder.reply(sender, "reply");
+    BOOST_CHECK_EQUAL(recv_string(other_xport), "");
+}
+
+BOOST_AUTO_TEST_CASE(test_udp_discovery_timeout)
+{
+    constexpr double max_timeout = 1.0;
+    responder_t responder;
+    {
+        auto xport = udp_discovery::make("test", "127.0.0.1", responder.port);
+        // Nothing was received yet
+        BOOST_CHECK_EQUAL(xport->get_timeout(max_timeout), max_timeout);
+        xport->send(asio::buffer("find", 4));
+        responder.reply(responder.get_request(), "reply");
+        BOOST_CHECK_EQUAL(recv_string(xport), "reply");
+    }
+
+    // The reply on loopback took a lot less than MIN_TIMEOUT / TIMEOUT_MARGIN
+    auto xport = udp_discovery::make("test", "127.0.0.1", responder.port);
+    BOOST_CHECK_EQUAL(xport->get_timeout(max_timeout), udp_discovery::MIN_TIMEOUT);
+    BOOST_CHECK_EQUAL(xport->get_timeout(0.001), 0.001);
+
+    // Other ports and other finders are tracked separately
+    responder_t other_responder;
+    BOOST_CHECK_EQUAL(
+        udp_discovery::make("test", "127.0.0.1", other_responder.port)
+            ->get_timeout(max_timeout),
+        max_timeout);
+    BOOST_CHECK_EQUAL(udp_discovery::make("other", "127.0.0.1", responder.port)
+                          ->get_timeout(max_timeout),
+        max_timeout);
+
+    // Broadcasts may reach new devices, so they always wait the full timeout
+    BOOST_CHECK_EQUAL(udp_discovery::make("test", "255.255.255.255", responder.port)
+                          ->get_timeout(max_timeout),
+        max_timeout);
+
+    // A discovery without a reply resets the timeout
+    xport->send(asio::buffer("find", 4));
+    responder.get_request();
+    BOOST_CHECK_EQUAL(recv_string(xport), "");
+    xport.reset();
+    BOOST_CHECK_EQUAL(udp_discovery::make("test", "127.0.0.1", responder.port)
+                          ->get_timeout(max_timeout),
+        max_timeout);
+}
@@ -0,0 +1,154 @@
+//
+// Copyright 2019 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include "x300_adc_self_cal.hpp"
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace uhd::usrp::x300;
+namespace fs = boost::filesystem;
+
+namespace {
+//! The windows a linear sweep over all steps finds
+std::vector<adc_cal_window_t> sweep_windows(
+    const std::vector<bool>& valid, const size_t min_len)
+{
+    std::vector<adc_cal_window_t> windows;
+    long start = -1;
+    for (size_t i = 0; i <= valid.size(); i++) {
+        // Past the last step counts as invalid, to close a run which reaches it
+        const bool is_valid = i < valid.size() and valid[i];
+        if (is_valid and start == -1) {
+            start = long(i);
+        } else if (not is_valid and start != -1) {
+            if (i - 1 - size_t(start) >= min_len) {
+                windows.push_back(adc_cal_window_t(size_t(start), i - 1));
+            }
+            start = -1;
+        }
+    }
+    return windows;
+}
+
+//! Valid steps in [start, stop] of each window, with a wraparound at num_steps
+std::vector<bool> make_eye(
+    const size_t num_steps, const std::vector<adc_cal_window_t>& windows)
+{
+    std::vector<bool> valid(num_steps, false);
+    for (const auto& window : windows) {
+        for (size_t i = window.first; i <= window.second; i++) {
+            valid[i % num_steps] = true;
+        }
+    }
+    return valid;
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(test_adc_cal_windows)
+{
+    const size_t num_steps = 32;
+    const size_t min_len   = 4;
+
+    // Slide an eye over the steps, including positions at the edges
+    for (size_t start = 0; start < num_steps; start++) {
+        for (size_t len = min_len; len < num_steps - min_len - 1; len += 3) {
+            const std::vector<bool> valid =
+                make_eye(num_steps, {adc_cal_window_t(start, start + len)});
+            size_t num_tests = 0;
+            const std::vector<adc_cal_window_t> windows = find_adc_cal_windows(
+                num_steps,
+                min_len,
+                [&](const size_t step) {
+                    num_tests++;
+                    return bool(valid.at(step));
+                },
+                false);
+            const std::vector<adc_cal_window_t> expected = sweep_windows(valid, min_len);
+            BOOST_REQUIRE_EQUAL(windows.size(), expected.size());
+            for (size_t i = 0; i < windows.size(); i++) {
+                BOOST_CHECK_EQUAL(windows[i].first, expected[i].first);
+                BOOST_CHECK_EQUAL(windows[i].second, expected[i].second);
+            }
+            // Far fewer tests than steps
+            BOOST_CHECK_LE(num_tests, num_steps / 2 + 2);
+        }
+    }
+
+    // Two eyes: the sweep finds both, or stops at the first
+    const std::vector<bool> valid = make_eye(
+        100, {adc_cal_window_t(10, 30), adc_cal_window_t(50, 80)});
+    auto is_valid = [&](const size_t step) { return bool(valid.at(step)); };
+    std::vector<adc_cal_window_t> windows = find_adc_cal_windows(100, 12, is_valid, false);
+    BOOST_REQUIRE_EQUAL(windows.size(), 2);
+    BOOST_CHECK_EQUAL(windows[1].first, 50);
+    BOOST_CHECK_EQUAL(windows[1].second, 80);
+    windows = find_adc_cal_windows(100, 12, is_valid, true);
+    BOOST_REQUIRE_EQUAL(windows.size(), 1);
+    BOOST_CHECK_EQUAL(windows[0].first, 10);
+    BOOST_CHECK_EQUAL(windows[0].second, 30);
+
+    // An eye which reaches the last step ends there
+    const std::vector<bool> valid_at_end =
+        make_eye(num_steps, {adc_cal_window_t(20, num_steps - 1)});
+    auto is_valid_at_end = [&](const size_t step) { return bool(valid_at_end.at(step)); };
+    for (const bool stop_at_first : {false, true}) {
+        windows =
+            find_adc_cal_windows(num_steps, min_len, is_valid_at_end, stop_at_first);
+        BOOST_REQUIRE_EQUAL(windows.size(), 1);
+        BOOST_CHECK_EQUAL(windows[0].first, 20);
+        BOOST_CHECK_EQUAL(windows[0].second, num_steps - 1);
+    }
+    // ...but only if it is long enough
+    BOOST_CHECK(find_adc_cal_windows(
+        num_steps,
+        min_len,
+        [&](const size_t step) { return step >= num_steps - min_len; },
+        false)
+                    .empty());
+
+    // No windows
+    BOOST_CHECK(find_adc_cal_windows(
+        num_steps, min_len, [](const size_t) { return false; }, false)
+                    .empty());
+}
+
+BOOST_AUTO_TEST_CASE(test_adc_self_cal_cache)
+{
+    const fs::path config_dir =
+        fs::temp_directory_path() / fs::unique_path("uhd_adc_self_cal_%%%%%%%%");
+    setenv("UHD_CONFIG_DIR", config_dir.string().c_str(), 1);
+
+    adc_self_cal_key_t key;
+    key.serial            = "30C1234";
+    key.master_clock_rate = 200e6;
+    key.fpga_hash         = "1234567";
+    BOOST_CHECK(not load_adc_self_cal(key, "capture_delay_A"));
+
+    store_adc_self_cal(key, "capture_delay_A", 17);
+    store_adc_self_cal(key, "capture_delay_B", 15);
+    store_adc_self_cal(key, "capture_delay_A", 16);
+    BOOST_CHECK_EQUAL(load_adc_self_cal(key, "capture_delay_A").get(), 16);
+    BOOST_CHECK_EQUAL(load_adc_self_cal(key, "capture_delay_B").get(), 15);
+
+    // Results are specific to the clock rate and the FPGA image
+    adc_self_cal_key_t other_key = key;
+    other_key.master_clock_rate  = 184.32e6;
+    BOOST_CHECK(not load_adc_self_cal(other_key, "capture_delay_A"));
+    other_key           = key;
+    other_key.fpga_hash = "89abcde";
+    BOOST_CHECK(not load_adc_self_cal(other_key, "capture_delay_A"));
+
+    // Without a serial, nothing is cached
+    other_key.serial = "";
+    store_adc_self_cal(other_key, "capture_delay_A", 3);
+    BOOST_CHECK(not load_adc_self_cal(other_key, "capture_delay_A"));
+
+    fs::remove_all(config_dir);
+    unsetenv("UHD_CONFIG_DIR");
+}
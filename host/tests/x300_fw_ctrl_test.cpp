@@ -0,0 +1,244 @@
+//
+// Copyright 2019 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include "x300_fw_common.h"
+#include "x300_fw_ctrl.hpp"
+#include <uhd/transport/udp_simple.hpp>
+#include <uhd/utils/byteswap.hpp>
+#include <boost/asio.hpp>
+#include <boost/test/unit_test.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <map>
+#include <string>
+#include <thread>
+
+using namespace uhd;
+using namespace uhd::usrp::x300;
+namespace asio = boost::asio;
+
+namespace {
+//! The registers of the emulated firmware
+std::map<uint32_t, uint32_t> regs;
+
+uint32_t test_peek32(const uint32_t addr)
+{
+    return regs[addr];
+}
+
+void test_poke32(const uint32_t addr, const uint32_t data)
+{
+    regs[addr] = data;
+}
+
+/*! Firmware fw comms handler, running natively behind a UDP socket on localhost
+ *
+ * With legacy set, requests are handled like firmware without support for
+ * batches does: every request is a single peek and/or poke.
+ */
+class fw_emulator
+{
+public:
+    fw_emulator(const bool legacy)
+        : _socket(_io_service, asio::ip::udp::endpoint(asio::ip::address_v4::loopback(), 0))
+        , _legacy(legacy)
+    {
+        _socket.non_blocking(true);
+        _thread = std::thread([this]() { run(); });
+    }
+
+    ~fw_emulator()
+    {
+        _running = false;
+        _thread.join();
+    }
+
+    std::string get_port(void) const
+    {
+        return std::to_string(_socket.local_endpoint().port());
+    }
+
+    //! Number of requests received
+    std::atomic<size_t> num_requests{0};
+
+private:
+    void run(void)
+    {
+        uint32_t request[X300_FW_COMMS_MTU / sizeof(uint32_t)];
+        x300_fw_comms_batch_t reply;
+        while (_running) {
+            asio::ip::udp::endpoint sender;
+            boost::system::error_code ec;
+            const size_t num_bytes =
+                _socket.receive_from(asio::buffer(request), sender, 0, ec);
+            if (ec) {
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+                continue;
+            }
+            num_requests++;
+
+            // The firmware is big endian, so it works on network order words
+            for (size_t i = 0; i < num_bytes / sizeof(uint32_t); i++) {
+                request[i] = uhd::ntohx(request[i]);
+            }
+            if (_legacy) {
+                // The handler of firmware before batches
+                x300_fw_comms_t* single = reinterpret_cast<x300_fw_comms_t*>(&reply);
+                std::memcpy(single, request, sizeof(x300_fw_comms_t));
+                if (single->flags & X300_FW_COMMS_FLAGS_PEEK32) {
+                    single->data = test_peek32(single->addr);
+                }
+                if (single->flags & X300_FW_COMMS_FLAGS_POKE32) {
+                    test_poke32(single->addr, single->data);
+                }
+                send_reply(reply, sizeof(x300_fw_comms_t), sender);
+                continue;
+            }
+            const size_t reply_len = x300_fw_comms_handle_request(
+                request, num_bytes, &reply, &test_peek32, &test_poke32);
+            send_reply(reply, reply_len, sender);
+        }
+    }
+
+    void send_reply(x300_fw_comms_batch_t& reply,
+        const size_t reply_len,
+        const asio::ip::udp::endpoint& dest)
+    {
+        uint32_t* words = reinterpret_cast<uint32_t*>(&reply);
+        for (size_t i = 0; i < reply_len / sizeof(uint32_t); i++) {
+            words[i] = uhd::htonx(words[i]);
+        }
+        _socket.send_to(asio::buffer(&reply, reply_len), dest);
+    }
+
+    asio::io_service _io_service;
+    asio::ip::udp::socket _socket;
+    const bool _legacy;
+    std::atomic<bool> _running{true};
+    std::thread _thread;
+};
+
+//! Pokes to \p num_regs registers, then peeks of them
+std::vector<fw_reg_op_t> make_ops(const size_t num_regs)
+{
+    std::vector<fw_reg_op_t> ops;
+    for (size_t i = 0; i < num_regs; i++) {
+        ops.push_back(fw_reg_op_t::poke32(uint32_t(4 * i), uint32_t(0xAB000000 + i)));
+    }
+    for (size_t i = 0; i < num_regs; i++) {
+        ops.push_back(fw_reg_op_t::peek32(uint32_t(4 * i)));
+    }
+    return ops;
+}
+
+void check_ops(const std::vector<fw_reg_op_t>& ops, const size_t num_regs)
+{
+    for (size_t i = 0; i < num_regs; i++) {
+        BOOST_CHECK_EQUAL(regs[uint32_t(4 * i)], 0xAB000000 + i);
+        BOOST_CHECK_EQUAL(ops[num_regs + i].data, 0xAB000000 + i);
+    }
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(test_fw_ctrl_batch)
+{
+    regs.clear();
+    fw_emulator fw(false);
+    fw_ctrl_iface::sptr ctrl = x300_make_ctrl_iface_enet(
+        transport::udp_simple::make_connected("127.0.0.1", fw.get_port()));
+    const size_t num_requests = fw.num_requests;
+
+    // Single peeks and pokes work as before
+    ctrl->poke32(0x1000, 42);
+    BOOST_CHECK_EQUAL(ctrl->peek32(0x1000), 42);
+    BOOST_CHECK_EQUAL(fw.num_requests, num_requests + 2);
+
+    // A batch takes one request per X300_FW_COMMS_BATCH_MAX_OPS operations
+    const size_t num_regs        = 100;
+    std::vector<fw_reg_op_t> ops = make_ops(num_regs);
+    ctrl->transact32(ops);
+    check_ops(ops, num_regs);
+    BOOST_CHECK_EQUAL(fw.num_requests,
+        num_requests + 2
+            + (ops.size() + X300_FW_COMMS_BATCH_MAX_OPS - 1)
+                  / X300_FW_COMMS_BATCH_MAX_OPS);
+
+    // The helper uses the batch interface, too
+    std::vector<fw_reg_op_t> peeks = {
+        fw_reg_op_t::peek32(0x1000), fw_reg_op_t::peek32(0)};
+    const size_t num_requests_helper = fw.num_requests;
+    fw_transact32(ctrl, peeks);
+    BOOST_CHECK_EQUAL(peeks[0].data, 42);
+    BOOST_CHECK_EQUAL(peeks[1].data, 0xAB000000);
+    BOOST_CHECK_EQUAL(fw.num_requests, num_requests_helper + 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_fw_ctrl_batch_fallback)
+{
+    regs.clear();
+    fw_emulator fw(true);
+    fw_ctrl_iface::sptr ctrl = x300_make_ctrl_iface_enet(
+        transport::udp_simple::make_connected("127.0.0.1", fw.get_port()));
+    const size_t num_requests = fw.num_requests;
+
+    // The first batch finds out that the firmware doesn't support batches,
+    // and then runs one request per operation
+    const size_t num_regs        = 10;
+    std::vector<fw_reg_op_t> ops = make_ops(num_regs);
+    ctrl->transact32(ops);
+    check_ops(ops, num_regs);
+    BOOST_CHECK_EQUAL(fw.num_requests, num_requests + 1 + ops.size());
+
+    // Later batches don't try again
+    ops = make_ops(num_regs);
+    ctrl->transact32(ops);
+    check_ops(ops, num_regs);
+    BOOST_CHECK_EQUAL(fw.num_requests, num_requests + 1 + 2 * ops.size());
+}
+
+BOOST_AUTO_TEST_CASE(test_fw_comms_handle_request)
+{
+    regs.clear();
+    x300_fw_comms_batch_t request = x300_fw_comms_batch_t();
+    x300_fw_comms_batch_t reply;
+
+    // Batches which are too short or too long are rejected
+    request.flags   = X300_FW_COMMS_FLAGS_ACK | X300_FW_COMMS_FLAGS_BATCH;
+    request.num_ops = 2;
+    BOOST_CHECK_EQUAL(x300_fw_comms_handle_request(&request,
+                          X300_FW_COMMS_BATCH_LEN(1),
+                          &reply,
+                          &test_peek32,
+                          &test_poke32),
+        sizeof(x300_fw_comms_t));
+    BOOST_CHECK(reply.flags & X300_FW_COMMS_FLAGS_ERROR);
+    request.num_ops = X300_FW_COMMS_BATCH_MAX_OPS + 1;
+    x300_fw_comms_handle_request(
+        &request, sizeof(request), &reply, &test_peek32, &test_poke32);
+    BOOST_CHECK(reply.flags & X300_FW_COMMS_FLAGS_ERROR);
+    BOOST_CHECK(regs.empty());
+
+    // Operations run in order
+    request.num_ops      = 3;
+    request.ops[0].flags = X300_FW_COMMS_FLAGS_PEEK32;
+    request.ops[0].addr  = 8;
+    request.ops[1].flags = X300_FW_COMMS_FLAGS_POKE32;
+    request.ops[1].addr  = 8;
+    request.ops[1].data  = 7;
+    request.ops[2].flags = X300_FW_COMMS_FLAGS_PEEK32;
+    request.ops[2].addr  = 8;
+    BOOST_CHECK_EQUAL(x300_fw_comms_handle_request(&request,
+                          X300_FW_COMMS_BATCH_LEN(3),
+                          &reply,
+                          &test_peek32,
+                          &test_poke32),
+        X300_FW_COMMS_BATCH_LEN(3));
+    BOOST_CHECK(not(reply.flags & X300_FW_COMMS_FLAGS_ERROR));
+    BOOST_CHECK_EQUAL(reply.num_ops, 3);
+    BOOST_CHECK_EQUAL(reply.ops[0].data, 0);
+    BOOST_CHECK_EQUAL(reply.ops[2].data, 7);
+}
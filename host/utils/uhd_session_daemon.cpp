@@ -0,0 +1,77 @@
+//
+// Copyright 2019 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include <uhd/usrp/multi_usrp.hpp>
+#include <uhd/usrp/session.hpp>
+#include <uhd/utils/safe_main.hpp>
+#include <boost/format.hpp>
+#include <boost/program_options.hpp>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+
+namespace po = boost::program_options;
+
+static bool stop_signal_called = false;
+void sig_int_handler(int)
+{
+    stop_signal_called = true;
+}
+
+int UHD_SAFE_MAIN(int argc, char* argv[])
+{
+    std::string args, socket_path, ref, pps;
+
+    po::options_description desc("Allowed options");
+    // clang-format off
+    desc.add_options()
+        ("help", "help message")
+        ("args", po::value<std::string>(&args)->default_value(""), "device address args")
+        ("socket", po::value<std::string>(&socket_path)->default_value("/tmp/uhd_session.sock"), "path of the socket clients attach to")
+        ("ref", po::value<std::string>(&ref), "reference source (internal, external, gpsdo)")
+        ("pps", po::value<std::string>(&pps), "time source (internal, external, gpsdo)")
+    ;
+    // clang-format on
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    po::notify(vm);
+
+    // print the help message
+    if (vm.count("help")) {
+        std::cout << boost::format("UHD Session Daemon %s") % desc << std::endl;
+        std::cout << std::endl
+                  << "Keeps a device initialized and claimed, and lets other processes\n"
+                     "attach to it through uhd::usrp::session_client."
+                  << std::endl;
+        return EXIT_SUCCESS;
+    }
+
+    std::cout << boost::format("Creating the usrp device with: %s...") % args
+              << std::endl;
+    uhd::usrp::multi_usrp::sptr usrp = uhd::usrp::multi_usrp::make(args);
+    if (vm.count("ref")) {
+        usrp->set_clock_source(ref);
+    }
+    if (vm.count("pps")) {
+        usrp->set_time_source(pps);
+    }
+    std::cout << boost::format("Using Device: %s") % usrp->get_pp_string() << std::endl;
+
+    uhd::usrp::session_server::sptr server =
+        uhd::usrp::session_server::make(usrp, socket_path);
+    std::signal(SIGINT, &sig_int_handler);
+    std::signal(SIGTERM, &sig_int_handler);
+    std::cout << boost::format("Serving on %s, press Ctrl + C to stop...") % socket_path
+              << std::endl;
+    while (not stop_signal_called) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+
+    std::cout << std::endl << "Done!" << std::endl << std::endl;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,416 @@
+//
+// Copyright 2019 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+// Benchmarks the host-side zero_copy_if implementations without hardware.
+// Every transport is connected to an echo peer running in this process, on
+// the loopback interface. The benchmark streams time-stamped frames through
+// the transport, and the peer sends them straight back.
+
+#include <uhd/exception.hpp>
+#include <uhd/transport/muxed_zero_copy_if.hpp>
+#include <uhd/transport/tcp_zero_copy.hpp>
+#include <uhd/transport/udp_zero_copy.hpp>
+#include <uhd/transport/zero_copy_flow_ctrl.hpp>
+#include <uhd/transport/zero_copy_recv_offload.hpp>
+#include <uhd/utils/safe_main.hpp>
+#include <boost/algorithm/string.hpp>
+#include <boost/asio.hpp>
+#include <boost/format.hpp>
+#include <boost/program_options.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <ctime>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace po   = boost::program_options;
+namespace asio = boost::asio;
+using namespace uhd::transport;
+
+namespace {
+
+constexpr char LOOPBACK_ADDR[] = "127.0.0.1";
+//! Every frame starts with a sequence number and a send time stamp
+constexpr size_t HEADER_SIZE = 2 * sizeof(uint64_t);
+
+uint64_t get_time_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+/***********************************************************************
+ * Loopback peers
+ **********************************************************************/
+class echo_peer
+{
+public:
+    typedef std::unique_ptr<echo_peer> uptr;
+
+    virtual ~echo_peer() {}
+
+    //! The port the peer is listening on
+    virtual std::string get_port() const = 0;
+};
+
+class udp_echo_peer : public echo_peer
+{
+public:
+    udp_echo_peer(const size_t frame_size)
+        : _socket(_io_service,
+              asio::ip::udp::endpoint(asio::ip::address::from_string(LOOPBACK_ADDR), 0))
+        , _frame_size(frame_size)
+    {
+        _socket.set_option(asio::socket_base::receive_buffer_size(32 * 1024 * 1024));
+        _socket.set_option(asio::socket_base::send_buffer_size(32 * 1024 * 1024));
+        _thread = std::thread([this]() { this->echo_loop(); });
+    }
+
+    ~udp_echo_peer()
+    {
+        // An empty datagram tells the echo loop to exit
+        asio::ip::udp::socket kicker(_io_service, asio::ip::udp::v4());
+        kicker.send_to(asio::buffer(&_frame_size, 0), _socket.local_endpoint());
+        _thread.join();
+    }
+
+    std::string get_port() const
+    {
+        return std::to_string(_socket.local_endpoint().port());
+    }
+
+private:
+    void echo_loop()
+    {
+        std::vector<char> buff(_frame_size);
+        asio::ip::udp::endpoint sender;
+        while (true) {
+            const size_t len = _socket.receive_from(asio::buffer(buff), sender);
+            if (len == 0) {
+                return;
+            }
+            _socket.send_to(asio::buffer(buff.data(), len), sender);
+        }
+    }
+
+    asio::io_service _io_service;
+    asio::ip::udp::socket _socket;
+    size_t _frame_size;
+    std::thread _thread;
+};
+
+class tcp_echo_peer : public echo_peer
+{
+public:
+    tcp_echo_peer(const size_t frame_size)
+        : _acceptor(_io_service,
+              asio::ip::tcp::endpoint(asio::ip::address::from_string(LOOPBACK_ADDR), 0))
+        , _socket(_io_service)
+        , _frame_size(frame_size)
+    {
+        // Client connects are queued up by the listen backlog, so we can
+        // accept in the echo thread
+        _thread = std::thread([this]() { this->echo_loop(); });
+    }
+
+    ~tcp_echo_peer()
+    {
+        // The echo loop ends once the client closes the connection
+        _thread.join();
+    }
+
+    std::string get_port() const
+    {
+        return std::to_string(_acceptor.local_endpoint().port());
+    }
+
+private:
+    void echo_loop()
+    {
+        std::vector<char> buff(_frame_size);
+        boost::system::error_code ec;
+        _acceptor.accept(_socket, ec);
+        while (not ec) {
+            const size_t len = _socket.read_some(asio::buffer(buff), ec);
+            if (ec) {
+                return;
+            }
+            asio::write(_socket, asio::buffer(buff.data(), len), ec);
+        }
+    }
+
+    asio::io_service _io_service;
+    asio::ip::tcp::acceptor _acceptor;
+    asio::ip::tcp::socket _socket;
+    size_t _frame_size;
+    std::thread _thread;
+};
+
+/***********************************************************************
+ * Transports under test
+ **********************************************************************/
+struct xport_under_test
+{
+    // The peer must outlive the transport, so it's declared first
+    echo_peer::uptr peer;
+    //! Keeps transports alive that the benchmarked transport wraps
+    std::vector<zero_copy_if::sptr> base_xports;
+    muxed_zero_copy_if::sptr mux;
+    zero_copy_if::sptr xport;
+    //! True for transports that may chop up frames (TCP)
+    bool is_stream = false;
+};
+
+zero_copy_if::sptr make_udp(echo_peer::uptr& peer, const zero_copy_xport_params& params)
+{
+    peer.reset(new udp_echo_peer(std::max(params.recv_frame_size, params.send_frame_size)));
+    udp_zero_copy::buff_params buff_params_out;
+    return udp_zero_copy::make(LOOPBACK_ADDR,
+        peer->get_port(),
+        params,
+        buff_params_out,
+        uhd::device_addr_t("recv_buff_size=33554432,send_buff_size=33554432"));
+}
+
+xport_under_test make_xport(const std::string& name, const zero_copy_xport_params& params)
+{
+    xport_under_test xut;
+    if (name == "udp") {
+        xut.xport = make_udp(xut.peer, params);
+    } else if (name == "tcp") {
+        xut.peer.reset(
+            new tcp_echo_peer(std::max(params.recv_frame_size, params.send_frame_size)));
+        xut.xport     = tcp_zero_copy::make(LOOPBACK_ADDR,
+            xut.peer->get_port(),
+            uhd::device_addr_t(str(boost::format("recv_frame_size=%d,send_frame_size=%d,"
+                                                 "num_recv_frames=%d,num_send_frames=%d")
+                                   % params.recv_frame_size % params.send_frame_size
+                                   % params.num_recv_frames % params.num_send_frames)));
+        xut.is_stream = true;
+    } else if (name == "muxed") {
+        zero_copy_if::sptr base = make_udp(xut.peer, params);
+        xut.mux   = muxed_zero_copy_if::make(base, [](void*, size_t) { return 0; }, 1);
+        xut.xport = xut.mux->make_stream(0);
+        xut.base_xports.push_back(base);
+    } else if (name == "offload") {
+        zero_copy_if::sptr base = make_udp(xut.peer, params);
+        xut.xport               = zero_copy_recv_offload::make(base, 0.1);
+        xut.base_xports.push_back(base);
+    } else if (name == "flowctrl") {
+        zero_copy_if::sptr base = make_udp(xut.peer, params);
+        // Credit accounting is stubbed out, this measures the wrapper cost
+        xut.xport = zero_copy_flow_ctrl::make(base,
+            [](managed_buffer::sptr) { return true; },
+            [](managed_buffer::sptr) { return true; });
+        xut.base_xports.push_back(base);
+    } else if (name == "dpdk") {
+        throw uhd::not_implemented_error(
+            "The DPDK transport requires a NIC bound to DPDK and can't be run "
+            "against a loopback peer.");
+    } else {
+        throw uhd::value_error("Unknown transport: " + name);
+    }
+    return xut;
+}
+
+/***********************************************************************
+ * Benchmark
+ **********************************************************************/
+struct bench_results
+{
+    size_t tx_packets = 0;
+    size_t rx_packets = 0;
+    size_t rx_bytes   = 0;
+    size_t lost       = 0;
+    double duration_s = 0.0;
+    double cpu_s      = 0.0;
+    std::vector<uint64_t> latencies_ns;
+};
+
+bench_results run_bench(xport_under_test& xut,
+    const size_t frame_size,
+    const double duration_s,
+    const size_t window)
+{
+    bench_results results;
+    results.latencies_ns.reserve(1 << 20);
+
+    std::atomic<bool> running(true);
+    std::atomic<size_t> num_sent(0);
+    // All frames with a lower sequence number were received or given up on
+    std::atomic<size_t> num_retired(0);
+    zero_copy_if::sptr xport = xut.xport;
+
+    // Retire all frames up to (excluding) end_seq, of which num_frames arrived.
+    // Frames which arrive after they were given up on don't move it back.
+    auto retire = [&](const size_t end_seq, const size_t num_frames) {
+        const size_t retired = num_retired;
+        if (end_seq <= retired) {
+            return;
+        }
+        results.lost += end_seq - retired - std::min(num_frames, end_seq - retired);
+        num_retired = end_seq;
+    };
+
+    std::thread tx_thread([&]() {
+        uint64_t seq = 0;
+        while (running) {
+            if (num_sent - num_retired >= window) {
+                std::this_thread::yield();
+                continue;
+            }
+            managed_send_buffer::sptr buff = xport->get_send_buff(0.1);
+            if (not buff) {
+                continue;
+            }
+            const uint64_t header[2] = {seq++, get_time_ns()};
+            std::memcpy(buff->cast<void*>(), header, HEADER_SIZE);
+            buff->commit(frame_size);
+            buff.reset();
+            num_sent++;
+        }
+    });
+
+    const std::clock_t cpu_start = std::clock();
+    const uint64_t start_ns      = get_time_ns();
+    const uint64_t end_ns        = start_ns + uint64_t(duration_s * 1e9);
+    size_t stream_offset         = 0;
+    while (get_time_ns() < end_ns) {
+        managed_recv_buffer::sptr buff = xport->get_recv_buff(0.1);
+        if (not buff) {
+            // Whatever didn't make it back by now, isn't coming back
+            retire(num_sent, 0);
+            continue;
+        }
+        const uint64_t now_ns = get_time_ns();
+        const size_t len      = buff->size();
+        size_t num_frames     = 1;
+        if (xut.is_stream) {
+            // Count the frames completed by this chunk. Only frames that
+            // start at the beginning of a buffer carry a usable time stamp.
+            // A stream delivers every frame in order, so the number of
+            // completed frames is the sequence number of the next one.
+            const bool aligned = (stream_offset % frame_size) == 0;
+            num_frames = (stream_offset + len) / frame_size - stream_offset / frame_size;
+            stream_offset += len;
+            results.rx_bytes += len;
+            results.rx_packets += num_frames;
+            retire(stream_offset / frame_size, num_frames);
+            if (not aligned or len < HEADER_SIZE) {
+                continue;
+            }
+        }
+        uint64_t header[2];
+        std::memcpy(header, buff->cast<const void*>(), HEADER_SIZE);
+        results.latencies_ns.push_back(now_ns - header[1]);
+        if (not xut.is_stream) {
+            results.rx_bytes += len;
+            results.rx_packets += num_frames;
+            retire(size_t(header[0]) + 1, num_frames);
+        }
+    }
+    results.duration_s = (get_time_ns() - start_ns) / 1e9;
+    results.cpu_s      = double(std::clock() - cpu_start) / CLOCKS_PER_SEC;
+
+    running = false;
+    tx_thread.join();
+    results.tx_packets = num_sent;
+    return results;
+}
+
+uint64_t get_percentile(const std::vector<uint64_t>& sorted, const double percentile)
+{
+    if (sorted.empty()) {
+        return 0;
+    }
+    const size_t index =
+        std::min(sorted.size() - 1, size_t(percentile / 100.0 * sorted.size()));
+    return sorted[index];
+}
+
+void print_results(const std::string& name, bench_results& results)
+{
+    std::sort(results.latencies_ns.begin(), results.latencies_ns.end());
+    const double gbytes = results.rx_bytes / 1e9;
+    std::cout << boost::format("%-9s %12.0f %10.1f %9.1f %9.1f %9.1f %9.1f %9.2f %8d")
+                     % name % (results.rx_packets / results.duration_s)
+                     % (results.rx_packets ? results.duration_s * 1e9 / results.rx_packets
+                                           : 0.0)
+                     % (get_percentile(results.latencies_ns, 50.0) / 1e3)
+                     % (get_percentile(results.latencies_ns, 99.0) / 1e3)
+                     % (get_percentile(results.latencies_ns, 99.9) / 1e3)
+                     % (results.latencies_ns.empty() ? 0.0
+                                                     : results.latencies_ns.back() / 1e3)
+                     % (gbytes > 0.0 ? results.cpu_s / gbytes : 0.0) % results.lost
+              << std::endl;
+}
+
+} // namespace
+
+int UHD_SAFE_MAIN(int argc, char* argv[])
+{
+    std::string xports;
+    size_t frame_size, num_frames, window;
+    double duration;
+
+    po::options_description desc("Allowed options");
+    // clang-format off
+    desc.add_options()
+        ("help", "help message")
+        ("xports", po::value<std::string>(&xports)->default_value("udp,tcp,muxed,offload,flowctrl"), "Comma-separated list of transports to benchmark (udp, tcp, muxed, offload, flowctrl, dpdk)")
+        ("duration", po::value<double>(&duration)->default_value(2.0), "Duration of each benchmark in seconds")
+        ("frame-size", po::value<size_t>(&frame_size)->default_value(8000), "Frame size in bytes")
+        ("num-frames", po::value<size_t>(&num_frames)->default_value(128), "Number of send and receive frames of the transport")
+        ("window", po::value<size_t>(&window)->default_value(64), "Maximum number of frames in flight")
+    ;
+    // clang-format on
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    po::notify(vm);
+
+    if (vm.count("help")) {
+        std::cout << boost::format("UHD Transport Benchmark %s") % desc << std::endl
+                  << "Streams frames through each transport to an echo peer on the "
+                     "loopback interface." << std::endl
+                  << "CPU time is process time, and includes the echo peer." << std::endl;
+        return EXIT_SUCCESS;
+    }
+    if (frame_size < HEADER_SIZE) {
+        throw uhd::value_error("Frame size too small!");
+    }
+
+    zero_copy_xport_params params;
+    params.recv_frame_size = frame_size;
+    params.send_frame_size = frame_size;
+    params.num_recv_frames = num_frames;
+    params.num_send_frames = num_frames;
+
+    std::vector<std::string> xport_names;
+    boost::split(xport_names, xports, boost::is_any_of(","), boost::token_compress_on);
+
+    std::cout << boost::format("%-9s %12s %10s %9s %9s %9s %9s %9s %8s") % "Xport"
+                     % "Packets/s" % "ns/packet" % "p50[us]" % "p99[us]" % "p99.9[us]"
+                     % "max[us]" % "CPU s/GB" % "Lost"
+              << std::endl;
+    for (const std::string& name : xport_names) {
+        try {
+            xport_under_test xut = make_xport(name, params);
+            bench_results results = run_bench(xut, frame_size, duration, window);
+            print_results(name, results);
+        } catch (const uhd::not_implemented_error& ex) {
+            std::cout << boost::format("%-9s skipped: %s") % name % ex.what()
+                      << std::endl;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}